@@ -27,8 +27,10 @@
  *   - Decimation with anti-alias filtering
  *   - Interpolation with anti-image filtering
  *   - Rational rate conversion (L/M)
+ *   - Streaming polyphase and arbitrary-ratio (clock-drift) resamplers
  *   - Polyphase vs direct efficiency
  *   - Spectral effects of multirate operations
+ *   - Polyphase filter bank channelizer vs K mix + decimate chains
  *
  * Build & run:
  *   make chapters && ./build/bin/ch17
@@ -46,6 +48,7 @@
 #include "filter.h"
 #include "dsp_utils.h"
 #include "gnuplot.h"
+#include "realtime.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -163,14 +166,34 @@ static void demo_resample(void)
 
     /* 48000 → 44100:  L/M = 441/480 = 147/160 */
     int L = 147, M = 160;
-    int max_out = (N * L) / M + 10;
+    int max_out = 2 * N;              /* room for the ratio > 1 case below */
     double *y = (double *)calloc((size_t)max_out, sizeof(double));
     int out_len = resample(x, N, L, M, y);
 
     double fs_out = fs_in * (double)L / (double)M;
     printf("  Input:  fs = %.0f Hz, N = %d\n", fs_in, N);
     printf("  Output: fs = %.1f Hz, N = %d\n", fs_out, out_len);
-    printf("  Ratio:  %d/%d = %.6f\n\n", L, M, (double)L / (double)M);
+    printf("  Ratio:  %d/%d = %.6f\n", L, M, (double)L / (double)M);
+
+    /* Streaming: same conversion, fed in 10-sample blocks */
+    ResamplerState rs;
+    if (resampler_init(&rs, L, M, 24) == 0) {
+        int total = 0;
+        for (int i = 0; i < N; i += 10)
+            total += resampler_process(&rs, x + i, 10, y + total);
+        printf("  ResamplerState, 10-sample blocks: %d outputs, "
+               "%d taps per output\n", total, rs.taps);
+        resampler_free(&rs);
+    }
+
+    /* A 44.1 kHz stream whose clock runs 37 ppm fast, to 48 kHz */
+    FracResamplerState fr;
+    double ratio = 48000.0 / (44100.0 * (1.0 + 37e-6));
+    if (frac_resampler_init(&fr, ratio, 32) == 0) {
+        int out = frac_resampler_process(&fr, x, N, y);
+        printf("  FracResamplerState, ratio %.8f: %d outputs\n\n", ratio, out);
+        frac_resampler_free(&fr);
+    }
 
     free(x); free(y);
 }
@@ -214,9 +237,28 @@ static void demo_polyphase(void)
     printf("  Polyphase: %d sub-filters × %d taps each, at rate 1/%d\n",
            M, (taps + M - 1) / M, M);
     printf("  Max |direct - polyphase| = %.2e\n", max_err);
-    printf("  Ops ratio: polyphase uses ~%d× fewer multiplies\n\n",
+    printf("  Ops ratio: polyphase uses ~%d× fewer multiplies\n",
            M);
 
+    /* Same filter as a streaming object, fed 100 samples at a time */
+    DecimatorState ds;
+    if (decimator_init(&ds, M, h, taps) == 0) {
+        int total = 0;
+        for (int i = 0; i < N; i += 100) {
+            int len = (N - i < 100) ? N - i : 100;
+            total += decimator_process(&ds, x + i, len, y_poly + total);
+        }
+        max_err = 0.0;
+        for (int i = 0; i < out_len; i++) {
+            double err = fabs(y_direct[i] - y_poly[i]);
+            if (err > max_err) max_err = err;
+        }
+        printf("  DecimatorState, 100-sample blocks: %d outputs, "
+               "max err %.2e\n", total, max_err);
+        decimator_free(&ds);
+    }
+    printf("\n");
+
     free(x); free(h); free(filtered); free(y_direct); free(y_poly);
 }
 
@@ -263,6 +305,95 @@ static void demo_spectral(void)
     free(x); free(X); free(mag_orig); free(freq_axis);
 }
 
+/* ── Demo 6: Polyphase Filter Bank ────────────────────────────── */
+
+static void demo_channelizer(void)
+{
+    printf("=== Demo 6: Polyphase Filter Bank Channelizer ===\n\n");
+
+    const int K = 64, D = 32, P = 12, N = 64 * 1024;
+    Complex *x = (Complex *)malloc((size_t)N * sizeof(Complex));
+    Complex *Y = (Complex *)malloc((size_t)(N / D + 1) * K * sizeof(Complex));
+    Complex *xr = (Complex *)malloc((size_t)N * sizeof(Complex));
+    double *mix = (double *)malloc((size_t)N * sizeof(double));
+    double *dec = (double *)malloc((size_t)(N / D + 1) * sizeof(double));
+
+    /* Three carriers on channel centres 3, 17 and 40 (= −24) */
+    const int ch[3] = {3, 17, 40};
+    const double amp[3] = {1.0, 0.5, 0.25};
+    for (int i = 0; i < N; i++) {
+        x[i].re = x[i].im = 0.0;
+        for (int c = 0; c < 3; c++) {
+            double ph = 2.0 * M_PI * ch[c] * i / K;
+            x[i].re += amp[c] * cos(ph);
+            x[i].im += amp[c] * sin(ph);
+        }
+    }
+
+    PfbAnalysis an;
+    PfbSynthesis sy;
+    if (pfb_analysis_init(&an, K, D, P) != 0 ||
+        pfb_synthesis_init(&sy, K, D, P) != 0) {
+        printf("  init failed\n\n");
+        free(x); free(Y); free(xr); free(mix); free(dec);
+        return;
+    }
+
+    double t0 = timer_usec();
+    int frames = pfb_analysis_process(&an, x, N, Y);
+    double t_pfb = timer_usec() - t0;
+
+    printf("  K = %d channels, D = %d (2× oversampled), %d-tap prototype\n",
+           K, D, an.taps);
+    printf("  Channel  |y| (last frame)\n");
+    for (int q = 0; q < K; q++) {
+        Complex y = Y[(size_t)(frames - 1) * K + q];
+        double mag = hypot(y.re, y.im);
+        if (mag > 1e-3 || q == 4)
+            printf("  %5d    %.4f\n", q, mag);
+    }
+
+    /* The same channels as K separate chains: mix to 0 Hz, then
+     * DecimatorState on I and Q with the same prototype */
+    double *h = (double *)malloc((size_t)(an.taps + 2 * K) * sizeof(double));
+    double *cs = h + an.taps, *sn = cs + K;     /* mixer table e^{−j2πk/K} */
+    for (int i = 0; i < an.taps; i++) h[i] = an.h[i] / K;
+    for (int k = 0; k < K; k++) {
+        cs[k] = cos(2.0 * M_PI * k / K);
+        sn[k] = -sin(2.0 * M_PI * k / K);
+    }
+    t0 = timer_usec();
+    for (int q = 0; q < K; q++) {
+        for (int part = 0; part < 2; part++) {
+            DecimatorState ds;
+            if (decimator_init(&ds, D, h, an.taps) != 0) continue;
+            for (int i = 0, k = 0; i < N; i++, k = (k + q) % K)
+                mix[i] = part ? x[i].re * sn[k] + x[i].im * cs[k]
+                              : x[i].re * cs[k] - x[i].im * sn[k];
+            decimator_process(&ds, mix, N, dec);
+            decimator_free(&ds);
+        }
+    }
+    double t_chain = timer_usec() - t0;
+    printf("\n  %d samples: filter bank %.2f ms, %d mix + decimate chains %.2f ms"
+           " (%.0f×)\n", N, t_pfb / 1e3, K, t_chain / 1e3, t_chain / t_pfb);
+
+    int nr = pfb_synthesis_process(&sy, Y, frames, xr);
+    int dly = an.taps - 1;
+    double se = 0.0, sx = 0.0;
+    for (int t = 2 * K * P; t < nr; t++) {
+        double dr = xr[t].re - x[t - dly].re, di = xr[t].im - x[t - dly].im;
+        se += dr * dr + di * di;
+        sx += x[t - dly].re * x[t - dly].re + x[t - dly].im * x[t - dly].im;
+    }
+    printf("  Synthesis bank: x rebuilt %d samples late, SNR %.1f dB\n\n",
+           dly, 10.0 * log10(sx / se));
+
+    pfb_analysis_free(&an);
+    pfb_synthesis_free(&sy);
+    free(x); free(Y); free(xr); free(mix); free(dec); free(h);
+}
+
 int main(void)
 {
     printf("╔══════════════════════════════════════════════════════════╗\n");
@@ -274,6 +405,7 @@ int main(void)
     demo_resample();
     demo_polyphase();
     demo_spectral();
+    demo_channelizer();
 
     printf("=== Chapter 17 Complete ===\n");
     return 0;
@@ -24,7 +24,7 @@ extern "C" {
  * @param x     Input signal (length n)
  * @param n     Signal length (need NOT be power of 2; zero-padded to nfft)
  * @param c     Output real cepstrum (length nfft)
- * @param nfft  FFT size (must be power of 2 and >= n)
+ * @param nfft  FFT size (>= n; even sizes such as rfft_fast_length(n) are fastest)
  */
 void cepstrum_real(const double *x, int n, double *c, int nfft);
 
@@ -36,7 +36,7 @@ void cepstrum_real(const double *x, int n, double *c, int nfft);
  * @param x     Input signal (length n)
  * @param n     Signal length
  * @param c     Output complex cepstrum (length nfft)
- * @param nfft  FFT size (power of 2, >= n)
+ * @param nfft  FFT size (>= n; see fft_fast_length())
  */
 void cepstrum_complex(const double *x, int n, double *c, int nfft);
 
@@ -89,7 +89,7 @@ void mel_filterbank(const double *power_spec, int nfft, double fs,
  *
  * @param frame     Input time-domain frame (length frame_len)
  * @param frame_len Frame size in samples
- * @param nfft      FFT size (power of 2, >= frame_len)
+ * @param nfft      FFT size (>= frame_len; even sizes are fastest)
  * @param fs        Sampling rate (Hz)
  * @param n_filters Number of Mel filters (e.g. 26)
  * @param n_mfcc    Number of MFCCs to return (e.g. 13)
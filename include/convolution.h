@@ -16,9 +16,38 @@
 /* ── Linear convolution ─────────────────────────────────────────── */
 
 /**
- * Linear (direct) convolution: y[n] = Σ x[k] * h[n-k].
+ * Convolution algorithm.  CONV_AUTO lets conv_select_method() choose;
+ * the others force a path (results agree to rounding, ~1e-15 relative).
+ */
+typedef enum {
+    CONV_AUTO = 0,  /**< Cheapest by the cost model                    */
+    CONV_DIRECT,    /**< O(N·M) time-domain sum                         */
+    CONV_OLA,       /**< Block FFT, overlap-add (streaming.h)           */
+    CONV_OLS        /**< Block FFT, overlap-save (streaming.h)          */
+} ConvMethod;
+
+/**
+ * Pick the cheapest method for an x_len × h_len convolution.
+ *
+ * Direct costs x_len·h_len MACs.  The FFT paths cost
+ * ⌈(x_len+h_len−1)/L⌉ blocks of one N-point rfft/multiply/irfft, with
+ * N a power of 2 and L = N − h_len + 1, minimised over N; one block
+ * is priced at a fixed 1.5 MACs per N·log₂N.  Nothing is timed, so the
+ * answer — and the output bits of every CONV_AUTO caller — depends only
+ * on the sizes.  OLS moves fewer samples per block than OLA, so it is
+ * the FFT path chosen; short filters (h_len < 32) and small products
+ * return CONV_DIRECT.
+ *
+ * @return CONV_DIRECT or CONV_OLS
+ */
+ConvMethod conv_select_method(int x_len, int h_len);
+
+/**
+ * Linear convolution: y[n] = Σ x[k] * h[n-k].
  *
  * Output length = x_len + h_len - 1 (caller must allocate).
+ * Runs convolve_method(..., CONV_AUTO): direct for short filters,
+ * block FFT when the cost model says it is cheaper.
  *
  * @param x      Input signal, length x_len
  * @param x_len  Length of input signal
@@ -31,9 +60,21 @@ int convolve(const double *x, int x_len,
              const double *h, int h_len,
              double *y);
 
+/**
+ * convolve() with an explicit method (CONV_AUTO = convolve()).
+ * y must not overlap x or h.  A forced FFT method that cannot allocate
+ * falls back to the direct sum.
+ *
+ * @return Output length (x_len + h_len - 1)
+ */
+int convolve_method(const double *x, int x_len,
+                    const double *h, int h_len,
+                    double *y, ConvMethod method);
+
 /**
  * Causal convolution with truncation: output length equals x_len.
  * Equivalent to the first x_len samples of full convolution.
+ * Method chosen as in convolve().
  *
  * @param x      Input signal
  * @param x_len  Length of input signal
@@ -45,6 +86,11 @@ void convolve_causal(const double *x, int x_len,
                      const double *h, int h_len,
                      double *y);
 
+/** convolve_causal() with an explicit method (see convolve_method()). */
+void convolve_causal_method(const double *x, int x_len,
+                            const double *h, int h_len,
+                            double *y, ConvMethod method);
+
 /* ── Cross-correlation ──────────────────────────────────────────── */
 
 /**
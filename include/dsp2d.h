@@ -86,12 +86,14 @@ void sobel_magnitude(const double *img, int rows, int cols, double *mag);
 /* ------------------------------------------------------------------ */
 
 /**
- * Forward 2-D FFT (in-place, rows × cols must both be powers of 2).
- * Data layout: row-major Complex array [rows * cols].
+ * Forward 2-D FFT (in-place).
+ * Data layout: split planes, row-major [rows * cols] each; rows are
+ * transformed directly in the planes with fft_execute_split().
  *
- * @param data  Complex image (rows × cols), in-place
- * @param rows  Height (power of 2)
- * @param cols  Width (power of 2)
+ * @param data_re  Real part (rows × cols), in-place
+ * @param data_im  Imag part (rows × cols), in-place
+ * @param rows     Height (powers of 2 are fastest)
+ * @param cols     Width (powers of 2 are fastest)
  */
 void fft2d(double *data_re, double *data_im, int rows, int cols);
 
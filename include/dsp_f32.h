@@ -0,0 +1,228 @@
+/**
+ * @file dsp_f32.h
+ * @brief Chapter 29 — Single-precision (float32) core API.
+ *
+ * A parallel `*_f32` family of the hot paths for data that does not
+ * need double precision (e.g. 16/24-bit acquisition):
+ *
+ *   double API                  float API
+ *   ──────────                  ─────────
+ *   FftPlan / fft_execute       FftPlanF / fft_execute_f32
+ *   RfftPlan / rfft_execute     RfftPlanF / rfft_execute_f32
+ *   fir_filter                  fir_filter_f32
+ *   SOSCascade / sos_process_*  SOSCascadeF / sos_process_*_f32
+ *   OlaState / OlsState         OlaStateF / OlsStateF
+ *   welch_psd                   welch_psd_f32
+ *   RingBuffer                  RingBufferF
+ *
+ * Half the bytes per sample means twice the samples per cache line and
+ * per SIMD register (ComplexF kernels in simd.h run 4 complex values
+ * per AVX2 operation instead of 2).
+ *
+ * Precision
+ * ─────────
+ *   Filters are designed in double (butterworth_lowpass() etc.) and
+ *   rounded once with sos_to_f32(); FFT twiddles are computed in
+ *   double and stored as float.  Expect ~1e-6 relative agreement with
+ *   the double path — float32 has a 24-bit mantissa (~144 dB), ample
+ *   for 24-bit data.
+ *
+ *   Power-of-2 FFTs run a native float radix-4 engine; other lengths
+ *   go through the double engine (converted in and out).
+ *
+ * @see chapters/29-optimisation/tutorial.md
+ */
+
+#ifndef DSP_F32_H
+#define DSP_F32_H
+
+#include "dsp_utils.h"   /* ComplexF, window_fn */
+#include "fft.h"         /* FftPlan */
+#include "iir.h"         /* SOSCascade, MAX_SOS_SECTIONS */
+
+/* ── FFT ─────────────────────────────────────────────────────────── */
+
+/** Precomputed float FFT for one length N (see FftPlan). */
+typedef struct {
+    int       n;              /**< Transform length                   */
+    int       log2n;          /**< log₂N, or -1 if not a power of 2   */
+    int       n_swaps;        /**< Bit-reversal swap pairs            */
+    int      *swaps;          /**< 2·n_swaps indices                  */
+    ComplexF *stage_twiddle;  /**< Radix-4 stage twiddles (float)     */
+    FftPlan  *wide;           /**< Double plan for non-power-of-2 N   */
+} FftPlanF;
+
+/** Float real-input FFT plan (N even, N/2-point complex core). */
+typedef struct {
+    int       n;              /**< Real transform length              */
+    FftPlanF *half;           /**< N/2-point complex plan             */
+    ComplexF *split;          /**< W_N^k, k = 0 .. N/4                */
+} RfftPlanF;
+
+/** Create a float plan for length n (any n >= 1).  NULL on error. */
+FftPlanF *fft_plan_create_f32(int n);
+
+/** Free a plan from fft_plan_create_f32() (NULL is a no-op). */
+void fft_plan_destroy_f32(FftPlanF *p);
+
+/**
+ * In-place forward FFT of p->n float samples.
+ * @return 0, or -1 if a non-power-of-2 transform could not allocate
+ */
+int fft_execute_f32(const FftPlanF *p, ComplexF *x);
+
+/** In-place inverse FFT (scaled by 1/N).  0 or -1 as fft_execute_f32(). */
+int ifft_execute_f32(const FftPlanF *p, ComplexF *x);
+
+/** Create a float real-FFT plan (n even, >= 2).  NULL on error. */
+RfftPlanF *rfft_plan_create_f32(int n);
+
+/** Free a plan from rfft_plan_create_f32() (NULL is a no-op). */
+void rfft_plan_destroy_f32(RfftPlanF *p);
+
+/**
+ * Real FFT: in[0..N-1] → out[0..N/2] (N/2 + 1 bins).
+ * @return 0, or -1 as fft_execute_f32()
+ */
+int rfft_execute_f32(const RfftPlanF *p, const float *in, ComplexF *out);
+
+/**
+ * Inverse real FFT: in[0..N/2] → out[0..N-1], scaled by 1/N.
+ * in is used as scratch and overwritten.
+ */
+int irfft_execute_f32(const RfftPlanF *p, ComplexF *in, float *out);
+
+/** Shared plans, built on first use (thread-safe, see fft_plan_cached). */
+const FftPlanF  *fft_plan_cached_f32(int n);
+const RfftPlanF *rfft_plan_cached_f32(int n);
+
+/** Free every cached float plan (pointers from *_cached_f32 become invalid). */
+void fft_plan_cache_clear_f32(void);
+
+/** One-shot transforms on cached plans.  0, or -1 on error. */
+int fft_f32(ComplexF *x, int n);
+int ifft_f32(ComplexF *x, int n);
+int rfft_f32(const float *in, ComplexF *out, int n);
+
+/* ── FIR ─────────────────────────────────────────────────────────── */
+
+/** Float fir_filter(): out[i] = Σ h[k]·in[i−k], zero initial state. */
+void fir_filter_f32(const float *in, float *out, int n,
+                    const float *h, int order);
+
+/* ── Biquad / SOS ────────────────────────────────────────────────── */
+
+typedef struct {
+    float b0, b1, b2;   /**< Numerator   */
+    float a1, a2;       /**< Denominator (a0 = 1) */
+} BiquadF;
+
+typedef struct {
+    float x1, x2;       /**< Input delay  */
+    float y1, y2;       /**< Output delay */
+} BiquadDF1StateF;
+
+typedef struct {
+    BiquadF         sections[MAX_SOS_SECTIONS];
+    BiquadDF1StateF states[MAX_SOS_SECTIONS];
+    int             n_sections;
+    float           gain;
+} SOSCascadeF;
+
+/** Round a double-designed cascade to float (state cleared). */
+void sos_to_f32(SOSCascadeF *dst, const SOSCascade *src);
+
+/** Zero sections, state and set gain = 1 (as sos_init). */
+void sos_init_f32(SOSCascadeF *sos);
+
+/** Direct Form I biquad, one sample. */
+float biquad_process_df1_f32(const BiquadF *bq, BiquadDF1StateF *s, float x);
+
+/** Direct Form I biquad over a block (in and out may alias). */
+void biquad_process_block_f32(const BiquadF *bq, BiquadDF1StateF *s,
+                              const float *in, float *out, int n);
+
+/** Cascade, one sample. */
+float sos_process_sample_f32(SOSCascadeF *sos, float x);
+
+/**
+ * Cascade over a block, one section at a time (state stays in
+ * registers).  Same arithmetic as sos_process_sample_f32() per sample;
+ * in and out may alias.
+ */
+void sos_process_block_f32(SOSCascadeF *sos, const float *in, float *out, int n);
+
+/* ── Overlap-Add / Overlap-Save (see streaming.h) ────────────────── */
+
+typedef struct {
+    int    block_size;          /**< L                                */
+    int    fft_size;            /**< N ≥ L + M − 1, power of 2        */
+    int    filter_len;          /**< M                                */
+    const RfftPlanF *plan;      /**< Shared N-point plan (from cache) */
+    ComplexF *H;                /**< Filter spectrum (N/2+1)          */
+    ComplexF *Xbuf;             /**< Block spectrum scratch (N/2+1)   */
+    float    *tail;             /**< Overlap tail (N − L)             */
+    float    *padded;           /**< Zero-padded block / IFFT output  */
+} OlaStateF;
+
+typedef struct {
+    int    block_size;          /**< L                                */
+    int    fft_size;            /**< N ≥ L + M − 1, power of 2        */
+    int    filter_len;          /**< M                                */
+    const RfftPlanF *plan;      /**< Shared N-point plan (from cache) */
+    ComplexF *H;                /**< Filter spectrum (N/2+1)          */
+    ComplexF *Xbuf;             /**< Segment spectrum scratch         */
+    float    *input_buf;        /**< [last M−1 | new L | 0…] (N)      */
+    float    *ybuf;             /**< IFFT output (N)                  */
+} OlsStateF;
+
+/** As ola_init(); 0 on success, -1 on error. */
+int  ola_init_f32(OlaStateF *s, const float *h, int filter_len, int block_size);
+/** Filter one block of s->block_size samples. */
+void ola_process_f32(OlaStateF *s, const float *in, float *out);
+void ola_free_f32(OlaStateF *s);
+
+/** As ols_init(); 0 on success, -1 on error. */
+int  ols_init_f32(OlsStateF *s, const float *h, int filter_len, int block_size);
+/** Filter one block of s->block_size samples. */
+void ols_process_f32(OlsStateF *s, const float *in, float *out);
+void ols_free_f32(OlsStateF *s);
+
+/* ── Welch PSD (see spectrum.h) ──────────────────────────────────── */
+
+/**
+ * Float welch_psd(): same segmentation, window normalisation and
+ * one-sided scaling.  The window is evaluated in double.
+ * @return Number of segments averaged, or -1 on error
+ */
+int welch_psd_f32(const float *x, int n, float *psd, int nfft,
+                  int seg_len, int overlap, window_fn win);
+
+/* ── Ring buffer (see realtime.h) ────────────────────────────────── */
+
+/** Same SPSC layout as RingBuffer: producer and consumer fields on
+ *  separate 64-byte cache lines, acquire/release index handoff. */
+typedef struct {
+    float *buf;     /**< Sample storage             */
+    int    cap;     /**< Capacity (power of 2)      */
+    int    mask;    /**< cap − 1                    */
+    char   pad0[64];
+    int    head;        /**< Write position (producer)  */
+    int    tail_cache;  /**< Producer's view of tail    */
+    char   pad1[64];
+    int    tail;        /**< Read position (consumer)   */
+    int    head_cache;  /**< Consumer's view of head    */
+    char   pad2[64];
+} RingBufferF;
+
+RingBufferF *ring_buffer_create_f32(int capacity);
+void ring_buffer_destroy_f32(RingBufferF *rb);
+int  ring_buffer_write_f32(RingBufferF *rb, const float *data, int n);
+int  ring_buffer_read_f32(RingBufferF *rb, float *data, int n);
+int  ring_buffer_available_f32(const RingBufferF *rb);
+int  ring_buffer_space_f32(const RingBufferF *rb);
+int  ring_buffer_peek_f32(const RingBufferF *rb, float *data, int n);
+int  ring_buffer_skip_f32(RingBufferF *rb, int n);
+void ring_buffer_reset_f32(RingBufferF *rb);
+
+#endif /* DSP_F32_H */
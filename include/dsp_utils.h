@@ -18,6 +18,12 @@ typedef struct {
     double im;  /* Imaginary part */
 } Complex;
 
+/** Single-precision complex, same layout as Complex (see dsp_f32.h). */
+typedef struct {
+    float re;
+    float im;
+} ComplexF;
+
 /* ── Complex arithmetic ──────────────────────────────────────────── */
 
 /** @brief Add two complex numbers: (a.re+b.re) + j(a.im+b.im) */
@@ -37,6 +43,54 @@ double  complex_phase(Complex z);
  */
 Complex complex_from_polar(double mag, double phase);
 
+/* ── Split (structure-of-arrays) complex buffers ─────────────────── */
+/*
+ *   Complex x[n]   re im re im re im ...     interleaved (array of structs)
+ *   SplitComplex   re re re ...  im im im    two planes  (struct of arrays)
+ *
+ * The split layout lets a vector register hold 4 real parts (or 4
+ * imaginary parts) at once, so a complex multiply needs no shuffles.
+ * fft_execute_split(), simd_cmul_split() and simd_magnitude_split()
+ * work on any (re, im) plane pair — a SplitComplex or caller arrays
+ * such as the data_re/data_im planes of fft2d().
+ */
+
+typedef struct {
+    double *re;  /* Real plane, n values      */
+    double *im;  /* Imaginary plane, n values */
+    int     n;   /* Number of complex values  */
+} SplitComplex;
+
+/** @brief Allocate a zeroed n-element split buffer. Returns NULL on failure. */
+SplitComplex *split_complex_create(int n);
+/** @brief Free a split buffer. NULL is ignored. */
+void split_complex_destroy(SplitComplex *s);
+/** @brief Deinterleave: re[k] = x[k].re, im[k] = x[k].im, k < n. */
+void complex_to_split(const Complex *x, double *re, double *im, int n);
+/** @brief Interleave: x[k] = re[k] + j·im[k], k < n. */
+void split_to_complex(const double *re, const double *im, Complex *x, int n);
+
+/* ── Arena allocator ─────────────────────────────────────────────── */
+/*
+ * A bump allocator over caller-provided memory: objects are carved out
+ * back to back and released all at once with dsp_arena_reset().  No
+ * per-object headers or malloc calls, so thousands of small objects
+ * (e.g. SOSChain filter banks, see iir.h) stay contiguous in cache.
+ */
+
+typedef struct {
+    unsigned char *base;  /* Caller memory             */
+    size_t         size;  /* Bytes available           */
+    size_t         used;  /* Bytes handed out so far   */
+} DspArena;
+
+/** @brief Use buf[0..size) as an empty arena. */
+void  dsp_arena_init(DspArena *a, void *buf, size_t size);
+/** @brief bytes of zeroed, 16-byte-aligned memory, or NULL if the arena is full. */
+void *dsp_arena_alloc(DspArena *a, size_t bytes);
+/** @brief Release everything allocated so far (the memory is reused). */
+void  dsp_arena_reset(DspArena *a);
+
 /* ── Window functions ────────────────────────────────────────────── */
 /* Each returns w[i] for a window of length n.
  * See chapters/09-window-functions.md for spectral leakage theory.
@@ -1,9 +1,33 @@
 /**
  * @file fft.h
- * @brief Cooley-Tukey Radix-2 FFT — the core transform of this library.
+ * @brief Cooley-Tukey FFT (radix-4 engine) — the core transform of this library.
  *
  * Provides forward and inverse FFT for complex and real-valued signals.
- * All sizes must be powers of 2.
+ * Any size N >= 1 is accepted:
+ *
+ *   N = 2^a             radix-4 engine (fastest)
+ *   N = 2^a·3^b·5^c·7^d  mixed-radix Stockham stages
+ *   anything else       Bluestein chirp-z on a power-of-2 FFT (~3-6× slower)
+ *
+ * fft_fast_length() / rfft_fast_length() return the next size ≥ n of
+ * the second kind, for callers that are free to zero-pad.
+ *
+ * ── Plans ───────────────────────────────────────────────────────
+ *
+ *   An FftPlan holds everything about a transform that depends only
+ *   on its size: the bit-reversal swap list and the twiddle table
+ *   W[k] = exp(-j·2π·k/N).  Build it once, execute it many times:
+ *
+ *     FftPlan *p = fft_plan_create(1024);
+ *     for (...) fft_execute(p, frame);     ← no sin/cos, no index walk
+ *     fft_plan_destroy(p);
+ *
+ *   fft()/ifft() use a library-owned plan cache, so repeated calls at
+ *   the same size pay the table set-up cost only once.
+ *
+ *   fft_execute() runs radix-4 butterflies, plus one radix-2 pass when
+ *   log₂N is odd, so every power of 2 gets the radix-4 operation count.
+ *   fft_radix2() is kept as the textbook reference.
  *
  * See chapters/08-fft-fundamentals.md for the full theory walkthrough.
  */
@@ -13,12 +37,256 @@
 
 #include "dsp_utils.h"  /* Complex type */
 
+/** Upper bound on mixed-radix stages (every radix is >= 2). */
+#define FFT_MAX_FACTORS 32
+
+/**
+ * Powers of 2 with log₂N at or above this use the four-step engine
+ * (n1 × n2 sub-FFTs plus a transpose, split across the thread pool).
+ * The in-place radix-4 path is faster on one thread while the data
+ * stays in the last-level cache; 2^22 points are 64 MB.  Measure the
+ * crossover for a machine with bench_fft_crossover() (optimization.h)
+ * and override with -DFFT_FOURSTEP_MIN_LOG2=….
+ */
+#ifndef FFT_FOURSTEP_MIN_LOG2
+#define FFT_FOURSTEP_MIN_LOG2 22
+#endif
+
+/* ── Transform plan ──────────────────────────────────────────────── */
+
+/**
+ * @brief Pre-computed tables for an N-point FFT.
+ *
+ * Twiddles are evaluated directly with cos/sin for every k, so there is
+ * no error build-up from chaining complex multiplies at large N.
+ *
+ * stage_twiddle holds, for each radix-4 stage of length L in execution
+ * order, three planes W_L^k, W_L^2k, W_L^3k (k = 0 .. L/4-1), so
+ * consecutive butterflies read consecutive twiddles (SIMD-friendly).
+ * stage_twiddle_split is the same table as separate re/im planes for
+ * fft_execute_split().
+ *
+ * Plans are read-only during execution (sizes that are not a power of
+ * 2 take their work buffer per call), so one plan may run on several
+ * threads at the same time.
+ *
+ * Powers of 2 from 2^FFT_FOURSTEP_MIN_LOG2 up hold no radix-4 tables;
+ * they own an n1-point and an n2-point plan plus two short tables
+ * whose products give the inter-step twiddles W_N^(k1·j2) (see
+ * fourstep_execute() in fft.c).
+ */
+typedef struct FftPlan {
+    int      n;         /**< Transform size                              */
+    int      log2n;     /**< log₂(n), or -1 if n is not a power of 2     */
+    int      n_swaps;   /**< Number of bit-reversal swap pairs           */
+    int     *swaps;     /**< Swap pairs (i, j), i < j, 2·n_swaps entries */
+    Complex *twiddle;   /**< W[k] = exp(-j·2π·k/N), k = 0 .. N/2-1       */
+    Complex *stage_twiddle; /**< Radix-4 twiddle planes, per stage       */
+    double  *stage_twiddle_split; /**< Same, as re/im planes (6 per k)   */
+
+    /* Sizes that are not a power of 2 (log2n == -1) */
+    int      n_factors;     /**< Mixed-radix stages; 0 selects Bluestein */
+    int      factors[FFT_MAX_FACTORS]; /**< Radix per stage (4,2,3,5,7)  */
+    Complex *mr_twiddle;    /**< Per-stage roots + W_{Lp}^(q·k) tables   */
+    int      m;             /**< Bluestein convolution length (pow 2)    */
+    Complex *chirp;         /**< Bluestein: exp(-jπ·k²/N), k < N         */
+    Complex *chirp_fft;     /**< Bluestein: FFT_M of the conjugate chirp */
+    struct FftPlan *conv;   /**< Bluestein: owned M-point plan           */
+
+    /* Four-step (log2n >= FFT_FOURSTEP_MIN_LOG2) */
+    int      n1, n2;        /**< N = n1·n2, column and row FFT lengths   */
+    struct FftPlan *fs_cols;    /**< Owned n1-point plan                 */
+    struct FftPlan *fs_rows;    /**< Owned n2-point plan                 */
+    Complex *fs_tw_lo;      /**< W_N^k, k < n1                           */
+    Complex *fs_tw_hi;      /**< W_N^(n1·k) = W_n2^k, k < n2             */
+} FftPlan;
+
+/**
+ * Create a plan for an n-point transform.
+ * @param n  Transform size (>= 1)
+ * @return   New plan, or NULL if n is invalid or allocation fails
+ */
+FftPlan *fft_plan_create(int n);
+
+/** Power-of-2 engine choice for fft_plan_create_engine(). */
+typedef enum {
+    FFT_ENGINE_AUTO,        /**< Four-step from 2^FFT_FOURSTEP_MIN_LOG2 up */
+    FFT_ENGINE_INPLACE,     /**< Radix-4 stages over the whole array       */
+    FFT_ENGINE_FOURSTEP     /**< Cache-blocked n1 × n2 four-step           */
+} FftEngine;
+
+/**
+ * Create a plan with an explicit power-of-2 engine, e.g. to benchmark
+ * both sides of the FFT_FOURSTEP_MIN_LOG2 crossover.  Other sizes
+ * ignore `engine` (FFT_ENGINE_FOURSTEP needs a power of 2 >= 4).
+ * @return   New plan, or NULL if n/engine is invalid or allocation fails
+ */
+FftPlan *fft_plan_create_engine(int n, FftEngine engine);
+
+/** Free a plan created by fft_plan_create().  NULL is ignored. */
+void fft_plan_destroy(FftPlan *p);
+
+/**
+ * In-place forward FFT using a plan.
+ * @param p  Plan for the transform size
+ * @param x  Array of p->n complex samples (modified in-place)
+ */
+void fft_execute(const FftPlan *p, Complex *x);
+
+/**
+ * In-place inverse FFT (scaled by 1/N) using a plan.
+ * @param p  Plan for the transform size
+ * @param x  Array of p->n complex bins (modified in-place)
+ */
+void ifft_execute(const FftPlan *p, Complex *x);
+
+/**
+ * In-place forward FFT on split planes (see SplitComplex).
+ *
+ * Powers of 2 run the radix-4 engine directly on the planes and give
+ * bit-identical results to fft_execute() on the interleaved data.
+ * Other sizes interleave into a temporary buffer, so prefer
+ * fft_execute() for those.
+ *
+ * @param p   Plan for the transform size
+ * @param re  Real parts, p->n values (modified in-place)
+ * @param im  Imaginary parts, p->n values (modified in-place)
+ * @return    0 on success, -1 if the temporary buffer cannot be allocated
+ */
+int fft_execute_split(const FftPlan *p, double *re, double *im);
+
+/** Inverse of fft_execute_split(), scaled by 1/N.  Returns 0 or -1. */
+int ifft_execute_split(const FftPlan *p, double *re, double *im);
+
+/* ── Batched transforms ──────────────────────────────────────────── */
+
+/**
+ * Run howmany in-place FFTs of one plan (FFTW "howmany" layout).
+ *
+ * Transform j, element i is x[j·dist + i·stride]:
+ *
+ *   rows of a rows×cols image:     howmany = rows, stride = 1,    dist = cols
+ *   columns of the same image:     howmany = cols, stride = cols, dist = 1
+ *   channel-interleaved frames:    howmany = ch,   stride = ch,   dist = 1
+ *
+ * Strided power-of-2 transforms (stride > 1) are gathered 8 at a time
+ * and run with their butterflies interleaved, sharing every twiddle
+ * load — about 2× faster than gathering them one by one.  Contiguous
+ * transforms (stride == 1) run back to back on the shared plan.  The
+ * result is bit-identical to calling fft_execute() on each transform.
+ *
+ * @return 0 on success, -1 on bad arguments or allocation failure
+ */
+int fft_execute_many(const FftPlan *p, Complex *x, int howmany, int stride, int dist);
+
+/** Inverse of fft_execute_many() (each transform scaled by 1/N). */
+int ifft_execute_many(const FftPlan *p, Complex *x, int howmany, int stride, int dist);
+
+/** fft_execute_many() on split planes, indexed the same way. */
+int fft_execute_many_split(const FftPlan *p, double *re, double *im,
+                           int howmany, int stride, int dist);
+
+/** Inverse of fft_execute_many_split(). */
+int ifft_execute_many_split(const FftPlan *p, double *re, double *im,
+                            int howmany, int stride, int dist);
+
+/**
+ * Get the shared, library-owned plan for size n.
+ *
+ * The plan is built on first request and kept until
+ * fft_plan_cache_clear().  Callers must not destroy it.
+ * Lookups are serialised by a mutex, and the returned plan may be
+ * executed on several threads at once (see FftPlan);
+ * fft_plan_cache_clear() must not race with users of cached plans.
+ *
+ * @param n  Transform size (>= 1)
+ * @return   Cached plan, or NULL if n is invalid or allocation fails
+ */
+const FftPlan *fft_plan_cached(int n);
+
+/** Destroy every cached plan.  Pointers previously returned become invalid. */
+void fft_plan_cache_clear(void);
+
+/**
+ * Smallest length >= n whose only prime factors are 2, 3, 5 and 7.
+ * Use it in place of next_power_of_2() when zero-padding: 1025 → 1029
+ * instead of 2048, 48000 stays 48000.
+ */
+int fft_fast_length(int n);
+
+/** As fft_fast_length(), but even (for rfft/irfft).  Returns >= 2. */
+int rfft_fast_length(int n);
+
+/* ── Real-input transform plan ───────────────────────────────────── */
+
+/**
+ * @brief Plan for an N-point real-to-complex transform.
+ *
+ * A real signal of length N is packed into N/2 complex samples
+ * z[m] = x[2m] + j·x[2m+1], transformed with an N/2-point complex FFT,
+ * and split into the N/2 + 1 non-redundant bins of X:
+ *
+ *   X[k] = ½(Z[k] + Z*[N/2-k]) − ½j·W^k·(Z[k] − Z*[N/2-k])
+ *
+ * That is half the butterflies and half the memory of fft_real().
+ */
+typedef struct {
+    int      n;       /**< Real transform size N (even, >= 2)       */
+    FftPlan *half;    /**< Owned N/2-point complex plan             */
+    Complex *split;   /**< W^k = exp(-j·2π·k/N), k = 0 .. N/4       */
+} RfftPlan;
+
+/** Create a real-input plan for size n (even, >= 2). NULL on error. */
+RfftPlan *rfft_plan_create(int n);
+
+/** Free a plan created by rfft_plan_create().  NULL is ignored. */
+void rfft_plan_destroy(RfftPlan *p);
+
+/**
+ * Shared, library-owned real-input plan for size n (see fft_plan_cached).
+ * Also released by fft_plan_cache_clear().
+ */
+const RfftPlan *rfft_plan_cached(int n);
+
+/**
+ * Real-to-complex forward FFT using a plan.
+ * @param p    Plan for size N
+ * @param in   Real input, N samples
+ * @param out  Bins X[0..N/2], N/2 + 1 entries (caller allocates)
+ */
+void rfft_execute(const RfftPlan *p, const double *in, Complex *out);
+
+/**
+ * howmany real-input FFTs: in + j·in_dist → out + j·out_dist.
+ * The half-length complex FFTs run batched via fft_execute_many().
+ * @param in_dist   Distance between input signals (>= N)
+ * @param out_dist  Distance between output spectra (>= N/2 + 1)
+ * @return 0 on success, -1 on bad arguments or allocation failure
+ */
+int rfft_execute_many(const RfftPlan *p, const double *in, int in_dist,
+                      Complex *out, int out_dist, int howmany);
+
+/**
+ * Complex-to-real inverse FFT (scaled by 1/N) using a plan.
+ * @param p    Plan for size N
+ * @param in   Bins X[0..N/2] of a real signal; used as scratch and overwritten
+ * @param out  Real output, N samples
+ */
+void irfft_execute(const RfftPlan *p, Complex *in, double *out);
+
 /* ── Forward FFT ─────────────────────────────────────────────────── */
 
 /**
- * Compute in-place complex FFT using Cooley-Tukey radix-2 DIT.
+ * Compute in-place complex FFT on the cached plan for n.
  * @param x  Array of N complex samples (modified in-place)
- * @param n  Transform size (MUST be a power of 2)
+ * @param n  Transform size (any n >= 1; see fft_fast_length())
+ *
+ * If the plan or its work buffer cannot be allocated, fft() falls back
+ * to a table-free radix-2 loop (power-of-2 n) or O(N²) DFT (other n),
+ * so the result is still the spectrum, only slower.  With not even N
+ * points of memory left for the DFT, x comes back unchanged and
+ * nothing is reported; callers that must know use fft_split() or
+ * fft_execute_split(), which return -1.
  *
  * After calling: x[k] contains the k-th frequency bin (0 ≤ k < N).
  *   x[0]   = DC component (sum of all samples)
@@ -26,25 +294,61 @@
  */
 void fft(Complex *x, int n);
 
+/**
+ * In-place FFT of split planes on the cached plan for n.
+ * @return 0 on success, -1 on allocation failure or n < 1
+ */
+int fft_split(double *re, double *im, int n);
+
+/**
+ * Textbook radix-2 FFT that computes its twiddles on the fly.
+ *
+ * This is the algorithm walked through in chapter 8, kept as the
+ * reference that the plan-based engine is measured and checked against.
+ * Same result as fft(); n must be a power of 2.
+ */
+void fft_radix2(Complex *x, int n);
+
 /**
  * Compute FFT of a real-valued signal.
  * @param in   Real input array of length n
  * @param out  Complex output array of length n  (caller allocates)
- * @param n    Transform size (power of 2)
+ * @param n    Transform size (any n >= 1)
  */
 void fft_real(const double *in, Complex *out, int n);
 
+/**
+ * Real-to-complex FFT returning only the non-redundant half spectrum.
+ * @param in   Real input array of length n
+ * @param out  Complex output X[0..n/2], n/2 + 1 entries (caller allocates)
+ * @param n    Transform size (even n uses the half-length packing)
+ *
+ * The remaining bins follow from X[n-k] = conj(X[k]).
+ */
+void rfft(const double *in, Complex *out, int n);
+
 /* ── Inverse FFT ─────────────────────────────────────────────────── */
 
 /**
  * Compute in-place inverse FFT (frequency → time domain).
  * @param x  Array of N complex frequency bins (modified in-place)
- * @param n  Transform size (power of 2)
+ * @param n  Transform size (any n >= 1)
  *
  * After calling: x[i] contains the i-th time-domain sample.
  */
 void ifft(Complex *x, int n);
 
+/** In-place inverse of fft_split(), scaled by 1/N.  Returns 0 or -1. */
+int ifft_split(double *re, double *im, int n);
+
+/**
+ * Inverse of rfft(): n/2 + 1 bins of a real signal → n real samples.
+ * @param in   Bins X[0..n/2]; used as scratch and overwritten
+ * @param out  Real output array of length n
+ * @param n    Transform size (same as the forward rfft())
+ */
+void irfft(Complex *in, double *out, int n);
+
 /* ── Feature extraction ──────────────────────────────────────────── */
 
 /**
@@ -52,6 +356,11 @@ void ifft(Complex *x, int n);
  */
 void fft_magnitude(const Complex *x, double *mag, int n);
 
+/**
+ * Magnitude of split-plane bins: mag[k] = sqrt(re[k]² + im[k]²)
+ */
+void fft_magnitude_split(const double *re, const double *im, double *mag, int n);
+
 /**
  * Extract phase spectrum: phase[k] = atan2(im, re) for k = 0..n-1
  */
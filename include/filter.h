@@ -16,6 +16,8 @@
 #ifndef FILTER_H
 #define FILTER_H
 
+#include "convolution.h"   /* ConvMethod */
+
 /* ── Direct FIR filtering (whole-buffer) ─────────────────────────── */
 
 /**
@@ -28,10 +30,85 @@
  *
  * The first (order-1) output samples use zero-padding for
  * unavailable past samples.
+ *
+ * Runs fir_filter_method(..., CONV_AUTO): the direct sum for short
+ * filters, block FFT (OLS) when conv_select_method() says it is
+ * cheaper — 4097 taps × 10M samples takes minutes direct, well under
+ * a second via OLS.  The choice depends only on n and order, so a
+ * given call returns the same bits on every run and machine.
  */
 void fir_filter(const double *in, double *out, int n,
                 const double *h, int order);
 
+/**
+ * fir_filter() with an explicit method: CONV_AUTO is fir_filter(),
+ * CONV_DIRECT always takes the time-domain sum, CONV_OLA / CONV_OLS force block FFT, CONV_AUTO picks the cheaper by
+ * conv_select_method().  in and out must not overlap.
+ */
+void fir_filter_method(const double *in, double *out, int n,
+                       const double *h, int order, ConvMethod method);
+
+/* ── Linear-phase FIR (coefficient symmetry) ─────────────────────── */
+
+/**
+ * Coefficient symmetry of a length-M FIR:
+ *
+ *   FIR_SYM_EVEN   h[k] =  h[M−1−k]   Type I (M odd) / Type II (M even)
+ *   FIR_SYM_ODD    h[k] = −h[M−1−k]   Type III (M odd) / Type IV (M even)
+ */
+typedef enum {
+    FIR_SYM_NONE = 0,   /**< No symmetry: generic kernel            */
+    FIR_SYM_EVEN,       /**< Symmetric (Types I, II)                */
+    FIR_SYM_ODD         /**< Antisymmetric (Types III, IV)          */
+} FirSymmetry;
+
+/**
+ * Detect the symmetry of h (to 1e-10 of the largest tap, so windowed
+ * designs whose mirrored taps differ in the last bits still qualify).
+ */
+FirSymmetry fir_symmetry(const double *h, int order);
+
+/**
+ * fir_filter() for linear-phase taps: pairs of inputs that share a
+ * coefficient are added (or subtracted) first, so each output costs
+ * ⌈order/2⌉ multiplies instead of order (the mirrored half of h is
+ * only used for the first order−1 outputs).  sym = FIR_SYM_NONE falls
+ * back to fir_filter().
+ */
+void fir_filter_symmetric(const double *in, double *out, int n,
+                          const double *h, int order, FirSymmetry sym);
+
+/* ── Streaming FIR (state carried across blocks) ─────────────────── */
+
+/**
+ * FIR filter state for block-by-block processing.  The last taps − 1
+ * inputs are kept in a double-length circular delay line, so feeding a
+ * stream in chunks of any size gives exactly the output of one
+ * CONV_DIRECT fir_filter_method() call over the whole stream — no block-edge glitches.
+ */
+typedef struct {
+    double *h;       /**< Copy of the coefficients (taps)             */
+    double *delay;   /**< Delay line, 2·taps (each sample twice)      */
+    int     taps;    /**< Number of coefficients M                    */
+    int     pos;     /**< Slot of the newest sample, 0 .. taps−1      */
+} FirState;
+
+/**
+ * Initialise a streaming FIR (zero history).
+ * @param h     Coefficients, length taps (copied)
+ * @return      0 on success, -1 on bad arguments or allocation failure
+ */
+int  fir_init(FirState *s, const double *h, int taps);
+
+/** Filter n samples; history carries over to the next call.  in may equal out. */
+void fir_process_block(FirState *s, const double *in, double *out, int n);
+
+/** Clear the history (as if freshly initialised). */
+void fir_reset(FirState *s);
+
+/** Free the buffers allocated by fir_init. */
+void fir_free(FirState *s);
+
 /* ── Simple coefficient generators ───────────────────────────────── */
 
 /**
@@ -56,7 +56,8 @@ void analytic_signal(const double *x, int n, Complex *z, int taps);
 /**
  * @brief Compute the analytic signal via FFT (zero negative frequencies).
  *
- * Faster for long signals. Uses N-point FFT where N = next power of 2.
+ * Faster for long signals. Uses an N-point FFT where N = fft_fast_length(n),
+ * the next length with no prime factor above 7 (N = n when n is 7-smooth).
  *
  * @param x      Real input signal (length n).
  * @param n      Signal length.
@@ -100,6 +100,81 @@ typedef struct {
     double gain;                             /**< Overall cascade gain       */
 } SOSCascade;
 
+/**
+ * @brief Variable-length cascade — any order, sized to the filter.
+ *
+ * SOSCascade reserves MAX_SOS_SECTIONS sections (~600 bytes) whatever
+ * the order and stops at order 16.  An SOSChain holds exactly the
+ * sections it was created for, with DF2T state (2 words per section):
+ *
+ *   [SOSChain | Biquad × capacity | BiquadDF2TState × capacity]
+ *
+ * in one block, from malloc or from a caller's DspArena (dsp_utils.h).
+ * A 2nd-order filter takes ~100 bytes.
+ */
+typedef struct {
+    int              n_sections; /**< Sections in use (≤ capacity)      */
+    int              capacity;   /**< Sections allocated                */
+    double           gain;       /**< Overall cascade gain              */
+    Biquad          *sections;   /**< Coefficients, capacity entries    */
+    BiquadDF2TState *states;     /**< DF2T state, capacity entries      */
+    int              owned;      /**< 1 if from malloc (freed by destroy) */
+} SOSChain;
+
+/**
+ * @brief Many chains in one allocation, for filter banks.
+ *
+ * Chain headers, then every chain's sections, then every chain's
+ * states, each packed back to back; chain f is chains[f] and works with
+ * every sos_chain_* function.
+ */
+typedef struct {
+    int       n_chains;          /**< Number of cascades                */
+    SOSChain *chains;            /**< n_chains headers                  */
+    int       owned;             /**< 1 if from malloc                  */
+} SOSBank;
+
+/**
+ * @brief Parallel-form IIR — partial-fraction expansion of B(z)/A(z).
+ *
+ *           ┌─► [ (β0 + β1·z⁻¹) / (1 + a1·z⁻¹ + a2·z⁻²) ]₀ ──┐
+ *   x[n] ──┼─► [ … ]₁ ─────────────────────────────────────┼─► Σ ─► y[n]
+ *           ├─► [ … ]_{K−1} ────────────────────────────────┤
+ *           └─► [ c0 + c1·z⁻¹ + … ]  (direct terms) ───────┘
+ *
+ * The K terms are independent, so they run four to a SIMD register
+ * (simd_iir_parallel).  sections[] holds them for inspection (b2 = 0);
+ * the filter runs from the packed coef/state copy.
+ */
+typedef struct {
+    int     n_sections;  /**< Second-order terms K                    */
+    Biquad *sections;    /**< K terms, b2 = 0                         */
+    int     n_fir;       /**< Direct terms (deg B − deg A + 1, or 0)  */
+    double *fir;         /**< c[0..n_fir−1]                           */
+    double *hist;        /**< n_fir − 1 previous inputs               */
+    int     n_groups;    /**< ⌈K/4⌉ lane groups                       */
+    double *coef;        /**< simd_iir_parallel() layout, 16 per group */
+    double *state;       /**< 8 per group                             */
+} IIRParallel;
+
+/**
+ * @brief Lattice-ladder IIR (Gray–Markel).
+ *
+ *   x ─► f_N ─(−k_N)─► f_{N−1} ─ ··· ─(−k_1)─► f_0 ─┬─► g_0
+ *                │              │                  │
+ *   g_N ◄─(+k_N)─┴─ g_{N−1} ◄── ··· ◄─(+k_1)─ z⁻¹ ◄┘
+ *   y = v_0·g_0 + v_1·g_1 + … + v_N·g_N
+ *
+ * Stable exactly when every |k_m| < 1, and it stays so under
+ * coefficient rounding as long as that holds.
+ */
+typedef struct {
+    int     order;       /**< N                                       */
+    double *k;           /**< Reflection coefficients k_1..k_N (k[0..N−1]) */
+    double *v;           /**< Ladder coefficients v_0..v_N            */
+    double *g;           /**< Backward-path state g_0..g_N            */
+} IIRLattice;
+
 /* ══════════════════════════════════════════════════════════════════
  *  General IIR filtering
  * ══════════════════════════════════════════════════════════════════ */
@@ -221,6 +296,10 @@ double sos_process_sample(SOSCascade *sos, double x);
 /**
  * @brief Process a block of samples through the SOS cascade.
  *
+ * Coefficients and state are held in locals for the whole block rather
+ * than reloaded per sample and section.  Bit-identical to calling
+ * sos_process_sample() n times; in and out may alias.
+ *
  * @param sos  Cascade (states updated in-place)
  * @param in   Input buffer, length n
  * @param out  Output buffer, length n (caller allocates)
@@ -229,6 +308,201 @@ double sos_process_sample(SOSCascade *sos, double x);
 void sos_process_block(SOSCascade *sos,
                        const double *in, double *out, int n);
 
+/**
+ * @brief Block cascade in Direct Form II Transposed.
+ *
+ * Uses the coefficients and gain of @p sos but its own DF2T state, so
+ * sos->states is not touched.  Same transfer function as
+ * sos_process_sample(); outputs agree to rounding (~1e-15 relative).
+ * in and out may alias.
+ *
+ * @param sos  Cascade (coefficients and gain only)
+ * @param st   sos->n_sections states, zeroed with biquad_df2t_init()
+ *             before the first block and kept between blocks
+ * @param in   Input buffer, length n
+ * @param out  Output buffer, length n
+ * @param n    Number of samples
+ */
+void sos_process_block_df2t(const SOSCascade *sos, BiquadDF2TState *st,
+                            const double *in, double *out, int n);
+
+/**
+ * @brief Run one cascade over several interleaved channels at once.
+ *
+ * Channels map to SIMD lanes (4 per AVX2 register, 2 per SSE2; see
+ * simd_sos_df2t() in simd.h), in DF2T.  Each channel gets exactly the
+ * output of sos_process_block_df2t() on that channel alone.  in and out
+ * may alias.
+ *
+ * @param sos         Cascade (coefficients and gain only)
+ * @param st          n_sections · n_channels states, zeroed before the
+ *                    first block; section k of channel c is st[k·C + c]
+ * @param in          Interleaved input, sample i of channel c at
+ *                    in[i·C + c], n·C values
+ * @param out         Interleaved output, same layout
+ * @param n           Samples per channel
+ * @param n_channels  C ≥ 1
+ */
+void sos_process_multi(const SOSCascade *sos, BiquadDF2TState *st,
+                       const double *in, double *out, int n, int n_channels);
+
+/* ══════════════════════════════════════════════════════════════════
+ *  Variable-length cascades (SOSChain / SOSBank)
+ * ══════════════════════════════════════════════════════════════════ */
+
+/** @brief Sections needed for a given filter order: ⌈order/2⌉. */
+int sos_chain_sections(int order);
+
+/**
+ * @brief Create a chain with room for @p capacity sections.
+ *
+ * Sections, gain (1) and state start zeroed/empty; fill it with a
+ * *_chain designer or sos_chain_from_cascade().
+ *
+ * @param arena     Arena to allocate from, or NULL for malloc
+ * @param capacity  Number of sections (≥ 1)
+ * @return          Chain, or NULL on error / arena full
+ */
+SOSChain *sos_chain_create(DspArena *arena, int capacity);
+
+/** @brief Free a malloc'd chain (arena chains are released with the arena). */
+void sos_chain_destroy(SOSChain *c);
+
+/** @brief Zero the DF2T state of every section. */
+void sos_chain_reset(SOSChain *c);
+
+/**
+ * @brief Copy coefficients and gain from a fixed-size cascade (state cleared).
+ * @return 0, or -1 if sos has more sections than c->capacity
+ */
+int sos_chain_from_cascade(SOSChain *c, const SOSCascade *sos);
+
+/**
+ * @brief Filter a block (DF2T, state kept across calls; in and out may alias).
+ *
+ * Same engine as sos_process_block_df2t(): an SOSChain built from a
+ * cascade gives the same bits.
+ */
+void sos_chain_process(SOSChain *c, const double *in, double *out, int n);
+
+/** @brief As sos_freq_response(), for a chain. */
+void sos_chain_freq_response(const SOSChain *c,
+                             double *mag, double *phase, int n_points);
+
+/**
+ * @brief Create a bank of chains, chain f with room for capacity[f] sections.
+ *
+ * @param arena     Arena to allocate from, or NULL for one malloc
+ * @param capacity  n_chains section counts (each ≥ 1)
+ * @param n_chains  Number of chains (≥ 1)
+ * @return          Bank, or NULL on error / arena full
+ */
+SOSBank *sos_bank_create(DspArena *arena, const int *capacity, int n_chains);
+
+/** @brief Free a malloc'd bank (arena banks are released with the arena). */
+void sos_bank_destroy(SOSBank *b);
+
+/* ══════════════════════════════════════════════════════════════════
+ *  Alternative realizations — parallel form and lattice-ladder
+ *
+ *  Same H(z), different arithmetic:
+ *    cascade   sections in series, each sample goes through all K
+ *    parallel  sections side by side on the same x → SIMD across sections
+ *    lattice   reflection coefficients; stability is |k_m| < 1
+ * ══════════════════════════════════════════════════════════════════ */
+
+/**
+ * @brief Multiply a cascade out to one transfer function.
+ *
+ * Expanded in long double, rounded once.  b includes the gain; a[0] = 1.
+ *
+ * @param b  Output numerator,   2·n_sections + 1 coefficients
+ * @param a  Output denominator, 2·n_sections + 1 coefficients
+ * @return   Length of b and a (2·n_sections + 1)
+ */
+int sos_to_tf(const SOSCascade *sos, double *b, double *a);
+
+/** @brief sos_to_tf() for a chain (any order).  @return 2·n_sections + 1, or -1 */
+int sos_chain_to_tf(const SOSChain *c, double *b, double *a);
+
+/**
+ * @brief Parallel form of B(z)/A(z) by partial fractions.
+ *
+ * Finds the roots of A (Durand–Kerner), pairs conjugates into real
+ * second-order terms and puts any excess numerator degree in the
+ * direct terms.  Poles must be distinct.  The poles are only as good
+ * as the expanded A allows — clustered high-order poles lose digits
+ * here; prefer iir_parallel_from_biquads() for designed filters.
+ *
+ * @return Filter (zero state), or NULL on error, repeated poles or
+ *         order above 64
+ */
+IIRParallel *iir_parallel_create(const double *b, int b_len,
+                                 const double *a, int a_len);
+
+/**
+ * @brief Parallel form of n_sections biquads in series, times gain.
+ *
+ * Takes the poles from each section's quadratic instead of rooting
+ * the expanded denominator, so high orders keep their accuracy.
+ *
+ * @return Filter (zero state), or NULL on error, repeated poles or
+ *         order (2·n_sections) above 64
+ */
+IIRParallel *iir_parallel_from_biquads(const Biquad *sec, int n_sections,
+                                      double gain);
+
+/** @brief iir_parallel_from_biquads() of a cascade (order ≤ 16). */
+IIRParallel *iir_parallel_from_sos(const SOSCascade *sos);
+
+/** @brief iir_parallel_from_biquads() of a chain (order ≤ 64). */
+IIRParallel *iir_parallel_from_chain(const SOSChain *c);
+
+/** @brief Filter a block (state kept across calls; in and out must not overlap). */
+void iir_parallel_process(IIRParallel *p, const double *in, double *out, int n);
+
+/** @brief Zero the state. */
+void iir_parallel_reset(IIRParallel *p);
+
+/** @brief Free a parallel-form filter. */
+void iir_parallel_destroy(IIRParallel *p);
+
+/**
+ * @brief Lattice-ladder form of B(z)/A(z) (step-down recursion).
+ *
+ * deg B may exceed deg A (A is zero-padded).  Computed in long double.
+ *
+ * @return Filter (zero state), or NULL on error or if some |k_m| ≥ 1
+ *         (the filter is unstable)
+ */
+IIRLattice *iir_lattice_create(const double *b, int b_len,
+                               const double *a, int a_len);
+
+/**
+ * @brief Lattice-ladder form of n_sections biquads in series, times
+ * gain (expanded in long double).
+ *
+ * @return Filter (zero state), or NULL on error, instability or order
+ *         (2·n_sections) above 64
+ */
+IIRLattice *iir_lattice_from_biquads(const Biquad *sec, int n_sections,
+                                    double gain);
+
+/** @brief iir_lattice_from_biquads() of a cascade (order ≤ 16). */
+IIRLattice *iir_lattice_from_sos(const SOSCascade *sos);
+
+/** @brief iir_lattice_from_biquads() of a chain (order ≤ 64). */
+IIRLattice *iir_lattice_from_chain(const SOSChain *c);
+
+/** @brief Filter a block (state kept across calls; in and out may alias). */
+void iir_lattice_process(IIRLattice *l, const double *in, double *out, int n);
+
+/** @brief Zero the state. */
+void iir_lattice_reset(IIRLattice *l);
+
+/** @brief Free a lattice filter. */
+void iir_lattice_destroy(IIRLattice *l);
+
 /* ══════════════════════════════════════════════════════════════════
  *  IIR Filter Design — Butterworth
  *
@@ -248,6 +522,13 @@ void sos_process_block(SOSCascade *sos,
  */
 int butterworth_lowpass(int order, double cutoff, SOSCascade *sos);
 
+/**
+ * @brief butterworth_lowpass() into a chain: any order up to
+ * 2·c->capacity (see sos_chain_sections()).  State is cleared.
+ * @return 0 on success, -1 on invalid parameters or too few sections
+ */
+int butterworth_lowpass_chain(int order, double cutoff, SOSChain *c);
+
 /**
  * @brief Design a Butterworth highpass filter.
  *
@@ -261,6 +542,9 @@ int butterworth_lowpass(int order, double cutoff, SOSCascade *sos);
  */
 int butterworth_highpass(int order, double cutoff, SOSCascade *sos);
 
+/** @brief butterworth_highpass() into a chain (as butterworth_lowpass_chain()). */
+int butterworth_highpass_chain(int order, double cutoff, SOSChain *c);
+
 /* ══════════════════════════════════════════════════════════════════
  *  IIR Filter Design — Chebyshev Type I
  *
@@ -281,6 +565,10 @@ int butterworth_highpass(int order, double cutoff, SOSCascade *sos);
 int chebyshev1_lowpass(int order, double ripple_db, double cutoff,
                        SOSCascade *sos);
 
+/** @brief chebyshev1_lowpass() into a chain (as butterworth_lowpass_chain()). */
+int chebyshev1_lowpass_chain(int order, double ripple_db, double cutoff,
+                             SOSChain *c);
+
 /* ══════════════════════════════════════════════════════════════════
  *  Frequency Response Evaluation
  *
@@ -25,11 +25,51 @@
  *        h[n] = h₀[n] + z⁻¹·h₁[n] + ... + z⁻⁽ᴹ⁻¹⁾·h_{M-1}[n]
  *
  *   Each sub-filter hₖ operates at the lower rate → M× savings.
+ *
+ * ── Streaming Decimator / Interpolator ───────────────────────────
+ *
+ *   DecimatorState      ↓M: inputs are dealt round-robin to M branch
+ *                       delay lines; one output per M inputs
+ *   InterpolatorState   ↑L: each input drives all L branches, one
+ *                       output each
+ *
+ *   The branches are split once at init.  decimate() and interpolate()
+ *   run on these objects.
+ *
+ * ── Streaming Resamplers ─────────────────────────────────────────
+ *
+ *   ResamplerState      exact L/M: only the outputs that are kept are
+ *                       computed, each by one of L polyphase branches
+ *   FracResamplerState  any ratio (irrational, or changed on the fly
+ *                       for clock drift): windowed-sinc table with
+ *                       linear interpolation between its phases
+ *
+ *   Both carry their history across calls, so a stream fed in chunks
+ *   of any size gives the same output as one call.
+ *
+ * ── Multistage Decimation ────────────────────────────────────────
+ *
+ *   x ──► CIC ↓R ──► comp FIR ──► halfband ↓2 … ──► FIR ↓F ──► y
+ *
+ *   decim_plan() factors a large M into this cascade and estimates
+ *   each stage's cost; multistage_decimator_create() builds it.
+ *
+ * ── Polyphase Filter Bank (channelizer) ──────────────────────────
+ *
+ *   x ──► K branches of h ──► rotate ──► K-point IFFT ──► K channels
+ *         (one frame every D inputs)                      at fs/D
+ *
+ *   One prototype lowpass serves all K channels, so a frame costs
+ *   K·P multiplies plus one FFT instead of K separate filters.
+ *   PfbSynthesis inverts it (weighted overlap-add) for D ≤ K/2.
  */
 
 #ifndef MULTIRATE_H
 #define MULTIRATE_H
 
+#include "dsp_utils.h"   /* Complex */
+#include "fft.h"         /* FftPlan */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -38,11 +78,15 @@ extern "C" {
  * @brief Decimate a signal by factor M with anti-alias filtering.
  *
  * Applies an internal FIR lowpass (cutoff = 0.5/M) before down-sampling.
+ * Runs a DecimatorState, so only the kept samples are filtered: len/M
+ * multiplies per input, against ⌈len/2⌉ for the folded full-rate
+ * fir_filter_symmetric() path this replaces.  The default design has
+ * about 8 taps per branch, too few for the folded branches to pay off.
  *
  * @param x      Input signal (length n).
  * @param n      Length of input.
  * @param M      Decimation factor (>= 1).
- * @param y      Output buffer (length >= n/M).
+ * @param y      Output buffer (length >= (n + M - 1)/M).
  * @return       Number of output samples.
  */
 int decimate(const double *x, int n, int M, double *y);
@@ -51,6 +95,7 @@ int decimate(const double *x, int n, int M, double *y);
  * @brief Interpolate a signal by factor L with anti-image filtering.
  *
  * Inserts L-1 zeros, then applies an FIR lowpass (cutoff = 0.5/L, gain = L).
+ * Runs an InterpolatorState, so the zeros are never multiplied.
  *
  * @param x      Input signal (length n).
  * @param n      Length of input.
@@ -91,6 +136,389 @@ int resample(const double *x, int n, int L, int M, double *y);
 int polyphase_decimate(const double *x, int n,
                        const double *h, int taps, int M, double *y);
 
+/* ── Streaming decimator / interpolator ──────────────────────────── */
+
+/**
+ * Polyphase decimator state.
+ *
+ *   y[m] = Σₖ Σⱼ h[k + j·M] · x[m·M − k − j·M]
+ *
+ * Branch k only ever sees the inputs with index ≡ −k (mod M), so each
+ * input goes to exactly one branch delay line (the commutator) and an
+ * output is computed when branch 0 receives x[m·M].
+ *
+ * A linear-phase h (fir_symmetry() ≠ FIR_SYM_NONE, as for every
+ * windowed-sinc design) with at least 12 taps per branch is folded per
+ * output: tap k + j·M mirrors onto branch (len − 1 − k) mod M read
+ * backwards, so each pair of branches adds (or subtracts) its two
+ * inputs first and multiplies once, as fir_filter_symmetric() does at
+ * the full rate.  Shorter branches run faster as plain dot products.
+ */
+typedef struct {
+    int     M;          /**< Decimation factor                           */
+    int     taps;       /**< Taps per branch J = ⌈len / M⌉               */
+    int     len;        /**< Prototype length                            */
+    int     sym;        /**< +1 / −1 folded (anti)symmetric h, 0 plain   */
+    double *branch;     /**< M branches × J: branch k holds h[k + j·M]   */
+    double *delay;      /**< M delay lines × 2·J (each input twice)      */
+    int     pos;        /**< Slot of the newest input in every line      */
+    int     phase;      /**< Branch that receives the next input         */
+} DecimatorState;
+
+/**
+ * Initialise a decimator by M (zero history).
+ *
+ * @param h     Anti-alias filter at the input rate, or NULL to design
+ *              the same windowed-sinc lowpass (cutoff 0.5/M) as decimate()
+ * @param taps  Length of h; with h == NULL, ≤ 0 picks decimate()'s length
+ * @return 0 on success, -1 on bad arguments or allocation failure
+ */
+int  decimator_init(DecimatorState *s, int M, const double *h, int taps);
+
+/**
+ * Filter and decimate n inputs; history carries over to the next call.
+ * Outputs fall on inputs 0, M, 2M, … of the whole stream.
+ * @param out  Room for n/M + 1 samples
+ * @return     Number of outputs written
+ */
+int  decimator_process(DecimatorState *s, const double *in, int n, double *out);
+
+/** Clear the history (as if freshly initialised). */
+void decimator_reset(DecimatorState *s);
+
+/** Free the buffers allocated by decimator_init. */
+void decimator_free(DecimatorState *s);
+
+/**
+ * Polyphase interpolator state.
+ *
+ *   y[i·L + p] = Σⱼ g[p + j·L] · x[i − j],   p = 0 … L−1
+ *
+ * The zero-stuffed signal is never formed: each input is pushed once
+ * and the L branches each produce one output from the same history.
+ * That is len/L multiplies per output, already fewer than folding the
+ * full-rate filter (len/2); mirrored taps sit in different branches,
+ * i.e. different outputs, so there is nothing left to pair up.
+ */
+typedef struct {
+    int     L;          /**< Interpolation factor                        */
+    int     taps;       /**< Taps per branch J = ⌈len / L⌉               */
+    double *branch;     /**< L branches × J: branch p holds g[p + j·L]   */
+    double *delay;      /**< Delay line, 2·J (each input twice)          */
+    int     pos;        /**< Slot of the newest input                    */
+} InterpolatorState;
+
+/**
+ * Initialise an interpolator by L (zero history).
+ *
+ * @param h     Anti-image filter at the output rate, gain included, or
+ *              NULL to design interpolate()'s lowpass (cutoff 0.5/L, gain L)
+ * @param taps  Length of h; with h == NULL, ≤ 0 picks interpolate()'s length
+ * @return 0 on success, -1 on bad arguments or allocation failure
+ */
+int  interpolator_init(InterpolatorState *s, int L, const double *h, int taps);
+
+/**
+ * Interpolate n inputs into n·L outputs; history carries over.
+ * @return Number of outputs written (n·L)
+ */
+int  interpolator_process(InterpolatorState *s, const double *in, int n,
+                          double *out);
+
+/** Clear the history (as if freshly initialised). */
+void interpolator_reset(InterpolatorState *s);
+
+/** Free the buffers allocated by interpolator_init. */
+void interpolator_free(InterpolatorState *s);
+
+/* ── Streaming rational resampler (L/M) ──────────────────────────── */
+
+/**
+ * Polyphase L/M resampler state.
+ *
+ *   high-rate time t = m·M  (output m)
+ *   y[m] = Σⱼ g[p + j·L] · x[i₀ − j],   i₀ = ⌊t/L⌋,  p = t mod L
+ *
+ * The zero-stuffed signal is never formed and the M − 1 of every M
+ * high-rate samples that would be discarded are never computed: each
+ * output costs one branch of `taps` multiplies.
+ */
+typedef struct {
+    int     L, M;       /**< Ratio (reduced by the gcd in resampler_init) */
+    int     taps;       /**< Taps per branch J                           */
+    double *branch;     /**< L branches × J: branch p holds g[p + j·L]   */
+    double *delay;      /**< Delay line, 2·J (each input twice)          */
+    int     pos;        /**< Slot of the newest input                    */
+    int     phase;      /**< Branch of the next output, 0 .. L−1         */
+    int     need;       /**< Inputs still to read before it is due       */
+} ResamplerState;
+
+/**
+ * Initialise an L/M resampler (zero history).
+ *
+ * Designs a windowed-sinc prototype of taps_per_phase·L − 1 taps,
+ * cutoff 0.5/max(L, M) of the high rate, gain L.  Group delay is about
+ * taps_per_phase/2 input samples.
+ *
+ * @param taps_per_phase  Branch length J (≤ 0 → 24); more = sharper
+ * @return 0 on success, -1 on bad arguments or allocation failure
+ */
+int  resampler_init(ResamplerState *s, int L, int M, int taps_per_phase);
+
+/** Exact number of outputs the next resampler_process() of n inputs writes. */
+int  resampler_max_output(const ResamplerState *s, int n);
+
+/**
+ * Resample n inputs; history carries over to the next call.
+ * @param out  Room for resampler_max_output(s, n) samples
+ * @return     Number of outputs written
+ */
+int  resampler_process(ResamplerState *s, const double *in, int n, double *out);
+
+/** Clear the history (as if freshly initialised). */
+void resampler_reset(ResamplerState *s);
+
+/** Free the buffers allocated by resampler_init. */
+void resampler_free(ResamplerState *s);
+
+/* ── Streaming arbitrary-ratio resampler ─────────────────────────── */
+
+/**
+ * Fractional-delay resampler for any ratio.
+ *
+ *   output m sits at input time τ = m / ratio,  τ = k + μ,  0 ≤ μ < 1
+ *   y = Σⱼ hⱼ(μ) · x[k + T/2 − j]
+ *
+ * hⱼ(μ) comes from a table of P = 256 windowed-sinc (Blackman) rows
+ * per input sample, linearly interpolated between the two rows around
+ * μ — a first-order Farrow structure on a polyphase bank.  Every row
+ * sums to 1.  The ratio can be changed between calls; the cutoff,
+ * 0.45·min(1, ratio) of the input rate, stays the one set at init.
+ */
+typedef struct {
+    double  ratio;      /**< Output rate / input rate                    */
+    double  step;       /**< 1 / ratio: input samples per output         */
+    int     taps;       /**< Kernel length T (even)                      */
+    int     phases;     /**< Table rows P per input sample               */
+    double *table;      /**< (P + 1) × T kernel rows, row q at μ = q/P   */
+    double *delay;      /**< Delay line, 2·T                             */
+    int     pos;        /**< Slot of the newest input                    */
+    int     need;       /**< Inputs still to read before the next output */
+    double  frac;       /**< μ of the next output                        */
+} FracResamplerState;
+
+/**
+ * Initialise an arbitrary-ratio resampler (zero history).
+ *
+ * Output m is the input signal at time m/ratio; it is written once
+ * input ⌊m/ratio⌋ + T/2 has been read.
+ *
+ * @param ratio  Output rate / input rate (> 0), e.g. 48000.0/44100.0
+ * @param taps   Kernel length T (≤ 0 → 32; rounded up to even)
+ * @return 0 on success, -1 on bad arguments or allocation failure
+ */
+int  frac_resampler_init(FracResamplerState *s, double ratio, int taps);
+
+/** Change the ratio from the next output on (e.g. a drift-tracking loop). */
+void frac_resampler_set_ratio(FracResamplerState *s, double ratio);
+
+/** Upper bound on the outputs of the next frac_resampler_process() of n inputs. */
+int  frac_resampler_max_output(const FracResamplerState *s, int n);
+
+/**
+ * Resample n inputs; history carries over to the next call.
+ * @return Number of outputs written
+ */
+int  frac_resampler_process(FracResamplerState *s, const double *in, int n,
+                            double *out);
+
+/** Clear the history (as if freshly initialised; the ratio is kept). */
+void frac_resampler_reset(FracResamplerState *s);
+
+/** Free the buffers allocated by frac_resampler_init. */
+void frac_resampler_free(FracResamplerState *s);
+
+/* ── Multistage decimation ───────────────────────────────────────── */
+
+#define DECIM_MAX_STAGES 16
+
+/** Stage kinds in a DecimPlan, in cascade order. */
+typedef enum {
+    DECIM_STAGE_CIC,        /**< sinc^N (CIC) front end, ↓R              */
+    DECIM_STAGE_COMP,       /**< Inverse-sinc^N droop compensation, ↓1   */
+    DECIM_STAGE_HALFBAND,   /**< Halfband lowpass, ↓2 (every other tap 0) */
+    DECIM_STAGE_FIR         /**< Final windowed-sinc lowpass, ↓F         */
+} DecimStageType;
+
+/** One stage of a multistage decimator. */
+typedef struct {
+    DecimStageType type;
+    int    factor;      /**< Rate change of this stage                   */
+    int    taps;        /**< Filter length (CIC: N·(R − 1) + 1)          */
+    double cost;        /**< Multiplies per sample of the cascade input  */
+} DecimStage;
+
+/**
+ * A multistage decimation plan.
+ *
+ * Cost is counted in multiplies per input sample of the whole cascade.
+ * A stage that runs at fs/r and does K multiplies per output costs
+ * K/(r·factor): K = taps for the polyphase FIRs, and (taps + 5)/4 for
+ * a halfband (symmetric pairs folded, zero taps skipped).  single_cost
+ * is the same count for one polyphase FIR ↓M designed to the same
+ * specification.
+ */
+typedef struct {
+    int        M;               /**< Total decimation (product of factors) */
+    double     pass;            /**< Protected band, fraction of output Nyquist */
+    int        n_stages;
+    DecimStage stage[DECIM_MAX_STAGES];
+    double     cost;            /**< Sum of the stage costs                */
+    double     single_cost;     /**< One-stage polyphase FIR, same spec    */
+} DecimPlan;
+
+/**
+ * Factor a decimation ratio into stages.
+ *
+ *   M ≥ 32:  CIC ↓R (order 4) + comp FIR, with R = M/D, where D is the
+ *            largest divisor of M that is ≤ 8, or else the smallest
+ *            prime factor of M (143 → CIC ↓13, FIR ↓11).  This leaves
+ *            ≥ D× of oversampling after the CIC, enough that its
+ *            aliases land ~100 dB down.  A prime M has no such split
+ *            and gets a single FIR ↓M.
+ *   then     the rest (D, or M itself below 32) = 2ᵃ·b:  a − 1 halfband
+ *            ↓2 stages, then a FIR ↓(2b) (↓b when a = 0).
+ *
+ * The band 0 … pass·fs_out/2 is kept free of aliases (Hamming-windowed
+ * designs, ~50 dB); each filter is just long enough for its own
+ * transition band.  The last stage is always a FIR, never the CIC.
+ *
+ * @param M     Decimation factor (≥ 1)
+ * @param pass  Protected band as a fraction of the output Nyquist,
+ *              0 < pass < 1 (≤ 0 → 0.8)
+ * @return 0 on success, -1 on bad arguments
+ */
+int decim_plan(DecimPlan *plan, int M, double pass);
+
+/** Opaque multistage decimator built from a DecimPlan. */
+typedef struct MultistageDecimator MultistageDecimator;
+
+/**
+ * Design every stage of a plan and allocate the cascade (zero history).
+ * The CIC runs as its sinc^N polyphase FIR, which needs no growing
+ * integrators in floating point.  Halfbands skip their zero taps.
+ * @return Decimator, or NULL on bad plan / allocation failure
+ */
+MultistageDecimator *multistage_decimator_create(const DecimPlan *plan);
+
+/**
+ * Decimate n inputs by plan->M; history carries over to the next call.
+ * Outputs fall on inputs 0, M, 2M, … of the whole stream.
+ * @param out  Room for n/M + 1 samples
+ * @return     Number of outputs written
+ */
+int  multistage_decimator_process(MultistageDecimator *d, const double *in,
+                                  int n, double *out);
+
+/** Clear the history of every stage. */
+void multistage_decimator_reset(MultistageDecimator *d);
+
+/** Free a decimator (NULL is ignored). */
+void multistage_decimator_destroy(MultistageDecimator *d);
+
+/* ── Polyphase filter bank ───────────────────────────────────────── */
+
+/**
+ * Polyphase analysis filter bank: K channels, one frame per D inputs.
+ *
+ *   y_q[m] = Σₙ h[n] · x[mD − n] · e^{−j2πq(mD − n)/K},   q = 0 … K−1
+ *
+ * Channel q is the band around q·fs/K (q > K/2 are the negative
+ * frequencies) shifted to 0 Hz.  With u[k] = Σₚ h[k + pK]·x[mD − k − pK]
+ * (the K polyphase branches) the whole frame is one inverse DFT of u
+ * rotated by mD mod K.  D = K is critically sampled; D = K/2 is 2×
+ * oversampled, which keeps the band edges alias-free and is what the
+ * synthesis bank needs.
+ */
+typedef struct {
+    int      K, D;      /**< Channels, input samples per frame           */
+    int      taps;      /**< Prototype length, K·P − 1 (odd, symmetric)  */
+    double  *h;         /**< K·P taps (last one 0), pre-scaled by K      */
+    Complex *delay;     /**< Delay line, 2·K·P (each input twice)        */
+    Complex *u;         /**< K folded branch outputs                     */
+    int      pos;       /**< Slot of the newest input                    */
+    int      need;      /**< Inputs still to read before the next frame  */
+    int      shift;     /**< mD mod K for the next frame                 */
+    const FftPlan *plan;
+} PfbAnalysis;
+
+/**
+ * Initialise an analysis bank (zero history).
+ *
+ * The prototype is a Hamming-windowed sinc, cutoff 0.5/K, with P taps
+ * per branch; each channel is −6 dB at ±fs/(2K) from its centre.
+ *
+ * @param K  Number of channels (≥ 2)
+ * @param D  Decimation per channel, 1 … K (K: critical, K/2: 2× oversampled)
+ * @param P  Taps per branch (≤ 0 → 12); more = sharper channel edges
+ * @return 0 on success, -1 on bad arguments or allocation failure
+ */
+int  pfb_analysis_init(PfbAnalysis *s, int K, int D, int P);
+
+/**
+ * Channelize n inputs; history carries over to the next call.
+ * Frames fall on inputs 0, D, 2D, … of the whole stream.
+ * @param out  Room for (n/D + 1)·K samples; frame f, channel q at out[f·K + q]
+ * @return     Number of frames written
+ */
+int  pfb_analysis_process(PfbAnalysis *s, const Complex *in, int n,
+                          Complex *out);
+
+/** Clear the history (as if freshly initialised). */
+void pfb_analysis_reset(PfbAnalysis *s);
+
+/** Free the buffers allocated by pfb_analysis_init. */
+void pfb_analysis_free(PfbAnalysis *s);
+
+/**
+ * Polyphase synthesis filter bank: the inverse of PfbAnalysis.
+ *
+ *   w_m[k]  = Σ_q Y_q[m] · e^{j2πqk/K}                (one IFFT per frame)
+ *   x̂[t]    = Σₘ f[t − mD] · w_m[(t − τ) mod K],   τ = (taps − 1) mod K
+ *
+ * f is a Hamming sinc of the same length with cutoff 1/K: flat across
+ * each analysis channel, so Σ_q H·F is flat, and stopped before the
+ * images at multiples of fs/D.  It is scaled for unit chain gain.  Fed
+ * unmodified analysis frames, x̂[t] ≈ x[t − (taps − 1)], about 50 dB
+ * down (the window's stopband) when D ≤ K/2.  At D = K the images
+ * cannot be stopped and the bank does not reconstruct.
+ */
+typedef struct {
+    int      K, D;      /**< Channels, output samples per frame          */
+    int      taps;      /**< Prototype length (as PfbAnalysis)           */
+    double  *f;         /**< K·P synthesis taps (last one 0)             */
+    Complex *acc;       /**< Overlap-add buffer, K·P                     */
+    Complex *w;         /**< K-point IFFT of the current frame           */
+    int      shift;     /**< mD mod K for the next frame                 */
+    const FftPlan *plan;
+} PfbSynthesis;
+
+/** Initialise a synthesis bank matching pfb_analysis_init(K, D, P). */
+int  pfb_synthesis_init(PfbSynthesis *s, int K, int D, int P);
+
+/**
+ * Rebuild D·n_frames output samples from n_frames frames of K channels.
+ * @return Number of samples written
+ */
+int  pfb_synthesis_process(PfbSynthesis *s, const Complex *frames,
+                           int n_frames, Complex *out);
+
+/** Clear the history (as if freshly initialised). */
+void pfb_synthesis_reset(PfbSynthesis *s);
+
+/** Free the buffers allocated by pfb_synthesis_init. */
+void pfb_synthesis_free(PfbSynthesis *s);
+
 #ifdef __cplusplus
 }
 #endif
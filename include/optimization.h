@@ -21,9 +21,10 @@
  *   - Cache-friendly memory access patterns
  *   - Aligned memory allocation helpers
  *
- * SIMD (Stage 4) and threading (Stage 5) are platform-specific
- * and discussed in the tutorial but not implemented here to
- * maintain zero external dependencies and portability.
+ * Stage 4 lives in simd.h: SSE2/AVX2 kernels chosen at run time,
+ * with a scalar fallback on every other target.  Stage 5 lives in
+ * threadpool.h: a worker pool that splits fft2d(), conv2d() and
+ * 1-D FFTs of 2^FFT_FOURSTEP_MIN_LOG2 points and up across cores.
  *
  * @see chapters/29-optimisation.md
  */
@@ -32,6 +33,7 @@
 #define OPTIMIZATION_H
 
 #include "dsp_utils.h"
+#include "fft.h"   /* FftPlan */
 
 /* ================================================================== */
 /*  Benchmarking                                                      */
@@ -46,6 +48,7 @@
  *   │  max_us ── worst case        │
  *   │  avg_us ── mean over runs    │
  *   │  mflops ── throughput        │
+ *   │  max_err ── vs fft_radix2    │
  *   └──────────────────────────────┘
  */
 typedef struct {
@@ -55,12 +58,13 @@ typedef struct {
     double mflops;   /**< Million FLOPs/sec (for FFT: 5·N·log2(N) / avg_us) */
     int    runs;     /**< Number of benchmark iterations */
     int    n;        /**< Problem size */
+    double max_err;  /**< Max |X - X_ref| vs fft_radix2 (0 for the reference) */
 } BenchResult;
 
 /**
  * @brief Benchmark the baseline radix-2 FFT.
  *
- * Runs fft() on random data 'runs' times and collects timing.
+ * Runs the textbook fft_radix2() on random data 'runs' times and collects timing.
  *
  * @param n    FFT length (power of 2).
  * @param runs Number of repetitions (≥3 recommended for stable results).
@@ -69,10 +73,107 @@ typedef struct {
 BenchResult bench_fft_radix2(int n, int runs);
 
 /**
- * @brief Benchmark the optimised radix-4 FFT.
+ * @brief Benchmark the in-place radix-4 FFT engine (any power of 2).
+ *
+ * Also fills max_err with the largest deviation of the output from
+ * fft_radix2() on the same input.
  */
 BenchResult bench_fft_radix4(int n, int runs);
 
+/**
+ * @brief Benchmark the cache-blocked four-step engine (power of 2 >= 4).
+ *
+ * Same measurement as bench_fft_radix4(), on a plan built with
+ * FFT_ENGINE_FOURSTEP whatever the size (max_err = -1 if n is invalid).
+ */
+BenchResult bench_fft_fourstep(int n, int runs);
+
+/**
+ * @brief Measure where the four-step engine overtakes the in-place one.
+ *
+ *   time │ in-place ╱
+ *        │        ╱ ╱ four-step
+ *        │      ╱╱
+ *        │    ╳       ← crossover: data no longer fits in cache
+ *        │  ╱╱
+ *        └──────────── log₂N
+ *
+ * Benchmarks both engines from 2^max_log2 down and stops at the first
+ * size where the in-place engine is at least as fast (best of 'runs').
+ *
+ * @return Smallest log₂N from which the four-step engine wins at every
+ *         size up to max_log2, or -1 if it does not win at max_log2.
+ *         A build can bake the result in with -DFFT_FOURSTEP_MIN_LOG2=…
+ */
+int bench_fft_crossover(int min_log2, int max_log2, int runs);
+
+/**
+ * @brief Benchmark the generic direct-form FIR (fir_filter_method(), CONV_DIRECT).
+ *
+ * Filters n random samples with a taps-long windowed-sinc lowpass.
+ * mflops counts 2·n·taps (one multiply-add per tap per output).
+ */
+BenchResult bench_fir_direct(int n, int taps, int runs);
+
+/**
+ * @brief Benchmark the folded linear-phase FIR, fir_filter_symmetric().
+ *
+ * Same input, taps and FLOP count as bench_fir_direct(), so the mflops
+ * ratio is the speedup; max_err is the deviation from the direct form.
+ */
+BenchResult bench_fir_symmetric(int n, int taps, int runs);
+
+/** IIR realizations compared by bench_iir_structure() (see iir.h). */
+typedef enum {
+    IIR_STRUCT_DIRECT,    /**< iir_filter() on the expanded (b, a)   */
+    IIR_STRUCT_CASCADE,   /**< sos_chain_process() (DF2T)            */
+    IIR_STRUCT_PARALLEL,  /**< iir_parallel_process()                */
+    IIR_STRUCT_LATTICE    /**< iir_lattice_process()                 */
+} IirStructure;
+
+/**
+ * @brief Benchmark one IIR realization of the same filter.
+ *
+ * Filters n random samples with a Butterworth lowpass of the given
+ * order (cutoff 0.05, designed as an SOSChain, so any order; parallel
+ * and lattice stop at 64) in structure s.  The structures do
+ * different arithmetic for the same H(z), so mflops holds million
+ * samples per second (best run) instead of FLOPs; max_err is the
+ * largest deviation from the cascade run in long double, and -1 if the
+ * filter could not be built in that structure.
+ */
+BenchResult bench_iir_structure(IirStructure s, int order, int n, int runs);
+
+/** Decimator layouts compared by bench_decimation() (see multirate.h). */
+typedef enum {
+    DECIM_SINGLE,         /**< One polyphase FIR ↓M (DecimatorState)  */
+    DECIM_MULTISTAGE      /**< decim_plan() cascade                   */
+} DecimStrategy;
+
+/**
+ * @brief Benchmark single-stage against multistage decimation by M.
+ *
+ * Both keep 80% of the output band alias-free: the single-stage FIR
+ * is one Hamming-windowed lowpass with a (1 − 0.8)/M transition.  The
+ * input is n samples of a unit tone that folds to 0.1 of the output
+ * Nyquist.  mflops holds million input samples per second (best run).
+ * max_err is the largest alias left in the second half of the output,
+ * or -1 if the decimator could not be built.
+ */
+BenchResult bench_decimation(DecimStrategy s, int M, int n, int runs);
+
+/**
+ * @brief Benchmark RingBuffer throughput between two threads.
+ *
+ * A producer thread pushes n samples of a counting sequence through a
+ * 4096-slot RingBuffer in blocks of up to `block` samples while a
+ * consumer thread pulls them out in blocks of the same size.  mflops
+ * holds million samples per second (best run, wall time from start to
+ * join); max_err is the number of samples that arrived out of
+ * sequence, and -1 if the buffer or threads could not be created.
+ */
+BenchResult bench_ring_buffer(int block, int n, int runs);
+
 /**
  * @brief Print a formatted benchmark comparison table.
  */
@@ -85,8 +186,8 @@ void bench_print(const char *label, const BenchResult *r);
 /**
  * @brief In-place radix-4 FFT.
  *
- * Requires n to be a power of 4 (4, 16, 64, 256, 1024, ...).
- * Falls back to radix-2 for non-power-of-4 sizes.
+ * Runs the plan engine behind fft(): radix-4 stages for every power
+ * of 2, with a single radix-2 stage first when log₂N is odd.
  *
  * Radix-4 butterfly:
  *
@@ -99,7 +200,7 @@ void bench_print(const char *label, const BenchResult *r);
  * Two of the four twiddle multiplies are trivial (×1, ×-j).
  *
  * @param x  Complex array of length n (in-place).
- * @param n  Transform length (must be power of 4 for full radix-4).
+ * @param n  Transform length (power of 2).
  */
 void fft_radix4(Complex *x, int n);
 
@@ -115,13 +216,13 @@ void ifft_radix4(Complex *x, int n);
  *
  * Computing exp(-j·2π·k/N) is expensive (sin/cos per butterfly).
  * Pre-computing and storing them in a lookup table gives ~30% speedup.
+ *
+ * This is the same object as FftPlan (fft.h), which also carries the
+ * bit-reversal table; the twiddle_* names are kept for chapter 29.
  */
-typedef struct {
-    Complex *W;      /**< Twiddle factors W[k] = exp(-j·2π·k/N) */
-    int      n;      /**< Table size */
-} TwiddleTable;
+typedef FftPlan TwiddleTable;
 
-/** Create a twiddle table for FFT of size n. */
+/** Create a twiddle table for FFT of size n (same as fft_plan_create). */
 TwiddleTable *twiddle_create(int n);
 
 /** Destroy twiddle table. */
@@ -10,7 +10,8 @@
  *   └──────────┘    └──────────┘    └────────────┘    └──────────┘
  *
  * Components:
- *   - **RingBuffer**: Lock-free SPSC circular FIFO (power-of-2 capacity)
+ *   - **RingBuffer**: Lock-free SPSC circular FIFO (power-of-2 capacity,
+ *     acquire/release indices on separate cache lines, memcpy transfers)
  *   - **FrameProcessor**: Overlap-add frame extraction + windowed FFT
  *   - **LatencyTimer**: Microsecond-resolution timing for budget tracking
  *
@@ -26,27 +27,51 @@
 #define REALTIME_H
 
 #include "dsp_utils.h"
+#include "fft.h"         /* FftPlan */
 
 /* ================================================================== */
 /*  Ring Buffer — lock-free SPSC circular FIFO                        */
 /* ================================================================== */
 
+/** Bytes between the producer's and the consumer's fields. */
+#define RB_CACHE_LINE 64
+
 /**
  * @brief Circular buffer with power-of-2 capacity.
  *
  * Uses bitwise AND mask for O(1) index wrapping.
- * Safe for single-producer / single-consumer without locks.
+ * Safe for one producer thread and one consumer thread without locks:
+ *
+ *   - head is written only by the producer, tail only by the consumer.
+ *     Each is published with a release store and read by the other
+ *     side with an acquire load, so the samples copied before a store
+ *     are visible to whoever sees the new index.
+ *   - head and tail sit on separate cache lines, each next to its
+ *     owner's cached copy of the other index.  The opposite index is
+ *     re-read only when the cached one says the ring is full (producer)
+ *     or empty (consumer), so a steady stream touches the shared line
+ *     about once per wrap instead of once per call.
+ *   - Reads and writes are at most two memcpy() segments.
  *
  *   write ──►  [5][6][7][_][_][_][1][2][3][4]  ◄── read
  *               ↑                               ↑
  *              head                             tail
+ *
+ * write/space are producer calls; read/peek/skip are consumer calls;
+ * available can be called from either side.  create, destroy and reset
+ * need both sides idle.
  */
 typedef struct {
     double *buf;     /**< Pre-allocated sample storage */
     int     cap;     /**< Capacity (must be power of 2) */
     int     mask;    /**< cap - 1 for bitwise wrap */
-    int     head;    /**< Write position */
-    int     tail;    /**< Read position */
+    char    pad0[RB_CACHE_LINE];
+    int     head;        /**< Write position (producer, release)     */
+    int     tail_cache;  /**< Producer's last view of tail           */
+    char    pad1[RB_CACHE_LINE];
+    int     tail;        /**< Read position (consumer, release)      */
+    int     head_cache;  /**< Consumer's last view of head           */
+    char    pad2[RB_CACHE_LINE];
 } RingBuffer;
 
 /** Create a ring buffer.  capacity is rounded up to next power of 2. */
@@ -73,7 +98,7 @@ int ring_buffer_peek(const RingBuffer *rb, double *data, int n);
 /** Discard up to n samples from the read side. */
 int ring_buffer_skip(RingBuffer *rb, int n);
 
-/** Reset to empty state. */
+/** Reset to empty state (neither side may be active). */
 void ring_buffer_reset(RingBuffer *rb);
 
 /* ================================================================== */
@@ -95,9 +120,10 @@ void ring_buffer_reset(RingBuffer *rb);
 typedef struct {
     int      frame_size;       /**< FFT length N (power of 2) */
     int      hop_size;         /**< Samples between frames */
+    const RfftPlan *plan;      /**< Shared N-point real plan (from the cache) */
     double  *frame;            /**< Current windowed frame [N] */
     double  *window;           /**< Pre-computed window [N] */
-    Complex *spectrum;         /**< FFT output [N] */
+    Complex *spectrum;         /**< rfft output [N/2+1] */
     double  *magnitude;        /**< |X[k]| for k=0..N/2-1 */
     double  *magnitude_db;     /**< 20·log10(|X[k]|) */
     int      frames_processed; /**< Counter */
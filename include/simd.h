@@ -0,0 +1,174 @@
+/**
+ * @file simd.h
+ * @brief Chapter 29 — SIMD kernels with runtime CPU dispatch (Stage 4).
+ *
+ * Vectorised versions of the inner loops that dominate FFT-based DSP:
+ *
+ *   ┌──────────────────────┬───────────────────────────────────────┐
+ *   │ Kernel               │ Used by                               │
+ *   ├──────────────────────┼───────────────────────────────────────┤
+ *   │ simd_radix4_stage    │ fft_execute() (every power-of-2 FFT)  │
+ *   │ simd_cmul            │ OLA/OLS spectral multiply, Bluestein  │
+ *   │ simd_cmul_conj       │ xcorr / autocorr  conj(X)·Y           │
+ *   │ simd_magnitude       │ fft_magnitude, frame processor        │
+ *   │ simd_power           │ periodogram / Welch |X|² accumulation │
+ *   │ simd_sos_df2t        │ sos_process_block_df2t / _multi       │
+ *   │ simd_iir_parallel    │ iir_parallel_process (sections/lanes) │
+ *   ├──────────────────────┼───────────────────────────────────────┤
+ *   │ simd_*_split         │ fft_execute_split, fft2d, filter2d    │
+ *   │ simd_radix4_stage_batch │ fft_execute_many (batched FFTs)    │
+ *   ├──────────────────────┼───────────────────────────────────────┤
+ *   │ simd_*_f32           │ float32 FFT, OLA/OLS, Welch (dsp_f32) │
+ *   └──────────────────────┴───────────────────────────────────────┘
+ *
+ * The instruction set is picked once, on first use, with cpuid
+ * (__builtin_cpu_supports):
+ *
+ *     AVX2  ── 2 complex doubles per 256-bit register (4 if split)
+ *     SSE2  ── 1 complex double per 128-bit register (2 if split)
+ *     scalar ── plain C99, used on every other target
+ *
+ * Results are bit-identical across levels: the vector code performs the
+ * same IEEE operations in the same order as the scalar loops, and never
+ * uses FMA (a fused multiply-add rounds once where the C code rounds
+ * twice).  This holds as long as the library itself is built without
+ * -ffp-contract=fast / -mfma, which is the Makefile default.
+ *
+ * @see chapters/29-optimisation/tutorial.md
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include "dsp_utils.h"   /* Complex, ComplexF */
+
+/** Instruction-set level used by the kernels. */
+typedef enum {
+    SIMD_SCALAR = 0,     /**< Portable C99 loops                      */
+    SIMD_SSE2   = 1,     /**< x86 SSE2, 128-bit                       */
+    SIMD_AVX2   = 2      /**< x86 AVX2, 256-bit                       */
+} SimdLevel;
+
+/** Best level supported by this CPU (detected once). */
+SimdLevel simd_detect(void);
+
+/** Level currently used by the kernels (defaults to simd_detect()). */
+SimdLevel simd_level(void);
+
+/**
+ * Force a level, e.g. SIMD_SCALAR to compare paths in tests or
+ * benchmarks.  Requests above simd_detect() are clamped.
+ * @return  The level actually in effect.
+ */
+SimdLevel simd_set_level(SimdLevel level);
+
+/** Human-readable name: "scalar", "sse2" or "avx2". */
+const char *simd_level_name(SimdLevel level);
+
+/* ── Kernels ─────────────────────────────────────────────────────── */
+
+/** y[k] = a[k] · b[k], k < n.  y may alias a or b. */
+void simd_cmul(Complex *y, const Complex *a, const Complex *b, int n);
+
+/** y[k] = conj(a[k]) · b[k], k < n.  y may alias a or b. */
+void simd_cmul_conj(Complex *y, const Complex *a, const Complex *b, int n);
+
+/** acc[k] += a[k] · b[k], k < n (the partitioned-convolution inner loop). */
+void simd_cmac(Complex *acc, const Complex *a, const Complex *b, int n);
+
+/**
+ * DF2T biquad cascade run on `lanes` signals at once, one per SIMD lane
+ * (AVX2: 4 per register, SSE2: 2; a single lane runs the scalar loop).
+ * Sample i of lane l is in[i·stride + l]; in and out may alias.  Same
+ * operations per lane as biquad_process_df2t() section after section
+ * (see iir.h), so every level gives the same bits.
+ *
+ * @param coef    5 per section: b0, b1, b2, a1, a2
+ * @param state   2 per section and lane: s1, s2 of section k, lane l at
+ *                state[2(k·lanes + l)] (the BiquadDF2TState layout)
+ * @param stride  ≥ lanes, e.g. the channel count of interleaved audio
+ */
+void simd_sos_df2t(const double *coef, double *state, int n_sections,
+                   const double *in, double *out, int n, int lanes, int stride);
+
+/**
+ * Parallel-form IIR: 4·n_groups sections, one per SIMD lane, all fed
+ * the same input (see IIRParallel in iir.h).  Each section runs
+ *
+ *   y = b0·x + s1,   s1 = (b1·x + s2) − a1·y,   s2 = (−a2)·y
+ *
+ * and out[i] = direct·in[i] + Σ y.  The sum order is fixed (per-lane
+ * partials, then (p0 + p2) + (p1 + p3) per chunk of groups), so every
+ * level gives the same bits.  in and out must not overlap.
+ *
+ * @param coef   16 per group: b0[4], b1[4], a1[4], −a2[4]
+ * @param state  8 per group: s1[4], s2[4]
+ */
+void simd_iir_parallel(const double *coef, double *state, int n_groups,
+                       double direct, const double *in, double *out, int n);
+
+/** mag[k] = |x[k]| = sqrt(re² + im²), k < n. */
+void simd_magnitude(const Complex *x, double *mag, int n);
+
+/**
+ * p[k] = |x[k]|² · scale   (accumulate == 0)
+ * p[k] += |x[k]|² · scale  (accumulate != 0)
+ */
+void simd_power(const Complex *x, double *p, int n, double scale, int accumulate);
+
+/**
+ * One radix-4 DIT stage over the whole array (see src/fft.c).
+ *
+ * @param x   Data, n complex samples, bit-reversed input order
+ * @param n   Transform size
+ * @param q   Quarter length of this stage (sub-DFT size), L = 4q
+ * @param tw  3q twiddles: W_L^k, then W_L^2k, then W_L^3k (k < q)
+ */
+void simd_radix4_stage(Complex *x, int n, int q, const Complex *tw);
+
+/* ── Split-plane kernels (SplitComplex layout, see dsp_utils.h) ──── */
+
+/**
+ * (yr + j·yi)[k] = (ar + j·ai)[k] · (br + j·bi)[k], k < n.
+ * Outputs may alias either input.
+ */
+void simd_cmul_split(double *yr, double *yi,
+                     const double *ar, const double *ai,
+                     const double *br, const double *bi, int n);
+
+/** mag[k] = sqrt(re[k]² + im[k]²), k < n. */
+void simd_magnitude_split(const double *re, const double *im, double *mag, int n);
+
+/**
+ * One radix-4 DIT stage on split planes; same arithmetic as
+ * simd_radix4_stage(), so both layouts give bit-identical FFTs.
+ *
+ * @param tw  6q doubles: Re W^k, Im W^k, Re W^2k, Im W^2k, Re W^3k, Im W^3k
+ */
+void simd_radix4_stage_split(double *re, double *im, int n, int q, const double *tw);
+
+/**
+ * One radix-4 stage applied to `lanes` transforms at once.
+ *
+ * Element i of transform b lives at re[i·lanes + b] / im[i·lanes + b],
+ * so each twiddle is loaded once and applied across all lanes.  Same
+ * arithmetic per element as simd_radix4_stage_split().
+ *
+ * @param tw     Split twiddles of this stage (6q doubles, as above)
+ * @param lanes  Number of interleaved transforms (AVX2 when a multiple of 4)
+ */
+void simd_radix4_stage_batch(double *re, double *im, int n, int q,
+                             const double *tw, int lanes);
+
+/* ── Single-precision kernels (ComplexF, see dsp_f32.h) ──────────── */
+
+/** y[k] = a[k] · b[k] in float, k < n.  y may alias a or b. */
+void simd_cmul_f32(ComplexF *y, const ComplexF *a, const ComplexF *b, int n);
+
+/** p[k] (+)= |x[k]|² · scale in float, as simd_power(). */
+void simd_power_f32(const ComplexF *x, float *p, int n, float scale, int accumulate);
+
+/** Float radix-4 stage, same layout and operation order as simd_radix4_stage(). */
+void simd_radix4_stage_f32(ComplexF *x, int n, int q, const ComplexF *tw);
+
+#endif /* SIMD_H */
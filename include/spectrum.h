@@ -7,6 +7,8 @@
  *
  * Frequency axis: psd[k] corresponds to f_k = k · fs / nfft, for k = 0 … nfft/2.
  * Output length is always nfft/2 + 1.
+ * nfft must be even; rfft_fast_length(n) gives a cheap size >= n that
+ * need not be a power of 2.
  */
 #ifndef SPECTRUM_H
 #define SPECTRUM_H
@@ -19,7 +21,7 @@
  * @param x      Input signal (length n).
  * @param n      Number of samples.
  * @param psd    Output array, length nfft/2 + 1 (one-sided).
- * @param nfft   FFT size (must be power-of-2, >= n; zero-padded if nfft > n).
+ * @param nfft   FFT size (even, >= n; zero-padded if nfft > n).
  * @return       Number of output bins (nfft/2 + 1), or -1 on error.
  */
 int periodogram(const double *x, int n, double *psd, int nfft);
@@ -30,7 +32,7 @@ int periodogram(const double *x, int n, double *psd, int nfft);
  * @param x      Input signal (length n).
  * @param n      Number of samples.
  * @param psd    Output array, length nfft/2 + 1.
- * @param nfft   FFT size (power-of-2, >= n).
+ * @param nfft   FFT size (even, >= n).
  * @param win    Window function (e.g. hann_window).  NULL → rectangular.
  * @return       Number of output bins, or -1 on error.
  */
@@ -46,7 +48,7 @@ int periodogram_windowed(const double *x, int n, double *psd, int nfft,
  * @param x        Input signal (length n).
  * @param n        Number of samples.
  * @param psd      Output array, length nfft/2 + 1.
- * @param nfft     FFT size per segment (power-of-2, >= seg_len).
+ * @param nfft     FFT size per segment (even, >= seg_len).
  * @param seg_len  Segment length (samples).  Must be <= nfft.
  * @param overlap  Overlap in samples (typically seg_len/2).
  * @param win      Window function.  NULL → rectangular.
@@ -61,7 +63,7 @@ int welch_psd(const double *x, int n, double *psd, int nfft,
  * @param x, y     Two signals of equal length n.
  * @param n        Number of samples.
  * @param cpsd     Output complex array, length nfft/2 + 1.
- * @param nfft     FFT size per segment (power-of-2, >= seg_len).
+ * @param nfft     FFT size per segment (even, >= seg_len).
  * @param seg_len  Segment length.
  * @param overlap  Overlap in samples.
  * @param win      Window function.  NULL → rectangular.
@@ -36,18 +36,26 @@
 #define STREAMING_H
 
 #include "dsp_utils.h"
+#include "fft.h"         /* FftPlan */
 
 /* ── Overlap-Add state ───────────────────────────────────────────── */
 
 typedef struct {
-    int    block_size;   /**< L: input block size (user-supplied)     */
+    int    block_size;   /**< L: input block size (given or automatic) */
     int    fft_size;     /**< N: L + M - 1, rounded to power-of-2    */
     int    filter_len;   /**< M: FIR filter length                    */
 
-    Complex *H;          /**< Pre-computed FFT of filter (N bins)     */
-    Complex *Xbuf;       /**< Scratch: FFT of input block             */
-    double  *tail;       /**< Overlap tail from previous block (M-1)  */
-    double  *padded;     /**< Zero-padded input (N samples)           */
+    const RfftPlan *plan; /**< Shared N-point real plan (from cache)  */
+    Complex *H;          /**< Pre-computed FFT of filter (N/2+1 bins) */
+    Complex *Xbuf;       /**< Scratch: FFT of input block (N/2+1)     */
+    double  *tail;       /**< Overlap tail from previous blocks (N-L) */
+    double  *padded;     /**< Input block; [L, N) stays zero (N)      */
+    double  *ybuf;       /**< Scratch: IFFT output (N)                */
+
+    Complex *H_next;     /**< Queued spectrum (see ola_set_filter)    */
+    Complex *Xnext;      /**< Scratch: X·H_next during a crossfade    */
+    double  *ynext;      /**< Scratch: new-filter output (N)          */
+    int      swap_pending; /**< H_next is crossfaded in next block    */
 } OlaState;
 
 /**
@@ -56,7 +64,9 @@ typedef struct {
  * @param s           State struct (caller-allocated)
  * @param h           FIR filter coefficients, length filter_len
  * @param filter_len  Number of filter taps (M)
- * @param block_size  Number of new input samples per call (L)
+ * @param block_size  Number of new input samples per call (L), or ≤ 0
+ *                    to pick L = N − M + 1 for the cheapest N (see
+ *                    stream_block_size()); read it back from s->block_size
  * @return            0 on success, -1 on error
  */
 int ola_init(OlaState *s, const double *h, int filter_len, int block_size);
@@ -82,9 +92,18 @@ typedef struct {
     int    fft_size;     /**< N: block_size + filter_len - 1 (pow2)   */
     int    filter_len;   /**< M: filter length                        */
 
-    Complex *H;          /**< Pre-computed FFT of filter (N bins)     */
-    Complex *Xbuf;       /**< Scratch: FFT of input segment           */
-    double  *input_buf;  /**< Current input segment (N samples)       */
+    const RfftPlan *plan; /**< Shared N-point real plan (from cache)  */
+    Complex *H;          /**< Pre-computed FFT of filter (N/2+1 bins) */
+    Complex *Xbuf;       /**< Scratch: FFT of input segment (N/2+1)   */
+    double  *input_buf;  /**< Input ring; FFTs read segments in place */
+    double  *ybuf;       /**< Scratch: IFFT output (N samples)        */
+    int      ring_len;   /**< 4N                                      */
+    int      ring_pos;   /**< Where the next block is written         */
+
+    Complex *H_next;     /**< Queued spectrum (see ols_set_filter)    */
+    Complex *Xnext;      /**< Scratch: X·H_next during a crossfade    */
+    double  *ynext;      /**< Scratch: new-filter output (N)          */
+    int      swap_pending; /**< H_next is crossfaded in next block    */
 } OlsState;
 
 /**
@@ -93,7 +112,8 @@ typedef struct {
  * @param s           State struct (caller-allocated)
  * @param h           FIR filter coefficients, length filter_len
  * @param filter_len  Number of filter taps (M)
- * @param block_size  Number of valid output samples per call (L)
+ * @param block_size  Number of valid output samples per call (L), or ≤ 0
+ *                    for L = N − M + 1 (no zero padding at all)
  * @return            0 on success, -1 on error
  */
 int ols_init(OlsState *s, const double *h, int filter_len, int block_size);
@@ -112,4 +132,234 @@ void ols_process(OlsState *s, const double *in, double *out);
  */
 void ols_free(OlsState *s);
 
+/**
+ * @brief Block size L = N − M + 1 for the power-of-2 N with the lowest
+ * FFT work per output sample, N·log₂N / L (a larger N is taken only if
+ * it saves more than 5%, to keep latency down).  Used by ola_init() and
+ * ols_init() when block_size ≤ 0.
+ *
+ * @return L ≥ 1, or -1 if filter_len < 1
+ */
+int stream_block_size(int filter_len);
+
+/* ── Hot filter swap ─────────────────────────────────────────────── */
+
+/*
+ *   Retuning by ola_free() + ola_init() allocates, recomputes H on the
+ *   audio thread and drops the overlap state — an audible click.
+ *   Instead the new spectrum is computed elsewhere and queued:
+ *
+ *     control thread:  stream_filter_spectrum(h_new, …, s.fft_size, Hn)
+ *     audio thread:    ols_set_filter(&s, Hn, M_new)     (memcpy only)
+ *                      ols_process(&s, in, out)  ← old → new crossfade
+ *
+ *   The next block is filtered with both spectra and the outputs are
+ *   blended with a raised-cosine ramp over its L samples; from the block
+ *   after that on only the new filter runs.  Neither call allocates.
+ *
+ *   OLS blends two complete outputs (the segment carries the M − 1
+ *   samples of history both filters need).  OLA keeps no input history,
+ *   so its "new" output is the new filter on the current block plus the
+ *   old filter's tail: earlier blocks ring out through the filter they
+ *   were convolved with.
+ */
+
+/**
+ * @brief N/2 + 1-bin spectrum of h zero-padded to fft_size, in the
+ * layout ola_set_filter() / ols_set_filter() expect.  Allocates scratch
+ * and may build a plan — call it off the audio thread.
+ *
+ * @param h           New FIR coefficients
+ * @param filter_len  Number of taps
+ * @param fft_size    s->fft_size of the state it is meant for
+ * @param H           Output, fft_size/2 + 1 bins (caller-allocated)
+ * @return            0 on success, -1 on error
+ */
+int stream_filter_spectrum(const double *h, int filter_len, int fft_size,
+                           Complex *H);
+
+/**
+ * @brief Queue a new filter spectrum; the next ola_process() crossfades
+ * to it over one block.  Copies H (s->fft_size/2 + 1 bins), no allocation.
+ * Call from the thread that runs ola_process(), between blocks; a second
+ * call before the swap happens replaces the queued spectrum.
+ *
+ * @param filter_len  Taps behind H; at most N − L + 1 (the tail length
+ *                    plus one), so a longer filter does not alias
+ * @return            0, or -1 if H is NULL or filter_len does not fit
+ */
+int ola_set_filter(OlaState *s, const Complex *H, int filter_len);
+
+/**
+ * @brief As ola_set_filter() for overlap-save.  filter_len may not exceed
+ * s->filter_len: the ring keeps exactly M − 1 samples of history.
+ */
+int ols_set_filter(OlsState *s, const Complex *H, int filter_len);
+
+/* ── Uniformly partitioned convolution (UPOLS) ───────────────────── */
+
+/*
+ *   OLA/OLS need N ≥ L + M − 1: a 65536-tap filter with L = 256 costs a
+ *   128K-point FFT per 256 samples.  UPOLS cuts h into P = ⌈M/B⌉
+ *   partitions of B taps and keeps the spectra of the last P input
+ *   blocks (the frequency-domain delay line, FDL):
+ *
+ *     x block n ──► [x_{n−1} | x_n] ──► rfft(2B) ──► X_n ──► FDL slot
+ *
+ *     Y = X_n·H_0 + X_{n−1}·H_1 + … + X_{n−P+1}·H_{P−1}   (B+1 bins)
+ *     y_n = last B samples of irfft(Y)
+ *
+ *   One 2B-point rfft/irfft pair and P complex MACs per bin per block;
+ *   latency is one block (B samples) whatever M is.
+ */
+
+typedef struct {
+    int    block_size;   /**< B: samples per call = partition length  */
+    int    fft_size;     /**< 2B                                      */
+    int    filter_len;   /**< M: filter length                        */
+    int    n_parts;      /**< P = ⌈M / B⌉                             */
+    int    fdl_pos;      /**< FDL slot holding the newest spectrum    */
+
+    const RfftPlan *plan; /**< Shared 2B-point real plan (from cache) */
+    Complex *H;          /**< Partition spectra, P × (B+1)            */
+    Complex *fdl;        /**< Past input spectra, P × (B+1)           */
+    Complex *acc;        /**< Spectral accumulator (B+1)              */
+    double  *input_buf;  /**< [previous block | new block] (2B)       */
+    double  *ybuf;       /**< Scratch: IFFT output (2B)               */
+} UpolsState;
+
+/**
+ * @brief Initialise a uniformly partitioned convolver.
+ *
+ * @param s           State struct (caller-allocated)
+ * @param h           FIR filter coefficients, length filter_len
+ * @param filter_len  Number of filter taps (M, any length)
+ * @param block_size  Samples per call (B); a power of 2 is fastest
+ * @return            0 on success, -1 on error
+ */
+int upols_init(UpolsState *s, const double *h, int filter_len, int block_size);
+
+/**
+ * @brief Filter one block of s->block_size samples (in and out may alias).
+ */
+void upols_process(UpolsState *s, const double *in, double *out);
+
+/** @brief Clear the input history (filter kept). */
+void upols_reset(UpolsState *s);
+
+/** @brief Free all resources allocated by upols_init. */
+void upols_free(UpolsState *s);
+
+/* ── Non-uniform partitions ──────────────────────────────────────── */
+
+/*
+ *   With thousands of partitions the MACs dominate.  Later taps can use
+ *   bigger blocks — their output is not needed until later:
+ *
+ *     taps  [0, 3B)      [3B, 15B)     [15B, 63B)     [63B, M)
+ *     block  B            4B            16B            64B  ...
+ *
+ *   A level with block K starting at tap K − B finishes its K-block
+ *   exactly when its first output sample is due, so latency stays B.
+ *   Each level runs once per K/B calls (the work is bursty).
+ */
+
+#define NUPOLS_MAX_LEVELS 8
+
+typedef struct {
+    int    block_size;   /**< B: samples per call                     */
+    int    filter_len;   /**< M                                       */
+    int    n_levels;     /**< Levels in use (1 = plain UPOLS)         */
+    UpolsState level[NUPOLS_MAX_LEVELS]; /**< Level i: block B·4^i   */
+    int    offset[NUPOLS_MAX_LEVELS];    /**< First tap of level i    */
+    int    fill[NUPOLS_MAX_LEVELS];      /**< Samples in in_acc[i]    */
+    double *in_acc[NUPOLS_MAX_LEVELS];   /**< Input gathered for i ≥ 1 */
+    double *scratch;     /**< Output of a large level (largest block) */
+    double *ring;        /**< Pending output of levels ≥ 1            */
+    int    ring_mask;    /**< Ring length − 1 (power of 2)            */
+    int    ring_pos;     /**< Ring slot of the next output sample     */
+} NupolsState;
+
+/**
+ * @brief Initialise a non-uniformly partitioned convolver.
+ *
+ * Blocks grow 4× per level up to max_block; max_block ≤ block_size
+ * gives plain UPOLS.  Output matches upols_process() to rounding.
+ *
+ * @return 0 on success, -1 on error
+ */
+int nupols_init(NupolsState *s, const double *h, int filter_len,
+                int block_size, int max_block);
+
+/** @brief Filter one block of s->block_size samples (in and out may alias). */
+void nupols_process(NupolsState *s, const double *in, double *out);
+
+/** @brief Free all resources allocated by nupols_init. */
+void nupols_free(NupolsState *s);
+
+/* ── Multichannel block convolution ──────────────────────────────── */
+
+/*
+ *   One filter, C channels.  h is real, so filtering commutes with
+ *   packing two real channels into one complex signal:
+ *
+ *     (a + j·b) ∗ h = (a ∗ h) + j·(b ∗ h)
+ *
+ *   Each block packs channel pairs into ⌈C/2⌉ complex frames, runs them
+ *   through one batched N-point FFT (fft_execute_many), multiplies every
+ *   frame by the one shared H, and inverts the batch: real part →
+ *   channel 2p, imaginary part → channel 2p+1.  No per-channel spectra,
+ *   and half as many transforms as channels.
+ */
+
+/** Sample layout of a multichannel block of L samples × C channels. */
+typedef enum {
+    CHAN_PLANAR = 0,     /**< x[c·L + i]: one contiguous run per channel */
+    CHAN_INTERLEAVED     /**< x[i·C + c]: frames of C samples            */
+} ChannelLayout;
+
+typedef struct {
+    int    block_size;   /**< L: samples per channel per call          */
+    int    fft_size;     /**< N ≥ L + M − 1, power of 2                */
+    int    filter_len;   /**< M                                        */
+    int    n_channels;   /**< C                                        */
+    int    n_pairs;      /**< ⌈C/2⌉ complex transforms per block       */
+    int    overlap_save; /**< 1 = OLS history, 0 = OLA tails           */
+    int    hist_len;     /**< Per channel: M − 1 (OLS) or N − L (OLA)  */
+    ChannelLayout layout;
+
+    const FftPlan *plan; /**< Shared N-point complex plan (from cache) */
+    Complex *H;          /**< Shared filter spectrum, N bins           */
+    Complex *frames;     /**< n_pairs frames of N (pair p at p·N)      */
+    double  *hist;       /**< C × hist_len overlap state               */
+} MultiConvState;
+
+/**
+ * @brief Initialise a multichannel convolver.
+ *
+ * @param s             State struct (caller-allocated)
+ * @param h             FIR coefficients, length filter_len
+ * @param filter_len    M
+ * @param block_size    L samples per channel per call
+ * @param n_channels    C ≥ 1
+ * @param layout        CHAN_PLANAR or CHAN_INTERLEAVED (in and out)
+ * @param overlap_save  1 for overlap-save, 0 for overlap-add
+ * @return              0 on success, -1 on error
+ */
+int multiconv_init(MultiConvState *s, const double *h, int filter_len,
+                   int block_size, int n_channels, ChannelLayout layout,
+                   int overlap_save);
+
+/**
+ * @brief Filter one block of L × C samples (in and out may alias).
+ * @return 0, or -1 if the batched FFT could not allocate
+ */
+int multiconv_process(MultiConvState *s, const double *in, double *out);
+
+/** @brief Clear all channel history (filter kept). */
+void multiconv_reset(MultiConvState *s);
+
+/** @brief Free all resources allocated by multiconv_init. */
+void multiconv_free(MultiConvState *s);
+
 #endif /* STREAMING_H */
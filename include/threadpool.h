@@ -0,0 +1,69 @@
+/**
+ * @file threadpool.h
+ * @brief Chapter 29 — Library-owned worker pool (Stage 5: multithreading).
+ *
+ * A small pthread pool used by the heavy kernels to split independent
+ * work — rows/columns of fft2d(), output rows of conv2d(), the column
+ * and row passes of large 1-D FFTs — across cores:
+ *
+ *     dsp_parallel_for(count, min_chunk, fn, ctx)
+ *
+ *       [0 ──────────── count)
+ *        │ chunk 0 │ chunk 1 │ chunk 2 │ chunk 3 │   one per thread
+ *          caller    worker    worker    worker
+ *
+ * The range is cut into contiguous chunks that depend only on `count`
+ * and the thread count, and every kernel that uses the pool writes
+ * disjoint outputs with the same arithmetic it would use serially, so
+ * results are bit-identical for any number of threads.
+ *
+ * The pool defaults to 1 thread (no workers, everything runs on the
+ * caller), so the library stays single-threaded unless asked:
+ *
+ *     dsp_set_num_threads(0);     ← one thread per online CPU
+ *     fft2d(re, im, 4096, 4096);  ← rows, then columns, in parallel
+ *
+ * A dsp_parallel_for() issued while the pool is busy (from a task, or
+ * from a second application thread) runs serially on its caller.
+ *
+ * @see chapters/29-optimisation/tutorial.md
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+/** Upper bound on pool threads (caller included). */
+#define DSP_MAX_THREADS 64
+
+/**
+ * Work callback: process items [begin, end) of the range.
+ * @param ctx    Caller data passed to dsp_parallel_for()
+ */
+typedef void (*dsp_task_fn)(void *ctx, int begin, int end);
+
+/**
+ * Set the number of threads used by parallel kernels (caller included).
+ * @param n  1 = serial, 0 = one per online CPU, clamped to DSP_MAX_THREADS
+ * @return   Thread count now in effect
+ */
+int dsp_set_num_threads(int n);
+
+/** Thread count currently in effect (default 1). */
+int dsp_get_num_threads(void);
+
+/**
+ * Run fn over [0, count) split into contiguous chunks, one per thread,
+ * and wait for all of them.  Uses fewer threads if count / min_chunk
+ * is small.
+ *
+ * @param count      Number of items
+ * @param min_chunk  Smallest worthwhile chunk (>= 1)
+ * @param fn         Callback, invoked with disjoint [begin, end) ranges
+ * @param ctx        Passed through to fn
+ */
+void dsp_parallel_for(int count, int min_chunk, dsp_task_fn fn, void *ctx);
+
+/** Join and free the worker threads (the next parallel call recreates them). */
+void dsp_threadpool_shutdown(void);
+
+#endif /* THREADPOOL_H */
@@ -8,11 +8,15 @@
  *
  * ── MFCC Pipeline ────────────────────────────────────────────────
  *   frame → Hamming → FFT → |X|² → Mel filterbank → log → DCT-II
+ *
+ * Real cepstrum, liftering and MFCC only need the half spectrum of a
+ * real sequence and use rfft/irfft.  The complex cepstrum keeps the
+ * full N-bin transform because its phase unwrapping walks all bins.
  */
 
 #include "cepstrum.h"
 #include "dsp_utils.h"   /* Complex */
-#include "fft.h"         /* fft, ifft */
+#include "fft.h"         /* fft, ifft, rfft, irfft */
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -27,25 +31,23 @@
 
 void cepstrum_real(const double *x, int n, double *c, int nfft)
 {
-    Complex *X = (Complex *)calloc((size_t)nfft, sizeof(Complex));
-    for (int i = 0; i < n && i < nfft; i++) {
-        X[i].re = x[i];
-        X[i].im = 0.0;
-    }
+    int half = nfft / 2;
+    Complex *X = (Complex *)calloc((size_t)(half + 1), sizeof(Complex));
 
-    fft(X, nfft);
+    /* c doubles as the zero-padded input buffer */
+    for (int i = 0; i < nfft; i++)
+        c[i] = (i < n) ? x[i] : 0.0;
 
-    /* log|X[k]| */
-    for (int k = 0; k < nfft; k++) {
+    rfft(c, X, nfft);
+
+    /* log|X[k]| — real and even, so the IFFT is real */
+    for (int k = 0; k <= half; k++) {
         double mag = sqrt(X[k].re * X[k].re + X[k].im * X[k].im);
         X[k].re = log(mag + 1e-30);
         X[k].im = 0.0;
     }
 
-    ifft(X, nfft);
-
-    for (int i = 0; i < nfft; i++)
-        c[i] = X[i].re;
+    irfft(X, c, nfft);
 
     free(X);
 }
@@ -101,28 +103,26 @@ void cepstrum_complex(const double *x, int n, double *c, int nfft)
 
 void cepstrum_lifter(const double *c, int nfft, int L, double *envelope)
 {
-    Complex *X = (Complex *)calloc((size_t)nfft, sizeof(Complex));
+    int half = nfft / 2;
+    double  *cl = (double *)calloc((size_t)nfft, sizeof(double));
+    Complex *X  = (Complex *)calloc((size_t)(half + 1), sizeof(Complex));
 
     /* Low-time lifter: keep c[0..L-1] and mirror c[nfft-L+1..nfft-1] */
-    for (int i = 0; i < L && i < nfft; i++) {
-        X[i].re = c[i];
-        X[i].im = 0.0;
-    }
+    for (int i = 0; i < L && i < nfft; i++)
+        cl[i] = c[i];
     /* Mirror for real-valued result */
-    for (int i = 1; i < L && (nfft - i) >= L; i++) {
-        X[nfft - i].re = c[nfft - i];
-        X[nfft - i].im = 0.0;
-    }
+    for (int i = 1; i < L && (nfft - i) >= L; i++)
+        cl[nfft - i] = c[nfft - i];
 
-    fft(X, nfft);
+    rfft(cl, X, nfft);
 
     /* Output: log magnitude envelope in dB (positive frequencies) */
-    int half = nfft / 2;
     for (int k = 0; k < half; k++) {
         double mag = sqrt(X[k].re * X[k].re + X[k].im * X[k].im);
         envelope[k] = 20.0 * log10(mag + 1e-30);
     }
 
+    free(cl);
     free(X);
 }
 
@@ -217,14 +217,10 @@ void compute_mfcc(const double *frame, int frame_len, int nfft,
     }
 
     /* 2. FFT → power spectrum */
-    Complex *X = (Complex *)calloc((size_t)nfft, sizeof(Complex));
-    for (int i = 0; i < nfft; i++) {
-        X[i].re = windowed[i];
-        X[i].im = 0.0;
-    }
-    fft(X, nfft);
-
     int half = nfft / 2;
+    Complex *X = (Complex *)calloc((size_t)(half + 1), sizeof(Complex));
+    rfft(windowed, X, nfft);
+
     double *power_spec = (double *)malloc((size_t)half * sizeof(double));
     for (int k = 0; k < half; k++)
         power_spec[k] = X[k].re * X[k].re + X[k].im * X[k].im;
@@ -2,45 +2,187 @@
  * @file convolution.c
  * @brief Implementation of discrete convolution, correlation, and LTI utilities.
  *
- * All functions are direct implementations — no FFT-based fast convolution here.
- * That belongs in Ch16 (Overlap-Add/Save) once we have the DFT chapter.
+ * Correlation and the LTI helpers are direct implementations.  Linear
+ * convolution picks between the direct sum and the Ch16 Overlap-Save /
+ * Overlap-Add engines (streaming.c) with a fixed cost model.
  */
 
 #define _GNU_SOURCE
 #include "convolution.h"
+#include "streaming.h"
 #include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
 /* ── Linear convolution ─────────────────────────────────────────── */
 /*
- * Full linear convolution: y[n] = Σ h[k] * x[n-k]
+ * Direct sum y[n] = Σ h[k] * x[n-k] over the taps that overlap x:
  *
- * Output length = x_len + h_len - 1.
- * Direct O(N·M) implementation — educational, not FFT-accelerated.
+ *   kmin = max(0, n - (x_len-1))     kmax = min(h_len-1, n)
+ *
+ * so the inner loop carries no bounds test.  Taps are still summed in
+ * ascending k, so results match the textbook loop bit for bit.
  *
  *   x: [████████]          len=8
  *   h: [▓▓▓]                len=3
  *   y: [░░░░░░░░░░]        len=10  (= 8+3-1)
  *       ^ h slides across x, summing element-wise products
- */int convolve(const double *x, int x_len,
-             const double *h, int h_len,
-             double *y)
+ */
+static void conv_direct(const double *x, int x_len,
+                        const double *h, int h_len,
+                        double *y, int y_len)
 {
-    int y_len = x_len + h_len - 1;
+    for (int n = 0; n < y_len; n++) {
+        int kmin = n - (x_len - 1) > 0 ? n - (x_len - 1) : 0;
+        int kmax = n < h_len - 1 ? n : h_len - 1;
+        double sum = 0.0;
+        for (int k = kmin; k <= kmax; k++) {
+            sum += h[k] * x[n - k];
+        }
+        y[n] = sum;
+    }
+}
+
+/*
+ * Block FFT convolution: feed x through an OLS (or OLA) state in blocks
+ * of L, zero-padding past the end of x until y_len outputs exist.  The
+ * streaming state starts from zero history, which is exactly the
+ * causal/zero-padded convolution.  Returns 0, or -1 on allocation failure.
+ */
+static int conv_fft(const double *x, int x_len,
+                    const double *h, int h_len,
+                    double *y, int y_len, ConvMethod method, int L)
+{
+    OlaState ola;
+    OlsState ols;
+    int use_ola = method == CONV_OLA;
+    double *blk = (double *)malloc(2 * (size_t)L * sizeof(double));
+    if (!blk) return -1;
+    double *out = blk + L;
 
-    /* Zero output first */
-    memset(y, 0, (size_t)y_len * sizeof(double));
+    int rc = use_ola ? ola_init(&ola, h, h_len, L)
+                     : ols_init(&ols, h, h_len, L);
+    if (rc != 0) {
+        free(blk);
+        return -1;
+    }
 
-    /* Direct sum: y[n] = Σ_{k=0}^{h_len-1} h[k] * x[n-k] */
-    for (int n = 0; n < y_len; n++) {
-        for (int k = 0; k < h_len; k++) {
-            int idx = n - k;
-            if (idx >= 0 && idx < x_len) {
-                y[n] += h[k] * x[idx];
-            }
+    for (int pos = 0; pos < y_len; pos += L) {
+        int n_in = x_len - pos;
+        if (n_in < 0) n_in = 0;
+        if (n_in > L) n_in = L;
+        if (n_in > 0)
+            memcpy(blk, x + pos, (size_t)n_in * sizeof(double));
+        memset(blk + n_in, 0, (size_t)(L - n_in) * sizeof(double));
+
+        if (use_ola) ola_process(&ola, blk, out);
+        else         ols_process(&ols, blk, out);
+
+        int n_out = y_len - pos < L ? y_len - pos : L;
+        memcpy(y + pos, out, (size_t)n_out * sizeof(double));
+    }
+
+    if (use_ola) ola_free(&ola);
+    else         ols_free(&ols);
+    free(blk);
+    return 0;
+}
+
+/*
+ * Cost model, in units of one direct MAC
+ *
+ *   direct  = x_len · h_len
+ *   FFT(N)  = ⌈y_len / L⌉ · CONV_FFT_COST · N·log₂N,   L = N − h_len + 1
+ *
+ * CONV_FFT_COST is one OLS block (rfft, multiply, irfft) per N·log₂N
+ * relative to a conv_direct() MAC; timing both on x86-64 at -O3 gives
+ * 1.3–1.6.  It is a constant, not a measurement, so the method
+ * chosen — and with it every output bit — depends only on the sizes.
+ * The FFT cost is minimised over power-of-2 N from 2·h_len up to one
+ * block covering the whole output: small N wastes work on the M−1
+ * overlap, large N pays the log factor.  OLA does the same transforms
+ * but moves ~N more samples per block, so the model only prices OLS.
+ */
+#define CONV_MIN_TAPS   32          /* below this, direct always wins  */
+#define CONV_MIN_MACS   (1 << 17)   /* ... and for small problems      */
+#define CONV_MAX_FFT    (1 << 22)
+#define CONV_FFT_COST   1.5         /* MACs per N·log₂N of one block   */
+
+/* Cheapest FFT cost (MACs) for y_len outputs; *block receives its L. */
+static double conv_fft_cost(int y_len, int h_len, int *block)
+{
+    int n_full = next_power_of_2(y_len + h_len - 1);
+    int n = next_power_of_2(2 * h_len);
+    if (n > n_full) n = n_full;
+    int n_max = n_full < CONV_MAX_FFT ? n_full : CONV_MAX_FFT;
+    if (n_max < n) n_max = n;
+
+    double best = HUGE_VAL;
+    *block = n - h_len + 1;
+    for (; n <= n_max; n *= 2) {
+        int L = n - h_len + 1;
+        double blocks = ceil((double)y_len / L);
+        double cost = blocks * CONV_FFT_COST * n * log2((double)n);
+        if (cost < best) {
+            best = cost;
+            *block = L;
         }
     }
+    return best;
+}
+
+/* Resolve method (CONV_AUTO → cheapest) and the FFT block length. */
+static ConvMethod conv_plan(int x_len, int h_len, int y_len,
+                            ConvMethod method, int *block)
+{
+    double macs = (double)x_len * h_len;
+    *block = 0;
+    if (method == CONV_DIRECT || x_len <= 0 || h_len <= 0)
+        return CONV_DIRECT;
+    if (method == CONV_AUTO && (h_len < CONV_MIN_TAPS || macs < CONV_MIN_MACS))
+        return CONV_DIRECT;
+
+    double fft = conv_fft_cost(y_len, h_len, block);
+    if (method != CONV_AUTO)
+        return method;
+    return fft < macs ? CONV_OLS : CONV_DIRECT;
+}
+
+ConvMethod conv_select_method(int x_len, int h_len)
+{
+    int block;
+    return conv_plan(x_len, h_len, x_len + h_len - 1, CONV_AUTO, &block);
+}
+
+static void conv_run(const double *x, int x_len,
+                     const double *h, int h_len,
+                     double *y, int y_len, ConvMethod method)
+{
+    int block;
+    method = conv_plan(x_len, h_len, y_len, method, &block);
+    if (method != CONV_DIRECT &&
+        conv_fft(x, x_len, h, h_len, y, y_len, method, block) == 0)
+        return;
+    conv_direct(x, x_len, h, h_len, y, y_len);
+}
+
+/*
+ * Full linear convolution: y[n] = Σ h[k] * x[n-k]
+ * Output length = x_len + h_len - 1.
+ */
+int convolve(const double *x, int x_len,
+             const double *h, int h_len,
+             double *y)
+{
+    return convolve_method(x, x_len, h, h_len, y, CONV_AUTO);
+}
 
+int convolve_method(const double *x, int x_len,
+                    const double *h, int h_len,
+                    double *y, ConvMethod method)
+{
+    int y_len = x_len + h_len - 1;
+    conv_run(x, x_len, h, h_len, y, y_len, method);
     return y_len;
 }
 
@@ -52,17 +194,14 @@ void convolve_causal(const double *x, int x_len,
                      const double *h, int h_len,
                      double *y)
 {
-    /* Only compute first x_len samples of full convolution */
-    for (int n = 0; n < x_len; n++) {
-        double sum = 0.0;
-        for (int k = 0; k < h_len; k++) {
-            int idx = n - k;
-            if (idx >= 0 && idx < x_len) {
-                sum += h[k] * x[idx];
-            }
-        }
-        y[n] = sum;
-    }
+    convolve_causal_method(x, x_len, h, h_len, y, CONV_AUTO);
+}
+
+void convolve_causal_method(const double *x, int x_len,
+                            const double *h, int h_len,
+                            double *y, ConvMethod method)
+{
+    conv_run(x, x_len, h, h_len, y, x_len, method);
 }
 
 /* ── Cross-correlation ──────────────────────────────────────────── */
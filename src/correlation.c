@@ -5,10 +5,16 @@
  * Linear (non-circular) correlation is achieved by zero-padding both
  * signals to length nfft >= nx + ny - 1, computing FFTs, multiplying
  * conj(X)·Y in frequency domain, and IFFT-ing.
+ *
+ * Both signals are real, so only the nfft/2 + 1 non-redundant bins are
+ * computed (rfft/irfft).  Autocorrelation needs a single transform.
+ * nfft is the next 2·3·5·7-smooth length rather than the next power of
+ * 2, e.g. 1025 + 1025 - 1 → 2058 instead of 4096.
  */
 #define _POSIX_C_SOURCE 200809L
 #include "correlation.h"
 #include "fft.h"
+#include "simd.h"
 #include "dsp_utils.h"
 
 #include <math.h>
@@ -30,32 +36,41 @@ static int xcorr_raw(const double *x, int nx,
         return -1;
 
     int r_len = nx + ny - 1;
-    int nfft  = next_power_of_2(r_len);
-
-    Complex *bx = (Complex *)calloc((size_t)nfft, sizeof(Complex));
-    Complex *by = (Complex *)calloc((size_t)nfft, sizeof(Complex));
-    if (!bx || !by) {
+    int nfft  = rfft_fast_length(r_len);   /* 7-smooth, even */
+    int n_bins = nfft / 2 + 1;
+    const RfftPlan *plan = rfft_plan_cached(nfft);
+    if (!plan) return -1;
+
+    double  *t  = (double *)calloc((size_t)nfft, sizeof(double));
+    Complex *bx = (Complex *)malloc((size_t)n_bins * sizeof(Complex));
+    Complex *by = (Complex *)malloc((size_t)n_bins * sizeof(Complex));
+    if (!t || !bx || !by) {
+        free(t);
         free(bx);
         free(by);
         return -1;
     }
 
-    /* Load signals (zero-padded) */
-    for (int i = 0; i < nx; i++) { bx[i].re = x[i]; bx[i].im = 0.0; }
-    for (int i = 0; i < ny; i++) { by[i].re = y[i]; by[i].im = 0.0; }
+    /* Load signals (zero-padded) and transform */
+    memcpy(t, x, (size_t)nx * sizeof(double));
+    rfft_execute(plan, t, bx);
 
-    fft(bx, nfft);
-    fft(by, nfft);
+    if (y == x && ny == nx) {
+        /* Autocorrelation: conj(X)·X = |X|² */
+        for (int k = 0; k < n_bins; k++) {
+            bx[k].re = bx[k].re * bx[k].re + bx[k].im * bx[k].im;
+            bx[k].im = 0.0;
+        }
+    } else {
+        memset(t, 0, (size_t)nfft * sizeof(double));
+        memcpy(t, y, (size_t)ny * sizeof(double));
+        rfft_execute(plan, t, by);
 
-    /* conj(X) · Y */
-    for (int k = 0; k < nfft; k++) {
-        double xr = bx[k].re, xi = bx[k].im;
-        double yr = by[k].re, yi = by[k].im;
-        bx[k].re = xr * yr + xi * yi;   /* Re(conj(X)·Y) */
-        bx[k].im = xr * yi - xi * yr;   /* Im(conj(X)·Y) */
+        /* conj(X) · Y */
+        simd_cmul_conj(bx, bx, by, n_bins);
     }
 
-    ifft(bx, nfft);
+    irfft_execute(plan, bx, t);
 
     /*
      * IFFT(conj(X)·Y)[m] = sum_n x[n]·y[n+m].
@@ -63,23 +78,24 @@ static int xcorr_raw(const double *x, int nx,
      * Valid lag range: -(nx-1) .. +(ny-1).
      * Centre (lag 0) stored at output index (nx-1).
      *
-     * In the circular buffer bx:
-     *   lag  0      → bx[0]
-     *   lag +1      → bx[1]
+     * In the circular buffer t:
+     *   lag  0      → t[0]
+     *   lag +1      → t[1]
      *   ...
-     *   lag +(ny-1) → bx[ny-1]
-     *   lag -1      → bx[nfft - 1]
+     *   lag +(ny-1) → t[ny-1]
+     *   lag -1      → t[nfft - 1]
      *   ...
-     *   lag -(nx-1) → bx[nfft - (nx-1)]
+     *   lag -(nx-1) → t[nfft - (nx-1)]
      */
     /* Non-negative lags: 0 .. ny-1 → r[nx-1 .. nx-1+ny-1] */
     for (int m = 0; m < ny; m++)
-        r[nx - 1 + m] = bx[m].re;
+        r[nx - 1 + m] = t[m];
 
     /* Negative lags: -(nx-1) .. -1 → r[0 .. nx-2] */
     for (int m = 1; m < nx; m++)
-        r[nx - 1 - m] = bx[nfft - m].re;
+        r[nx - 1 - m] = t[nfft - m];
 
+    free(t);
     free(bx);
     free(by);
     return r_len;
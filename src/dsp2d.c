@@ -3,18 +3,26 @@
  * @brief 2-D DSP — convolution, FFT (row-column), image kernels.
  *
  * ── 2-D FFT Strategy ────────────────────────────────────────────
- *   1. Apply 1-D FFT to each row
- *   2. Apply 1-D FFT to each column
+ *   1. Apply 1-D FFT to each row     (in place on the re/im planes)
+ *   2. Apply 1-D FFT to each column  (batched, 8 columns per block)
  *   Complexity: O(MN·log(MN))   for M×N image
  *
  * ── Spatial Convolution ──────────────────────────────────────────
  *   out(r,c) = ΣΣ img(r-i, c-j) · kernel(i,j)
  *   Zero-padded boundary conditions.
+ *
+ * ── Threading ────────────────────────────────────────────────────
+ *   Row bands (conv2d, FFT row pass) and column bands (FFT column
+ *   pass) are independent, so they are handed to dsp_parallel_for().
+ *   Each output is computed by the same code whatever the band
+ *   split, so results do not depend on dsp_set_num_threads().
  */
 
 #include "dsp2d.h"
 #include "dsp_utils.h"  /* Complex */
-#include "fft.h"        /* fft, ifft */
+#include "fft.h"        /* fft_execute_many_split */
+#include "simd.h"       /* simd_cmul_split */
+#include "threadpool.h" /* dsp_parallel_for */
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -27,14 +35,24 @@
 /*  2-D Spatial Convolution                                            */
 /* ================================================================== */
 
-void conv2d(const double *img, int rows, int cols,
-            const double *kernel, int krows, int kcols,
-            double *out)
+typedef struct {
+    const double *img, *kernel;
+    double *out;
+    int rows, cols, krows, kcols;
+} Conv2dJob;
+
+/* Output rows [r0, r1) */
+static void conv2d_rows(void *ctx, int r0, int r1)
 {
+    const Conv2dJob *job = (const Conv2dJob *)ctx;
+    const double *img = job->img, *kernel = job->kernel;
+    double *out = job->out;
+    int rows = job->rows, cols = job->cols;
+    int krows = job->krows, kcols = job->kcols;
     int kr2 = krows / 2;
     int kc2 = kcols / 2;
 
-    for (int r = 0; r < rows; r++) {
+    for (int r = r0; r < r1; r++) {
         for (int c = 0; c < cols; c++) {
             double sum = 0.0;
             for (int ki = 0; ki < krows; ki++) {
@@ -50,6 +68,18 @@ void conv2d(const double *img, int rows, int cols,
     }
 }
 
+void conv2d(const double *img, int rows, int cols,
+            const double *kernel, int krows, int kcols,
+            double *out)
+{
+    Conv2dJob job = { img, kernel, out, rows, cols, krows, kcols };
+
+    /* Aim for >= 16K multiply-adds per band */
+    int work = cols * krows * kcols;
+    int min_rows = work > 0 ? 1 + 16384 / work : rows;
+    dsp_parallel_for(rows, min_rows, conv2d_rows, &job);
+}
+
 /* ================================================================== */
 /*  Standard Kernels                                                   */
 /* ================================================================== */
@@ -153,70 +183,67 @@ void sobel_magnitude(const double *img, int rows, int cols, double *mag)
 /*  2-D FFT (row-column decomposition)                                 */
 /* ================================================================== */
 
-void fft2d(double *data_re, double *data_im, int rows, int cols)
-{
-    Complex *tmp = (Complex *)malloc((size_t)(rows > cols ? rows : cols) * sizeof(Complex));
-
-    /* FFT along each row */
-    for (int r = 0; r < rows; r++) {
-        for (int c = 0; c < cols; c++) {
-            tmp[c].re = data_re[r * cols + c];
-            tmp[c].im = data_im[r * cols + c];
-        }
-        fft(tmp, cols);
-        for (int c = 0; c < cols; c++) {
-            data_re[r * cols + c] = tmp[c].re;
-            data_im[r * cols + c] = tmp[c].im;
-        }
-    }
+/*
+ * Both passes are batched calls on the split planes:
+ *   rows    — contiguous, transformed in place back to back
+ *   columns — stride = cols; gathered 8 columns at a time so each row
+ *             access reads neighbouring elements (see fft_execute_many)
+ *
+ * Each pass is split into bands of rows / columns across the thread
+ * pool; plans are read-only during execution, so any size can share
+ * one cached plan between bands.
+ */
+typedef struct {
+    const FftPlan *prow, *pcol;
+    double *re, *im;
+    int cols, inverse;
+} Fft2dJob;
 
-    /* FFT along each column */
-    for (int c = 0; c < cols; c++) {
-        for (int r = 0; r < rows; r++) {
-            tmp[r].re = data_re[r * cols + c];
-            tmp[r].im = data_im[r * cols + c];
-        }
-        fft(tmp, rows);
-        for (int r = 0; r < rows; r++) {
-            data_re[r * cols + c] = tmp[r].re;
-            data_im[r * cols + c] = tmp[r].im;
-        }
-    }
+static void fft2d_row_band(void *ctx, int r0, int r1)
+{
+    const Fft2dJob *job = (const Fft2dJob *)ctx;
+    size_t off = (size_t)r0 * (size_t)job->cols;
+    if (job->inverse)
+        ifft_execute_many_split(job->prow, job->re + off, job->im + off,
+                                r1 - r0, 1, job->cols);
+    else
+        fft_execute_many_split(job->prow, job->re + off, job->im + off,
+                               r1 - r0, 1, job->cols);
+}
 
-    free(tmp);
+static void fft2d_col_band(void *ctx, int c0, int c1)
+{
+    const Fft2dJob *job = (const Fft2dJob *)ctx;
+    if (job->inverse)
+        ifft_execute_many_split(job->pcol, job->re + c0, job->im + c0,
+                                c1 - c0, job->cols, 1);
+    else
+        fft_execute_many_split(job->pcol, job->re + c0, job->im + c0,
+                               c1 - c0, job->cols, 1);
 }
 
-void ifft2d(double *data_re, double *data_im, int rows, int cols)
+static void fft2d_dir(double *data_re, double *data_im, int rows, int cols,
+                      int inverse)
 {
-    Complex *tmp = (Complex *)malloc((size_t)(rows > cols ? rows : cols) * sizeof(Complex));
+    const FftPlan *prow = fft_plan_cached(cols);
+    const FftPlan *pcol = fft_plan_cached(rows);
+    if (!prow || !pcol) return;
 
-    /* IFFT along each row */
-    for (int r = 0; r < rows; r++) {
-        for (int c = 0; c < cols; c++) {
-            tmp[c].re = data_re[r * cols + c];
-            tmp[c].im = data_im[r * cols + c];
-        }
-        ifft(tmp, cols);
-        for (int c = 0; c < cols; c++) {
-            data_re[r * cols + c] = tmp[c].re;
-            data_im[r * cols + c] = tmp[c].im;
-        }
-    }
+    Fft2dJob job = { prow, pcol, data_re, data_im, cols, inverse };
 
-    /* IFFT along each column */
-    for (int c = 0; c < cols; c++) {
-        for (int r = 0; r < rows; r++) {
-            tmp[r].re = data_re[r * cols + c];
-            tmp[r].im = data_im[r * cols + c];
-        }
-        ifft(tmp, rows);
-        for (int r = 0; r < rows; r++) {
-            data_re[r * cols + c] = tmp[r].re;
-            data_im[r * cols + c] = tmp[r].im;
-        }
-    }
+    /* Bands of >= 8 columns keep the 8-wide column blocks whole */
+    dsp_parallel_for(rows, 1, fft2d_row_band, &job);
+    dsp_parallel_for(cols, 8, fft2d_col_band, &job);
+}
 
-    free(tmp);
+void fft2d(double *data_re, double *data_im, int rows, int cols)
+{
+    fft2d_dir(data_re, data_im, rows, cols, 0);
+}
+
+void ifft2d(double *data_re, double *data_im, int rows, int cols)
+{
+    fft2d_dir(data_re, data_im, rows, cols, 1);
 }
 
 /* ================================================================== */
@@ -235,13 +262,8 @@ void filter2d_freq(const double *img, int rows, int cols,
 
     fft2d(re, im, rows, cols);
 
-    /* Multiply: X·H */
-    for (int i = 0; i < N; i++) {
-        double a = re[i], b = im[i];
-        double c = H_re[i], d = H_im[i];
-        re[i] = a * c - b * d;
-        im[i] = a * d + b * c;
-    }
+    /* Multiply: X·H, split planes (SIMD) */
+    simd_cmul_split(re, im, re, im, H_re, H_im, N);
 
     ifft2d(re, im, rows, cols);
 
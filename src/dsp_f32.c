@@ -0,0 +1,830 @@
+/**
+ * @file dsp_f32.c
+ * @brief Single-precision (float32) FFT, FIR, SOS, OLA/OLS, Welch and
+ *        ring buffer.
+ *
+ * Each routine mirrors its double counterpart line for line (fft.c,
+ * filter.c, iir.c, streaming.c, spectrum.c, realtime.c) with float
+ * storage and arithmetic; only tables and window values are computed
+ * in double and rounded once.
+ *
+ * ── Float FFT engine ────────────────────────────────────────────
+ *
+ *   N = 2^k:   table bit-reversal → [radix-2] → radix-4 stages
+ *              (simd_radix4_stage_f32: 4 ComplexF per AVX2 op)
+ *
+ *   other N:   ComplexF ──► Complex ──► fft_execute(wide) ──► ComplexF
+ *
+ * @see include/dsp_f32.h
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "dsp_f32.h"
+#include "simd.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* ================================================================== */
+/*  FFT plans                                                         */
+/* ================================================================== */
+
+static int log2_exact(int n)
+{
+    if (n < 1 || (n & (n - 1)) != 0) return -1;
+    int l = 0;
+    while ((1 << l) < n) l++;
+    return l;
+}
+
+/* Same tables as plan_init_pow2() in fft.c, stored as float */
+static int plan_init_pow2_f32(FftPlanF *p)
+{
+    int n = p->n;
+    int first_q = (p->log2n & 1) ? 2 : 1;
+    int n_stage_tw = 0;
+    for (int q = first_q; q < n; q <<= 2)
+        n_stage_tw += 3 * q;
+
+    p->swaps = (int *)malloc((size_t)(n > 1 ? n : 1) * sizeof(int));
+    p->stage_twiddle = (ComplexF *)malloc((size_t)(n_stage_tw > 0 ? n_stage_tw : 1)
+                                          * sizeof(ComplexF));
+    if (!p->swaps || !p->stage_twiddle)
+        return -1;
+
+    int j = 0;
+    for (int i = 0; i < n - 1; i++) {
+        if (i < j) {
+            p->swaps[2 * p->n_swaps]     = i;
+            p->swaps[2 * p->n_swaps + 1] = j;
+            p->n_swaps++;
+        }
+        int m = n >> 1;
+        while (m >= 1 && j >= m) {
+            j -= m;
+            m >>= 1;
+        }
+        j += m;
+    }
+
+    ComplexF *tw = p->stage_twiddle;
+    for (int q = first_q; q < n; q <<= 2) {
+        double base = -2.0 * M_PI / (double)(4 * q);
+        for (int m = 1; m <= 3; m++) {
+            for (int k = 0; k < q; k++) {
+                tw->re = (float)cos(base * (double)(m * k));
+                tw->im = (float)sin(base * (double)(m * k));
+                tw++;
+            }
+        }
+    }
+    return 0;
+}
+
+FftPlanF *fft_plan_create_f32(int n)
+{
+    if (n < 1) return NULL;
+
+    FftPlanF *p = (FftPlanF *)calloc(1, sizeof(FftPlanF));
+    if (!p) return NULL;
+    p->n = n;
+    p->log2n = log2_exact(n);
+
+    int rc;
+    if (p->log2n >= 0) {
+        rc = plan_init_pow2_f32(p);
+    } else {
+        p->wide = fft_plan_create(n);
+        rc = p->wide ? 0 : -1;
+    }
+    if (rc != 0) {
+        fft_plan_destroy_f32(p);
+        return NULL;
+    }
+    return p;
+}
+
+void fft_plan_destroy_f32(FftPlanF *p)
+{
+    if (!p) return;
+    free(p->swaps);
+    free(p->stage_twiddle);
+    fft_plan_destroy(p->wide);
+    free(p);
+}
+
+static void radix4_execute_f32(const FftPlanF *p, ComplexF *x)
+{
+    int n = p->n;
+
+    for (int s = 0; s < p->n_swaps; s++) {
+        int i = p->swaps[2 * s];
+        int j = p->swaps[2 * s + 1];
+        ComplexF tmp = x[i];
+        x[i] = x[j];
+        x[j] = tmp;
+    }
+
+    int q = 1;
+    if (p->log2n & 1) {
+        for (int i = 0; i < n; i += 2) {
+            ComplexF u = x[i];
+            ComplexF v = x[i + 1];
+            x[i].re     = u.re + v.re;  x[i].im     = u.im + v.im;
+            x[i + 1].re = u.re - v.re;  x[i + 1].im = u.im - v.im;
+        }
+        q = 2;
+    }
+
+    const ComplexF *tw = p->stage_twiddle;
+    for (; q < n; q <<= 2) {
+        simd_radix4_stage_f32(x, n, q, tw);
+        tw += 3 * q;
+    }
+}
+
+/* Non-power-of-2: round-trip through the double engine */
+static int wide_execute_f32(const FftPlanF *p, ComplexF *x)
+{
+    int n = p->n;
+    Complex *t = (Complex *)malloc((size_t)n * sizeof(Complex));
+    if (!t) return -1;
+    for (int i = 0; i < n; i++) {
+        t[i].re = x[i].re;
+        t[i].im = x[i].im;
+    }
+    fft_execute(p->wide, t);
+    for (int i = 0; i < n; i++) {
+        x[i].re = (float)t[i].re;
+        x[i].im = (float)t[i].im;
+    }
+    free(t);
+    return 0;
+}
+
+int fft_execute_f32(const FftPlanF *p, ComplexF *x)
+{
+    if (p->n <= 1) return 0;
+    if (p->log2n < 0)
+        return wide_execute_f32(p, x);
+    radix4_execute_f32(p, x);
+    return 0;
+}
+
+int ifft_execute_f32(const FftPlanF *p, ComplexF *x)
+{
+    int n = p->n;
+    for (int i = 0; i < n; i++)
+        x[i].im = -x[i].im;
+
+    if (fft_execute_f32(p, x) != 0) {
+        for (int i = 0; i < n; i++)
+            x[i].im = -x[i].im;
+        return -1;
+    }
+
+    float scale = 1.0f / (float)n;
+    for (int i = 0; i < n; i++) {
+        x[i].re *= scale;
+        x[i].im = -x[i].im * scale;
+    }
+    return 0;
+}
+
+/* ================================================================== */
+/*  Real-input FFT (same packing as rfft_execute in fft.c)            */
+/* ================================================================== */
+
+RfftPlanF *rfft_plan_create_f32(int n)
+{
+    if (n < 2 || (n & 1)) return NULL;
+
+    RfftPlanF *p = (RfftPlanF *)calloc(1, sizeof(RfftPlanF));
+    if (!p) return NULL;
+    p->n = n;
+    p->half = fft_plan_create_f32(n / 2);
+    p->split = (ComplexF *)malloc((size_t)(n / 4 + 1) * sizeof(ComplexF));
+    if (!p->half || !p->split) {
+        rfft_plan_destroy_f32(p);
+        return NULL;
+    }
+    for (int k = 0; k <= n / 4; k++) {
+        double angle = -2.0 * M_PI * (double)k / (double)n;
+        p->split[k].re = (float)cos(angle);
+        p->split[k].im = (float)sin(angle);
+    }
+    return p;
+}
+
+void rfft_plan_destroy_f32(RfftPlanF *p)
+{
+    if (!p) return;
+    fft_plan_destroy_f32(p->half);
+    free(p->split);
+    free(p);
+}
+
+int rfft_execute_f32(const RfftPlanF *p, const float *in, ComplexF *out)
+{
+    int M = p->n / 2;
+    for (int m = 0; m < M; m++) {
+        out[m].re = in[2 * m];
+        out[m].im = in[2 * m + 1];
+    }
+    if (fft_execute_f32(p->half, out) != 0)
+        return -1;
+
+    float z0r = out[0].re, z0i = out[0].im;
+    out[0].re = z0r + z0i;  out[0].im = 0.0f;
+    out[M].re = z0r - z0i;  out[M].im = 0.0f;
+
+    for (int k = 1; k <= M / 2; k++) {
+        ComplexF a = out[k];
+        ComplexF b = out[M - k];
+        ComplexF w = p->split[k];
+
+        float er = 0.5f * (a.re + b.re), ei = 0.5f * (a.im - b.im);
+        float or_ = 0.5f * (a.im + b.im), oi = -0.5f * (a.re - b.re);
+
+        float tr = w.re * or_ - w.im * oi;
+        float ti = w.re * oi + w.im * or_;
+
+        out[k].re     = er + tr;  out[k].im     = ei + ti;
+        out[M - k].re = er - tr;  out[M - k].im = -(ei - ti);
+    }
+    return 0;
+}
+
+int irfft_execute_f32(const RfftPlanF *p, ComplexF *in, float *out)
+{
+    int M = p->n / 2;
+
+    float x0 = in[0].re, xm = in[M].re;
+    in[0].re = 0.5f * (x0 + xm);
+    in[0].im = 0.5f * (x0 - xm);
+
+    for (int k = 1; k <= M / 2; k++) {
+        ComplexF a = in[k];
+        ComplexF b = in[M - k];
+        ComplexF w = p->split[k];
+
+        float er = 0.5f * (a.re + b.re), ei = 0.5f * (a.im - b.im);
+        float dr = 0.5f * (a.re - b.re), di = 0.5f * (a.im + b.im);
+
+        float or_ = w.re * dr + w.im * di;
+        float oi  = w.re * di - w.im * dr;
+
+        in[k].re     = er - oi;  in[k].im     = ei + or_;
+        in[M - k].re = er + oi;  in[M - k].im = -ei + or_;
+    }
+
+    if (ifft_execute_f32(p->half, in) != 0)
+        return -1;
+
+    for (int m = 0; m < M; m++) {
+        out[2 * m]     = in[m].re;
+        out[2 * m + 1] = in[m].im;
+    }
+    return 0;
+}
+
+/* ================================================================== */
+/*  Plan cache (same layout as fft.c: pow2 slots + list)              */
+/* ================================================================== */
+
+#define F32_PLAN_CACHE_SLOTS 31
+
+static FftPlanF  *plan_cache[F32_PLAN_CACHE_SLOTS];
+static RfftPlanF *rplan_cache[F32_PLAN_CACHE_SLOTS];
+
+static FftPlanF  **plan_list;
+static RfftPlanF **rplan_list;
+static int n_plan_list, n_rplan_list;
+
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const FftPlanF *plan_cached_locked(int n)
+{
+    if (n < 1) return NULL;
+    int log2n = log2_exact(n);
+    if (log2n >= 0) {
+        if (log2n >= F32_PLAN_CACHE_SLOTS) return NULL;
+        if (!plan_cache[log2n])
+            plan_cache[log2n] = fft_plan_create_f32(n);
+        return plan_cache[log2n];
+    }
+
+    for (int i = 0; i < n_plan_list; i++)
+        if (plan_list[i]->n == n) return plan_list[i];
+
+    FftPlanF **grown = (FftPlanF **)realloc(plan_list,
+                                            (size_t)(n_plan_list + 1) * sizeof(FftPlanF *));
+    if (!grown) return NULL;
+    plan_list = grown;
+    FftPlanF *p = fft_plan_create_f32(n);
+    if (p) plan_list[n_plan_list++] = p;
+    return p;
+}
+
+const FftPlanF *fft_plan_cached_f32(int n)
+{
+    pthread_mutex_lock(&cache_lock);
+    const FftPlanF *p = plan_cached_locked(n);
+    pthread_mutex_unlock(&cache_lock);
+    return p;
+}
+
+static const RfftPlanF *rplan_cached_locked(int n)
+{
+    if (n < 2 || (n & 1)) return NULL;
+    int log2n = log2_exact(n);
+    if (log2n >= 0) {
+        if (log2n >= F32_PLAN_CACHE_SLOTS) return NULL;
+        if (!rplan_cache[log2n])
+            rplan_cache[log2n] = rfft_plan_create_f32(n);
+        return rplan_cache[log2n];
+    }
+
+    for (int i = 0; i < n_rplan_list; i++)
+        if (rplan_list[i]->n == n) return rplan_list[i];
+
+    RfftPlanF **grown = (RfftPlanF **)realloc(rplan_list,
+                                              (size_t)(n_rplan_list + 1) * sizeof(RfftPlanF *));
+    if (!grown) return NULL;
+    rplan_list = grown;
+    RfftPlanF *p = rfft_plan_create_f32(n);
+    if (p) rplan_list[n_rplan_list++] = p;
+    return p;
+}
+
+const RfftPlanF *rfft_plan_cached_f32(int n)
+{
+    pthread_mutex_lock(&cache_lock);
+    const RfftPlanF *p = rplan_cached_locked(n);
+    pthread_mutex_unlock(&cache_lock);
+    return p;
+}
+
+void fft_plan_cache_clear_f32(void)
+{
+    pthread_mutex_lock(&cache_lock);
+    for (int i = 0; i < F32_PLAN_CACHE_SLOTS; i++) {
+        fft_plan_destroy_f32(plan_cache[i]);
+        rfft_plan_destroy_f32(rplan_cache[i]);
+        plan_cache[i] = NULL;
+        rplan_cache[i] = NULL;
+    }
+    for (int i = 0; i < n_plan_list; i++)
+        fft_plan_destroy_f32(plan_list[i]);
+    for (int i = 0; i < n_rplan_list; i++)
+        rfft_plan_destroy_f32(rplan_list[i]);
+    free(plan_list);
+    free(rplan_list);
+    plan_list = NULL;
+    rplan_list = NULL;
+    n_plan_list = n_rplan_list = 0;
+    pthread_mutex_unlock(&cache_lock);
+}
+
+int fft_f32(ComplexF *x, int n)
+{
+    if (n <= 1) return n == 1 ? 0 : -1;
+    const FftPlanF *p = fft_plan_cached_f32(n);
+    return p ? fft_execute_f32(p, x) : -1;
+}
+
+int ifft_f32(ComplexF *x, int n)
+{
+    if (n <= 1) return n == 1 ? 0 : -1;
+    const FftPlanF *p = fft_plan_cached_f32(n);
+    return p ? ifft_execute_f32(p, x) : -1;
+}
+
+int rfft_f32(const float *in, ComplexF *out, int n)
+{
+    const RfftPlanF *p = rfft_plan_cached_f32(n);
+    return p ? rfft_execute_f32(p, in, out) : -1;
+}
+
+/* ================================================================== */
+/*  FIR                                                               */
+/* ================================================================== */
+
+void fir_filter_f32(const float *in, float *out, int n,
+                    const float *h, int order)
+{
+    for (int i = 0; i < n; i++) {
+        /* Taps past the start of the signal see zeros: stop at k = i */
+        int kmax = i < order - 1 ? i : order - 1;
+        float sum = 0.0f;
+        for (int k = 0; k <= kmax; k++)
+            sum += h[k] * in[i - k];
+        out[i] = sum;
+    }
+}
+
+/* ================================================================== */
+/*  Biquad / SOS (Direct Form I, as iir.c)                            */
+/* ================================================================== */
+
+void sos_init_f32(SOSCascadeF *sos)
+{
+    memset(sos, 0, sizeof(SOSCascadeF));
+    sos->gain = 1.0f;
+}
+
+void sos_to_f32(SOSCascadeF *dst, const SOSCascade *src)
+{
+    sos_init_f32(dst);
+    dst->n_sections = src->n_sections;
+    dst->gain = (float)src->gain;
+    for (int i = 0; i < src->n_sections; i++) {
+        const Biquad *b = &src->sections[i];
+        BiquadF *f = &dst->sections[i];
+        f->b0 = (float)b->b0;
+        f->b1 = (float)b->b1;
+        f->b2 = (float)b->b2;
+        f->a1 = (float)b->a1;
+        f->a2 = (float)b->a2;
+    }
+}
+
+float biquad_process_df1_f32(const BiquadF *bq, BiquadDF1StateF *s, float x)
+{
+    float y = bq->b0 * x + bq->b1 * s->x1 + bq->b2 * s->x2
+                          - bq->a1 * s->y1 - bq->a2 * s->y2;
+    s->x2 = s->x1;
+    s->x1 = x;
+    s->y2 = s->y1;
+    s->y1 = y;
+    return y;
+}
+
+void biquad_process_block_f32(const BiquadF *bq, BiquadDF1StateF *s,
+                              const float *in, float *out, int n)
+{
+    /* Coefficients and state in locals so they stay in registers */
+    float b0 = bq->b0, b1 = bq->b1, b2 = bq->b2, a1 = bq->a1, a2 = bq->a2;
+    float x1 = s->x1, x2 = s->x2, y1 = s->y1, y2 = s->y2;
+
+    for (int i = 0; i < n; i++) {
+        float x = in[i];
+        float y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+        x2 = x1;  x1 = x;
+        y2 = y1;  y1 = y;
+        out[i] = y;
+    }
+
+    s->x1 = x1;  s->x2 = x2;
+    s->y1 = y1;  s->y2 = y2;
+}
+
+float sos_process_sample_f32(SOSCascadeF *sos, float x)
+{
+    float y = x;
+    for (int i = 0; i < sos->n_sections; i++)
+        y = biquad_process_df1_f32(&sos->sections[i], &sos->states[i], y);
+    return y * sos->gain;
+}
+
+void sos_process_block_f32(SOSCascadeF *sos, const float *in, float *out, int n)
+{
+    if (sos->n_sections == 0) {
+        for (int i = 0; i < n; i++)
+            out[i] = in[i] * sos->gain;
+        return;
+    }
+
+    /* Section 0 reads in, the rest run in place on out */
+    biquad_process_block_f32(&sos->sections[0], &sos->states[0], in, out, n);
+    for (int s = 1; s < sos->n_sections; s++)
+        biquad_process_block_f32(&sos->sections[s], &sos->states[s], out, out, n);
+
+    for (int i = 0; i < n; i++)
+        out[i] *= sos->gain;
+}
+
+/* ================================================================== */
+/*  Overlap-Add / Overlap-Save (as streaming.c)                       */
+/* ================================================================== */
+
+int ola_init_f32(OlaStateF *s, const float *h, int filter_len, int block_size)
+{
+    memset(s, 0, sizeof(*s));
+    if (!h || filter_len < 1 || block_size < 1) return -1;
+
+    s->filter_len = filter_len;
+    s->block_size = block_size;
+    s->fft_size = next_power_of_2(block_size + filter_len - 1);
+    if (s->fft_size < 2) s->fft_size = 2;
+    s->plan = rfft_plan_cached_f32(s->fft_size);
+    if (!s->plan) return -1;
+
+    int n_bins = s->fft_size / 2 + 1;
+    s->H      = (ComplexF *)calloc((size_t)n_bins, sizeof(ComplexF));
+    s->Xbuf   = (ComplexF *)calloc((size_t)n_bins, sizeof(ComplexF));
+    s->tail   = (float *)calloc((size_t)(s->fft_size - block_size), sizeof(float));
+    s->padded = (float *)calloc((size_t)s->fft_size, sizeof(float));
+
+    if (!s->H || !s->Xbuf || !s->tail || !s->padded) {
+        ola_free_f32(s);
+        return -1;
+    }
+
+    memcpy(s->padded, h, (size_t)filter_len * sizeof(float));
+    if (rfft_execute_f32(s->plan, s->padded, s->H) != 0) {
+        ola_free_f32(s);
+        return -1;
+    }
+    return 0;
+}
+
+void ola_process_f32(OlaStateF *s, const float *in, float *out)
+{
+    int N = s->fft_size;
+    int L = s->block_size;
+    int tail_len = N - L;
+
+    memset(s->padded, 0, (size_t)N * sizeof(float));
+    memcpy(s->padded, in, (size_t)L * sizeof(float));
+
+    /* N is a power of 2: the float engine never allocates here */
+    rfft_execute_f32(s->plan, s->padded, s->Xbuf);
+    simd_cmul_f32(s->Xbuf, s->Xbuf, s->H, N / 2 + 1);
+    irfft_execute_f32(s->plan, s->Xbuf, s->padded);
+
+    /* Tail is N − L long: may be shorter or longer than the block */
+    int carry = tail_len < L ? tail_len : L;
+    for (int i = 0; i < carry; i++)
+        out[i] = s->padded[i] + s->tail[i];
+    for (int i = carry; i < L; i++)
+        out[i] = s->padded[i];
+    for (int i = 0; i < tail_len; i++) {
+        float old = L + i < tail_len ? s->tail[L + i] : 0.0f;
+        s->tail[i] = s->padded[L + i] + old;
+    }
+}
+
+void ola_free_f32(OlaStateF *s)
+{
+    if (s) {
+        free(s->H);      s->H      = NULL;
+        free(s->Xbuf);   s->Xbuf   = NULL;
+        free(s->tail);   s->tail   = NULL;
+        free(s->padded); s->padded = NULL;
+    }
+}
+
+int ols_init_f32(OlsStateF *s, const float *h, int filter_len, int block_size)
+{
+    memset(s, 0, sizeof(*s));
+    if (!h || filter_len < 1 || block_size < 1) return -1;
+
+    s->filter_len = filter_len;
+    s->block_size = block_size;
+    s->fft_size = next_power_of_2(block_size + filter_len - 1);
+    if (s->fft_size < 2) s->fft_size = 2;
+    s->plan = rfft_plan_cached_f32(s->fft_size);
+    if (!s->plan) return -1;
+
+    int n_bins = s->fft_size / 2 + 1;
+    s->H         = (ComplexF *)calloc((size_t)n_bins, sizeof(ComplexF));
+    s->Xbuf      = (ComplexF *)calloc((size_t)n_bins, sizeof(ComplexF));
+    s->input_buf = (float *)calloc((size_t)s->fft_size, sizeof(float));
+    s->ybuf      = (float *)calloc((size_t)s->fft_size, sizeof(float));
+
+    if (!s->H || !s->Xbuf || !s->input_buf || !s->ybuf) {
+        ols_free_f32(s);
+        return -1;
+    }
+
+    memcpy(s->ybuf, h, (size_t)filter_len * sizeof(float));
+    if (rfft_execute_f32(s->plan, s->ybuf, s->H) != 0) {
+        ols_free_f32(s);
+        return -1;
+    }
+    return 0;
+}
+
+void ols_process_f32(OlsStateF *s, const float *in, float *out)
+{
+    int N = s->fft_size;
+    int M = s->filter_len;
+    int L = s->block_size;
+
+    memmove(s->input_buf, s->input_buf + L, (size_t)(M - 1) * sizeof(float));
+    memcpy(s->input_buf + (M - 1), in, (size_t)L * sizeof(float));
+
+    int filled = M - 1 + L;
+    if (filled < N)
+        memset(s->input_buf + filled, 0, (size_t)(N - filled) * sizeof(float));
+
+    rfft_execute_f32(s->plan, s->input_buf, s->Xbuf);
+    simd_cmul_f32(s->Xbuf, s->Xbuf, s->H, N / 2 + 1);
+    irfft_execute_f32(s->plan, s->Xbuf, s->ybuf);
+
+    memcpy(out, s->ybuf + (M - 1), (size_t)L * sizeof(float));
+}
+
+void ols_free_f32(OlsStateF *s)
+{
+    if (s) {
+        free(s->H);         s->H         = NULL;
+        free(s->Xbuf);      s->Xbuf      = NULL;
+        free(s->input_buf); s->input_buf = NULL;
+        free(s->ybuf);      s->ybuf      = NULL;
+    }
+}
+
+/* ================================================================== */
+/*  Welch PSD (as spectrum.c)                                         */
+/* ================================================================== */
+
+int welch_psd_f32(const float *x, int n, float *psd, int nfft,
+                  int seg_len, int overlap, window_fn win)
+{
+    if (!x || !psd || n <= 0 || nfft < 2 || (nfft & 1))
+        return -1;
+    if (seg_len <= 0 || seg_len > nfft || overlap < 0 || overlap >= seg_len)
+        return -1;
+
+    int n_bins = nfft / 2 + 1;
+    int hop    = seg_len - overlap;
+    int n_segs = 0;
+
+    const RfftPlanF *plan = rfft_plan_cached_f32(nfft);
+    float    *w   = (float *)malloc((size_t)seg_len * sizeof(float));
+    float    *seg = (float *)calloc((size_t)nfft, sizeof(float));
+    ComplexF *buf = (ComplexF *)malloc((size_t)n_bins * sizeof(ComplexF));
+    if (!plan || !w || !seg || !buf) {
+        free(w);
+        free(seg);
+        free(buf);
+        return -1;
+    }
+
+    double win_power = 0.0;
+    for (int i = 0; i < seg_len; i++) {
+        double wi = win ? win(seg_len, i) : 1.0;
+        w[i] = (float)wi;
+        win_power += wi * wi;
+    }
+    if (win_power < 1e-30) win_power = (double)seg_len;
+    float scale = (float)(1.0 / win_power);
+
+    memset(psd, 0, (size_t)n_bins * sizeof(float));
+
+    for (int start = 0; start + seg_len <= n; start += hop) {
+        for (int i = 0; i < seg_len; i++)
+            seg[i] = x[start + i] * w[i];
+        if (rfft_execute_f32(plan, seg, buf) != 0) {
+            n_segs = 0;
+            break;
+        }
+        simd_power_f32(buf, psd, n_bins, scale, 1);
+        n_segs++;
+    }
+
+    free(w);
+    free(seg);
+    free(buf);
+    if (n_segs == 0) return -1;
+
+    float inv_segs = 1.0f / (float)n_segs;
+    for (int k = 0; k < n_bins; k++)
+        psd[k] *= inv_segs;
+    for (int k = 1; k < n_bins - 1; k++)
+        psd[k] *= 2.0f;
+    return n_segs;
+}
+
+/* ================================================================== */
+/*  Ring buffer (as realtime.c)                                       */
+/* ================================================================== */
+
+#if defined(__GNUC__)
+#define rbf_load_relaxed(p)     __atomic_load_n((p), __ATOMIC_RELAXED)
+#define rbf_load_acquire(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define rbf_store_release(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && \
+      !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define rbf_load_relaxed(p)     atomic_load_explicit((_Atomic int *)(p), memory_order_relaxed)
+#define rbf_load_acquire(p)     atomic_load_explicit((_Atomic int *)(p), memory_order_acquire)
+#define rbf_store_release(p, v) atomic_store_explicit((_Atomic int *)(p), (v), memory_order_release)
+#else
+#error "RingBufferF needs GCC/Clang __atomic builtins or C11 <stdatomic.h>"
+#endif
+
+RingBufferF *ring_buffer_create_f32(int capacity)
+{
+    if (capacity < 2) capacity = 2;
+    capacity = next_power_of_2(capacity);
+
+    RingBufferF *rb = (RingBufferF *)calloc(1, sizeof(RingBufferF));
+    if (!rb) return NULL;
+
+    rb->buf = (float *)calloc((size_t)capacity, sizeof(float));
+    if (!rb->buf) { free(rb); return NULL; }
+
+    rb->cap  = capacity;
+    rb->mask = capacity - 1;
+    return rb;
+}
+
+void ring_buffer_destroy_f32(RingBufferF *rb)
+{
+    if (!rb) return;
+    free(rb->buf);
+    free(rb);
+}
+
+int ring_buffer_available_f32(const RingBufferF *rb)
+{
+    int tail = rbf_load_acquire(&rb->tail);
+    int head = rbf_load_acquire(&rb->head);
+    return (head - tail) & rb->mask;
+}
+
+int ring_buffer_space_f32(const RingBufferF *rb)
+{
+    int head = rbf_load_acquire(&rb->head);
+    int tail = rbf_load_acquire(&rb->tail);
+    return rb->cap - 1 - ((head - tail) & rb->mask);
+}
+
+int ring_buffer_write_f32(RingBufferF *rb, const float *data, int n)
+{
+    int head  = rbf_load_relaxed(&rb->head);
+    int space = rb->cap - 1 - ((head - rb->tail_cache) & rb->mask);
+    if (n > space) {
+        rb->tail_cache = rbf_load_acquire(&rb->tail);
+        space = rb->cap - 1 - ((head - rb->tail_cache) & rb->mask);
+        if (n > space) n = space;
+    }
+    if (n <= 0) return 0;
+
+    int first = rb->cap - head;
+    if (first > n) first = n;
+    memcpy(rb->buf + head, data, (size_t)first * sizeof(float));
+    memcpy(rb->buf, data + first, (size_t)(n - first) * sizeof(float));
+
+    rbf_store_release(&rb->head, (head + n) & rb->mask);
+    return n;
+}
+
+static void rbf_copy_out(const RingBufferF *rb, int pos, float *data, int n)
+{
+    int first = rb->cap - pos;
+    if (first > n) first = n;
+    memcpy(data, rb->buf + pos, (size_t)first * sizeof(float));
+    memcpy(data + first, rb->buf, (size_t)(n - first) * sizeof(float));
+}
+
+int ring_buffer_read_f32(RingBufferF *rb, float *data, int n)
+{
+    int tail  = rbf_load_relaxed(&rb->tail);
+    int avail = (rb->head_cache - tail) & rb->mask;
+    if (n > avail) {
+        rb->head_cache = rbf_load_acquire(&rb->head);
+        avail = (rb->head_cache - tail) & rb->mask;
+        if (n > avail) n = avail;
+    }
+    if (n <= 0) return 0;
+
+    rbf_copy_out(rb, tail, data, n);
+    rbf_store_release(&rb->tail, (tail + n) & rb->mask);
+    return n;
+}
+
+int ring_buffer_peek_f32(const RingBufferF *rb, float *data, int n)
+{
+    int tail  = rbf_load_relaxed(&rb->tail);
+    int avail = (rbf_load_acquire(&rb->head) - tail) & rb->mask;
+    if (n > avail) n = avail;
+    if (n <= 0) return 0;
+
+    rbf_copy_out(rb, tail, data, n);
+    return n;
+}
+
+int ring_buffer_skip_f32(RingBufferF *rb, int n)
+{
+    int tail  = rbf_load_relaxed(&rb->tail);
+    int avail = (rbf_load_acquire(&rb->head) - tail) & rb->mask;
+    if (n > avail) n = avail;
+    if (n <= 0) return 0;
+    rbf_store_release(&rb->tail, (tail + n) & rb->mask);
+    return n;
+}
+
+void ring_buffer_reset_f32(RingBufferF *rb)
+{
+    rb->head = rb->tail = 0;
+    rb->head_cache = rb->tail_cache = 0;
+}
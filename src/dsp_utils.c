@@ -10,6 +10,9 @@
 #define _GNU_SOURCE
 #include "dsp_utils.h"
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -86,6 +89,46 @@ Complex complex_from_polar(double mag, double phase) {
     return (Complex){ mag * cos(phase), mag * sin(phase) };
 }
 
+/* ════════════════════════════════════════════════════════════════════
+ *  Split complex buffers
+ *
+ *  One allocation holds both planes: re = block, im = block + n.
+ * ════════════════════════════════════════════════════════════════════ */
+
+SplitComplex *split_complex_create(int n) {
+    if (n < 1) return NULL;
+    SplitComplex *s = (SplitComplex *)malloc(sizeof(SplitComplex));
+    if (!s) return NULL;
+    s->re = (double *)calloc((size_t)2 * (size_t)n, sizeof(double));
+    if (!s->re) {
+        free(s);
+        return NULL;
+    }
+    s->im = s->re + n;
+    s->n  = n;
+    return s;
+}
+
+void split_complex_destroy(SplitComplex *s) {
+    if (!s) return;
+    free(s->re);
+    free(s);
+}
+
+void complex_to_split(const Complex *x, double *re, double *im, int n) {
+    for (int k = 0; k < n; k++) {
+        re[k] = x[k].re;
+        im[k] = x[k].im;
+    }
+}
+
+void split_to_complex(const double *re, const double *im, Complex *x, int n) {
+    for (int k = 0; k < n; k++) {
+        x[k].re = re[k];
+        x[k].im = im[k];
+    }
+}
+
 /* ════════════════════════════════════════════════════════════════════
  *  Window functions
  *  Tutorial ref: chapters/09-window-functions.md
@@ -208,6 +251,41 @@ double db_from_magnitude(double mag) {
     return 20.0 * log10(mag);
 }
 
+/* ════════════════════════════════════════════════════════════════════
+ *  Arena allocator
+ * ════════════════════════════════════════════════════════════════════ */
+
+#define DSP_ARENA_ALIGN 16
+
+void dsp_arena_init(DspArena *a, void *buf, size_t size) {
+    a->base = (unsigned char *)buf;
+    a->size = buf ? size : 0;
+    a->used = 0;
+}
+
+/**
+ * @brief Carve the next block out of the arena.
+ *
+ * The start is rounded up to DSP_ARENA_ALIGN bytes in absolute address
+ * terms, so alignment holds whatever the alignment of the caller's buffer.
+ *
+ * @return Zeroed block, or NULL if fewer than bytes remain.
+ */
+void *dsp_arena_alloc(DspArena *a, size_t bytes) {
+    uintptr_t p = (uintptr_t)(a->base + a->used);
+    size_t pad = (size_t)((DSP_ARENA_ALIGN - p % DSP_ARENA_ALIGN) % DSP_ARENA_ALIGN);
+    if (pad > a->size - a->used || bytes > a->size - a->used - pad)
+        return NULL;
+    unsigned char *blk = a->base + a->used + pad;
+    a->used += pad + bytes;
+    memset(blk, 0, bytes);
+    return blk;
+}
+
+void dsp_arena_reset(DspArena *a) {
+    a->used = 0;
+}
+
 /**
  * @brief Compute the root-mean-square (RMS) of a signal.
  * @param signal  Input sample array.
@@ -14,10 +14,19 @@
  *      where W = exp(-j·2π·k/N) is the "twiddle factor"
  *
  * Complexity: O(N log N) — compared to O(N²) for the naive DFT.
+ *
+ * PLANS:
+ *   fft_radix2() below is the textbook version: it recomputes the
+ *   twiddles and walks the bit-reversal indices on every call.
+ *   FftPlan moves both into tables built once per size, and fft()
+ *   runs on a cached plan with a radix-4 butterfly engine.
  */
 
 #define _GNU_SOURCE
 #include "fft.h"
+#include "simd.h"
+#include "threadpool.h"
+#include <pthread.h>
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -80,7 +89,7 @@ static void bit_reverse_permute(Complex *x, int n) {
  *  a visual walkthrough of an 8-point FFT.
  * ════════════════════════════════════════════════════════════════════ */
 
-void fft(Complex *x, int n) {
+void fft_radix2(Complex *x, int n) {
     if (n <= 1) return;
 
     /* Step 1: reorder data by bit-reversal */
@@ -126,17 +135,1221 @@ void fft(Complex *x, int n) {
     }
 }
 
+/* ════════════════════════════════════════════════════════════════════
+ *  FFT plans
+ *
+ *  Everything in fft_radix2() that depends only on N is moved into
+ *  tables built once:
+ *
+ *    swaps[]          list of (i, j) pairs with i < j = bitrev(i)
+ *    twiddle[]        W[k] = exp(-j·2π·k/N),  k = 0 .. N/2-1
+ *    stage_twiddle[]  W_L^k, W_L^2k, W_L^3k planes per radix-4 stage
+ *
+ *  Radix-4 engine
+ *  ──────────────
+ *  Two radix-2 stages (lengths L/2 and L) are fused into one radix-4
+ *  stage of length L.  After bit-reversal, the four quarter-length
+ *  sub-DFTs of a group sit in the order
+ *
+ *     x[i0] = A   DFT of x[4m]      x[i2] = B   DFT of x[4m+1]
+ *     x[i1] = C   DFT of x[4m+2]    x[i3] = D   DFT of x[4m+3]
+ *
+ *  With a = A, c' = W^2k·C, b' = W^k·B, d' = W^3k·D  (W = W_L):
+ *
+ *     X[k]       = (a + c') + (b' + d')
+ *     X[k + L/4] = (a − c') − j(b' − d')
+ *     X[k + L/2] = (a + c') − (b' + d')
+ *     X[k + 3L/4]= (a − c') + j(b' − d')
+ *
+ *  3 complex multiplies per 4 outputs instead of 4 for two radix-2
+ *  stages.  When log₂N is odd one plain radix-2 stage (W = 1) runs
+ *  first, so every power of 2 is handled.  The stage loop itself is
+ *  simd_radix4_stage() (scalar, SSE2 or AVX2, picked at run time).
+ * ════════════════════════════════════════════════════════════════════ */
+
+/* ── Hot-loop arithmetic ──────────────────────────────────────────────
+ *  complex_mul() and friends live in dsp_utils.c and cannot be inlined
+ *  across translation units; the plan engines use these local copies.
+ */
+static inline Complex cmul(Complex a, Complex b) {
+    Complex r = { a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re };
+    return r;
+}
+
+static inline Complex cadd(Complex a, Complex b) {
+    Complex r = { a.re + b.re, a.im + b.im };
+    return r;
+}
+
+static inline Complex csub(Complex a, Complex b) {
+    Complex r = { a.re - b.re, a.im - b.im };
+    return r;
+}
+
+static int log2_exact(int n) {
+    if (n < 1 || (n & (n - 1)) != 0) return -1;
+    int l = 0;
+    while ((1 << l) < n) l++;
+    return l;
+}
+
+/* Split n into radices 4, 2, 3, 5, 7.  Returns the stage count, or 0
+ * if n has a prime factor above 7. */
+static int factorize(int n, int *factors) {
+    static const int primes[] = { 2, 3, 5, 7 };
+    int nf = 0;
+    while (n % 4 == 0) { factors[nf++] = 4; n /= 4; }
+    for (int i = 0; i < 4; i++) {
+        while (n % primes[i] == 0) {
+            factors[nf++] = primes[i];
+            n /= primes[i];
+        }
+    }
+    return n == 1 ? nf : 0;
+}
+
+static int plan_init_pow2(FftPlan *p) {
+    int n = p->n;
+    int log2n = p->log2n;
+
+    /* Radix-4 stages start at sub-DFT length 2 (odd log₂N) or 1 */
+    int first_q = (log2n & 1) ? 2 : 1;
+    int n_stage_tw = 0;
+    for (int q = first_q; q < n; q <<= 2)
+        n_stage_tw += 3 * q;
+
+    p->swaps = (int *)malloc((size_t)(n > 1 ? n : 1) * sizeof(int));
+    p->twiddle = (Complex *)malloc((size_t)(n > 1 ? n / 2 : 1) * sizeof(Complex));
+    p->stage_twiddle = (Complex *)malloc((size_t)(n_stage_tw > 0 ? n_stage_tw : 1)
+                                         * sizeof(Complex));
+    p->stage_twiddle_split = (double *)malloc((size_t)(n_stage_tw > 0 ? 2 * n_stage_tw : 1)
+                                              * sizeof(double));
+    if (!p->swaps || !p->twiddle || !p->stage_twiddle || !p->stage_twiddle_split)
+        return -1;
+
+    /* Bit-reversal swap list: exactly the swaps bit_reverse_permute() makes */
+    int j = 0;
+    for (int i = 0; i < n - 1; i++) {
+        if (i < j) {
+            p->swaps[2 * p->n_swaps]     = i;
+            p->swaps[2 * p->n_swaps + 1] = j;
+            p->n_swaps++;
+        }
+        int m = n >> 1;
+        while (m >= 1 && j >= m) {
+            j -= m;
+            m >>= 1;
+        }
+        j += m;
+    }
+
+    for (int k = 0; k < n / 2; k++) {
+        double angle = -2.0 * M_PI * (double)k / (double)n;
+        p->twiddle[k].re = cos(angle);
+        p->twiddle[k].im = sin(angle);
+    }
+
+    /* Per stage: W^k for all k, then W^2k, then W^3k (unit-stride for SIMD) */
+    Complex *tw = p->stage_twiddle;
+    for (int q = first_q; q < n; q <<= 2) {
+        double base = -2.0 * M_PI / (double)(4 * q);
+        for (int m = 1; m <= 3; m++) {
+            for (int k = 0; k < q; k++) {
+                tw->re = cos(base * (double)(m * k));
+                tw->im = sin(base * (double)(m * k));
+                tw++;
+            }
+        }
+    }
+
+    /* Split copy: per stage Re W^k, Im W^k, Re W^2k, Im W^2k, ... */
+    const Complex *src = p->stage_twiddle;
+    double *dst = p->stage_twiddle_split;
+    for (int q = first_q; q < n; q <<= 2) {
+        for (int m = 0; m < 3; m++) {
+            for (int k = 0; k < q; k++) {
+                dst[k]     = src[k].re;
+                dst[q + k] = src[k].im;
+            }
+            src += q;
+            dst += 2 * q;
+        }
+    }
+    return 0;
+}
+
+static int plan_init_mixed(FftPlan *p) {
+    /* Per stage: p roots exp(-j·2π·m/p), then W_{L·p}^(q·k) for
+     * k < L, q = 1 .. p-1, where L is the product of earlier radices. */
+    size_t n_tw = 0;
+    int L = 1;
+    for (int s = 0; s < p->n_factors; s++) {
+        int rad = p->factors[s];
+        n_tw += (size_t)rad + (size_t)(rad - 1) * (size_t)L;
+        L *= rad;
+    }
+
+    p->mr_twiddle = (Complex *)malloc(n_tw * sizeof(Complex));
+    if (!p->mr_twiddle)
+        return -1;
+
+    Complex *tw = p->mr_twiddle;
+    L = 1;
+    for (int s = 0; s < p->n_factors; s++) {
+        int rad = p->factors[s];
+        for (int m = 0; m < rad; m++) {
+            double angle = -2.0 * M_PI * (double)m / (double)rad;
+            tw->re = cos(angle);
+            tw->im = sin(angle);
+            tw++;
+        }
+        for (int k = 0; k < L; k++) {
+            for (int q = 1; q < rad; q++) {
+                double angle = -2.0 * M_PI * (double)(q * k) / (double)(L * rad);
+                tw->re = cos(angle);
+                tw->im = sin(angle);
+                tw++;
+            }
+        }
+        L *= rad;
+    }
+    return 0;
+}
+
+static int plan_init_bluestein(FftPlan *p) {
+    int n = p->n;
+    int m = 1;
+    while (m < 2 * n - 1) m <<= 1;
+    p->m = m;
+
+    p->conv      = fft_plan_create(m);
+    p->chirp     = (Complex *)malloc((size_t)n * sizeof(Complex));
+    p->chirp_fft = (Complex *)calloc((size_t)m, sizeof(Complex));
+    if (!p->conv || !p->chirp || !p->chirp_fft)
+        return -1;
+
+    /* w[k] = exp(-jπ·k²/N); k² is reduced mod 2N so the angle stays small */
+    for (int k = 0; k < n; k++) {
+        long long k2 = ((long long)k * k) % (2LL * n);
+        double angle = -M_PI * (double)k2 / (double)n;
+        p->chirp[k].re = cos(angle);
+        p->chirp[k].im = sin(angle);
+    }
+
+    /* b[k] = conj(w[|k|]) laid out circularly over M points */
+    for (int k = 0; k < n; k++) {
+        p->chirp_fft[k].re =  p->chirp[k].re;
+        p->chirp_fft[k].im = -p->chirp[k].im;
+        if (k > 0) p->chirp_fft[m - k] = p->chirp_fft[k];
+    }
+    fft_execute(p->conv, p->chirp_fft);
+    return 0;
+}
+
+/* Large powers of 2: N = n1·n2 with n1 = 2^⌊log₂N/2⌋, n2 = n1 or 2·n1 */
+static int plan_init_fourstep(FftPlan *p) {
+    int n = p->n;
+    p->n1 = 1 << (p->log2n / 2);
+    p->n2 = n / p->n1;
+    p->fs_cols = fft_plan_create(p->n1);
+    p->fs_rows = fft_plan_create(p->n2);
+    p->fs_tw_lo = (Complex *)malloc((size_t)p->n1 * sizeof(Complex));
+    p->fs_tw_hi = (Complex *)malloc((size_t)p->n2 * sizeof(Complex));
+    if (!p->fs_cols || !p->fs_rows || !p->fs_tw_lo || !p->fs_tw_hi)
+        return -1;
+
+    /* W_N^m = fs_tw_hi[m / n1] · fs_tw_lo[m % n1] for any m < N */
+    for (int k = 0; k < p->n1; k++) {
+        double angle = -2.0 * M_PI * (double)k / (double)n;
+        p->fs_tw_lo[k].re = cos(angle);
+        p->fs_tw_lo[k].im = sin(angle);
+    }
+    for (int k = 0; k < p->n2; k++) {
+        double angle = -2.0 * M_PI * (double)k / (double)p->n2;
+        p->fs_tw_hi[k].re = cos(angle);
+        p->fs_tw_hi[k].im = sin(angle);
+    }
+    return 0;
+}
+
+FftPlan *fft_plan_create(int n) {
+    return fft_plan_create_engine(n, FFT_ENGINE_AUTO);
+}
+
+FftPlan *fft_plan_create_engine(int n, FftEngine engine) {
+    if (n < 1) return NULL;
+    int log2n = log2_exact(n);
+    if (engine == FFT_ENGINE_FOURSTEP && log2n < 2) return NULL;
+
+    FftPlan *p = (FftPlan *)calloc(1, sizeof(FftPlan));
+    if (!p) return NULL;
+    p->n = n;
+    p->log2n = log2n;
+
+    int fourstep = engine == FFT_ENGINE_FOURSTEP ||
+                   (engine == FFT_ENGINE_AUTO && log2n >= FFT_FOURSTEP_MIN_LOG2);
+    int rc;
+    if (fourstep) {
+        rc = plan_init_fourstep(p);
+    } else if (p->log2n >= 0) {
+        rc = plan_init_pow2(p);
+    } else {
+        p->n_factors = factorize(n, p->factors);
+        rc = p->n_factors > 0 ? plan_init_mixed(p) : plan_init_bluestein(p);
+    }
+    if (rc != 0) {
+        fft_plan_destroy(p);
+        return NULL;
+    }
+    return p;
+}
+
+void fft_plan_destroy(FftPlan *p) {
+    if (!p) return;
+    free(p->swaps);
+    free(p->twiddle);
+    free(p->stage_twiddle);
+    free(p->stage_twiddle_split);
+    free(p->mr_twiddle);
+    free(p->chirp);
+    free(p->chirp_fft);
+    fft_plan_destroy(p->conv);
+    fft_plan_destroy(p->fs_cols);
+    fft_plan_destroy(p->fs_rows);
+    free(p->fs_tw_lo);
+    free(p->fs_tw_hi);
+    free(p);
+}
+
+static void radix4_execute(const FftPlan *p, Complex *x) {
+    int n = p->n;
+
+    /* Step 1: table-driven bit-reversal */
+    for (int s = 0; s < p->n_swaps; s++) {
+        int i = p->swaps[2 * s];
+        int j = p->swaps[2 * s + 1];
+        Complex tmp = x[i];
+        x[i] = x[j];
+        x[j] = tmp;
+    }
+
+    /* Step 2: one radix-2 stage (all twiddles are 1) when log₂N is odd */
+    int q = 1;
+    if (p->log2n & 1) {
+        for (int i = 0; i < n; i += 2) {
+            Complex u = x[i];
+            Complex v = x[i + 1];
+            x[i]     = cadd(u, v);
+            x[i + 1] = csub(u, v);
+        }
+        q = 2;
+    }
+
+    /* Step 3: radix-4 stages, q = quarter length (vector kernels in simd.c) */
+    const Complex *tw = p->stage_twiddle;
+    for (; q < n; q <<= 2) {
+        simd_radix4_stage(x, n, q, tw);
+        tw += 3 * q;
+    }
+}
+
+/* Same steps on split planes: identical arithmetic, no interleaving */
+static void radix4_execute_split(const FftPlan *p, double *re, double *im) {
+    int n = p->n;
+
+    for (int s = 0; s < p->n_swaps; s++) {
+        int i = p->swaps[2 * s];
+        int j = p->swaps[2 * s + 1];
+        double tr = re[i], ti = im[i];
+        re[i] = re[j];  im[i] = im[j];
+        re[j] = tr;     im[j] = ti;
+    }
+
+    int q = 1;
+    if (p->log2n & 1) {
+        for (int i = 0; i < n; i += 2) {
+            double ur = re[i], ui = im[i];
+            double vr = re[i + 1], vi = im[i + 1];
+            re[i]     = ur + vr;  im[i]     = ui + vi;
+            re[i + 1] = ur - vr;  im[i + 1] = ui - vi;
+        }
+        q = 2;
+    }
+
+    const double *tw = p->stage_twiddle_split;
+    for (; q < n; q <<= 2) {
+        simd_radix4_stage_split(re, im, n, q, tw);
+        tw += 6 * q;
+    }
+}
+
+/* ── Mixed radix (Stockham autosort) ─────────────────────────────────
+ *
+ *  Stage t views the data as a table A[k][c]: row k < L is a frequency
+ *  index of the length-L sub-DFTs done so far, column c < r = N/L picks
+ *  the sub-sequence x[c + r·i].  A radix-p stage merges p columns
+ *  (c, c + r/p, …) into one column of length L·p:
+ *
+ *     A'[k + L·s][c] = Σ_q  W_{Lp}^(q·k) · W_p^(q·s) · A[k][c + q·r/p]
+ *
+ *  Reads and writes run along c, so both are unit-stride, and the
+ *  output lands in natural order without any digit reversal.  Stages
+ *  ping-pong between x and a per-call work buffer.
+ */
+
+/* Work buffers up to this many points live on the stack, larger ones
+ * are allocated per call.  Either way the plan is never written while
+ * executing, so one cached plan can run on several threads at once. */
+#define FFT_STACK_WORK 512
+
+/* Table-free O(N²) DFT, the out-of-memory fallback for sizes
+ * fft_radix2() cannot take.  Angles come from (k·j mod N), so the
+ * error does not grow with N the way a rotated twiddle would. */
+static void fft_dft(Complex *x, int n) {
+    Complex stack_work[FFT_STACK_WORK];
+    Complex *y = n <= FFT_STACK_WORK ? stack_work
+               : (Complex *)malloc((size_t)n * sizeof(Complex));
+    if (!y) return;      /* not even N points free: x unchanged */
+
+    for (int k = 0; k < n; k++) {
+        double re = 0.0, im = 0.0;
+        for (int j = 0; j < n; j++) {
+            double ang = -2.0 * M_PI * (double)((long long)k * j % n) / n;
+            double c = cos(ang), s = sin(ang);
+            re += x[j].re * c - x[j].im * s;
+            im += x[j].re * s + x[j].im * c;
+        }
+        y[k].re = re;
+        y[k].im = im;
+    }
+    memcpy(x, y, (size_t)n * sizeof(Complex));
+    if (y != stack_work)
+        free(y);
+}
+
+/* p-point DFT for odd p, pairing inputs q and p−q */
+static inline void dft_odd(const Complex *a, const int rad, const Complex *roots, Complex *y) {
+    const int h = (rad - 1) / 2;
+    Complex t[3], d[3];
+    y[0] = a[0];
+    for (int q = 1; q <= h; q++) {
+        t[q - 1] = cadd(a[q], a[rad - q]);
+        d[q - 1] = csub(a[q], a[rad - q]);
+        y[0] = cadd(y[0], t[q - 1]);
+    }
+    for (int s = 1; s <= h; s++) {
+        double rr = a[0].re, ri = a[0].im;   /* a0 + Σ t·cos */
+        double ir = 0.0, ii = 0.0;           /* Σ d·(−sin)   */
+        for (int q = 1, qs = s; q <= h; q++, qs = (qs + s < rad) ? qs + s : qs + s - rad) {
+            const Complex *w = &roots[qs];
+            rr += t[q - 1].re * w->re;  ri += t[q - 1].im * w->re;
+            ir += d[q - 1].re * w->im;  ii += d[q - 1].im * w->im;
+        }
+        /* X[s] = R + j·I,  X[p−s] = R − j·I  (roots carry the −sin) */
+        y[s].re       = rr - ii;  y[s].im       = ri + ir;
+        y[rad - s].re = rr + ii;  y[rad - s].im = ri - ir;
+    }
+}
+
+/* One radix-rad stage.  Called with a literal rad so each radix gets
+ * its own fully unrolled copy. */
+static inline void mixed_stage(const Complex *src, Complex *dst,
+                               const Complex *roots, const Complex *tw,
+                               int L, int r2, const int rad) {
+    for (int k = 0; k < L; k++) {
+        const Complex *w = tw + k * (rad - 1);
+        const Complex *in = src + k * rad * r2;
+        Complex *out = dst + k * r2;
+
+        for (int c = 0; c < r2; c++) {
+            Complex a[7], y[7];
+            a[0] = in[c];
+            if (k == 0) {
+                for (int q = 1; q < rad; q++)
+                    a[q] = in[c + q * r2];
+            } else {
+                for (int q = 1; q < rad; q++)
+                    a[q] = cmul(w[q - 1], in[c + q * r2]);
+            }
+
+            if (rad == 2) {
+                y[0] = cadd(a[0], a[1]);
+                y[1] = csub(a[0], a[1]);
+            } else if (rad == 4) {
+                Complex s0 = cadd(a[0], a[2]);
+                Complex d0 = csub(a[0], a[2]);
+                Complex s1 = cadd(a[1], a[3]);
+                Complex d1 = csub(a[1], a[3]);
+                y[0] = cadd(s0, s1);
+                y[2] = csub(s0, s1);
+                y[1].re = d0.re + d1.im;  y[1].im = d0.im - d1.re;   /* − j·d1 */
+                y[3].re = d0.re - d1.im;  y[3].im = d0.im + d1.re;   /* + j·d1 */
+            } else {
+                dft_odd(a, rad, roots, y);
+            }
+
+            for (int q = 0; q < rad; q++)
+                out[q * L * r2 + c] = y[q];
+        }
+    }
+}
+
+static int mixed_radix_execute(const FftPlan *p, Complex *x) {
+    int n = p->n;
+    Complex stack_work[FFT_STACK_WORK];
+    Complex *work = n <= FFT_STACK_WORK ? stack_work
+                  : (Complex *)malloc((size_t)n * sizeof(Complex));
+    if (!work) return -1;
+
+    Complex *src = x;
+    Complex *dst = work;
+    const Complex *tw = p->mr_twiddle;
+    int L = 1;
+
+    for (int s = 0; s < p->n_factors; s++) {
+        int rad = p->factors[s];
+        int r2  = n / (L * rad);
+        const Complex *roots = tw;
+        tw += rad;
+
+        switch (rad) {
+        case 2:  mixed_stage(src, dst, roots, tw, L, r2, 2); break;
+        case 3:  mixed_stage(src, dst, roots, tw, L, r2, 3); break;
+        case 4:  mixed_stage(src, dst, roots, tw, L, r2, 4); break;
+        case 5:  mixed_stage(src, dst, roots, tw, L, r2, 5); break;
+        default: mixed_stage(src, dst, roots, tw, L, r2, 7); break;
+        }
+
+        tw += L * (rad - 1);
+        L *= rad;
+        Complex *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != x)
+        memcpy(x, src, (size_t)n * sizeof(Complex));
+    if (work != stack_work)
+        free(work);
+    return 0;
+}
+
+/* ── Bluestein chirp-z ───────────────────────────────────────────────
+ *
+ *  With nk = (k² + n² − (k−n)²)/2:
+ *
+ *     X[k] = w[k] · Σ_n (x[n]·w[n]) · conj(w[k−n]),   w[k] = exp(-jπk²/N)
+ *
+ *  which is a linear convolution, evaluated with a power-of-2 FFT of
+ *  length M ≥ 2N−1.  Used when N has a prime factor above 7.
+ */
+static int bluestein_execute(const FftPlan *p, Complex *x) {
+    int n = p->n;
+    int m = p->m;
+    Complex stack_work[FFT_STACK_WORK];
+    Complex *a = m <= FFT_STACK_WORK ? stack_work
+               : (Complex *)malloc((size_t)m * sizeof(Complex));
+    if (!a) return -1;
+
+    for (int k = 0; k < n; k++)
+        a[k] = cmul(x[k], p->chirp[k]);
+    memset(a + n, 0, (size_t)(m - n) * sizeof(Complex));
+
+    fft_execute(p->conv, a);
+    simd_cmul(a, a, p->chirp_fft, m);
+    ifft_execute(p->conv, a);
+
+    for (int k = 0; k < n; k++)
+        x[k] = cmul(a[k], p->chirp[k]);
+    if (a != stack_work)
+        free(a);
+    return 0;
+}
+
+/* ── Four-step (large powers of 2) ───────────────────────────────────
+ *
+ *  View x as an n1 × n2 row-major matrix A[j1][j2] = x[j1·n2 + j2]:
+ *
+ *     X[k1 + n1·k2] = Σ_j2 W_N^(j2·k1) · W_n2^(j2·k2) · Σ_j1 A[j1][j2]·W_n1^(j1·k1)
+ *
+ *    1. n2 column FFTs of length n1     (8 columns per block) → t
+ *    2. multiply by W_N^(k1·j2)         (fused into the store to t)
+ *    3. n1 row FFTs of length n2        (in place in t, cache-sized)
+ *    4. transpose n1 × n2 → n2 × n1     (X[k1 + n1·k2] = C[k1][k2])
+ *                                       (fused: rows stored back to x)
+ *
+ *          x ──(cols, ×W)──► t ──(rows)──► t ──(transpose)──► x
+ *
+ *  Every sub-FFT fits in cache and every DRAM access moves at least
+ *  FS_GROUP consecutive elements, so the data crosses the memory bus
+ *  about four times instead of once per radix-4 stage.  The N inter-
+ *  step twiddles come from two √N tables (plan_init_fourstep()), so
+ *  they stay in cache too.
+ *
+ *  Each pass is split across the thread pool; chunks write disjoint
+ *  data with the same arithmetic, so the result does not depend on
+ *  the thread count.
+ */
+#define FFT_BATCH 8
+#define FS_GROUP  FFT_BATCH
+#define FS_PANEL  (8 * FFT_BATCH)
+
+static void batch_execute(const FftPlan *p, double *re, double *im);
+
+typedef struct {
+    const FftPlan *p;
+    Complex *x;
+    Complex *t;        /* n complex: the n1 × n2 intermediate */
+    int failed;        /* a column chunk could not get its block */
+} FourStepJob;
+
+/* Steps 1-2 for columns [c0, c1), FS_PANEL columns per pass over the
+ * rows: each row visit moves FS_PANEL·16 bytes, so a pass touches
+ * n1 pages (not n1 pages per FFT_BATCH columns) */
+static void fs_columns(void *ctx, int c0, int c1) {
+    FourStepJob *job = (FourStepJob *)ctx;
+    const FftPlan *p = job->p;
+    const int B = FFT_BATCH;
+    int n1 = p->n1, n2 = p->n2, lo_mask = n1 - 1, hi_shift = p->log2n / 2;
+    size_t plane = (size_t)n1 * B;            /* doubles per block plane */
+    double *blk = (double *)malloc((size_t)2 * FS_PANEL * n1 * sizeof(double));
+    if (!blk) {
+        job->failed = 1;   /* x is untouched: caller falls back */
+        return;
+    }
+
+    for (int j0 = c0; j0 < c1; j0 += FS_PANEL) {
+        int width = c1 - j0 < FS_PANEL ? c1 - j0 : FS_PANEL;
+        int nblk = (width + B - 1) / B;
+
+        /* Gather: block q holds columns j0 + q·B .. + B-1, zero-padded */
+        for (int i = 0; i < n1; i++) {
+            const Complex *src = job->x + (size_t)i * n2 + j0;
+            for (int q = 0; q < nblk; q++) {
+                double *rrow = blk + 2 * q * plane + (size_t)i * B;
+                double *irow = rrow + plane;
+                for (int b = 0; b < B; b++) {
+                    int c = q * B + b;
+                    rrow[b] = c < width ? src[c].re : 0.0;
+                    irow[b] = c < width ? src[c].im : 0.0;
+                }
+            }
+        }
+
+        for (int q = 0; q < nblk; q++)
+            batch_execute(p->fs_cols, blk + 2 * q * plane, blk + (2 * q + 1) * plane);
+
+        /* Scatter rows of the panel to t, times W_N^(k1·j2) */
+        for (int k1 = 0; k1 < n1; k1++) {
+            Complex *dst = job->t + (size_t)k1 * n2 + j0;
+            for (int c = 0; c < width; c++) {
+                const double *rrow = blk + 2 * (c / B) * plane + (size_t)k1 * B;
+                int m = k1 * (j0 + c);              /* < N */
+                Complex w = cmul(p->fs_tw_hi[m >> hi_shift], p->fs_tw_lo[m & lo_mask]);
+                dst[c] = cmul((Complex){ rrow[c % B], rrow[plane + c % B] }, w);
+            }
+        }
+    }
+    free(blk);
+}
+
+/* Steps 3-4 for rows [r0, r1), FS_GROUP rows at a time so every
+ * store to x covers FS_GROUP consecutive elements */
+static void fs_rows(void *ctx, int r0, int r1) {
+    FourStepJob *job = (FourStepJob *)ctx;
+    const FftPlan *p = job->p;
+    int n1 = p->n1, n2 = p->n2;
+
+    for (int g0 = r0; g0 < r1; g0 += FS_GROUP) {
+        int g = r1 - g0 < FS_GROUP ? r1 - g0 : FS_GROUP;
+        Complex *src = job->t + (size_t)g0 * n2;
+        for (int b = 0; b < g; b++)
+            fft_execute(p->fs_rows, src + (size_t)b * n2);
+        for (int k2 = 0; k2 < n2; k2++) {
+            Complex *dst = job->x + (size_t)k2 * n1 + g0;
+            for (int b = 0; b < g; b++)
+                dst[b] = src[(size_t)b * n2 + k2];
+        }
+    }
+}
+
+static void fourstep_execute(const FftPlan *p, Complex *x) {
+    FourStepJob job = { p, x, (Complex *)malloc((size_t)p->n * sizeof(Complex)), 0 };
+    if (job.t)
+        dsp_parallel_for(p->n2, FFT_BATCH, fs_columns, &job);
+    if (!job.t || job.failed) {
+        free(job.t);
+        fft_radix2(x, p->n);   /* out of memory: table-free fallback */
+        return;
+    }
+    dsp_parallel_for(p->n1, FS_GROUP, fs_rows, &job);
+    free(job.t);
+}
+
+void fft_execute(const FftPlan *p, Complex *x) {
+    if (p->n <= 1) return;
+    if (p->fs_cols)
+        fourstep_execute(p, x);
+    else if (p->log2n >= 0)
+        radix4_execute(p, x);
+    else if ((p->n_factors > 0 ? mixed_radix_execute(p, x)
+                               : bluestein_execute(p, x)) != 0)
+        fft_dft(x, p->n);      /* out of memory for the work buffer */
+}
+
+void ifft_execute(const FftPlan *p, Complex *x) {
+    int n = p->n;
+    for (int i = 0; i < n; i++)
+        x[i].im = -x[i].im;
+
+    fft_execute(p, x);
+
+    double scale = 1.0 / n;
+    for (int i = 0; i < n; i++) {
+        x[i].re *= scale;
+        x[i].im = -x[i].im * scale;
+    }
+}
+
+int fft_execute_split(const FftPlan *p, double *re, double *im) {
+    int n = p->n;
+    if (n <= 1) return 0;
+    if (p->log2n >= 0 && !p->fs_cols) {
+        radix4_execute_split(p, re, im);
+        return 0;
+    }
+
+    /* Four-step, mixed radix and Bluestein work on interleaved data */
+    Complex *tmp = (Complex *)malloc((size_t)n * sizeof(Complex));
+    if (!tmp) return -1;
+    split_to_complex(re, im, tmp, n);
+    fft_execute(p, tmp);
+    complex_to_split(tmp, re, im, n);
+    free(tmp);
+    return 0;
+}
+
+int ifft_execute_split(const FftPlan *p, double *re, double *im) {
+    int n = p->n;
+    for (int i = 0; i < n; i++)
+        im[i] = -im[i];
+
+    if (fft_execute_split(p, re, im) != 0) {
+        for (int i = 0; i < n; i++)
+            im[i] = -im[i];
+        return -1;
+    }
+
+    double scale = 1.0 / n;
+    for (int i = 0; i < n; i++) {
+        re[i] *= scale;
+        im[i] = -im[i] * scale;
+    }
+    return 0;
+}
+
+/* ── Batched transforms ──────────────────────────────────────────────
+ *
+ *  fft_execute_many() runs `howmany` transforms of one plan; transform
+ *  j reads element i at x[j·dist + i·stride].
+ *
+ *  Strided power-of-2 batches are gathered FFT_BATCH transforms at a time into
+ *  a lane-interleaved block
+ *
+ *     blk[i·B + b] = element i of transform j0 + b      (split re/im)
+ *
+ *  and pushed through the radix-4 stages together, so every twiddle is
+ *  loaded once per butterfly for all B lanes and the AVX2 kernel runs
+ *  at full width even in the q = 1, 2 stages.  For column batches
+ *  (dist = 1) each gathered row is B neighbouring elements, i.e. whole
+ *  cache lines instead of one element per line.  Results are
+ *  bit-identical to transforming one at a time.
+ */
+
+static void batch_execute(const FftPlan *p, double *re, double *im) {
+    const int B = FFT_BATCH;
+    int n = p->n;
+
+    for (int s = 0; s < p->n_swaps; s++) {
+        double *ri = re + (size_t)p->swaps[2 * s] * B;
+        double *rj = re + (size_t)p->swaps[2 * s + 1] * B;
+        double *ii = im + (size_t)p->swaps[2 * s] * B;
+        double *ij = im + (size_t)p->swaps[2 * s + 1] * B;
+        for (int b = 0; b < B; b++) {
+            double tr = ri[b], ti = ii[b];
+            ri[b] = rj[b];  ii[b] = ij[b];
+            rj[b] = tr;     ij[b] = ti;
+        }
+    }
+
+    int q = 1;
+    if (p->log2n & 1) {
+        for (int i = 0; i < n; i += 2) {
+            double *r0 = re + (size_t)i * B, *r1 = r0 + B;
+            double *i0 = im + (size_t)i * B, *i1 = i0 + B;
+            for (int b = 0; b < B; b++) {
+                double ur = r0[b], ui = i0[b], vr = r1[b], vi = i1[b];
+                r0[b] = ur + vr;  i0[b] = ui + vi;
+                r1[b] = ur - vr;  i1[b] = ui - vi;
+            }
+        }
+        q = 2;
+    }
+
+    const double *tw = p->stage_twiddle_split;
+    for (; q < n; q <<= 2) {
+        simd_radix4_stage_batch(re, im, n, q, tw, B);
+        tw += 6 * q;
+    }
+}
+
+/* Source is either interleaved (x) or split planes (xr, xi) */
+static int execute_many(const FftPlan *p, Complex *x, double *xr, double *xi,
+                        int howmany, int stride, int dist, int inverse) {
+    int n = p->n;
+    if (howmany < 0 || stride < 1) return -1;
+    if (n <= 1 || howmany == 0) return 0;
+
+    /* Contiguous transforms: already unit-stride, run them back to back
+     * (blocking them only adds a gather/scatter; measured slower) */
+    if (stride == 1) {
+        for (int j = 0; j < howmany; j++) {
+            size_t base = (size_t)j * (size_t)dist;
+            int rc = 0;
+            if (x) {
+                if (inverse) ifft_execute(p, x + base);
+                else         fft_execute(p, x + base);
+            } else {
+                rc = inverse ? ifft_execute_split(p, xr + base, xi + base)
+                             : fft_execute_split(p, xr + base, xi + base);
+            }
+            if (rc != 0) return -1;
+        }
+        return 0;
+    }
+
+    if (p->log2n < 0 || p->fs_cols) {
+        /* Mixed radix / Bluestein / four-step: one transform at a time */
+        Complex *tmp = (Complex *)malloc((size_t)n * sizeof(Complex));
+        if (!tmp) return -1;
+        for (int j = 0; j < howmany; j++) {
+            size_t base = (size_t)j * (size_t)dist;
+            for (int i = 0; i < n; i++) {
+                size_t at = base + (size_t)i * (size_t)stride;
+                tmp[i] = x ? x[at] : (Complex){ xr[at], xi[at] };
+            }
+            if (inverse) ifft_execute(p, tmp);
+            else         fft_execute(p, tmp);
+            for (int i = 0; i < n; i++) {
+                size_t at = base + (size_t)i * (size_t)stride;
+                if (x) x[at] = tmp[i];
+                else { xr[at] = tmp[i].re; xi[at] = tmp[i].im; }
+            }
+        }
+        free(tmp);
+        return 0;
+    }
+
+    const int B = FFT_BATCH;
+    double *blk = (double *)malloc((size_t)2 * (size_t)n * B * sizeof(double));
+    if (!blk) return -1;
+    double *br = blk, *bi = blk + (size_t)n * B;
+    double sign = inverse ? -1.0 : 1.0;     /* conjugate trick for the IFFT */
+    double scale = inverse ? 1.0 / n : 1.0;
+
+    for (int j0 = 0; j0 < howmany; j0 += B) {
+        int lanes = howmany - j0 < B ? howmany - j0 : B;
+
+        /* Gather; unused lanes of a partial block are zero */
+        size_t first = (size_t)j0 * (size_t)dist;
+        for (int i = 0; i < n; i++) {
+            double *rrow = br + (size_t)i * B, *irow = bi + (size_t)i * B;
+            size_t at = first + (size_t)i * (size_t)stride;
+            if (x) {
+                const Complex *src = x + at;
+                for (int b = 0; b < lanes; b++) {
+                    rrow[b] = src[(size_t)b * dist].re;
+                    irow[b] = src[(size_t)b * dist].im * sign;
+                }
+            } else {
+                for (int b = 0; b < lanes; b++) {
+                    rrow[b] = xr[at + (size_t)b * dist];
+                    irow[b] = xi[at + (size_t)b * dist] * sign;
+                }
+            }
+            for (int b = lanes; b < B; b++)
+                rrow[b] = irow[b] = 0.0;
+        }
+
+        batch_execute(p, br, bi);
+
+        if (inverse) {
+            for (int k = 0; k < n * B; k++) {
+                br[k] = br[k] * scale;
+                bi[k] = -bi[k] * scale;
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            const double *rrow = br + (size_t)i * B, *irow = bi + (size_t)i * B;
+            size_t at = first + (size_t)i * (size_t)stride;
+            if (x) {
+                Complex *dst = x + at;
+                for (int b = 0; b < lanes; b++) {
+                    dst[(size_t)b * dist].re = rrow[b];
+                    dst[(size_t)b * dist].im = irow[b];
+                }
+            } else {
+                for (int b = 0; b < lanes; b++) {
+                    xr[at + (size_t)b * dist] = rrow[b];
+                    xi[at + (size_t)b * dist] = irow[b];
+                }
+            }
+        }
+    }
+
+    free(blk);
+    return 0;
+}
+
+int fft_execute_many(const FftPlan *p, Complex *x, int howmany, int stride, int dist) {
+    return execute_many(p, x, NULL, NULL, howmany, stride, dist, 0);
+}
+
+int ifft_execute_many(const FftPlan *p, Complex *x, int howmany, int stride, int dist) {
+    return execute_many(p, x, NULL, NULL, howmany, stride, dist, 1);
+}
+
+int fft_execute_many_split(const FftPlan *p, double *re, double *im,
+                           int howmany, int stride, int dist) {
+    return execute_many(p, NULL, re, im, howmany, stride, dist, 0);
+}
+
+int ifft_execute_many_split(const FftPlan *p, double *re, double *im,
+                            int howmany, int stride, int dist) {
+    return execute_many(p, NULL, re, im, howmany, stride, dist, 1);
+}
+
+/* ── Plan cache ──────────────────────────────────────────────────────
+ *  One slot per power of 2 (index = log₂N); other sizes go in a small
+ *  list searched linearly.  Plans live until fft_plan_cache_clear(),
+ *  so callers may keep the pointer.  A mutex makes lookups safe from
+ *  any thread (plans are built while it is held).
+ */
+
+#define FFT_PLAN_CACHE_SLOTS 31
+
+static FftPlan  *plan_cache[FFT_PLAN_CACHE_SLOTS];
+static RfftPlan *rplan_cache[FFT_PLAN_CACHE_SLOTS];
+
+static FftPlan  **plan_list;
+static RfftPlan **rplan_list;
+static int n_plan_list, n_rplan_list;
+
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const FftPlan *plan_cached_locked(int n) {
+    if (n < 1) return NULL;
+    int log2n = log2_exact(n);
+    if (log2n >= 0) {
+        if (log2n >= FFT_PLAN_CACHE_SLOTS) return NULL;
+        if (!plan_cache[log2n])
+            plan_cache[log2n] = fft_plan_create(n);
+        return plan_cache[log2n];
+    }
+
+    for (int i = 0; i < n_plan_list; i++)
+        if (plan_list[i]->n == n) return plan_list[i];
+
+    FftPlan **grown = (FftPlan **)realloc(plan_list,
+                                          (size_t)(n_plan_list + 1) * sizeof(FftPlan *));
+    if (!grown) return NULL;
+    plan_list = grown;
+    FftPlan *p = fft_plan_create(n);
+    if (p) plan_list[n_plan_list++] = p;
+    return p;
+}
+
+const FftPlan *fft_plan_cached(int n) {
+    pthread_mutex_lock(&cache_lock);
+    const FftPlan *p = plan_cached_locked(n);
+    pthread_mutex_unlock(&cache_lock);
+    return p;
+}
+
+static const RfftPlan *rplan_cached_locked(int n) {
+    if (n < 2 || (n & 1)) return NULL;
+    int log2n = log2_exact(n);
+    if (log2n >= 0) {
+        if (log2n >= FFT_PLAN_CACHE_SLOTS) return NULL;
+        if (!rplan_cache[log2n])
+            rplan_cache[log2n] = rfft_plan_create(n);
+        return rplan_cache[log2n];
+    }
+
+    for (int i = 0; i < n_rplan_list; i++)
+        if (rplan_list[i]->n == n) return rplan_list[i];
+
+    RfftPlan **grown = (RfftPlan **)realloc(rplan_list,
+                                            (size_t)(n_rplan_list + 1) * sizeof(RfftPlan *));
+    if (!grown) return NULL;
+    rplan_list = grown;
+    RfftPlan *p = rfft_plan_create(n);
+    if (p) rplan_list[n_rplan_list++] = p;
+    return p;
+}
+
+const RfftPlan *rfft_plan_cached(int n) {
+    pthread_mutex_lock(&cache_lock);
+    const RfftPlan *p = rplan_cached_locked(n);
+    pthread_mutex_unlock(&cache_lock);
+    return p;
+}
+
+void fft_plan_cache_clear(void) {
+    pthread_mutex_lock(&cache_lock);
+    for (int i = 0; i < FFT_PLAN_CACHE_SLOTS; i++) {
+        rfft_plan_destroy(rplan_cache[i]);
+        rplan_cache[i] = NULL;
+        fft_plan_destroy(plan_cache[i]);
+        plan_cache[i] = NULL;
+    }
+    for (int i = 0; i < n_rplan_list; i++)
+        rfft_plan_destroy(rplan_list[i]);
+    for (int i = 0; i < n_plan_list; i++)
+        fft_plan_destroy(plan_list[i]);
+    free(rplan_list);
+    free(plan_list);
+    rplan_list = NULL;
+    plan_list = NULL;
+    n_rplan_list = n_plan_list = 0;
+    pthread_mutex_unlock(&cache_lock);
+}
+
+/* ── Fast lengths ────────────────────────────────────────────────── */
+
+static int is_7_smooth(int n) {
+    static const int primes[] = { 2, 3, 5, 7 };
+    for (int i = 0; i < 4; i++)
+        while (n % primes[i] == 0) n /= primes[i];
+    return n == 1;
+}
+
+int fft_fast_length(int n) {
+    if (n <= 1) return 1;
+    int m = n;
+    while (m > 0 && !is_7_smooth(m)) m++;
+    return m > 0 ? m : n;
+}
+
+int rfft_fast_length(int n) {
+    if (n <= 2) return 2;
+    return 2 * fft_fast_length((n + 1) / 2);
+}
+
+/* ════════════════════════════════════════════════════════════════════
+ *  Real-input FFT (N/2 complex packing)
+ *
+ *  Pack the even/odd samples into one half-length complex signal:
+ *
+ *     z[m] = x[2m] + j·x[2m+1],   m = 0 .. M-1,   M = N/2
+ *
+ *  After Z = FFT_M(z), the even and odd sub-spectra are recovered from
+ *  the conjugate-symmetric and anti-symmetric parts of Z:
+ *
+ *     E[k] = ½(Z[k] + Z*[M-k])          (DFT of x[2m])
+ *     O[k] = -½j(Z[k] − Z*[M-k])        (DFT of x[2m+1])
+ *     X[k] = E[k] + W_N^k · O[k],   k = 0 .. M
+ *
+ *  Bins k and M-k are produced together (W_N^(M-k) = -conj(W_N^k)):
+ *
+ *     X[M-k] = conj(E[k] − W_N^k · O[k])
+ *
+ *  so only W_N^k for k = 0 .. M/2 is tabulated.
+ * ════════════════════════════════════════════════════════════════════ */
+
+RfftPlan *rfft_plan_create(int n) {
+    if (n < 2 || (n & 1)) return NULL;
+
+    RfftPlan *p = (RfftPlan *)calloc(1, sizeof(RfftPlan));
+    if (!p) return NULL;
+    p->n = n;
+    p->half = fft_plan_create(n / 2);
+    p->split = (Complex *)malloc((size_t)(n / 4 + 1) * sizeof(Complex));
+    if (!p->half || !p->split) {
+        rfft_plan_destroy(p);
+        return NULL;
+    }
+    for (int k = 0; k <= n / 4; k++) {
+        double angle = -2.0 * M_PI * (double)k / (double)n;
+        p->split[k].re = cos(angle);
+        p->split[k].im = sin(angle);
+    }
+    return p;
+}
+
+void rfft_plan_destroy(RfftPlan *p) {
+    if (!p) return;
+    fft_plan_destroy(p->half);
+    free(p->split);
+    free(p);
+}
+
+/* Pack even/odd samples into out[0..M-1] */
+static void rfft_pack(const RfftPlan *p, const double *in, Complex *out) {
+    int M = p->n / 2;
+    for (int m = 0; m < M; m++) {
+        out[m].re = in[2 * m];
+        out[m].im = in[2 * m + 1];
+    }
+}
+
+/* Turn the half-length FFT Z in out[0..M-1] into bins X[0..M] */
+static void rfft_post(const RfftPlan *p, Complex *out) {
+    int M = p->n / 2;
+
+    /* DC and Nyquist are both real and come from Z[0] alone */
+    double z0r = out[0].re, z0i = out[0].im;
+    out[0].re = z0r + z0i;  out[0].im = 0.0;
+    out[M].re = z0r - z0i;  out[M].im = 0.0;
+
+    /* Split bins k and M-k together */
+    for (int k = 1; k <= M / 2; k++) {
+        Complex a = out[k];
+        Complex b = out[M - k];
+        Complex w = p->split[k];
+
+        /* E = ½(a + b*),  O = -½j(a - b*) */
+        double er = 0.5 * (a.re + b.re), ei = 0.5 * (a.im - b.im);
+        double or_ = 0.5 * (a.im + b.im), oi = -0.5 * (a.re - b.re);
+
+        /* t = W·O */
+        double tr = w.re * or_ - w.im * oi;
+        double ti = w.re * oi + w.im * or_;
+
+        out[k].re     = er + tr;  out[k].im     = ei + ti;
+        out[M - k].re = er - tr;  out[M - k].im = -(ei - ti);
+    }
+}
+
+void rfft_execute(const RfftPlan *p, const double *in, Complex *out) {
+    rfft_pack(p, in, out);
+    fft_execute(p->half, out);
+    rfft_post(p, out);
+}
+
+int rfft_execute_many(const RfftPlan *p, const double *in, int in_dist,
+                      Complex *out, int out_dist, int howmany) {
+    if (howmany < 0 || in_dist < p->n || out_dist < p->n / 2 + 1) return -1;
+    for (int j = 0; j < howmany; j++)
+        rfft_pack(p, in + (size_t)j * in_dist, out + (size_t)j * out_dist);
+    if (fft_execute_many(p->half, out, howmany, 1, out_dist) != 0)
+        return -1;
+    for (int j = 0; j < howmany; j++)
+        rfft_post(p, out + (size_t)j * out_dist);
+    return 0;
+}
+
+void irfft_execute(const RfftPlan *p, Complex *in, double *out) {
+    int M = p->n / 2;
+
+    /* Z[0] from DC and Nyquist: E = ½(X0 + XM), O = ½(X0 - XM) */
+    double x0 = in[0].re, xm = in[M].re;
+    in[0].re = 0.5 * (x0 + xm);
+    in[0].im = 0.5 * (x0 - xm);
+
+    /* Undo the split: Z[k] = E[k] + j·O[k], O[k] = ½·conj(W^k)·(X[k] − X*[M-k]) */
+    for (int k = 1; k <= M / 2; k++) {
+        Complex a = in[k];
+        Complex b = in[M - k];
+        Complex w = p->split[k];
+
+        double er = 0.5 * (a.re + b.re), ei = 0.5 * (a.im - b.im);
+        double dr = 0.5 * (a.re - b.re), di = 0.5 * (a.im + b.im);
+
+        /* O = conj(W)·D */
+        double or_ = w.re * dr + w.im * di;
+        double oi  = w.re * di - w.im * dr;
+
+        /* Z[k] = E + jO,  Z[M-k] = conj(E) + j·conj(O) */
+        in[k].re     = er - oi;  in[k].im     = ei + or_;
+        in[M - k].re = er + oi;  in[M - k].im = -ei + or_;
+    }
+
+    ifft_execute(p->half, in);
+
+    for (int m = 0; m < M; m++) {
+        out[2 * m]     = in[m].re;
+        out[2 * m + 1] = in[m].im;
+    }
+}
+
+/* ════════════════════════════════════════════════════════════════════
+ *  Forward FFT entry point
+ *  Runs on the cached plan; falls back to the table-free textbook loop
+ *  (radix-2) or O(N²) DFT (other sizes) if the plan could not be
+ *  allocated.
+ * ════════════════════════════════════════════════════════════════════ */
+
+void fft(Complex *x, int n) {
+    if (n <= 1) return;
+    const FftPlan *p = fft_plan_cached(n);
+    if (p)
+        fft_execute(p, x);
+    else if (log2_exact(n) >= 0)
+        fft_radix2(x, n);   /* out of memory: table-free fallback */
+    else
+        fft_dft(x, n);
+}
+
+int fft_split(double *re, double *im, int n) {
+    if (n < 1) return -1;
+    if (n == 1) return 0;
+    const FftPlan *p = fft_plan_cached(n);
+    return p ? fft_execute_split(p, re, im) : -1;
+}
+
 /* ════════════════════════════════════════════════════════════════════
  *  Real-valued FFT wrapper
  *  Copies real input into complex array, then runs FFT.
  * ════════════════════════════════════════════════════════════════════ */
 
 void fft_real(const double *in, Complex *out, int n) {
-    for (int i = 0; i < n; i++) {
-        out[i].re = in[i];
-        out[i].im = 0.0;
+    const RfftPlan *p = n >= 2 ? rfft_plan_cached(n) : NULL;
+    if (!p) {
+        for (int i = 0; i < n; i++) {
+            out[i].re = in[i];
+            out[i].im = 0.0;
+        }
+        fft(out, n);
+        return;
+    }
+
+    /* Half spectrum via rfft, upper half by conjugate symmetry */
+    rfft_execute(p, in, out);
+    for (int k = n / 2 + 1; k < n; k++) {
+        out[k].re =  out[n - k].re;
+        out[k].im = -out[n - k].im;
     }
-    fft(out, n);
+}
+
+void rfft(const double *in, Complex *out, int n) {
+    if (n < 2) {
+        if (n == 1) { out[0].re = in[0]; out[0].im = 0.0; }
+        return;
+    }
+    const RfftPlan *p = rfft_plan_cached(n);
+    if (p) {
+        rfft_execute(p, in, out);
+        return;
+    }
+
+    /* Odd n (or no memory for a plan): full complex transform, keep the first half */
+    Complex *tmp = (Complex *)malloc((size_t)n * sizeof(Complex));
+    if (!tmp) return;
+    for (int i = 0; i < n; i++) { tmp[i].re = in[i]; tmp[i].im = 0.0; }
+    fft(tmp, n);
+    memcpy(out, tmp, (size_t)(n / 2 + 1) * sizeof(Complex));
+    free(tmp);
 }
 
 /* ════════════════════════════════════════════════════════════════════
@@ -168,14 +1381,43 @@ void ifft(Complex *x, int n) {
     }
 }
 
+int ifft_split(double *re, double *im, int n) {
+    if (n < 1) return -1;
+    if (n == 1) return 0;
+    const FftPlan *p = fft_plan_cached(n);
+    return p ? ifft_execute_split(p, re, im) : -1;
+}
+
+void irfft(Complex *in, double *out, int n) {
+    if (n < 2) {
+        if (n == 1) out[0] = in[0].re;
+        return;
+    }
+    const RfftPlan *p = rfft_plan_cached(n);
+    if (p) {
+        irfft_execute(p, in, out);
+        return;
+    }
+
+    Complex *tmp = (Complex *)malloc((size_t)n * sizeof(Complex));
+    if (!tmp) return;
+    for (int k = 0; k <= n / 2; k++) tmp[k] = in[k];
+    for (int k = n / 2 + 1; k < n; k++) {
+        tmp[k].re =  in[n - k].re;
+        tmp[k].im = -in[n - k].im;
+    }
+    for (int i = 0; i < n; i++) tmp[i].im = -tmp[i].im;
+    fft(tmp, n);
+    for (int i = 0; i < n; i++) out[i] = tmp[i].re / n;
+    free(tmp);
+}
+
 /* ════════════════════════════════════════════════════════════════════
  *  Feature extraction helpers
  * ════════════════════════════════════════════════════════════════════ */
 
 void fft_magnitude(const Complex *x, double *mag, int n) {
-    for (int i = 0; i < n; i++) {
-        mag[i] = complex_mag(x[i]);
-    }
+    simd_magnitude(x, mag, n);   /* same result as complex_mag() per bin */
 }
 
 void fft_phase(const Complex *x, double *phase, int n) {
@@ -183,3 +1425,7 @@ void fft_phase(const Complex *x, double *phase, int n) {
         phase[i] = complex_phase(x[i]);
     }
 }
+
+void fft_magnitude_split(const double *re, const double *im, double *mag, int n) {
+    simd_magnitude_split(re, im, mag, n);
+}
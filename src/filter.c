@@ -22,6 +22,8 @@
 #include "filter.h"
 #include "dsp_utils.h"   /* hamming_window */
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -70,18 +72,180 @@
  */
 void fir_filter(const double *in, double *out, int n,
                 const double *h, int order)
+{
+    fir_filter_method(in, out, n, h, order, CONV_AUTO);
+}
+
+/* Time-domain sum, the reference every other FIR path is checked against */
+static void fir_direct(const double *in, double *out, int n,
+                       const double *h, int order)
 {
     for (int i = 0; i < n; i++) {
+        /* Taps with i − k < 0 see x = 0 (zero-padding): stop at k = i */
+        int kmax = i < order - 1 ? i : order - 1;
+        double sum = 0.0;
+        for (int k = 0; k <= kmax; k++) {
+            sum += h[k] * in[i - k];
+        }
+        out[i] = sum;
+    }
+}
+
+/* FFT paths are the same causal convolution; convolution.c owns them */
+void fir_filter_method(const double *in, double *out, int n,
+                       const double *h, int order, ConvMethod method)
+{
+    if (method == CONV_AUTO)
+        method = conv_select_method(n, order);
+    if (method == CONV_DIRECT)
+        fir_direct(in, out, n, h, order);
+    else
+        convolve_causal_method(in, n, h, order, out, method);
+}
+
+/* ════════════════════════════════════════════════════════════════════
+ *  Linear-phase FIR — folded delay line
+ *
+ *  Symmetric taps (h[k] = ±h[M−1−k]) let the two inputs that share a
+ *  coefficient be combined before the multiply:
+ *
+ *    x[n]  x[n-1]  x[n-2] │ x[n-3]  x[n-4]         M = 5, Type I
+ *      │     │       │    │   │       │
+ *      └─────┼───────┼────┼───┼──(+)──┘  × h[0]
+ *            └───────┼────┼──(+)         × h[1]
+ *                    └────┼──────────    × h[2]   (centre, M odd)
+ *
+ *    y[n] = Σ_{k<M/2} h[k]·(x[n−k] ± x[n−M+1+k])  [+ h[c]·x[n−c]]
+ *
+ *  Half the multiplies, same adds.  Types III/IV subtract; a Type III
+ *  centre tap is zero and skipped.  The first M−1 outputs (where the
+ *  folded partner lies before the signal start) use the plain sum.
+ * ════════════════════════════════════════════════════════════════════ */
+
+#define FIR_SYM_TOL 1e-10
+
+FirSymmetry fir_symmetry(const double *h, int order)
+{
+    if (!h || order < 2) return FIR_SYM_NONE;
+
+    double peak = 0.0;
+    for (int k = 0; k < order; k++)
+        if (fabs(h[k]) > peak) peak = fabs(h[k]);
+    if (peak == 0.0) return FIR_SYM_NONE;
+
+    double tol = FIR_SYM_TOL * peak;
+    int even = 1, odd = 1;
+    for (int k = 0; k < order / 2 + (order & 1); k++) {
+        double a = h[k], b = h[order - 1 - k];
+        if (fabs(a - b) > tol) even = 0;
+        if (fabs(a + b) > tol) odd = 0;
+    }
+    if (even) return FIR_SYM_EVEN;
+    if (odd)  return FIR_SYM_ODD;
+    return FIR_SYM_NONE;
+}
+
+void fir_filter_symmetric(const double *in, double *out, int n,
+                          const double *h, int order, FirSymmetry sym)
+{
+    if (sym == FIR_SYM_NONE || order < 2) {
+        fir_filter(in, out, n, h, order);
+        return;
+    }
+
+    int half = order / 2;
+    int centre = (order & 1) && sym == FIR_SYM_EVEN;
+    int head = n < order - 1 ? n : order - 1;
+
+    /* Start-up: partner samples fall before x[0], plain sum */
+    fir_direct(in, out, head, h, order);
+
+    for (int i = head; i < n; i++) {
+        const double *xn = in + i;               /* xn[-k] = x[i − k]          */
+        const double *xo = in + i - (order - 1); /* xo[k]  = x[i − M + 1 + k]  */
         double sum = 0.0;
-        for (int k = 0; k < order; k++) {
-            int idx = i - k;
-            if (idx >= 0) {
-                sum += h[k] * in[idx];
+        if (sym == FIR_SYM_EVEN) {
+            for (int k = 0; k < half; k++) {
+                sum += h[k] * (xn[-k] + xo[k]);
             }
-            /* else: x[idx] = 0 (zero-padding) */
+        } else {
+            for (int k = 0; k < half; k++) {
+                sum += h[k] * (xn[-k] - xo[k]);
+            }
+        }
+        if (centre) sum += h[half] * xn[-half];
+        out[i] = sum;
+    }
+}
+
+/* ════════════════════════════════════════════════════════════════════
+ *  Streaming FIR — circular delay line, stored twice
+ *
+ *  A plain circular buffer of M samples needs a modulo (or a wrap
+ *  branch) on every tap.  Writing each sample twice, at pos and
+ *  pos + M, in a buffer of 2M keeps the newest M samples contiguous
+ *  from any pos:
+ *
+ *     delay:  [ . . x0 x1 x2 x3 . . | . . x0 x1 x2 x3 . . ]
+ *                   ↑ pos                  ↑ pos + M
+ *             delay[pos + k] = x[n − k],  k = 0 .. M−1
+ *
+ *  so the tap loop is a straight dot product.  pos moves backwards
+ *  one slot per sample; the wrap test runs once per sample, not per
+ *  tap.  The sum runs in the same order as fir_filter(), so chunked
+ *  processing reproduces one CONV_DIRECT call on the whole stream.
+ * ════════════════════════════════════════════════════════════════════ */
+
+int fir_init(FirState *s, const double *h, int taps)
+{
+    memset(s, 0, sizeof(*s));
+    if (!h || taps < 1) return -1;
+
+    s->h     = (double *)malloc((size_t)taps * sizeof(double));
+    s->delay = (double *)calloc((size_t)(2 * taps), sizeof(double));
+    if (!s->h || !s->delay) {
+        fir_free(s);
+        return -1;
+    }
+    memcpy(s->h, h, (size_t)taps * sizeof(double));
+    s->taps = taps;
+    return 0;
+}
+
+void fir_process_block(FirState *s, const double *in, double *out, int n)
+{
+    const double *h = s->h;
+    double *dl = s->delay;
+    int M = s->taps;
+    int pos = s->pos;
+
+    for (int i = 0; i < n; i++) {
+        pos = (pos == 0 ? M : pos) - 1;
+        dl[pos] = dl[pos + M] = in[i];
+
+        const double *x = dl + pos;
+        double sum = 0.0;
+        for (int k = 0; k < M; k++) {
+            sum += h[k] * x[k];
         }
         out[i] = sum;
     }
+    s->pos = pos;
+}
+
+void fir_reset(FirState *s)
+{
+    memset(s->delay, 0, (size_t)(2 * s->taps) * sizeof(double));
+    s->pos = 0;
+}
+
+void fir_free(FirState *s)
+{
+    if (s) {
+        free(s->h);     s->h     = NULL;
+        free(s->delay); s->delay = NULL;
+        s->taps = 0;
+    }
 }
 
 /* ════════════════════════════════════════════════════════════════════
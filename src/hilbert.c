@@ -77,15 +77,30 @@ void analytic_signal(const double *x, int n, Complex *z, int taps)
 
     int K = taps / 2;
 
+    /*
+     * Folded Type III convolution.  h is antisymmetric about K and
+     * zero at even offsets, so with g[m] = h[K + m]:
+     *
+     *   x̂[i] = Σ_j h[j]·x[i − j + K] = Σ_{m odd} g[m]·(x[i − m] − x[i + m])
+     *
+     * one multiply per odd offset — a quarter of the plain loop.
+     */
+    const double *g = h + K;
+
     for (int i = 0; i < n; i++) {
         z[i].re = x[i];
 
-        /* Convolve with Hilbert filter */
         double acc = 0.0;
-        for (int j = 0; j < taps; j++) {
-            int idx = i - j + K;
-            if (idx >= 0 && idx < n)
-                acc += h[j] * x[idx];
+        if (i >= K && i + K < n) {
+            for (int m = 1; m <= K; m += 2)
+                acc += g[m] * (x[i - m] - x[i + m]);
+        } else {
+            /* Edges: samples outside [0, n) are zero */
+            for (int m = 1; m <= K; m += 2) {
+                double lo = i - m >= 0 ? x[i - m] : 0.0;
+                double hi = i + m < n  ? x[i + m] : 0.0;
+                acc += g[m] * (lo - hi);
+            }
         }
         z[i].im = acc;
     }
@@ -93,22 +108,13 @@ void analytic_signal(const double *x, int n, Complex *z, int taps)
     free(h);
 }
 
-/* ── Next power of 2 ─────────────────────────────────────────── */
-
-static int next_pow2(int n)
-{
-    int p = 1;
-    while (p < n) p <<= 1;
-    return p;
-}
-
 /* ── Analytic Signal (FFT) ────────────────────────────────────── */
 
 void analytic_signal_fft(const double *x, int n, Complex *z)
 {
     if (!x || !z || n <= 0) return;
 
-    int N = next_pow2(n);
+    int N = fft_fast_length(n);
     Complex *X = (Complex *)calloc((size_t)N, sizeof(Complex));
 
     /* Copy real signal */
@@ -124,11 +130,14 @@ void analytic_signal_fft(const double *x, int n, Complex *z)
      * Create one-sided spectrum:
      *   k = 0:         keep (DC)
      *   k = 1..N/2-1:  multiply by 2 (positive frequencies)
-     *   k = N/2:       keep (Nyquist)
+     *   k = N/2:       keep (Nyquist, even N only)
      *   k = N/2+1..N-1: zero out (negative frequencies)
+     *
+     * For odd N there is no Nyquist bin: k = 1..(N-1)/2 are doubled.
      */
+    int pos_end = (N % 2 == 0) ? N / 2 : (N + 1) / 2;
     /* k=0: unchanged */
-    for (int k = 1; k < N / 2; k++) {
+    for (int k = 1; k < pos_end; k++) {
         X[k].re *= 2.0;
         X[k].im *= 2.0;
     }
@@ -6,7 +6,11 @@
  *
  *   1. General IIR filtering  — direct-form difference equation
  *   2. Biquad processing      — DF1 and DF2-Transposed per-sample
- *   3. Cascaded SOS            — chain of biquads for high-order filters
+ *   3. Cascaded SOS            — chain of biquads for high-order filters,
+ *                                block engines (DF1, DF2T, DF2T across
+ *                                channels in SIMD lanes), variable-
+ *                                length chains and banks (SOSChain),
+ *                                and parallel / lattice-ladder forms
  *   4. Butterworth design      — maximally-flat magnitude response
  *   5. Chebyshev Type I design — equiripple passband, steeper rolloff
  *   6. Frequency response      — evaluate H(e^{jω}) on unit circle
@@ -48,6 +52,7 @@
 
 #define _GNU_SOURCE
 #include "iir.h"
+#include "simd.h"
 #include <math.h>
 #include <string.h>
 #include <stdlib.h>
@@ -75,20 +80,18 @@ void iir_filter(const double *b, int b_len,
     if (fabs(a0) < 1e-30) a0 = 1.0; /* safety */
 
     for (int i = 0; i < n; i++) {
+        /* Taps reaching before x[0] / y[0] are zero: stop at k = i */
+        int nb = b_len < i + 1 ? b_len : i + 1;
+        int na = a_len < i + 1 ? a_len : i + 1;
+
         /* Feed-forward (numerator) sum: Σ b[k]·x[n-k] */
         double sum = 0.0;
-        for (int k = 0; k < b_len; k++) {
-            int idx = i - k;
-            if (idx >= 0)
-                sum += b[k] * in[idx];
-        }
+        for (int k = 0; k < nb; k++)
+            sum += b[k] * in[i - k];
 
         /* Feedback (denominator) sum: − Σ a[k]·y[n-k], k=1..a_len-1 */
-        for (int k = 1; k < a_len; k++) {
-            int idx = i - k;
-            if (idx >= 0)
-                sum -= a[k] * out[idx];
-        }
+        for (int k = 1; k < na; k++)
+            sum -= a[k] * out[i - k];
 
         out[i] = sum / a0;
     }
@@ -215,12 +218,695 @@ double sos_process_sample(SOSCascade *sos, double x)
     return y * sos->gain;
 }
 
+/*
+ * Block processing keeps every section's coefficients and state in
+ * locals for the whole block instead of reloading them (through a call
+ * per section) for every sample.  Samples still go through the sections
+ * one after another, which lets successive samples overlap in the
+ * pipeline; a section-at-a-time pass over the block would instead wait
+ * on each section's y → state → y recurrence.  Every sample sees the
+ * same operations in the same order, so the result is bit-identical to
+ * sos_process_sample().
+ */
 void sos_process_block(SOSCascade *sos,
                        const double *in, double *out, int n)
 {
+    int K = sos->n_sections;
+    Biquad c[MAX_SOS_SECTIONS];
+    BiquadDF1State z[MAX_SOS_SECTIONS];
+    memcpy(c, sos->sections, (size_t)K * sizeof(Biquad));
+    memcpy(z, sos->states, (size_t)K * sizeof(BiquadDF1State));
+
     for (int i = 0; i < n; i++) {
-        out[i] = sos_process_sample(sos, in[i]);
+        double v = in[i];
+        for (int k = 0; k < K; k++) {
+            double y = c[k].b0 * v + c[k].b1 * z[k].x1 + c[k].b2 * z[k].x2
+                                   - c[k].a1 * z[k].y1 - c[k].a2 * z[k].y2;
+            z[k].x2 = z[k].x1;
+            z[k].x1 = v;
+            z[k].y2 = z[k].y1;
+            z[k].y1 = y;
+            v = y;
+        }
+        out[i] = v * sos->gain;
+    }
+    memcpy(sos->states, z, (size_t)K * sizeof(BiquadDF1State));
+}
+
+/*
+ * Run K DF2T sections over `lanes` interleaved signals, packing
+ * {b0, b1, b2, a1, a2} for simd_sos_df2t() eight sections at a time so
+ * no cascade length needs a fixed-size buffer.  state holds s1, s2 per
+ * section and lane (BiquadDF2TState[K · lanes]); the gain is applied on
+ * the way out.
+ */
+#define SOS_PACK 8
+
+static void sos_run_df2t(const Biquad *sec, int K, double gain,
+                         BiquadDF2TState *state, const double *in, double *out,
+                         int n, int lanes)
+{
+    const double *src = in;
+    for (int k0 = 0; k0 < K; k0 += SOS_PACK) {
+        int kn = K - k0 < SOS_PACK ? K - k0 : SOS_PACK;
+        double coef[5 * SOS_PACK];
+        for (int k = 0; k < kn; k++) {
+            const Biquad *bq = &sec[k0 + k];
+            coef[5 * k + 0] = bq->b0;
+            coef[5 * k + 1] = bq->b1;
+            coef[5 * k + 2] = bq->b2;
+            coef[5 * k + 3] = bq->a1;
+            coef[5 * k + 4] = bq->a2;
+        }
+        simd_sos_df2t(coef, &state[(size_t)k0 * lanes].s1, kn,
+                      src, out, n, lanes, lanes);
+        src = out;
+    }
+    for (size_t i = 0; i < (size_t)n * lanes; i++)
+        out[i] = src[i] * gain;
+}
+
+/*
+ * DF2T keeps two state words per section instead of four, and y needs
+ * only b0·x + s1, which shortens the per-sample dependency chain.
+ */
+void sos_process_block_df2t(const SOSCascade *sos, BiquadDF2TState *st,
+                            const double *in, double *out, int n)
+{
+    sos_run_df2t(sos->sections, sos->n_sections, sos->gain, st, in, out, n, 1);
+}
+
+/*
+ * Channels go in SIMD lanes (4 doubles per AVX2 register): the
+ * recurrence is serial in time but independent across channels, so C
+ * channels cost far less than C single-channel calls.
+ */
+void sos_process_multi(const SOSCascade *sos, BiquadDF2TState *st,
+                       const double *in, double *out, int n, int n_channels)
+{
+    sos_run_df2t(sos->sections, sos->n_sections, sos->gain, st, in, out,
+                 n, n_channels);
+}
+
+/* ══════════════════════════════════════════════════════════════════
+ *  Section 3 (cont.): Variable-Length Cascades
+ *
+ *  An SOSChain is one block — header, then capacity Biquads, then
+ *  capacity DF2T states — from malloc or a DspArena.  An SOSBank packs
+ *  many chains the same way: all headers, all sections, all states.
+ * ══════════════════════════════════════════════════════════════════ */
+
+int sos_chain_sections(int order)
+{
+    return order < 1 ? 0 : (order + 1) / 2;
+}
+
+/* Round up so the arrays after a header stay 16-byte aligned */
+static size_t sos_align(size_t bytes)
+{
+    return (bytes + 15) & ~(size_t)15;
+}
+
+static void *sos_alloc(DspArena *arena, size_t bytes)
+{
+    return arena ? dsp_arena_alloc(arena, bytes) : calloc(1, bytes);
+}
+
+/* Point c at `capacity` sections and states, empty, gain 1 */
+static void sos_chain_bind(SOSChain *c, Biquad *sec, BiquadDF2TState *st,
+                           int capacity, int owned)
+{
+    c->n_sections = 0;
+    c->capacity   = capacity;
+    c->gain       = 1.0;
+    c->sections   = sec;
+    c->states     = st;
+    c->owned      = owned;
+}
+
+SOSChain *sos_chain_create(DspArena *arena, int capacity)
+{
+    if (capacity < 1) return NULL;
+
+    size_t head = sos_align(sizeof(SOSChain));
+    size_t secs = sos_align((size_t)capacity * sizeof(Biquad));
+    unsigned char *blk = (unsigned char *)sos_alloc(
+        arena, head + secs + (size_t)capacity * sizeof(BiquadDF2TState));
+    if (!blk) return NULL;
+
+    SOSChain *c = (SOSChain *)blk;
+    sos_chain_bind(c, (Biquad *)(blk + head),
+                   (BiquadDF2TState *)(blk + head + secs), capacity, !arena);
+    return c;
+}
+
+void sos_chain_destroy(SOSChain *c)
+{
+    if (c && c->owned) free(c);
+}
+
+void sos_chain_reset(SOSChain *c)
+{
+    memset(c->states, 0, (size_t)c->capacity * sizeof(BiquadDF2TState));
+}
+
+int sos_chain_from_cascade(SOSChain *c, const SOSCascade *sos)
+{
+    if (sos->n_sections > c->capacity) return -1;
+    memcpy(c->sections, sos->sections, (size_t)sos->n_sections * sizeof(Biquad));
+    c->n_sections = sos->n_sections;
+    c->gain = sos->gain;
+    sos_chain_reset(c);
+    return 0;
+}
+
+void sos_chain_process(SOSChain *c, const double *in, double *out, int n)
+{
+    sos_run_df2t(c->sections, c->n_sections, c->gain, c->states, in, out, n, 1);
+}
+
+SOSBank *sos_bank_create(DspArena *arena, const int *capacity, int n_chains)
+{
+    if (!capacity || n_chains < 1) return NULL;
+
+    size_t total = 0;
+    for (int f = 0; f < n_chains; f++) {
+        if (capacity[f] < 1) return NULL;
+        total += (size_t)capacity[f];
     }
+
+    size_t head  = sos_align(sizeof(SOSBank));
+    size_t heads = sos_align((size_t)n_chains * sizeof(SOSChain));
+    size_t secs  = sos_align(total * sizeof(Biquad));
+    unsigned char *blk = (unsigned char *)sos_alloc(
+        arena, head + heads + secs + total * sizeof(BiquadDF2TState));
+    if (!blk) return NULL;
+
+    SOSBank *b = (SOSBank *)blk;
+    b->n_chains = n_chains;
+    b->chains   = (SOSChain *)(blk + head);
+    b->owned    = !arena;
+
+    Biquad *sec = (Biquad *)(blk + head + heads);
+    BiquadDF2TState *st = (BiquadDF2TState *)(blk + head + heads + secs);
+    for (int f = 0; f < n_chains; f++) {
+        sos_chain_bind(&b->chains[f], sec, st, capacity[f], 0);
+        sec += capacity[f];
+        st  += capacity[f];
+    }
+    return b;
+}
+
+void sos_bank_destroy(SOSBank *b)
+{
+    if (b && b->owned) free(b);
+}
+
+/* ══════════════════════════════════════════════════════════════════
+ *  Section 3 (cont.): Parallel and Lattice Realizations
+ *
+ *  The same H(z) = B(z)/A(z), with w = z⁻¹ and A(w) = Π (1 − p_i·w):
+ *
+ *  Parallel (partial fractions):
+ *    H = Q(w) + Σ r_i / (1 − p_i·w),   r_i = B(1/p_i) / Π_{j≠i} (1 − p_j/p_i)
+ *    Conjugate (or real) pole pairs combine into real 2nd-order terms
+ *      (β0 + β1·w) / (1 − (p1 + p2)·w + p1·p2·w²)
+ *      β0 = r1 + r2,   β1 = −(r1·p2 + r2·p1)
+ *    Every term sees the same x[n], so terms go in SIMD lanes.
+ *
+ *  Lattice-ladder (Gray–Markel, Proakis §9.3):
+ *    Step-down: k_m = α_m(m),  α_{m−1}(i) = (α_m(i) − k_m·α_m(m−i)) / (1 − k_m²)
+ *    Ladder:    v_m = c(m) − Σ_{q>m} v_q·α_q(q−m)
+ *
+ *      f_N = x ──►(−k_N)──► f_{N−1} ··· ──► f_0 ──┬── g_0
+ *      f_{m−1} = f_m − k_m·g_{m−1}[n−1]           │
+ *      g_m     = k_m·f_{m−1} + g_{m−1}[n−1]       │
+ *      y = Σ v_m·g_m
+ *
+ *    Stable ⇔ every |k_m| < 1, which the conversion checks.
+ * ══════════════════════════════════════════════════════════════════ */
+
+/* Largest order the parallel and lattice converters will build */
+#define PARALLEL_MAX_ORDER 64
+
+static Complex c_div(Complex a, Complex b)
+{
+    double d = b.re * b.re + b.im * b.im;
+    Complex r = { (a.re * b.re + a.im * b.im) / d,
+                  (a.im * b.re - a.re * b.im) / d };
+    return r;
+}
+
+/* Multiply the sections out in long double: b (with gain) and a, 2K+1 each */
+static int tf_expand(const Biquad *sec, int n_sections, double gain,
+                     long double *b, long double *a)
+{
+    int len = 1;
+    b[0] = gain;
+    a[0] = 1.0L;
+    for (int k = 0; k < n_sections; k++) {
+        const Biquad *q = &sec[k];
+        long double bq[3] = { q->b0, q->b1, q->b2 }, aq[3] = { 1.0L, q->a1, q->a2 };
+        b[len] = b[len + 1] = a[len] = a[len + 1] = 0.0L;
+        for (int i = len - 1; i >= 0; i--) {
+            long double bi = b[i], ai = a[i];
+            b[i] = 0.0L;
+            a[i] = 0.0L;
+            for (int j = 0; j < 3; j++) {
+                b[i + j] += bi * bq[j];
+                a[i + j] += ai * aq[j];
+            }
+        }
+        len += 2;
+    }
+    return len;
+}
+
+int sos_to_tf(const SOSCascade *sos, double *b, double *a)
+{
+    long double bl[2 * MAX_SOS_SECTIONS + 1], al[2 * MAX_SOS_SECTIONS + 1];
+    int len = tf_expand(sos->sections, sos->n_sections, sos->gain, bl, al);
+    for (int i = 0; i < len; i++) {
+        b[i] = (double)bl[i];
+        a[i] = (double)al[i];
+    }
+    return len;
+}
+
+int sos_chain_to_tf(const SOSChain *c, double *b, double *a)
+{
+    int len = 2 * c->n_sections + 1;
+    long double *bl = (long double *)malloc((size_t)(2 * len) * sizeof(long double));
+    if (!bl) return -1;
+    long double *al = bl + len;
+    tf_expand(c->sections, c->n_sections, c->gain, bl, al);
+    for (int i = 0; i < len; i++) {
+        b[i] = (double)bl[i];
+        a[i] = (double)al[i];
+    }
+    free(bl);
+    return len;
+}
+
+static IIRParallel *parallel_alloc(int n_sections, int n_fir)
+{
+    int groups = (n_sections + 3) / 4;
+    size_t head = sos_align(sizeof(IIRParallel));
+    size_t secs = sos_align((size_t)n_sections * sizeof(Biquad));
+    size_t fir  = sos_align((size_t)(2 * n_fir) * sizeof(double));
+    size_t lane = (size_t)groups * 24 * sizeof(double);
+    unsigned char *blk = (unsigned char *)calloc(1, head + secs + fir + lane);
+    if (!blk) return NULL;
+
+    IIRParallel *p = (IIRParallel *)blk;
+    p->n_sections = n_sections;
+    p->sections   = (Biquad *)(blk + head);
+    p->n_fir      = n_fir;
+    p->fir        = (double *)(blk + head + secs);
+    p->hist       = p->fir + n_fir;
+    p->n_groups   = groups;
+    p->coef       = (double *)(blk + head + secs + fir);
+    p->state      = p->coef + 16 * groups;
+    return p;
+}
+
+/*
+ * Partial fractions of B(w)/A(w) for N poles ordered so that p[2s],
+ * p[2s+1] form term s (conjugate or both real; a lone real pole last
+ * when N is odd).  a is A with a[0] = 1, length N+1; b has b_len taps.
+ */
+static IIRParallel *parallel_build(const double *b, int b_len,
+                                   const double *a, int N, const Complex *p)
+{
+    int K = (N + 1) / 2;
+    int n_fir = b_len > N ? b_len - N : 0;
+    IIRParallel *par = parallel_alloc(K, n_fir);
+    if (!par) return NULL;
+
+    /* Q(w): long division from the top degree */
+    if (n_fir > 0) {
+        double *rem = (double *)malloc((size_t)b_len * sizeof(double));
+        if (!rem) {
+            free(par);
+            return NULL;
+        }
+        memcpy(rem, b, (size_t)b_len * sizeof(double));
+        for (int d = n_fir - 1; d >= 0; d--) {
+            double q = rem[d + N] / a[N];
+            par->fir[d] = q;
+            for (int j = 0; j <= N; j++)
+                rem[d + j] -= q * a[j];
+        }
+        free(rem);
+    }
+
+    Complex r[2];
+    for (int s = 0; s < K; s++) {
+        int m = (2 * s + 1 < N) ? 2 : 1;
+        for (int t = 0; t < m; t++) {
+            Complex pi = p[2 * s + t], w = c_div((Complex){ 1.0, 0.0 }, pi);
+            Complex num = { 0.0, 0.0 }, den = { 1.0, 0.0 };
+            for (int i = b_len - 1; i >= 0; i--) {  /* Horner: B(1/p_i) */
+                num = complex_mul(num, w);
+                num.re += b[i];
+            }
+            int repeated = 0;
+            for (int j = 0; j < N; j++) {
+                if (j == 2 * s + t) continue;
+                Complex f = complex_mul(p[j], w);
+                f = (Complex){ 1.0 - f.re, -f.im };
+                /* Judge each factor: at high order the product of many
+                 * merely close poles underflows any fixed threshold */
+                if (complex_mag(f) < 1e-12) repeated = 1;
+                den = complex_mul(den, f);
+            }
+            if (repeated || complex_mag(den) == 0.0) {
+                free(par);
+                return NULL;
+            }
+            r[t] = c_div(num, den);
+        }
+        Biquad *q = &par->sections[s];
+        if (m == 2) {
+            Complex p1 = p[2 * s], p2 = p[2 * s + 1];
+            q->b0 = r[0].re + r[1].re;
+            q->b1 = -(complex_mul(r[0], p2).re + complex_mul(r[1], p1).re);
+            q->a1 = -(p1.re + p2.re);
+            q->a2 = complex_mul(p1, p2).re;
+        } else {
+            q->b0 = r[0].re;
+            q->a1 = -p[2 * s].re;
+        }
+    }
+
+    /* Lane layout for simd_iir_parallel(); padding lanes stay zero */
+    for (int s = 0; s < K; s++) {
+        double *c = par->coef + 16 * (s / 4) + (s % 4);
+        c[0]  = par->sections[s].b0;
+        c[4]  = par->sections[s].b1;
+        c[8]  = par->sections[s].a1;
+        c[12] = -par->sections[s].a2;
+    }
+    return par;
+}
+
+/* Order poles for parallel_build(): conjugate pairs, then reals.
+ * p has room for 2N entries; the upper half is scratch. */
+static void pair_poles(Complex *p, int N)
+{
+    Complex *sorted = p + N;                  /* scratch, N more entries */
+    int n_out = 0, used[PARALLEL_MAX_ORDER] = {0};
+    for (int i = 0; i < N; i++) {
+        double tol = 1e-8 * (1.0 + complex_mag(p[i]));
+        if (used[i] || fabs(p[i].im) <= tol) continue;
+        int best = -1;
+        double best_d = 0.0;
+        for (int j = 0; j < N; j++) {
+            if (j == i || used[j]) continue;
+            double d = complex_mag((Complex){ p[j].re - p[i].re, p[j].im + p[i].im });
+            if (best < 0 || d < best_d) {
+                best = j;
+                best_d = d;
+            }
+        }
+        if (best < 0 || best_d > 1e-6 * (1.0 + complex_mag(p[i]))) continue;
+        used[i] = used[best] = 1;
+        double re = 0.5 * (p[i].re + p[best].re);
+        double im = 0.5 * (fabs(p[i].im) + fabs(p[best].im));
+        sorted[n_out++] = (Complex){ re,  im };
+        sorted[n_out++] = (Complex){ re, -im };
+    }
+    for (int i = 0; i < N; i++)
+        if (!used[i]) sorted[n_out++] = (Complex){ p[i].re, 0.0 };
+    memcpy(p, sorted, (size_t)N * sizeof(Complex));
+}
+
+/*
+ * Roots of z^N + c[1]·z^{N−1} + … + c[N] (Durand–Kerner: every root
+ * estimate is refined against all the others at once).
+ * @return 0, or -1 if the iteration does not settle
+ */
+static int poly_roots(const double *c, int N, Complex *z)
+{
+    Complex seed = { 0.4, 0.9 };
+    for (int i = 0; i < N; i++)
+        z[i] = i ? complex_mul(z[i - 1], seed) : seed;
+
+    double moved = 0.0;
+    for (int it = 0; it < 500; it++) {
+        moved = 0.0;
+        for (int i = 0; i < N; i++) {
+            Complex num = { 1.0, 0.0 }, den = { 1.0, 0.0 };
+            for (int k = 1; k <= N; k++) {
+                num = complex_mul(num, z[i]);
+                num.re += c[k];
+            }
+            for (int j = 0; j < N; j++)
+                if (j != i) den = complex_mul(den, complex_sub(z[i], z[j]));
+            Complex step = c_div(num, den);
+            z[i] = complex_sub(z[i], step);
+            double m = complex_mag(step) / (1.0 + complex_mag(z[i]));
+            if (m > moved) moved = m;
+        }
+        if (moved < 1e-15) return 0;
+    }
+    /* Clustered roots jitter at the rounding floor of the expanded
+     * polynomial; that is as good as they get */
+    return moved < 1e-6 ? 0 : -1;
+}
+
+IIRParallel *iir_parallel_create(const double *b, int b_len,
+                                 const double *a, int a_len)
+{
+    if (!b || !a || b_len < 1 || a_len < 1 || a[0] == 0.0) return NULL;
+    int N = a_len - 1;
+    while (N > 0 && a[N] == 0.0) N--;          /* poles at z = 0 are delays */
+    if (N > PARALLEL_MAX_ORDER) return NULL;
+
+    double *an = (double *)malloc((size_t)(N + 1 + b_len) * sizeof(double));
+    Complex *p = (Complex *)malloc((size_t)(2 * N + 1) * sizeof(Complex));
+    IIRParallel *par = NULL;
+    if (an && p) {
+        double *bn = an + N + 1;
+        for (int i = 0; i <= N; i++) an[i] = a[i] / a[0];
+        for (int i = 0; i < b_len; i++) bn[i] = b[i] / a[0];
+        if (poly_roots(an, N, p) == 0) {
+            pair_poles(p, N);
+            par = parallel_build(bn, b_len, an, N, p);
+        }
+    }
+    free(an);
+    free(p);
+    return par;
+}
+
+IIRParallel *iir_parallel_from_biquads(const Biquad *sec, int n_sections,
+                                      double gain)
+{
+    if (!sec || n_sections < 0 || 2 * n_sections > PARALLEL_MAX_ORDER)
+        return NULL;
+
+    /* [bl | al] long double expansion, [b | a] rounded, then
+     * [p (2K poles) | single (K first-order poles)] */
+    int len = 2 * n_sections + 1, N = 0, n_single = 0;
+    long double *bl = (long double *)malloc((size_t)(2 * len) * sizeof(long double));
+    double *b = (double *)malloc((size_t)(2 * len) * sizeof(double));
+    Complex *p = (Complex *)malloc((size_t)(3 * n_sections + 1) * sizeof(Complex));
+    if (!bl || !b || !p) {
+        free(bl);
+        free(b);
+        free(p);
+        return NULL;
+    }
+    long double *al = bl + len;
+    double *a = b + len;
+    Complex *single = p + 2 * n_sections;
+    tf_expand(sec, n_sections, gain, bl, al);
+    for (int i = 0; i < len; i++) {
+        b[i] = (double)bl[i];
+        a[i] = (double)al[i];
+    }
+    free(bl);
+
+    /* Poles straight from each section's quadratic, not from a's roots */
+    for (int k = 0; k < n_sections; k++) {
+        double a1 = sec[k].a1, a2 = sec[k].a2;
+        if (a2 == 0.0) {
+            if (a1 != 0.0) single[n_single++] = (Complex){ -a1, 0.0 };
+            continue;
+        }
+        double disc = a1 * a1 - 4.0 * a2;
+        if (disc < 0.0) {
+            p[N++] = (Complex){ -0.5 * a1,  0.5 * sqrt(-disc) };
+            p[N++] = (Complex){ -0.5 * a1, -0.5 * sqrt(-disc) };
+        } else {
+            double q = -0.5 * (a1 + (a1 >= 0.0 ? sqrt(disc) : -sqrt(disc)));
+            p[N++] = (Complex){ q, 0.0 };
+            p[N++] = (Complex){ a2 / q, 0.0 };
+        }
+    }
+    for (int i = 0; i < n_single; i++)
+        p[N++] = single[i];
+
+    int b_len = len;
+    while (b_len > 1 && b[b_len - 1] == 0.0) b_len--;
+    IIRParallel *par = parallel_build(b, b_len, a, N, p);
+    free(b);
+    free(p);
+    return par;
+}
+
+IIRParallel *iir_parallel_from_sos(const SOSCascade *sos)
+{
+    return iir_parallel_from_biquads(sos->sections, sos->n_sections, sos->gain);
+}
+
+IIRParallel *iir_parallel_from_chain(const SOSChain *c)
+{
+    return iir_parallel_from_biquads(c->sections, c->n_sections, c->gain);
+}
+
+void iir_parallel_process(IIRParallel *p, const double *in, double *out, int n)
+{
+    double c0 = p->n_fir ? p->fir[0] : 0.0;
+    if (p->n_groups == 0) {
+        for (int i = 0; i < n; i++) out[i] = c0 * in[i];
+    } else {
+        simd_iir_parallel(p->coef, p->state, p->n_groups, c0, in, out, n);
+    }
+
+    /* Rest of Q(w): hist[j−1] = x[−j] from the previous block */
+    int F = p->n_fir;
+    if (F < 2) return;
+    for (int i = 0; i < n; i++) {
+        double acc = 0.0;
+        for (int j = 1; j < F; j++)
+            acc += p->fir[j] * (i >= j ? in[i - j] : p->hist[j - i - 1]);
+        out[i] += acc;
+    }
+    for (int j = F - 1; j >= 1; j--)
+        p->hist[j - 1] = (n >= j) ? in[n - j] : p->hist[j - n - 1];
+}
+
+void iir_parallel_reset(IIRParallel *p)
+{
+    memset(p->state, 0, (size_t)p->n_groups * 8 * sizeof(double));
+    if (p->n_fir > 1)
+        memset(p->hist, 0, (size_t)(p->n_fir - 1) * sizeof(double));
+}
+
+void iir_parallel_destroy(IIRParallel *p)
+{
+    free(p);
+}
+
+/* Step-down and ladder solve in long double; b and a have len N+1, a[0] = 1 */
+static IIRLattice *lattice_build(const long double *b, const long double *a, int N)
+{
+    long double *alpha = (long double *)malloc((size_t)(N + 2) * (N + 1) * sizeof(long double));
+    size_t head = sos_align(sizeof(IIRLattice));
+    IIRLattice *l = (IIRLattice *)calloc(1, head + (size_t)(3 * N + 2) * sizeof(double));
+    if (!alpha || !l) {
+        free(alpha);
+        free(l);
+        return NULL;
+    }
+    l->order = N;
+    l->k = (double *)((unsigned char *)l + head);
+    l->v = l->k + N;
+    l->g = l->v + N + 1;
+
+    /* alpha[m·(N+1) + i] = α_m(i) */
+    for (int i = 0; i <= N; i++) alpha[(size_t)N * (N + 1) + i] = a[i];
+    for (int m = N; m >= 1; m--) {
+        const long double *am = alpha + (size_t)m * (N + 1);
+        long double *ad = alpha + (size_t)(m - 1) * (N + 1);
+        long double km = am[m];
+        if (fabsl(km) >= 1.0L) {                 /* pole on/outside the circle */
+            free(alpha);
+            free(l);
+            return NULL;
+        }
+        l->k[m - 1] = (double)km;
+        for (int i = 0; i < m; i++)
+            ad[i] = (am[i] - km * am[m - i]) / (1.0L - km * km);
+    }
+    long double *v = alpha + (size_t)(N + 1) * (N + 1);
+    for (int m = N; m >= 0; m--) {
+        v[m] = b[m];
+        for (int q = m + 1; q <= N; q++)
+            v[m] -= v[q] * alpha[(size_t)q * (N + 1) + (q - m)];
+        l->v[m] = (double)v[m];
+    }
+    free(alpha);
+    return l;
+}
+
+IIRLattice *iir_lattice_create(const double *b, int b_len,
+                               const double *a, int a_len)
+{
+    if (!b || !a || b_len < 1 || a_len < 1 || a[0] == 0.0) return NULL;
+    int N = (a_len > b_len ? a_len : b_len) - 1;
+    long double *bl = (long double *)calloc((size_t)(2 * N + 2), sizeof(long double));
+    if (!bl) return NULL;
+    long double *al = bl + N + 1;
+    for (int i = 0; i < b_len; i++) bl[i] = (long double)b[i] / a[0];
+    for (int i = 0; i < a_len; i++) al[i] = (long double)a[i] / a[0];
+    IIRLattice *l = lattice_build(bl, al, N);
+    free(bl);
+    return l;
+}
+
+IIRLattice *iir_lattice_from_biquads(const Biquad *sec, int n_sections,
+                                    double gain)
+{
+    if (!sec || n_sections < 0 || 2 * n_sections > PARALLEL_MAX_ORDER)
+        return NULL;
+    int len = 2 * n_sections + 1;
+    long double *b = (long double *)malloc((size_t)(2 * len) * sizeof(long double));
+    if (!b) return NULL;
+    long double *a = b + len;
+    tf_expand(sec, n_sections, gain, b, a);
+    IIRLattice *l = lattice_build(b, a, len - 1);
+    free(b);
+    return l;
+}
+
+IIRLattice *iir_lattice_from_sos(const SOSCascade *sos)
+{
+    return iir_lattice_from_biquads(sos->sections, sos->n_sections, sos->gain);
+}
+
+IIRLattice *iir_lattice_from_chain(const SOSChain *c)
+{
+    return iir_lattice_from_biquads(c->sections, c->n_sections, c->gain);
+}
+
+void iir_lattice_process(IIRLattice *l, const double *in, double *out, int n)
+{
+    int N = l->order;
+    const double *k = l->k, *v = l->v;
+    double *g = l->g;
+    for (int i = 0; i < n; i++) {
+        double f = in[i], y = 0.0;
+        for (int m = N; m >= 1; m--) {
+            f -= k[m - 1] * g[m - 1];            /* g[m−1] still holds n−1 */
+            g[m] = k[m - 1] * f + g[m - 1];
+            y += v[m] * g[m];
+        }
+        g[0] = f;
+        out[i] = y + v[0] * f;
+    }
+}
+
+void iir_lattice_reset(IIRLattice *l)
+{
+    memset(l->g, 0, (size_t)(l->order + 1) * sizeof(double));
+}
+
+void iir_lattice_destroy(IIRLattice *l)
+{
+    free(l);
 }
 
 /* ══════════════════════════════════════════════════════════════════
@@ -247,13 +933,16 @@ void sos_process_block(SOSCascade *sos,
  *       |
  * ══════════════════════════════════════════════════════════════════ */
 
-int butterworth_lowpass(int order, double cutoff, SOSCascade *sos)
+/*
+ * The designers write ⌈order/2⌉ sections into sec[] and the overall gain
+ * into *gain, and return the section count; the public SOSCascade and
+ * SOSChain entry points validate, clear state and supply the storage.
+ */
+static int design_butterworth_lowpass(int order, double cutoff,
+                                      Biquad *sec, double *gain)
 {
-    if (order < 1 || order > 2 * MAX_SOS_SECTIONS ||
-        cutoff <= 0.0 || cutoff >= 0.5)
-        return -1;
-
-    sos_init(sos);
+    int n = 0;
+    *gain = 1.0;
 
     /* Step 1: Pre-warp the digital cutoff to analog frequency.
      *   ωd = 2π · cutoff   (digital angular frequency)
@@ -309,14 +998,13 @@ int butterworth_lowpass(int order, double cutoff, SOSCascade *sos)
          */
         double K = (1.0 + a1 + a2) / 4.0;
 
-        Biquad *bq = &sos->sections[sos->n_sections];
+        Biquad *bq = &sec[n];
         bq->b0 = K;
         bq->b1 = 2.0 * K;
         bq->b2 = K;
         bq->a1 = a1;
         bq->a2 = a2;
-        biquad_df1_init(&sos->states[sos->n_sections]);
-        sos->n_sections++;
+        n++;
     }
 
     /* Step 4: Handle real pole (odd order only).
@@ -333,16 +1021,39 @@ int butterworth_lowpass(int order, double cutoff, SOSCascade *sos)
          * DC gain: K·2 / (1 − zp) = 1  →  K = (1 − zp) / 2 */
         double K = (1.0 - zp) / 2.0;  /* actually 1 + (-zp) = 1 - zp */
 
-        Biquad *bq = &sos->sections[sos->n_sections];
+        Biquad *bq = &sec[n];
         bq->b0 = K;
         bq->b1 = K;
         bq->b2 = 0.0;
         bq->a1 = -zp;
         bq->a2 = 0.0;
-        biquad_df1_init(&sos->states[sos->n_sections]);
-        sos->n_sections++;
+        n++;
     }
 
+    return n;
+}
+
+int butterworth_lowpass(int order, double cutoff, SOSCascade *sos)
+{
+    if (order < 1 || order > 2 * MAX_SOS_SECTIONS ||
+        cutoff <= 0.0 || cutoff >= 0.5)
+        return -1;
+
+    sos_init(sos);
+    sos->n_sections = design_butterworth_lowpass(order, cutoff,
+                                                 sos->sections, &sos->gain);
+    return 0;
+}
+
+int butterworth_lowpass_chain(int order, double cutoff, SOSChain *c)
+{
+    if (!c || order < 1 || sos_chain_sections(order) > c->capacity ||
+        cutoff <= 0.0 || cutoff >= 0.5)
+        return -1;
+
+    sos_chain_reset(c);
+    c->n_sections = design_butterworth_lowpass(order, cutoff,
+                                               c->sections, &c->gain);
     return 0;
 }
 
@@ -358,22 +1069,14 @@ int butterworth_lowpass(int order, double cutoff, SOSCascade *sos)
  * Numerator zeros move from z = −1 (lowpass) to z = +1 (highpass),
  * creating a DC null instead of a Nyquist null.
  */
-int butterworth_highpass(int order, double cutoff, SOSCascade *sos)
+static int design_butterworth_highpass(int order, double cutoff,
+                                       Biquad *sec, double *gain)
 {
-    /* Design the complementary lowpass first */
-    double lp_cutoff = 0.5 - cutoff;
-    if (lp_cutoff <= 0.0 || lp_cutoff >= 0.5)
-        return -1;
+    int n = 0;
+    *gain = 1.0;
 
-    /* Actually, the correct approach is to pre-warp the highpass cutoff
-     * and use the analog highpass prototype directly. */
-    if (order < 1 || order > 2 * MAX_SOS_SECTIONS ||
-        cutoff <= 0.0 || cutoff >= 0.5)
-        return -1;
-
-    sos_init(sos);
-
-    /* Pre-warp the highpass cutoff */
+    /* The analog highpass prototype is used directly (rather than the
+     * complementary lowpass at 0.5 − cutoff); pre-warp the highpass cutoff */
     double wd = 2.0 * M_PI * cutoff;
     double Wa = 2.0 * tan(wd / 2.0);
 
@@ -413,14 +1116,13 @@ int butterworth_highpass(int order, double cutoff, SOSCascade *sos)
          */
         double K = (1.0 - a1 + a2) / 4.0;
 
-        Biquad *bq = &sos->sections[sos->n_sections];
+        Biquad *bq = &sec[n];
         bq->b0 = K;
         bq->b1 = -2.0 * K;
         bq->b2 = K;
         bq->a1 = a1;
         bq->a2 = a2;
-        biquad_df1_init(&sos->states[sos->n_sections]);
-        sos->n_sections++;
+        n++;
     }
 
     if (has_real) {
@@ -436,16 +1138,39 @@ int butterworth_highpass(int order, double cutoff, SOSCascade *sos)
          * K = (1 + zp) / 2 */
         double K = (1.0 + zp) / 2.0;
 
-        Biquad *bq = &sos->sections[sos->n_sections];
+        Biquad *bq = &sec[n];
         bq->b0 = K;
         bq->b1 = -K;
         bq->b2 = 0.0;
         bq->a1 = -zp;
         bq->a2 = 0.0;
-        biquad_df1_init(&sos->states[sos->n_sections]);
-        sos->n_sections++;
+        n++;
     }
 
+    return n;
+}
+
+int butterworth_highpass(int order, double cutoff, SOSCascade *sos)
+{
+    if (order < 1 || order > 2 * MAX_SOS_SECTIONS ||
+        cutoff <= 0.0 || cutoff >= 0.5)
+        return -1;
+
+    sos_init(sos);
+    sos->n_sections = design_butterworth_highpass(order, cutoff,
+                                                  sos->sections, &sos->gain);
+    return 0;
+}
+
+int butterworth_highpass_chain(int order, double cutoff, SOSChain *c)
+{
+    if (!c || order < 1 || sos_chain_sections(order) > c->capacity ||
+        cutoff <= 0.0 || cutoff >= 0.5)
+        return -1;
+
+    sos_chain_reset(c);
+    c->n_sections = design_butterworth_highpass(order, cutoff,
+                                                c->sections, &c->gain);
     return 0;
 }
 
@@ -470,14 +1195,11 @@ int butterworth_highpass(int order, double cutoff, SOSCascade *sos)
  *        |     ×    semi-major = Ωc·cosh(a)
  * ══════════════════════════════════════════════════════════════════ */
 
-int chebyshev1_lowpass(int order, double ripple_db, double cutoff,
-                       SOSCascade *sos)
+static int design_chebyshev1_lowpass(int order, double ripple_db, double cutoff,
+                                     Biquad *sec, double *gain)
 {
-    if (order < 1 || order > 2 * MAX_SOS_SECTIONS ||
-        cutoff <= 0.0 || cutoff >= 0.5 || ripple_db <= 0.0)
-        return -1;
-
-    sos_init(sos);
+    int n = 0;
+    *gain = 1.0;
 
     /* Ripple parameter: ε = √(10^{R/10} − 1) */
     double eps = sqrt(pow(10.0, ripple_db / 10.0) - 1.0);
@@ -517,14 +1239,13 @@ int chebyshev1_lowpass(int order, double ripple_db, double cutoff,
         /* Lowpass numerator zeros at z = −1 */
         double K = (1.0 + a1 + a2) / 4.0;
 
-        Biquad *bq = &sos->sections[sos->n_sections];
+        Biquad *bq = &sec[n];
         bq->b0 = K;
         bq->b1 = 2.0 * K;
         bq->b2 = K;
         bq->a1 = a1;
         bq->a2 = a2;
-        biquad_df1_init(&sos->states[sos->n_sections]);
-        sos->n_sections++;
+        n++;
     }
 
     if (has_real) {
@@ -534,14 +1255,13 @@ int chebyshev1_lowpass(int order, double ripple_db, double cutoff,
 
         double K = (1.0 + (-zp)) / 2.0;
 
-        Biquad *bq = &sos->sections[sos->n_sections];
+        Biquad *bq = &sec[n];
         bq->b0 = K;
         bq->b1 = K;
         bq->b2 = 0.0;
         bq->a1 = -zp;
         bq->a2 = 0.0;
-        biquad_df1_init(&sos->states[sos->n_sections]);
-        sos->n_sections++;
+        n++;
     }
 
     /* Chebyshev gain correction:
@@ -553,8 +1273,8 @@ int chebyshev1_lowpass(int order, double ripple_db, double cutoff,
         /* Even order: scale so DC gain = 1/√(1+ε²) (passband edge) */
         /* Actually, we'll just normalise DC to match expected level */
         double dc_gain = 1.0;
-        for (int i = 0; i < sos->n_sections; i++) {
-            Biquad *bq = &sos->sections[i];
+        for (int i = 0; i < n; i++) {
+            Biquad *bq = &sec[i];
             double section_dc = (bq->b0 + bq->b1 + bq->b2) /
                                 (1.0 + bq->a1 + bq->a2);
             dc_gain *= section_dc;
@@ -562,10 +1282,36 @@ int chebyshev1_lowpass(int order, double ripple_db, double cutoff,
         if (fabs(dc_gain) > 1e-30) {
             /* For even-order Chebyshev, DC should be 1/√(1+ε²) */
             double target_dc = 1.0 / sqrt(1.0 + eps * eps);
-            sos->gain = target_dc / dc_gain;
+            *gain = target_dc / dc_gain;
         }
     }
 
+    return n;
+}
+
+int chebyshev1_lowpass(int order, double ripple_db, double cutoff,
+                       SOSCascade *sos)
+{
+    if (order < 1 || order > 2 * MAX_SOS_SECTIONS ||
+        cutoff <= 0.0 || cutoff >= 0.5 || ripple_db <= 0.0)
+        return -1;
+
+    sos_init(sos);
+    sos->n_sections = design_chebyshev1_lowpass(order, ripple_db, cutoff,
+                                                sos->sections, &sos->gain);
+    return 0;
+}
+
+int chebyshev1_lowpass_chain(int order, double ripple_db, double cutoff,
+                             SOSChain *c)
+{
+    if (!c || order < 1 || sos_chain_sections(order) > c->capacity ||
+        cutoff <= 0.0 || cutoff >= 0.5 || ripple_db <= 0.0)
+        return -1;
+
+    sos_chain_reset(c);
+    c->n_sections = design_chebyshev1_lowpass(order, ripple_db, cutoff,
+                                              c->sections, &c->gain);
     return 0;
 }
 
@@ -631,15 +1377,16 @@ void biquad_freq_response(const Biquad *bq,
     freq_response(b, 3, a, 3, mag, phase, n_points);
 }
 
-void sos_freq_response(const SOSCascade *sos,
-                       double *mag, double *phase, int n_points)
+/* Product of the section responses, times the gain */
+static void sections_freq_response(const Biquad *sec, int n_sections, double gain,
+                                   double *mag, double *phase, int n_points)
 {
     if (n_points <= 0) return;
 
     /* Initialise to gain only */
     for (int i = 0; i < n_points; i++) {
-        mag[i]   = fabs(sos->gain);
-        if (phase) phase[i] = (sos->gain < 0) ? M_PI : 0.0;
+        mag[i]   = fabs(gain);
+        if (phase) phase[i] = (gain < 0) ? M_PI : 0.0;
     }
 
     /* Multiply each section's response */
@@ -650,8 +1397,8 @@ void sos_freq_response(const SOSCascade *sos,
         return;
     }
 
-    for (int s = 0; s < sos->n_sections; s++) {
-        biquad_freq_response(&sos->sections[s], sec_mag, sec_phase, n_points);
+    for (int s = 0; s < n_sections; s++) {
+        biquad_freq_response(&sec[s], sec_mag, sec_phase, n_points);
         for (int i = 0; i < n_points; i++) {
             mag[i]   *= sec_mag[i];
             if (phase) phase[i] += sec_phase[i];
@@ -662,6 +1409,20 @@ void sos_freq_response(const SOSCascade *sos,
     free(sec_phase);
 }
 
+void sos_freq_response(const SOSCascade *sos,
+                       double *mag, double *phase, int n_points)
+{
+    sections_freq_response(sos->sections, sos->n_sections, sos->gain,
+                           mag, phase, n_points);
+}
+
+void sos_chain_freq_response(const SOSChain *c,
+                             double *mag, double *phase, int n_points)
+{
+    sections_freq_response(c->sections, c->n_sections, c->gain,
+                           mag, phase, n_points);
+}
+
 /**
  * Approximate group delay at a single frequency using
  * central finite difference:
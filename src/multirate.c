@@ -7,7 +7,9 @@
  *   x[n] ──► [FIR LPF fc=0.5/M] ──► keep every M-th ──► y[m]
  *
  *   Anti-alias filter prevents spectral folding after down-sampling.
- *   Output length = floor(n / M).
+ *   Output length = floor(n / M).  Only the kept samples are computed
+ *   (DecimatorState): len/M multiplies per output instead of the
+ *   ⌈len/2⌉ per input of a folded full-rate filter.
  *
  * ── Interpolation Pipeline ───────────────────────────────────────
  *
@@ -26,6 +28,18 @@
  *             └──► [hₘ₋₁]─┘
  *
  *   Each hₖ processes at rate 1/M → M× fewer multiplies.
+ *
+ * ── Polyphase Resampler (L/M) ────────────────────────────────────
+ *
+ *   t:      0  1  2  3  4  5  6  7  8          (L = 3, M = 2)
+ *   x↑L:    x₀ 0  0  x₁ 0  0  x₂ 0  0
+ *   kept:   ▲     ▲     ▲     ▲     ▲
+ *
+ *   Output m lands on high-rate time t = m·M.  Only the taps that hit
+ *   real samples matter: g[p], g[p + L], g[p + 2L], … with p = t mod L.
+ *   So each output is one dot product with branch p, and resample()
+ *   does n·L/M of them instead of filtering all n·L zero-stuffed
+ *   samples.
  */
 
 #include "multirate.h"
@@ -34,6 +48,10 @@
 #include <string.h>
 #include <math.h>
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
 /* Internal anti-alias filter taps (auto-sized) */
 #define ANTI_ALIAS_TAPS_PER_FACTOR 8
 #define MIN_TAPS 15
@@ -59,22 +77,11 @@ int decimate(const double *x, int n, int M, double *y)
         return n;
     }
 
-    /* Design anti-alias lowpass */
-    int taps = compute_filter_len(M);
-    double *h = (double *)calloc((size_t)taps, sizeof(double));
-    double cutoff = 0.5 / (double)M;
-    fir_lowpass(h, taps, cutoff);
-
-    /* Filter, then downsample */
-    double *filtered = (double *)calloc((size_t)n, sizeof(double));
-    fir_filter(x, filtered, n, h, taps);
-
-    int out_len = 0;
-    for (int i = 0; i < n; i += M)
-        y[out_len++] = filtered[i];
-
-    free(h);
-    free(filtered);
+    /* Anti-alias lowpass, evaluated only at the kept samples */
+    DecimatorState s;
+    if (decimator_init(&s, M, NULL, 0) != 0) return 0;
+    int out_len = decimator_process(&s, x, n, y);
+    decimator_free(&s);
     return out_len;
 }
 
@@ -88,54 +95,57 @@ int interpolate(const double *x, int n, int L, double *y)
         return n;
     }
 
-    int out_len = n * L;
-
-    /* Zero-insert: place original samples at multiples of L */
-    double *upsampled = (double *)calloc((size_t)out_len, sizeof(double));
-    for (int i = 0; i < n; i++)
-        upsampled[i * L] = x[i];
-
-    /* Design anti-image lowpass with gain = L */
-    int taps = compute_filter_len(L);
-    double *h = (double *)calloc((size_t)taps, sizeof(double));
-    double cutoff = 0.5 / (double)L;
-    fir_lowpass(h, taps, cutoff);
-
-    /* Scale by L to compensate for zero-inserted energy loss */
-    for (int i = 0; i < taps; i++)
-        h[i] *= (double)L;
-
-    fir_filter(upsampled, y, out_len, h, taps);
-
-    free(upsampled);
-    free(h);
+    /* Anti-image lowpass (gain L), run on the L branches of x directly */
+    InterpolatorState s;
+    if (interpolator_init(&s, L, NULL, 0) != 0) return 0;
+    int out_len = interpolator_process(&s, x, n, y);
+    interpolator_free(&s);
     return out_len;
 }
 
 /* ── Rational Resampling ──────────────────────────────────────── */
 
+static int resampler_setup(ResamplerState *s, int L, int M,
+                           const double *g, int len);
+
 int resample(const double *x, int n, int L, int M, double *y)
 {
     if (L <= 0 || M <= 0 || n <= 0 || !x || !y) return 0;
+    if (L == 1 && M == 1) {
+        memcpy(y, x, (size_t)n * sizeof(double));
+        return n;
+    }
 
-    /* Interpolate by L first */
-    int interp_len = n * L;
-    double *tmp = (double *)calloc((size_t)interp_len, sizeof(double));
-    interpolate(x, n, L, tmp);
+    /*
+     * Same response as interpolating by L (anti-image filter, gain L;
+     * none when L = 1) and then, when L < M, decimating by M (anti-
+     * alias filter) — as one high-rate filter g, run polyphase.
+     */
+    int tl = (L > 1) ? compute_filter_len(L) : 1;
+    int tm = (L < M) ? compute_filter_len(M) : 1;
+    double *hl = (double *)malloc((size_t)(tl + tm + tl + tm - 1) * sizeof(double));
+    if (!hl) return 0;
+    double *hm = hl + tl, *g = hm + tm;
 
-    /* Then decimate by M (no extra filter — interpolation filter
-     * already limits bandwidth to min(1/L, 1/M) if L >= M) */
-    int out_len = 0;
-    if (L >= M) {
-        /* Already bandwidth-limited by interpolation filter */
-        for (int i = 0; i < interp_len; i += M)
-            y[out_len++] = tmp[i];
-    } else {
-        /* Need additional anti-alias filter */
-        out_len = decimate(tmp, interp_len, M, y);
+    hl[0] = 1.0;
+    if (L > 1) {
+        fir_lowpass(hl, tl, 0.5 / (double)L);
+        for (int i = 0; i < tl; i++) hl[i] *= (double)L;
     }
+    hm[0] = 1.0;
+    if (L < M) fir_lowpass(hm, tm, 0.5 / (double)M);
+    memset(g, 0, (size_t)(tl + tm - 1) * sizeof(double));
+    for (int i = 0; i < tl; i++)
+        for (int j = 0; j < tm; j++)
+            g[i + j] += hl[i] * hm[j];
 
-    free(tmp);
+    ResamplerState s;
+    int out_len = 0;
+    if (resampler_setup(&s, L, M, g, tl + tm - 1) == 0) {
+        out_len = resampler_process(&s, x, n, y);
+        resampler_free(&s);
+    }
+    free(hl);
     return out_len;
 }
 
@@ -158,17 +168,991 @@ int polyphase_decimate(const double *x, int n,
         double acc = 0.0;
         int base = out_idx * M;  /* Input index for this output */
 
-        for (int k = 0; k < M; k++) {
-            /* Sub-filter k, applied to x[base - k] (time-reversed) */
-            for (int m = 0; m < sub_len; m++) {
-                int h_idx = k + m * M;
-                int x_idx = base - k - m * M;
-                if (h_idx < taps && x_idx >= 0 && x_idx < n)
-                    acc += h[h_idx] * x[x_idx];
-            }
+        for (int k = 0; k < M && k <= base; k++) {
+            /* Sub-filter k, applied to x[base - k] (time-reversed);
+             * m stops at the end of hₖ or at x[0], whichever is first */
+            int m_end = (taps - k + M - 1) / M;
+            int m_max = (base - k) / M + 1;
+            if (m_end > m_max) m_end = m_max;
+            if (m_end > sub_len) m_end = sub_len;
+            const double *xk = x + base - k;
+            for (int m = 0; m < m_end; m++)
+                acc += h[k + m * M] * xk[-m * M];
         }
         y[out_idx] = acc;
     }
 
     return out_len;
 }
+
+/* ── Streaming Decimator ──────────────────────────────────────── */
+
+/* Taps per branch from which folding beats the plain dot products
+ * (shorter branches spend more on pair bookkeeping than they save) */
+#define DECIM_FOLD_MIN 12
+
+/* Split h (len taps) into P branches of J: branch p holds h[p + j·P] */
+static double *split_branches(const double *h, int len, int P, int *J_out)
+{
+    int J = (len + P - 1) / P;
+    *J_out = J;
+    double *b = (double *)calloc((size_t)P * J, sizeof(double));
+    if (!b) return NULL;
+    for (int p = 0; p < P; p++)
+        for (int j = 0; j < J && p + j * P < len; j++)
+            b[(size_t)p * J + j] = h[p + j * P];
+    return b;
+}
+
+/* The lowpass decimate()/interpolate() use for a factor, scaled by gain */
+static double *design_lowpass(int factor, int *taps, double gain)
+{
+    if (*taps <= 0) *taps = compute_filter_len(factor);
+    double *h = (double *)malloc((size_t)*taps * sizeof(double));
+    if (!h) return NULL;
+    fir_lowpass(h, *taps, 0.5 / (double)factor);
+    if (gain != 1.0)
+        for (int i = 0; i < *taps; i++) h[i] *= gain;
+    return h;
+}
+
+int decimator_init(DecimatorState *s, int M, const double *h, int taps)
+{
+    memset(s, 0, sizeof(*s));
+    if (M <= 0 || (h && taps <= 0)) return -1;
+
+    double *own = NULL;
+    if (!h) {
+        own = design_lowpass(M, &taps, 1.0);
+        if (!own) return -1;
+        h = own;
+    }
+    FirSymmetry sym = fir_symmetry(h, taps);
+    s->len = taps;
+    s->branch = split_branches(h, taps, M, &s->taps);
+    free(own);
+    if (!s->branch) return -1;
+    if (s->taps >= DECIM_FOLD_MIN)
+        s->sym = sym == FIR_SYM_EVEN ? 1 : sym == FIR_SYM_ODD ? -1 : 0;
+
+    s->delay = (double *)calloc((size_t)M * 2 * s->taps, sizeof(double));
+    if (!s->delay) {
+        decimator_free(s);
+        return -1;
+    }
+    s->M = M;
+    return 0;
+}
+
+/* One output from the M branch lines, pos = newest slot */
+static double decimator_dot(const DecimatorState *s, int pos)
+{
+    int J = s->taps;
+    double acc = 0.0;
+    for (int k = 0; k < s->M; k++) {
+        const double *b = s->branch + (size_t)k * J;
+        const double *x = s->delay + (size_t)k * 2 * J + pos;
+        for (int j = 0; j < J; j++)
+            acc += b[j] * x[j];
+    }
+    return acc;
+}
+
+/* Same output for (anti)symmetric h: tap k + j·M of branch k mirrors
+ * onto tap n_k − 1 − j of branch k' = (len − 1 − k) mod M, which holds
+ * the same n_k = ⌈(len − k)/M⌉ taps reversed */
+static double decimator_folded(const DecimatorState *s, int pos)
+{
+    int J = s->taps, M = s->M, len = s->len;
+    double acc = 0.0;
+    for (int k = 0, k2 = (len - 1) % M; k < M && k < len;
+         k++, k2 = (k2 == 0 ? M : k2) - 1) {
+        if (k2 < k) continue;               /* pair done from branch k2 */
+        int nk = (len - k + M - 1) / M;
+        int np = (k2 != k) ? nk : nk / 2;   /* pairs */
+        const double *b  = s->branch + (size_t)k * J;
+        const double *x  = s->delay + (size_t)k * 2 * J + pos;
+        const double *xm = s->delay + (size_t)k2 * 2 * J + pos + nk - 1;
+        double a0 = 0.0, a1 = 0.0;
+        int j = 0;
+        if (s->sym > 0) {
+            for (; j + 1 < np; j += 2) {
+                a0 += b[j]     * (x[j]     + xm[-j]);
+                a1 += b[j + 1] * (x[j + 1] + xm[-j - 1]);
+            }
+            if (j < np) a0 += b[j] * (x[j] + xm[-j]);
+        } else {
+            for (; j + 1 < np; j += 2) {
+                a0 += b[j]     * (x[j]     - xm[-j]);
+                a1 += b[j + 1] * (x[j + 1] - xm[-j - 1]);
+            }
+            if (j < np) a0 += b[j] * (x[j] - xm[-j]);
+        }
+        if (k2 == k && (nk & 1))
+            a0 += b[nk / 2] * x[nk / 2];
+        acc += a0 + a1;
+    }
+    return acc;
+}
+
+int decimator_process(DecimatorState *s, const double *in, int n, double *out)
+{
+    int J = s->taps, M = s->M;
+    int pos = s->pos, phase = s->phase;
+    int out_len = 0;
+
+    for (int i = 0; i < n; i++) {
+        /* Inputs m·M − (M−1) … m·M go to branches M−1 … 0; the first
+         * of each group starts a new low-rate slot in every line */
+        if (phase == M - 1)
+            pos = (pos == 0 ? J : pos) - 1;
+        double *dl = s->delay + (size_t)phase * 2 * J;
+        dl[pos] = dl[pos + J] = in[i];
+
+        if (phase > 0) {
+            phase--;
+            continue;
+        }
+        /* Branch 0 just took x[m·M]: line k holds x[m·M − k − j·M] */
+        out[out_len++] = s->sym ? decimator_folded(s, pos)
+                                : decimator_dot(s, pos);
+        phase = M - 1;
+    }
+    s->pos   = pos;
+    s->phase = phase;
+    return out_len;
+}
+
+void decimator_reset(DecimatorState *s)
+{
+    memset(s->delay, 0, (size_t)s->M * 2 * s->taps * sizeof(double));
+    s->pos   = 0;
+    s->phase = 0;
+}
+
+void decimator_free(DecimatorState *s)
+{
+    if (s) {
+        free(s->branch); s->branch = NULL;
+        free(s->delay);  s->delay  = NULL;
+    }
+}
+
+/* ── Streaming Interpolator ───────────────────────────────────── */
+
+int interpolator_init(InterpolatorState *s, int L, const double *h, int taps)
+{
+    memset(s, 0, sizeof(*s));
+    if (L <= 0 || (h && taps <= 0)) return -1;
+
+    double *own = NULL;
+    if (!h) {
+        own = design_lowpass(L, &taps, (double)L);
+        if (!own) return -1;
+        h = own;
+    }
+    s->branch = split_branches(h, taps, L, &s->taps);
+    free(own);
+    if (!s->branch) return -1;
+
+    s->delay = (double *)calloc((size_t)(2 * s->taps), sizeof(double));
+    if (!s->delay) {
+        interpolator_free(s);
+        return -1;
+    }
+    s->L = L;
+    return 0;
+}
+
+int interpolator_process(InterpolatorState *s, const double *in, int n,
+                         double *out)
+{
+    int J = s->taps, L = s->L;
+    double *dl = s->delay;
+    int pos = s->pos;
+
+    for (int i = 0; i < n; i++) {
+        pos = (pos == 0 ? J : pos) - 1;
+        dl[pos] = dl[pos + J] = in[i];
+
+        const double *x = dl + pos;
+        for (int p = 0; p < L; p++) {
+            const double *b = s->branch + (size_t)p * J;
+            double acc = 0.0;
+            for (int j = 0; j < J; j++)
+                acc += b[j] * x[j];
+            *out++ = acc;
+        }
+    }
+    s->pos = pos;
+    return n * L;
+}
+
+void interpolator_reset(InterpolatorState *s)
+{
+    memset(s->delay, 0, (size_t)(2 * s->taps) * sizeof(double));
+    s->pos = 0;
+}
+
+void interpolator_free(InterpolatorState *s)
+{
+    if (s) {
+        free(s->branch); s->branch = NULL;
+        free(s->delay);  s->delay  = NULL;
+    }
+}
+
+/* ── Streaming Polyphase Resampler ────────────────────────────── */
+
+/* Split g (len taps, at the L-fold rate) into L branches for an L/M resampler */
+static int resampler_setup(ResamplerState *s, int L, int M,
+                           const double *g, int len)
+{
+    memset(s, 0, sizeof(*s));
+    if (L <= 0 || M <= 0 || !g || len <= 0) return -1;
+
+    int J;
+    s->branch = split_branches(g, len, L, &J);
+    s->delay  = (double *)calloc((size_t)(2 * J), sizeof(double));
+    if (!s->branch || !s->delay) {
+        resampler_free(s);
+        return -1;
+    }
+    s->L    = L;
+    s->M    = M;
+    s->taps = J;
+    s->need = 1;            /* output 0 is due with x[0] */
+    return 0;
+}
+
+static int gcd_int(int a, int b)
+{
+    while (b) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+int resampler_init(ResamplerState *s, int L, int M, int taps_per_phase)
+{
+    memset(s, 0, sizeof(*s));
+    if (L <= 0 || M <= 0) return -1;
+    int d = gcd_int(L, M);
+    L /= d;
+    M /= d;
+    if (taps_per_phase <= 0) taps_per_phase = 24;
+
+    int len = taps_per_phase * L - 1;
+    if (len < 1) len = 1;
+    double *g = (double *)malloc((size_t)len * sizeof(double));
+    if (!g) return -1;
+    fir_lowpass(g, len, 0.5 / (double)(L > M ? L : M));
+    for (int i = 0; i < len; i++) g[i] *= (double)L;
+
+    int rc = resampler_setup(s, L, M, g, len);
+    free(g);
+    return rc;
+}
+
+int resampler_max_output(const ResamplerState *s, int n)
+{
+    /* Output k from now is due within n inputs iff
+     * k·M < (n − need + 1)·L − phase */
+    long long room = (long long)(n - s->need + 1) * s->L - s->phase;
+    return room > 0 ? (int)((room + s->M - 1) / s->M) : 0;
+}
+
+int resampler_process(ResamplerState *s, const double *in, int n, double *out)
+{
+    int J = s->taps, L = s->L, M = s->M;
+    double *dl = s->delay;
+    int pos = s->pos, phase = s->phase, need = s->need;
+    int out_len = 0;
+
+    for (int i = 0; i < n; i++) {
+        pos = (pos == 0 ? J : pos) - 1;
+        dl[pos] = dl[pos + J] = in[i];
+        if (--need > 0) continue;
+
+        /* dl[pos + j] = x[i₀ − j] */
+        const double *x = dl + pos;
+        while (need == 0) {
+            const double *b = s->branch + (size_t)phase * J;
+            double acc = 0.0;
+            for (int j = 0; j < J; j++)
+                acc += b[j] * x[j];
+            out[out_len++] = acc;
+
+            phase += M;
+            need   = phase / L;
+            phase %= L;
+        }
+    }
+    s->pos   = pos;
+    s->phase = phase;
+    s->need  = need;
+    return out_len;
+}
+
+void resampler_reset(ResamplerState *s)
+{
+    memset(s->delay, 0, (size_t)(2 * s->taps) * sizeof(double));
+    s->pos   = 0;
+    s->phase = 0;
+    s->need  = 1;
+}
+
+void resampler_free(ResamplerState *s)
+{
+    if (s) {
+        free(s->branch); s->branch = NULL;
+        free(s->delay);  s->delay  = NULL;
+    }
+}
+
+/* ── Streaming Arbitrary-Ratio Resampler ──────────────────────── */
+
+#define FRAC_PHASES 256
+
+/* Blackman-windowed sinc, cutoff fc (cycles/sample), support |t| ≤ half */
+static double frac_kernel(double t, double fc, double half)
+{
+    if (fabs(t) >= half) return 0.0;
+    double u = t / half;
+    double w = 0.42 + 0.5 * cos(M_PI * u) + 0.08 * cos(2.0 * M_PI * u);
+    double x = 2.0 * fc * t;
+    double sinc = (fabs(x) < 1e-12) ? 1.0 : sin(M_PI * x) / (M_PI * x);
+    return 2.0 * fc * sinc * w;
+}
+
+int frac_resampler_init(FracResamplerState *s, double ratio, int taps)
+{
+    memset(s, 0, sizeof(*s));
+    if (!(ratio > 0.0)) return -1;
+    if (taps <= 0) taps = 32;
+    taps += taps & 1;
+
+    int P = FRAC_PHASES;
+    s->table = (double *)malloc((size_t)(P + 1) * taps * sizeof(double));
+    s->delay = (double *)calloc((size_t)(2 * taps), sizeof(double));
+    if (!s->table || !s->delay) {
+        frac_resampler_free(s);
+        return -1;
+    }
+
+    /* Row q (μ = q/P), tap j weights x[k + T/2 − j] at distance j − T/2 + μ */
+    double fc = 0.45 * (ratio < 1.0 ? ratio : 1.0), half = 0.5 * taps;
+    for (int q = 0; q <= P; q++) {
+        double *row = s->table + (size_t)q * taps, sum = 0.0;
+        for (int j = 0; j < taps; j++) {
+            row[j] = frac_kernel(j - half + (double)q / P, fc, half);
+            sum += row[j];
+        }
+        for (int j = 0; j < taps; j++)
+            row[j] /= sum;
+    }
+    s->taps   = taps;
+    s->phases = P;
+    frac_resampler_set_ratio(s, ratio);
+    frac_resampler_reset(s);
+    return 0;
+}
+
+void frac_resampler_set_ratio(FracResamplerState *s, double ratio)
+{
+    if (!(ratio > 0.0)) return;
+    s->ratio = ratio;
+    s->step  = 1.0 / ratio;
+}
+
+int frac_resampler_max_output(const FracResamplerState *s, int n)
+{
+    return (int)ceil((double)n * s->ratio) + 2;
+}
+
+int frac_resampler_process(FracResamplerState *s, const double *in, int n,
+                           double *out)
+{
+    int T = s->taps, P = s->phases;
+    double *dl = s->delay;
+    int pos = s->pos, need = s->need;
+    double frac = s->frac;
+    int out_len = 0;
+
+    for (int i = 0; i < n; i++) {
+        pos = (pos == 0 ? T : pos) - 1;
+        dl[pos] = dl[pos + T] = in[i];
+        if (--need > 0) continue;
+
+        const double *x = dl + pos;
+        while (need == 0) {
+            double q = frac * P;
+            int qi = (int)q;
+            if (qi >= P) qi = P - 1;
+            const double *r0 = s->table + (size_t)qi * T, *r1 = r0 + T;
+            double v0 = 0.0, v1 = 0.0;
+            for (int j = 0; j < T; j++) {
+                v0 += r0[j] * x[j];
+                v1 += r1[j] * x[j];
+            }
+            out[out_len++] = v0 + (q - qi) * (v1 - v0);
+
+            frac += s->step;
+            need  = (int)floor(frac);
+            frac -= need;
+        }
+    }
+    s->pos  = pos;
+    s->need = need;
+    s->frac = frac;
+    return out_len;
+}
+
+void frac_resampler_reset(FracResamplerState *s)
+{
+    memset(s->delay, 0, (size_t)(2 * s->taps) * sizeof(double));
+    s->pos  = 0;
+    s->need = s->taps / 2 + 1;     /* output 0 (τ = 0) waits for x[T/2] */
+    s->frac = 0.0;
+}
+
+void frac_resampler_free(FracResamplerState *s)
+{
+    if (s) {
+        free(s->table); s->table = NULL;
+        free(s->delay); s->delay = NULL;
+    }
+}
+
+/* ── Multistage Decimation ────────────────────────────────────── */
+
+#define CIC_ORDER      4
+#define CIC_MIN_M      32       /* below this, halfbands + FIR only */
+#define CIC_TAIL_MAX   8        /* oversampling kept after the CIC  */
+#define COMP_HALF      3        /* compensation FIR: 2·3 + 1 taps   */
+#define MSDEC_BLOCK    4096     /* cascade runs in input blocks of this */
+
+/* Odd Hamming-windowed-sinc length for a transition width df (cycles/sample) */
+static int hamming_taps(double df)
+{
+    int taps = (int)ceil(3.3 / df);
+    return taps | 1;
+}
+
+/* Halfband length 4k + 3 for a protected band 0 … fp (input rate) */
+static int halfband_taps(double fp)
+{
+    int k = hamming_taps(0.5 - 2.0 * fp) / 4;     /* 4k + 3 ≥ that */
+    if (k < 1) k = 1;
+    return 4 * k + 3;
+}
+
+static void plan_add(DecimPlan *p, DecimStageType type, int factor,
+                     int taps, double rate_div)
+{
+    DecimStage *st = &p->stage[p->n_stages++];
+    double mults = (type == DECIM_STAGE_HALFBAND) ? (taps + 5) / 4 : taps;
+    st->type   = type;
+    st->factor = factor;
+    st->taps   = taps;
+    st->cost   = mults / (rate_div * factor);
+    p->cost   += st->cost;
+}
+
+int decim_plan(DecimPlan *plan, int M, double pass)
+{
+    memset(plan, 0, sizeof(*plan));
+    if (pass <= 0.0) pass = 0.8;
+    if (M <= 0 || pass >= 1.0) return -1;
+    plan->M    = M;
+    plan->pass = pass;
+    plan->single_cost = (M > 1) ? (double)hamming_taps((1.0 - pass) / M) / M : 0.0;
+
+    /* CIC ↓R with at least D× oversampling left for the later stages.
+     * With no divisor up to CIC_TAIL_MAX, D is the smallest prime
+     * factor; a prime M gets no CIC (R would be 1) and runs as one FIR. */
+    int D = M, rate = 1;
+    if (M >= CIC_MIN_M) {
+        D = 1;
+        for (int d = CIC_TAIL_MAX; d > 1 && D == 1; d--)
+            if (M % d == 0) D = d;
+        for (int d = CIC_TAIL_MAX + 1; D == 1; d++)
+            if (M % d == 0) D = d;
+    }
+    if (D < M) {
+        int R = M / D;
+        plan_add(plan, DECIM_STAGE_CIC, R, CIC_ORDER * (R - 1) + 1, 1.0);
+        rate = R;
+        plan_add(plan, DECIM_STAGE_COMP, 1, 2 * COMP_HALF + 1, rate);
+    }
+
+    /* D = 2ᵃ·b: a − 1 halfbands, then FIR ↓(2b), or ↓b when a = 0 */
+    int a = 0, b = D;
+    while (b % 2 == 0) { b /= 2; a++; }
+    for (int i = 1; i < a; i++) {
+        int after = D / 2;      /* decimation still to come after this stage */
+        plan_add(plan, DECIM_STAGE_HALFBAND, 2,
+                 halfband_taps(0.25 * pass / after), rate);
+        rate *= 2;
+        D = after;
+    }
+    if (D > 1)
+        plan_add(plan, DECIM_STAGE_FIR, D,
+                 hamming_taps((1.0 - pass) / D), rate);
+    return 0;
+}
+
+/* Halfband ↓2: h[c ± 2i] = 0 (i ≠ 0), h[c] = ½, taps = 4k + 3.
+ * Branch 0 (even inputs) carries the 2k + 2 nonzero side taps,
+ * folded into k + 1 symmetric pairs; branch 1 (odd inputs) only the
+ * centre tap, which reads one sample k slots back. */
+typedef struct {
+    int     k;
+    double *c;          /* h[2j], j = 0 … k                  */
+    double *d0, *d1;    /* 2·(2k + 2) and 2·(k + 1) doubles  */
+    int     pos0, pos1, phase;
+} HalfbandDec;
+
+static void halfband_free(HalfbandDec *s)
+{
+    free(s->c);  s->c  = NULL;
+    free(s->d0); s->d0 = NULL;
+    free(s->d1); s->d1 = NULL;
+}
+
+static int halfband_init(HalfbandDec *s, int taps)
+{
+    memset(s, 0, sizeof(*s));
+    int k = (taps - 3) / 4;
+    double *h = (double *)malloc((size_t)taps * sizeof(double));
+    s->c  = (double *)malloc((size_t)(k + 1) * sizeof(double));
+    s->d0 = (double *)calloc((size_t)(2 * (2 * k + 2)), sizeof(double));
+    s->d1 = (double *)calloc((size_t)(2 * (k + 1)), sizeof(double));
+    if (!h || !s->c || !s->d0 || !s->d1) {
+        free(h);
+        halfband_free(s);
+        return -1;
+    }
+
+    /* Windowed sinc at fs/4, with the zero taps forced to exactly 0
+     * and the side taps scaled so the DC gain is exactly 1 */
+    fir_lowpass(h, taps, 0.25);
+    double side = 0.0;
+    for (int j = 0; j <= k; j++)
+        side += 2.0 * h[2 * j];
+    for (int j = 0; j <= k; j++)
+        s->c[j] = h[2 * j] * 0.5 / side;
+    free(h);
+    s->k = k;
+    return 0;
+}
+
+static int halfband_process(HalfbandDec *s, const double *in, int n, double *out)
+{
+    int k = s->k, J0 = 2 * k + 2, J1 = k + 1;
+    int pos0 = s->pos0, pos1 = s->pos1, phase = s->phase;
+    int out_len = 0;
+
+    for (int i = 0; i < n; i++) {
+        if (phase) {
+            pos1 = (pos1 == 0 ? J1 : pos1) - 1;
+            s->d1[pos1] = s->d1[pos1 + J1] = in[i];
+            phase = 0;
+            continue;
+        }
+        pos0 = (pos0 == 0 ? J0 : pos0) - 1;
+        s->d0[pos0] = s->d0[pos0 + J0] = in[i];
+
+        const double *x0 = s->d0 + pos0;
+        double acc = 0.5 * s->d1[pos1 + k];
+        for (int j = 0; j <= k; j++)
+            acc += s->c[j] * (x0[j] + x0[J0 - 1 - j]);
+        out[out_len++] = acc;
+        phase = 1;
+    }
+    s->pos0  = pos0;
+    s->pos1  = pos1;
+    s->phase = phase;
+    return out_len;
+}
+
+static void halfband_reset(HalfbandDec *s)
+{
+    memset(s->d0, 0, (size_t)(2 * (2 * s->k + 2)) * sizeof(double));
+    memset(s->d1, 0, (size_t)(2 * (s->k + 1)) * sizeof(double));
+    s->pos0 = s->pos1 = s->phase = 0;
+}
+
+/* |CIC|: [sin(πf) / (R·sin(πf/R))]^N, f in cycles per output sample */
+static double cic_gain(double f, int R, int N)
+{
+    if (f < 1e-12) return 1.0;
+    return pow(fabs(sin(M_PI * f) / (R * sin(M_PI * f / R))), N);
+}
+
+/* Solve the n × n system A·x = b in place (partial pivoting); x → b */
+static int solve_small(double *A, double *b, int n)
+{
+    for (int c = 0; c < n; c++) {
+        int p = c;
+        for (int r = c + 1; r < n; r++)
+            if (fabs(A[r * n + c]) > fabs(A[p * n + c])) p = r;
+        if (A[p * n + c] == 0.0) return -1;
+        for (int j = 0; j < n; j++) {
+            double t = A[c * n + j]; A[c * n + j] = A[p * n + j]; A[p * n + j] = t;
+        }
+        double t = b[c]; b[c] = b[p]; b[p] = t;
+        for (int r = c + 1; r < n; r++) {
+            double m = A[r * n + c] / A[c * n + c];
+            for (int j = c; j < n; j++) A[r * n + j] -= m * A[c * n + j];
+            b[r] -= m * b[c];
+        }
+    }
+    for (int r = n - 1; r >= 0; r--) {
+        double acc = b[r];
+        for (int j = r + 1; j < n; j++) acc -= A[r * n + j] * b[j];
+        b[r] = acc / A[r * n + r];
+    }
+    return 0;
+}
+
+/*
+ * Droop compensator for a CIC ↓R of order N: symmetric FIR, 2K + 1 taps,
+ * least-squares fit of 1/|CIC| over 0 … fp.  Above fp it is pulled
+ * lightly (weight 0.01) toward the band-edge gain so it stays bounded.
+ */
+static void design_cic_comp(double *h, int K, int R, int N, double fp)
+{
+    enum { G = 128 };
+    int n = K + 1;
+    double A[(COMP_HALF + 1) * (COMP_HALF + 1)] = {0}, a[COMP_HALF + 1] = {0};
+    double edge = 1.0 / cic_gain(fp, R, N);
+
+    for (int g = 0; g < 2 * G; g++) {
+        double f, w, t, phi[COMP_HALF + 1];
+        if (g < G) { f = fp * g / (G - 1);                   w = 1.0;  t = 1.0 / cic_gain(f, R, N); }
+        else       { f = fp + (0.5 - fp) * (g - G + 1) / G;  w = 0.01; t = edge; }
+        for (int j = 0; j < n; j++)
+            phi[j] = j ? 2.0 * cos(2.0 * M_PI * f * j) : 1.0;
+        for (int i = 0; i < n; i++) {
+            a[i] += w * phi[i] * t;
+            for (int j = 0; j < n; j++)
+                A[i * n + j] += w * phi[i] * phi[j];
+        }
+    }
+    if (solve_small(A, a, n) != 0) {
+        memset(a, 0, sizeof(a));
+        a[0] = 1.0;
+    }
+    for (int j = 0; j <= K; j++)
+        h[K + j] = h[K - j] = a[j];
+}
+
+struct MultistageDecimator {
+    DecimPlan      plan;
+    DecimatorState fir[DECIM_MAX_STAGES];   /* CIC, COMP and FIR stages */
+    HalfbandDec    hb[DECIM_MAX_STAGES];    /* HALFBAND stages          */
+    double        *buf[2];                  /* MSDEC_BLOCK each         */
+};
+
+MultistageDecimator *multistage_decimator_create(const DecimPlan *plan)
+{
+    if (!plan || plan->M <= 0 || plan->n_stages < 0 ||
+        plan->n_stages > DECIM_MAX_STAGES)
+        return NULL;
+    MultistageDecimator *d = (MultistageDecimator *)calloc(1, sizeof(*d));
+    if (!d) return NULL;
+    d->plan   = *plan;
+    d->buf[0] = (double *)malloc(MSDEC_BLOCK * sizeof(double));
+    d->buf[1] = (double *)malloc(MSDEC_BLOCK * sizeof(double));
+    if (!d->buf[0] || !d->buf[1]) {
+        multistage_decimator_destroy(d);
+        return NULL;
+    }
+
+    int rest = plan->M, R = 1, ok = 1;
+    for (int i = 0; i < plan->n_stages && ok; i++) {
+        const DecimStage *st = &plan->stage[i];
+        int taps = st->taps, F = st->factor;
+        if (F <= 0 || taps <= 0 || rest % F != 0) { ok = 0; break; }
+        rest /= F;      /* decimation after this stage */
+
+        if (st->type == DECIM_STAGE_HALFBAND) {
+            ok = F == 2 && taps % 4 == 3 && halfband_init(&d->hb[i], taps) == 0;
+            continue;
+        }
+        double *h = (double *)calloc((size_t)taps, sizeof(double));
+        if (!h) { ok = 0; break; }
+        switch (st->type) {
+        case DECIM_STAGE_CIC: {
+            /* (1 + z⁻¹ + … + z⁻⁽ᴿ⁻¹⁾)^N / Rᴺ by repeated boxcar convolution */
+            int len = 1;
+            h[0] = 1.0;
+            for (int o = 0; o < CIC_ORDER && len + F - 1 <= taps; o++) {
+                for (int t = len + F - 2; t >= 0; t--) {
+                    double acc = 0.0;
+                    for (int j = 0; j < F; j++)
+                        if (t - j >= 0 && t - j < len) acc += h[t - j];
+                    h[t] = acc / F;
+                }
+                len += F - 1;
+            }
+            R = F;
+            break;
+        }
+        case DECIM_STAGE_COMP:
+            design_cic_comp(h, taps / 2, R, CIC_ORDER,
+                            0.5 * plan->pass / (rest > 0 ? rest : 1));
+            break;
+        default:
+            fir_lowpass(h, taps, 0.5 / F);
+            break;
+        }
+        ok = decimator_init(&d->fir[i], F, h, taps) == 0;
+        free(h);
+    }
+    if (!ok || rest != 1) {
+        multistage_decimator_destroy(d);
+        return NULL;
+    }
+    return d;
+}
+
+int multistage_decimator_process(MultistageDecimator *d, const double *in,
+                                 int n, double *out)
+{
+    const DecimPlan *p = &d->plan;
+    if (p->n_stages == 0) {
+        memcpy(out, in, (size_t)n * sizeof(double));
+        return n;
+    }
+
+    int out_len = 0;
+    for (int off = 0; off < n; off += MSDEC_BLOCK) {
+        const double *src = in + off;
+        int len = (n - off < MSDEC_BLOCK) ? n - off : MSDEC_BLOCK;
+
+        for (int i = 0; i < p->n_stages; i++) {
+            /* Stages write into the ping-pong buffers; the last one
+             * writes straight to the caller's output */
+            double *dst = (i == p->n_stages - 1) ? out + out_len : d->buf[i & 1];
+            if (p->stage[i].type == DECIM_STAGE_HALFBAND)
+                len = halfband_process(&d->hb[i], src, len, dst);
+            else
+                len = decimator_process(&d->fir[i], src, len, dst);
+            src = dst;
+        }
+        out_len += len;
+    }
+    return out_len;
+}
+
+void multistage_decimator_reset(MultistageDecimator *d)
+{
+    for (int i = 0; i < d->plan.n_stages; i++) {
+        if (d->plan.stage[i].type == DECIM_STAGE_HALFBAND)
+            halfband_reset(&d->hb[i]);
+        else
+            decimator_reset(&d->fir[i]);
+    }
+}
+
+void multistage_decimator_destroy(MultistageDecimator *d)
+{
+    if (!d) return;
+    for (int i = 0; i < DECIM_MAX_STAGES; i++) {
+        halfband_free(&d->hb[i]);
+        decimator_free(&d->fir[i]);
+    }
+    free(d->buf[0]);
+    free(d->buf[1]);
+    free(d);
+}
+
+/* ── Polyphase Filter Bank ────────────────────────────────────── */
+
+#define PFB_DEFAULT_P 12
+
+/* Prototype for both banks: K·P slots, Hamming sinc of K·P − 1 taps
+ * (odd, so it is symmetric about a whole sample) and a zero pad */
+static double *pfb_prototype(int K, int P, double cutoff, int *taps)
+{
+    int L = K * P;
+    double *h = (double *)calloc((size_t)L, sizeof(double));
+    if (!h) return NULL;
+    *taps = L - 1;
+    fir_lowpass(h, L - 1, cutoff);
+    return h;
+}
+
+int pfb_analysis_init(PfbAnalysis *s, int K, int D, int P)
+{
+    memset(s, 0, sizeof(*s));
+    if (K < 2 || D < 1 || D > K) return -1;
+    if (P <= 0) P = PFB_DEFAULT_P;
+
+    int L = K * P;
+    s->h     = pfb_prototype(K, P, 0.5 / K, &s->taps);
+    s->delay = (Complex *)calloc((size_t)(2 * L), sizeof(Complex));
+    s->u     = (Complex *)calloc((size_t)K, sizeof(Complex));
+    s->plan  = fft_plan_cached(K);
+    if (!s->h || !s->delay || !s->u || !s->plan) {
+        pfb_analysis_free(s);
+        return -1;
+    }
+    /* ifft_execute() scales by 1/K; put the K back into the taps */
+    for (int i = 0; i < L; i++)
+        s->h[i] *= (double)K;
+    s->K    = K;
+    s->D    = D;
+    s->need = 1;
+    return 0;
+}
+
+int pfb_analysis_process(PfbAnalysis *s, const Complex *in, int n,
+                         Complex *out)
+{
+    int K = s->K, L = s->taps + 1;
+    int pos = s->pos, need = s->need, shift = s->shift;
+    Complex *dl = s->delay, *u = s->u;
+    int frames = 0;
+
+    for (int i = 0; i < n; i++) {
+        pos = (pos == 0 ? L : pos) - 1;
+        dl[pos] = dl[pos + L] = in[i];
+        if (--need > 0) continue;
+
+        /* Fold: u[k] = Σₚ h[k + pK] · x[t − k − pK],  x[t − j] = dl[pos + j] */
+        const Complex *x = dl + pos;
+        for (int k = 0; k < K; k++) {
+            u[k].re = s->h[k] * x[k].re;
+            u[k].im = s->h[k] * x[k].im;
+        }
+        for (int base = K; base < L; base += K) {
+            const double  *hp = s->h + base;
+            const Complex *xp = x + base;
+            for (int k = 0; k < K; k++) {
+                u[k].re += hp[k] * xp[k].re;
+                u[k].im += hp[k] * xp[k].im;
+            }
+        }
+
+        /* Rotate by mD mod K, then one IFFT gives every channel */
+        Complex *frame = out + (size_t)frames * K;
+        for (int k = 0; k < K; k++) {
+            int j = k - shift;
+            frame[j < 0 ? j + K : j] = u[k];
+        }
+        ifft_execute(s->plan, frame);
+        frames++;
+
+        need  = s->D;
+        shift = (shift + s->D) % K;
+    }
+    s->pos   = pos;
+    s->need  = need;
+    s->shift = shift;
+    return frames;
+}
+
+void pfb_analysis_reset(PfbAnalysis *s)
+{
+    memset(s->delay, 0, (size_t)(2 * (s->taps + 1)) * sizeof(Complex));
+    s->pos   = 0;
+    s->need  = 1;
+    s->shift = 0;
+}
+
+void pfb_analysis_free(PfbAnalysis *s)
+{
+    if (s) {
+        free(s->h);     s->h     = NULL;
+        free(s->delay); s->delay = NULL;
+        free(s->u);     s->u     = NULL;
+    }
+}
+
+int pfb_synthesis_init(PfbSynthesis *s, int K, int D, int P)
+{
+    memset(s, 0, sizeof(*s));
+    if (K < 2 || D < 1 || D > K) return -1;
+    if (P <= 0) P = PFB_DEFAULT_P;
+
+    /*
+     * Channel q of the chain passes (1/D)·H(ν − q/K)·F(ν − q/K).  With
+     * F flat wherever H is nonzero the sum over q is Σ_q H(ν − q/K),
+     * which is flat because h[c ± lK] = 0 (cutoff 0.5/K).  The images
+     * at multiples of 1/D cancel if F is down before 1/D − 0.5/K, so
+     * F gets cutoff 1/K: flat to ~0.5/K + transition, stopped by
+     * ~1.5/K when D = K/2.
+     */
+    int L = K * P;
+    double *h = pfb_prototype(K, P, 0.5 / K, &s->taps);
+    s->f    = pfb_prototype(K, P, 1.0 / K, &s->taps);
+    s->acc  = (Complex *)calloc((size_t)L, sizeof(Complex));
+    s->w    = (Complex *)calloc((size_t)K, sizeof(Complex));
+    s->plan = fft_plan_cached(K);
+    if (!h || !s->f || !s->acc || !s->w || !s->plan) {
+        free(h);
+        pfb_synthesis_free(s);
+        return -1;
+    }
+
+    /* Averaged over the D output phases the chain gain is
+     * (K/D)·Σₐ f[a]·h[taps − 1 − a]; scale f so that is 1, times K for
+     * ifft_execute()'s 1/K */
+    double g = 0.0;
+    for (int i = 0; i < s->taps; i++)
+        g += s->f[i] * h[s->taps - 1 - i];
+    for (int i = 0; i < L; i++)
+        s->f[i] *= (double)D / g;
+    free(h);
+    s->K = K;
+    s->D = D;
+    return 0;
+}
+
+int pfb_synthesis_process(PfbSynthesis *s, const Complex *frames,
+                          int n_frames, Complex *out)
+{
+    int K = s->K, D = s->D, L = s->taps + 1;
+    int tau = (s->taps - 1) % K;
+    Complex *acc = s->acc, *w = s->w;
+
+    for (int m = 0; m < n_frames; m++) {
+        memcpy(w, frames + (size_t)m * K, (size_t)K * sizeof(Complex));
+        ifft_execute(s->plan, w);
+
+        /* acc[a] (time mD + a) += f[a] · w[(mD + a − τ) mod K] */
+        int k = ((s->shift - tau) % K + K) % K;
+        for (int a = 0; a < L; a++) {
+            acc[a].re += s->f[a] * w[k].re;
+            acc[a].im += s->f[a] * w[k].im;
+            if (++k == K) k = 0;
+        }
+
+        /* Times mD … mD + D − 1 have every contribution now */
+        memcpy(out + (size_t)m * D, acc, (size_t)D * sizeof(Complex));
+        memmove(acc, acc + D, (size_t)(L - D) * sizeof(Complex));
+        memset(acc + L - D, 0, (size_t)D * sizeof(Complex));
+        s->shift = (s->shift + D) % K;
+    }
+    return n_frames * D;
+}
+
+void pfb_synthesis_reset(PfbSynthesis *s)
+{
+    memset(s->acc, 0, (size_t)(s->taps + 1) * sizeof(Complex));
+    s->shift = 0;
+}
+
+void pfb_synthesis_free(PfbSynthesis *s)
+{
+    if (s) {
+        free(s->f);   s->f   = NULL;
+        free(s->acc); s->acc = NULL;
+        free(s->w);   s->w   = NULL;
+    }
+}
@@ -22,6 +22,7 @@
  *
  *   Pre-compute W[k] = exp(-j·2π·k/N) for k = 0 .. N/2-1
  *   Speeds up inner loop by replacing sin/cos with table lookup.
+ *   The table lives in FftPlan (fft.c); TwiddleTable is an alias.
  *
  * @see include/optimization.h
  */
@@ -34,6 +35,12 @@
 #include <time.h>
 #include "optimization.h"
 #include "fft.h"
+#include "filter.h"
+#include "iir.h"
+#include "multirate.h"
+#include "realtime.h"
+#include <pthread.h>
+#include <sched.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -50,121 +57,25 @@ static double time_usec(void)
     return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1000.0;
 }
 
-/* ================================================================== */
-/*  Bit-reversal permutation (for radix-4: base-4 digit reversal)     */
-/* ================================================================== */
-
-static int is_power_of_4(int n)
-{
-    if (n <= 0) return 0;
-    while (n > 1) {
-        if (n % 4 != 0) return 0;
-        n /= 4;
-    }
-    return 1;
-}
-
-/* Standard base-2 bit-reversal for any power-of-2 */
-static void bit_reverse(Complex *x, int n)
-{
-    int j = 0;
-    for (int i = 0; i < n - 1; i++) {
-        if (i < j) {
-            Complex tmp = x[i];
-            x[i] = x[j];
-            x[j] = tmp;
-        }
-        int m = n >> 1;
-        while (m >= 1 && j >= m) {
-            j -= m;
-            m >>= 1;
-        }
-        j += m;
-    }
-}
-
-/* Base-4 digit reversal for radix-4 DIT.
- * Reverses the base-4 digits of each index (NOT the same as bit-reversal).
- * E.g., for N=16: 1=01₄ → 10₄=4, 2=02₄ → 20₄=8 */
-static void digit_reverse_4(Complex *x, int n)
-{
-    int log4n = 0;
-    int temp = n;
-    while (temp > 1) { temp /= 4; log4n++; }
-
-    for (int i = 0; i < n; i++) {
-        int reversed = 0;
-        int val = i;
-        for (int d = 0; d < log4n; d++) {
-            reversed = reversed * 4 + (val % 4);
-            val /= 4;
-        }
-        if (reversed > i) {
-            Complex tmp = x[i];
-            x[i] = x[reversed];
-            x[reversed] = tmp;
-        }
-    }
-}
-
 /* ================================================================== */
 /*  Radix-4 FFT                                                       */
 /* ================================================================== */
 
+/*
+ * The radix-4 engine lives in fft_execute() (src/fft.c): radix-4
+ * stages for every power of 2, with one radix-2 stage when log₂N is
+ * odd.  This entry point just runs it on the cached plan.
+ */
 void fft_radix4(Complex *x, int n)
 {
     if (n <= 1) return;
 
-    /* Fall back to radix-2 for non-power-of-4 sizes */
-    if (!is_power_of_4(n)) {
-        fft(x, n);
+    const FftPlan *p = fft_plan_cached(n);
+    if (!p) {
+        fft_radix2(x, n);
         return;
     }
-
-    /* Base-4 digit reversal permutation */
-    digit_reverse_4(x, n);
-
-    /* Radix-4 stages */
-    for (int stage_len = 4; stage_len <= n; stage_len *= 4) {
-        int quarter = stage_len / 4;
-        double angle = -2.0 * M_PI / stage_len;
-
-        for (int group = 0; group < n; group += stage_len) {
-            for (int k = 0; k < quarter; k++) {
-                double theta1 = angle * k;
-                double theta2 = angle * 2 * k;
-                double theta3 = angle * 3 * k;
-
-                Complex W1 = { cos(theta1), sin(theta1) };
-                Complex W2 = { cos(theta2), sin(theta2) };
-                Complex W3 = { cos(theta3), sin(theta3) };
-
-                int i0 = group + k;
-                int i1 = i0 + quarter;
-                int i2 = i1 + quarter;
-                int i3 = i2 + quarter;
-
-                Complex a = x[i0];
-                Complex b = complex_mul(W1, x[i1]);
-                Complex c = complex_mul(W2, x[i2]);
-                Complex d = complex_mul(W3, x[i3]);
-
-                /* Radix-4 butterfly equations */
-                Complex ap = { a.re + c.re, a.im + c.im };  /* a + c */
-                Complex am = { a.re - c.re, a.im - c.im };  /* a - c */
-                Complex bp = { b.re + d.re, b.im + d.im };  /* b + d */
-                Complex bm = { b.re - d.re, b.im - d.im };  /* b - d */
-
-                /* -j * bm = { bm.im, -bm.re } */
-                Complex jbm = { bm.im, -bm.re };
-
-                x[i0].re = ap.re + bp.re;  x[i0].im = ap.im + bp.im;
-                x[i1].re = am.re + jbm.re; x[i1].im = am.im + jbm.im;
-                x[i2].re = ap.re - bp.re;  x[i2].im = ap.im - bp.im;
-                x[i3].re = am.re - jbm.re; x[i3].im = am.im - jbm.im;
-            }
-        }
-    }
+    fft_execute(p, x);
 }
 
 void ifft_radix4(Complex *x, int n)
@@ -184,54 +95,22 @@ void ifft_radix4(Complex *x, int n)
 
 TwiddleTable *twiddle_create(int n)
 {
-    TwiddleTable *tt = (TwiddleTable *)malloc(sizeof(TwiddleTable));
-    if (!tt) return NULL;
-
-    tt->n = n;
-    tt->W = (Complex *)malloc((size_t)(n / 2) * sizeof(Complex));
-    if (!tt->W) { free(tt); return NULL; }
-
-    for (int k = 0; k < n / 2; k++) {
-        double angle = -2.0 * M_PI * k / n;
-        tt->W[k].re = cos(angle);
-        tt->W[k].im = sin(angle);
-    }
-    return tt;
+    return fft_plan_create(n);
 }
 
 void twiddle_destroy(TwiddleTable *tt)
 {
-    if (!tt) return;
-    free(tt->W);
-    free(tt);
+    fft_plan_destroy(tt);
 }
 
 void fft_with_twiddles(Complex *x, int n, const TwiddleTable *tt)
 {
     if (n <= 1) return;
-
-    /* Bit-reversal */
-    bit_reverse(x, n);
-
-    /* Radix-2 DIT using pre-computed twiddles */
-    for (int stage = 2; stage <= n; stage *= 2) {
-        int half = stage / 2;
-        int step = n / stage;  /* index step in twiddle table */
-
-        for (int group = 0; group < n; group += stage) {
-            for (int k = 0; k < half; k++) {
-                Complex w = tt->W[k * step];
-                int i = group + k;
-                int j = i + half;
-
-                Complex t = complex_mul(w, x[j]);
-                x[j].re = x[i].re - t.re;
-                x[j].im = x[i].im - t.im;
-                x[i].re = x[i].re + t.re;
-                x[i].im = x[i].im + t.im;
-            }
-        }
+    if (!tt || tt->n != n) {
+        fft(x, n);
+        return;
     }
+    fft_execute(tt, x);
 }
 
 /* ================================================================== */
@@ -248,6 +127,23 @@ static void gen_random_complex(Complex *x, int n, unsigned int seed)
     }
 }
 
+/* Largest |X[k] − X_ref[k]| against the radix-2 reference on 'orig' */
+static double max_err_vs_radix2(const Complex *out, const Complex *orig, int n)
+{
+    Complex *ref = (Complex *)malloc((size_t)n * sizeof(Complex));
+    if (!ref) return -1.0;
+    memcpy(ref, orig, (size_t)n * sizeof(Complex));
+    fft_radix2(ref, n);
+
+    double max_err = 0.0;
+    for (int k = 0; k < n; k++) {
+        double err = complex_mag(complex_sub(out[k], ref[k]));
+        if (err > max_err) max_err = err;
+    }
+    free(ref);
+    return max_err;
+}
+
 BenchResult bench_fft_radix2(int n, int runs)
 {
     BenchResult r = {0};
@@ -263,7 +159,7 @@ BenchResult bench_fft_radix2(int n, int runs)
         memcpy(x, orig, (size_t)n * sizeof(Complex));
 
         double t0 = time_usec();
-        fft(x, n);
+        fft_radix2(x, n);
         double t1 = time_usec();
 
         double elapsed = t1 - t0;
@@ -284,7 +180,8 @@ BenchResult bench_fft_radix2(int n, int runs)
     return r;
 }
 
-BenchResult bench_fft_radix4(int n, int runs)
+/* Time fft_execute(p) on the bench input; fills max_err from the last run */
+static BenchResult bench_plan(const FftPlan *p, int n, int runs)
 {
     BenchResult r = {0};
     r.n    = n;
@@ -293,13 +190,19 @@ BenchResult bench_fft_radix4(int n, int runs)
 
     Complex *x = (Complex *)malloc((size_t)n * sizeof(Complex));
     Complex *orig = (Complex *)malloc((size_t)n * sizeof(Complex));
+    if (!p || !x || !orig) {
+        free(x);
+        free(orig);
+        r.max_err = -1.0;
+        return r;
+    }
     gen_random_complex(orig, n, 42);
 
     for (int run = 0; run < runs; run++) {
         memcpy(x, orig, (size_t)n * sizeof(Complex));
 
         double t0 = time_usec();
-        fft_radix4(x, n);
+        fft_execute(p, x);
         double t1 = time_usec();
 
         double elapsed = t1 - t0;
@@ -314,15 +217,415 @@ BenchResult bench_fft_radix4(int n, int runs)
     double flops = 5.0 * n * log2n;
     r.mflops = flops / r.avg_us;
 
+    /* Verify the last run against the textbook transform */
+    r.max_err = max_err_vs_radix2(x, orig, n);
+
     free(x);
     free(orig);
     return r;
 }
 
+BenchResult bench_fft_radix4(int n, int runs)
+{
+    /* Always the in-place engine, also above FFT_FOURSTEP_MIN_LOG2 */
+    FftPlan *p = fft_plan_create_engine(n, FFT_ENGINE_INPLACE);
+    BenchResult r = bench_plan(p, n, runs);
+    fft_plan_destroy(p);
+    return r;
+}
+
+BenchResult bench_fft_fourstep(int n, int runs)
+{
+    FftPlan *p = fft_plan_create_engine(n, FFT_ENGINE_FOURSTEP);
+    BenchResult r = bench_plan(p, n, runs);
+    fft_plan_destroy(p);
+    return r;
+}
+
+/*
+ * Walk down from max_log2 while the four-step engine keeps winning;
+ * the crossover is the last size where it still did.  Best-of-runs
+ * times are compared, since the average is skewed by the first run
+ * (page faults, cold caches).
+ */
+int bench_fft_crossover(int min_log2, int max_log2, int runs)
+{
+    if (min_log2 < 2 || max_log2 < min_log2 || max_log2 > 30)
+        return -1;
+
+    int crossover = -1;
+    for (int lg = max_log2; lg >= min_log2; lg--) {
+        BenchResult in_place = bench_fft_radix4(1 << lg, runs);
+        BenchResult four     = bench_fft_fourstep(1 << lg, runs);
+        if (in_place.max_err < 0.0 || four.max_err < 0.0)
+            return -1;
+        if (four.min_us >= in_place.min_us)
+            break;
+        crossover = lg;
+    }
+    return crossover;
+}
+
+/* Time direct fir_filter() (symmetric = 0) or fir_filter_symmetric() on the
+ * same random input; max_err is filled for the symmetric kernel */
+static BenchResult bench_fir(int n, int taps, int runs, int symmetric)
+{
+    BenchResult r = {0};
+    r.n    = n;
+    r.runs = runs;
+    r.min_us = 1e30;
+
+    if (n <= 0 || taps <= 0 || runs <= 0) {
+        r.max_err = -1.0;
+        return r;
+    }
+    Complex *noise = (Complex *)malloc((size_t)n * sizeof(Complex));
+    double *x = (double *)malloc((size_t)n * sizeof(double));
+    double *y = (double *)malloc((size_t)n * sizeof(double));
+    double *h = (double *)malloc((size_t)taps * sizeof(double));
+    if (!noise || !x || !y || !h) {
+        free(noise);
+        free(x);
+        free(y);
+        free(h);
+        r.max_err = -1.0;
+        return r;
+    }
+    gen_random_complex(noise, n, 42);
+    for (int i = 0; i < n; i++)
+        x[i] = noise[i].re;
+    fir_lowpass(h, taps, 0.2);
+    FirSymmetry sym = fir_symmetry(h, taps);
+
+    for (int run = 0; run < runs; run++) {
+        double t0 = time_usec();
+        if (symmetric)
+            fir_filter_symmetric(x, y, n, h, taps, sym);
+        else
+            fir_filter_method(x, y, n, h, taps, CONV_DIRECT);
+        double t1 = time_usec();
+
+        double elapsed = t1 - t0;
+        if (elapsed < r.min_us) r.min_us = elapsed;
+        if (elapsed > r.max_us) r.max_us = elapsed;
+        r.avg_us += elapsed;
+    }
+    r.avg_us /= runs;
+
+    /* One multiply-add per tap per output for the generic kernel */
+    r.mflops = 2.0 * n * taps / r.avg_us;
+
+    if (symmetric) {
+        /* Reference into the noise buffer's storage */
+        double *ref = (double *)noise;
+        fir_filter_method(x, ref, n, h, taps, CONV_DIRECT);
+        for (int i = 0; i < n; i++)
+            if (fabs(y[i] - ref[i]) > r.max_err)
+                r.max_err = fabs(y[i] - ref[i]);
+    }
+
+    free(noise);
+    free(x);
+    free(y);
+    free(h);
+    return r;
+}
+
+BenchResult bench_fir_direct(int n, int taps, int runs)
+{
+    return bench_fir(n, taps, runs, 0);
+}
+
+BenchResult bench_fir_symmetric(int n, int taps, int runs)
+{
+    return bench_fir(n, taps, runs, 1);
+}
+
+/* Cascade in long double (DF1): the accuracy reference for every structure.
+ * z holds 4 words per section. */
+static void iir_reference(const SOSChain *c, long double (*z)[4],
+                          const double *x, double *y, int n)
+{
+    memset(z, 0, (size_t)c->n_sections * sizeof(*z));
+    for (int i = 0; i < n; i++) {
+        long double v = x[i];
+        for (int k = 0; k < c->n_sections; k++) {
+            const Biquad *q = &c->sections[k];
+            long double out = q->b0 * v + q->b1 * z[k][0] + q->b2 * z[k][1]
+                            - q->a1 * z[k][2] - q->a2 * z[k][3];
+            z[k][1] = z[k][0];
+            z[k][0] = v;
+            z[k][3] = z[k][2];
+            z[k][2] = out;
+            v = out;
+        }
+        y[i] = (double)(v * c->gain);
+    }
+}
+
+BenchResult bench_iir_structure(IirStructure s, int order, int n, int runs)
+{
+    BenchResult r = {0};
+    r.n    = n;
+    r.runs = runs;
+    r.min_us = 1e30;
+    r.max_err = -1.0;
+
+    if (n <= 0 || runs <= 0 || order < 1)
+        return r;
+    SOSChain *sos = sos_chain_create(NULL, sos_chain_sections(order));
+    if (!sos || butterworth_lowpass_chain(order, 0.05, sos) != 0) {
+        sos_chain_destroy(sos);
+        return r;
+    }
+
+    /* (b, a) then the reference's long double DF1 state */
+    int len = 2 * sos->n_sections + 1;
+    double *b = (double *)malloc((size_t)(2 * len) * sizeof(double));
+    double *a = b ? b + len : NULL;
+    long double (*z)[4] = (long double (*)[4])malloc((size_t)sos->n_sections * sizeof(*z));
+    IIRParallel *par = (s == IIR_STRUCT_PARALLEL) ? iir_parallel_from_chain(sos) : NULL;
+    IIRLattice  *lat = (s == IIR_STRUCT_LATTICE)  ? iir_lattice_from_chain(sos)  : NULL;
+
+    Complex *noise = (Complex *)malloc((size_t)n * sizeof(Complex));
+    double *x = (double *)malloc((size_t)n * sizeof(double));
+    double *y = (double *)malloc((size_t)n * sizeof(double));
+    if (!noise || !x || !y || !b || !z || sos_chain_to_tf(sos, b, a) != len ||
+        (s == IIR_STRUCT_PARALLEL && !par) || (s == IIR_STRUCT_LATTICE && !lat)) {
+        free(noise);
+        free(x);
+        free(y);
+        free(b);
+        free(z);
+        sos_chain_destroy(sos);
+        iir_parallel_destroy(par);
+        iir_lattice_destroy(lat);
+        return r;
+    }
+    gen_random_complex(noise, n, 42);
+    for (int i = 0; i < n; i++)
+        x[i] = noise[i].re;
+
+    for (int run = 0; run < runs; run++) {
+        sos_chain_reset(sos);
+        if (par) iir_parallel_reset(par);
+        if (lat) iir_lattice_reset(lat);
+
+        double t0 = time_usec();
+        switch (s) {
+        case IIR_STRUCT_DIRECT:   iir_filter(b, len, a, len, x, y, n);         break;
+        case IIR_STRUCT_CASCADE:  sos_chain_process(sos, x, y, n);             break;
+        case IIR_STRUCT_PARALLEL: iir_parallel_process(par, x, y, n);          break;
+        case IIR_STRUCT_LATTICE:  iir_lattice_process(lat, x, y, n);           break;
+        }
+        double t1 = time_usec();
+
+        double elapsed = t1 - t0;
+        if (elapsed < r.min_us) r.min_us = elapsed;
+        if (elapsed > r.max_us) r.max_us = elapsed;
+        r.avg_us += elapsed;
+    }
+    r.avg_us /= runs;
+    r.mflops = n / r.min_us;             /* Msamples/s */
+
+    /* Reference into the noise buffer's storage */
+    double *ref = (double *)noise;
+    iir_reference(sos, z, x, ref, n);
+    r.max_err = 0.0;
+    for (int i = 0; i < n; i++)
+        if (fabs(y[i] - ref[i]) > r.max_err)
+            r.max_err = fabs(y[i] - ref[i]);
+
+    free(noise);
+    free(x);
+    free(y);
+    free(b);
+    free(z);
+    sos_chain_destroy(sos);
+    iir_parallel_destroy(par);
+    iir_lattice_destroy(lat);
+    return r;
+}
+
+BenchResult bench_decimation(DecimStrategy s, int M, int n, int runs)
+{
+    BenchResult r = {0};
+    r.n    = n;
+    r.runs = runs;
+    r.min_us = 1e30;
+    r.max_err = -1.0;
+
+    DecimPlan plan;
+    if (n <= 0 || runs <= 0 || decim_plan(&plan, M, 0.8) != 0)
+        return r;
+
+    MultistageDecimator *ms = NULL;
+    DecimatorState ds;
+    memset(&ds, 0, sizeof(ds));
+    int built;
+    if (s == DECIM_MULTISTAGE) {
+        ms = multistage_decimator_create(&plan);
+        built = ms != NULL;
+    } else {
+        int taps = (int)ceil(3.3 * M / (1.0 - plan.pass)) | 1;
+        double *h = (double *)malloc((size_t)taps * sizeof(double));
+        built = h != NULL;
+        if (built) {
+            fir_lowpass(h, taps, 0.5 / M);
+            built = decimator_init(&ds, M, h, taps) == 0;
+        }
+        free(h);
+    }
+
+    double *x = (double *)malloc((size_t)n * sizeof(double));
+    double *y = (double *)malloc((size_t)(n / M + 1) * sizeof(double));
+    if (!built || !x || !y) {
+        free(x);
+        free(y);
+        multistage_decimator_destroy(ms);
+        decimator_free(&ds);
+        return r;
+    }
+    double f = 0.95 / M;            /* folds to 0.05 cycles/output sample */
+    for (int i = 0; i < n; i++)
+        x[i] = sin(2.0 * M_PI * f * i);
+
+    int out = 0;
+    for (int run = 0; run < runs; run++) {
+        if (ms) multistage_decimator_reset(ms);
+        else    decimator_reset(&ds);
+
+        double t0 = time_usec();
+        out = ms ? multistage_decimator_process(ms, x, n, y)
+                 : decimator_process(&ds, x, n, y);
+        double t1 = time_usec();
+
+        double elapsed = t1 - t0;
+        if (elapsed < r.min_us) r.min_us = elapsed;
+        if (elapsed > r.max_us) r.max_us = elapsed;
+        r.avg_us += elapsed;
+    }
+    r.avg_us /= runs;
+    r.mflops = n / r.min_us;             /* Msamples/s */
+
+    r.max_err = 0.0;
+    for (int i = out / 2; i < out; i++)
+        if (fabs(y[i]) > r.max_err)
+            r.max_err = fabs(y[i]);
+
+    free(x);
+    free(y);
+    multistage_decimator_destroy(ms);
+    decimator_free(&ds);
+    return r;
+}
+
+/* One side of the bench_ring_buffer() transfer */
+typedef struct {
+    RingBuffer *rb;
+    double     *buf;     /* block-sized scratch */
+    int         block;
+    int         n;
+    long        errors;  /* consumer: out-of-sequence samples */
+} RingBenchArg;
+
+static void *ring_bench_producer(void *p)
+{
+    RingBenchArg *a = (RingBenchArg *)p;
+    double *buf = a->buf;
+    int sent = 0;
+    while (sent < a->n) {
+        int k = a->n - sent < a->block ? a->n - sent : a->block;
+        for (int i = 0; i < k; i++)
+            buf[i] = (double)(sent + i);
+        int done = 0;
+        while (done < k) {
+            int w = ring_buffer_write(a->rb, buf + done, k - done);
+            if (w == 0) sched_yield();
+            done += w;
+        }
+        sent += k;
+    }
+    return NULL;
+}
+
+static void *ring_bench_consumer(void *p)
+{
+    RingBenchArg *a = (RingBenchArg *)p;
+    double *buf = a->buf;
+    int got = 0;
+    while (got < a->n) {
+        int r = ring_buffer_read(a->rb, buf, a->block);
+        if (r == 0) { sched_yield(); continue; }
+        for (int i = 0; i < r; i++)
+            if (buf[i] != (double)(got + i))
+                a->errors++;
+        got += r;
+    }
+    return NULL;
+}
+
+BenchResult bench_ring_buffer(int block, int n, int runs)
+{
+    BenchResult r = {0};
+    r.n    = block;
+    r.runs = runs;
+    r.min_us = 1e30;
+    r.max_err = -1.0;
+
+    if (block <= 0 || n <= 0 || runs <= 0) return r;
+    RingBuffer *rb = ring_buffer_create(4096);
+    double *pbuf = (double *)malloc((size_t)block * sizeof(double));
+    double *cbuf = (double *)malloc((size_t)block * sizeof(double));
+    long errors = 0;
+    int ok = rb && pbuf && cbuf;
+    for (int run = 0; ok && run < runs; run++) {
+        ring_buffer_reset(rb);
+        RingBenchArg prod = { rb, pbuf, block, n, 0 };
+        RingBenchArg cons = { rb, cbuf, block, n, 0 };
+        pthread_t tp, tc;
+
+        double t0 = time_usec();
+        if (pthread_create(&tc, NULL, ring_bench_consumer, &cons) != 0) {
+            ok = 0;
+            break;
+        }
+        if (pthread_create(&tp, NULL, ring_bench_producer, &prod) != 0) {
+            /* Feed the consumer from here so it can finish */
+            ring_bench_producer(&prod);
+            pthread_join(tc, NULL);
+            ok = 0;
+            break;
+        }
+        pthread_join(tp, NULL);
+        pthread_join(tc, NULL);
+        double t1 = time_usec();
+
+        double elapsed = t1 - t0;
+        if (elapsed < r.min_us) r.min_us = elapsed;
+        if (elapsed > r.max_us) r.max_us = elapsed;
+        r.avg_us += elapsed;
+        errors += cons.errors;
+    }
+    if (ok) {
+        r.avg_us /= runs;
+        r.mflops = n / r.min_us;         /* Msamples/s */
+        r.max_err = (double)errors;
+    }
+
+    free(pbuf);
+    free(cbuf);
+    ring_buffer_destroy(rb);
+    return r;
+}
+
 void bench_print(const char *label, const BenchResult *r)
 {
-    printf("  %-22s  N=%-5d  min=%7.1f µs  avg=%7.1f µs  max=%7.1f µs  %.1f MFLOP/s\n",
+    printf("  %-22s  N=%-5d  min=%7.1f µs  avg=%7.1f µs  max=%7.1f µs  %.1f MFLOP/s",
            label, r->n, r->min_us, r->avg_us, r->max_us, r->mflops);
+    if (r->max_err > 0.0)
+        printf("  err=%.1e", r->max_err);
+    printf("\n");
 }
 
 /* ================================================================== */
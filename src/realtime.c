@@ -19,6 +19,13 @@
  *   available = (head - tail) & mask
  *   space     = cap - 1 - available   (always leave 1 slot empty)
  *
+ *   Producer:  copy into buf[head …]  ──►  store head (release)
+ *   Consumer:  load head (acquire)    ──►  copy out of buf[tail …]
+ *
+ *   The release/acquire pair orders the sample copies before the
+ *   index update, so the consumer never reads a slot the producer has
+ *   not finished writing (and vice versa for tail).
+ *
  * ── Frame Processor Pipeline ────────────────────────────────────
  *
  *   new samples ──► overlap_buf ──► window ──► FFT ──► |X[k]|
@@ -35,6 +42,7 @@
 #include <time.h>
 #include "realtime.h"
 #include "fft.h"
+#include "simd.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -59,6 +67,34 @@ static int next_pow2(int v)
 /*  Ring Buffer                                                       */
 /* ================================================================== */
 
+/*
+ * The tree builds as C99, so the C11 acquire/release operations come
+ * from the GCC/Clang __atomic builtins (same memory model), or from
+ * <stdatomic.h> when the compiler is in C11 mode without them.
+ */
+#if defined(__GNUC__)
+#define rb_load_relaxed(p)      __atomic_load_n((p), __ATOMIC_RELAXED)
+#define rb_load_acquire(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define rb_store_release(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && \
+      !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define rb_load_relaxed(p)      atomic_load_explicit((_Atomic int *)(p), memory_order_relaxed)
+#define rb_load_acquire(p)      atomic_load_explicit((_Atomic int *)(p), memory_order_acquire)
+#define rb_store_release(p, v)  atomic_store_explicit((_Atomic int *)(p), (v), memory_order_release)
+#else
+#error "RingBuffer needs GCC/Clang __atomic builtins or C11 <stdatomic.h>"
+#endif
+
+/* Copy n samples out of the ring starting at pos (≤ 2 segments) */
+static void rb_copy_out(const RingBuffer *rb, int pos, double *data, int n)
+{
+    int first = rb->cap - pos;
+    if (first > n) first = n;
+    memcpy(data, rb->buf + pos, (size_t)first * sizeof(double));
+    memcpy(data + first, rb->buf, (size_t)(n - first) * sizeof(double));
+}
+
 RingBuffer *ring_buffer_create(int capacity)
 {
     if (capacity < 2) capacity = 2;
@@ -72,8 +108,6 @@ RingBuffer *ring_buffer_create(int capacity)
 
     rb->cap  = capacity;
     rb->mask = capacity - 1;
-    rb->head = 0;
-    rb->tail = 0;
     return rb;
 }
 
@@ -86,64 +120,80 @@ void ring_buffer_destroy(RingBuffer *rb)
 
 int ring_buffer_available(const RingBuffer *rb)
 {
-    return (rb->head - rb->tail) & rb->mask;
+    int tail = rb_load_acquire(&rb->tail);
+    int head = rb_load_acquire(&rb->head);
+    return (head - tail) & rb->mask;
 }
 
 int ring_buffer_space(const RingBuffer *rb)
 {
     /* Leave one slot empty to distinguish full from empty */
-    return rb->cap - 1 - ring_buffer_available(rb);
+    int head = rb_load_acquire(&rb->head);
+    int tail = rb_load_acquire(&rb->tail);
+    return rb->cap - 1 - ((head - tail) & rb->mask);
 }
 
 int ring_buffer_write(RingBuffer *rb, const double *data, int n)
 {
-    int space = ring_buffer_space(rb);
-    if (n > space) n = space;
-
-    for (int i = 0; i < n; i++) {
-        rb->buf[rb->head & rb->mask] = data[i];
-        rb->head = (rb->head + 1) & rb->mask;
+    int head  = rb_load_relaxed(&rb->head);          /* ours */
+    int space = rb->cap - 1 - ((head - rb->tail_cache) & rb->mask);
+    if (n > space) {
+        rb->tail_cache = rb_load_acquire(&rb->tail);
+        space = rb->cap - 1 - ((head - rb->tail_cache) & rb->mask);
+        if (n > space) n = space;
     }
+    if (n <= 0) return 0;
+
+    int first = rb->cap - head;
+    if (first > n) first = n;
+    memcpy(rb->buf + head, data, (size_t)first * sizeof(double));
+    memcpy(rb->buf, data + first, (size_t)(n - first) * sizeof(double));
+
+    rb_store_release(&rb->head, (head + n) & rb->mask);
     return n;
 }
 
 int ring_buffer_read(RingBuffer *rb, double *data, int n)
 {
-    int avail = ring_buffer_available(rb);
-    if (n > avail) n = avail;
-
-    for (int i = 0; i < n; i++) {
-        data[i] = rb->buf[rb->tail & rb->mask];
-        rb->tail = (rb->tail + 1) & rb->mask;
+    int tail  = rb_load_relaxed(&rb->tail);          /* ours */
+    int avail = (rb->head_cache - tail) & rb->mask;
+    if (n > avail) {
+        rb->head_cache = rb_load_acquire(&rb->head);
+        avail = (rb->head_cache - tail) & rb->mask;
+        if (n > avail) n = avail;
     }
+    if (n <= 0) return 0;
+
+    rb_copy_out(rb, tail, data, n);
+    rb_store_release(&rb->tail, (tail + n) & rb->mask);
     return n;
 }
 
 int ring_buffer_peek(const RingBuffer *rb, double *data, int n)
 {
-    int avail = ring_buffer_available(rb);
+    int tail  = rb_load_relaxed(&rb->tail);
+    int avail = (rb_load_acquire(&rb->head) - tail) & rb->mask;
     if (n > avail) n = avail;
+    if (n <= 0) return 0;
 
-    int pos = rb->tail;
-    for (int i = 0; i < n; i++) {
-        data[i] = rb->buf[pos & rb->mask];
-        pos = (pos + 1) & rb->mask;
-    }
+    rb_copy_out(rb, tail, data, n);
     return n;
 }
 
 int ring_buffer_skip(RingBuffer *rb, int n)
 {
-    int avail = ring_buffer_available(rb);
+    int tail  = rb_load_relaxed(&rb->tail);
+    int avail = (rb_load_acquire(&rb->head) - tail) & rb->mask;
     if (n > avail) n = avail;
-    rb->tail = (rb->tail + n) & rb->mask;
+    if (n <= 0) return 0;
+    rb_store_release(&rb->tail, (tail + n) & rb->mask);
     return n;
 }
 
 void ring_buffer_reset(RingBuffer *rb)
 {
-    rb->head = 0;
-    rb->tail = 0;
+    rb->head = rb->tail = 0;
+    rb->head_cache = rb->tail_cache = 0;
 }
 
 /* ================================================================== */
@@ -162,15 +212,22 @@ FrameProcessor *frame_processor_create(int frame_size, int hop_size)
 
     fp->frame_size       = frame_size;
     fp->hop_size         = hop_size;
+    fp->plan             = rfft_plan_cached(frame_size);
     fp->frame            = (double *)calloc((size_t)frame_size, sizeof(double));
     fp->window           = (double *)malloc((size_t)frame_size * sizeof(double));
-    fp->spectrum         = (Complex *)calloc((size_t)frame_size, sizeof(Complex));
+    fp->spectrum         = (Complex *)calloc((size_t)(frame_size / 2 + 1), sizeof(Complex));
     fp->magnitude        = (double *)calloc((size_t)(frame_size / 2), sizeof(double));
     fp->magnitude_db     = (double *)calloc((size_t)(frame_size / 2), sizeof(double));
     fp->overlap_buf      = (double *)calloc((size_t)frame_size, sizeof(double));
     fp->frames_processed = 0;
     fp->samples_queued   = 0;
 
+    if (!fp->plan || !fp->frame || !fp->window || !fp->spectrum ||
+        !fp->magnitude || !fp->magnitude_db || !fp->overlap_buf) {
+        frame_processor_destroy(fp);
+        return NULL;
+    }
+
     /* Pre-compute Hann window */
     for (int i = 0; i < frame_size; i++)
         fp->window[i] = 0.5 * (1.0 - cos(2.0 * M_PI * i / (frame_size - 1)));
@@ -202,17 +259,16 @@ static void process_one_frame(FrameProcessor *fp)
     int half = N / 2;
 
     /* Apply window to overlap buffer */
-    for (int i = 0; i < N; i++) {
-        fp->spectrum[i].re = fp->overlap_buf[i] * fp->window[i];
-        fp->spectrum[i].im = 0.0;
-    }
+    for (int i = 0; i < N; i++)
+        fp->frame[i] = fp->overlap_buf[i] * fp->window[i];
 
-    /* FFT (in-place) */
-    fft(fp->spectrum, N);
+    /* Real FFT (cached plan) → bins 0 .. N/2 */
+    rfft_execute(fp->plan, fp->frame, fp->spectrum);
 
     /* Magnitude and dB */
+    simd_magnitude(fp->spectrum, fp->magnitude, half);
     for (int i = 0; i < half; i++) {
-        double mag = complex_mag(fp->spectrum[i]);
+        double mag = fp->magnitude[i];
         fp->magnitude[i] = mag / half;  /* normalise */
         fp->magnitude_db[i] = 20.0 * log10(mag / half + 1e-30);
     }
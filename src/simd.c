@@ -0,0 +1,1383 @@
+/**
+ * @file simd.c
+ * @brief SIMD kernels (scalar / SSE2 / AVX2) with runtime dispatch.
+ *
+ * ── Interleaved complex multiply in one register ────────────────
+ *
+ *   a  = [ar  ai ]          b = [br  bi]
+ *   t1 = a · [br br]     = [ar·br   ai·br]
+ *   t2 = [ai ar] · [bi bi] = [ai·bi   ar·bi]
+ *   a·b = [t1₀ − t2₀,  t1₁ + t2₁]
+ *
+ * The subtraction in lane 0 is done as t1₀ + (−t2₀) on SSE2 (sign-bit
+ * xor) and with addsub on AVX2; both are exactly t1₀ − t2₀ in IEEE
+ * arithmetic, and every product/sum matches the scalar expression
+ * term for term, so the vector paths are bit-identical to the C loops.
+ *
+ * AVX2 packs two complex values per __m256d; loop tails and radix-4
+ * stages with a quarter length of 1 drop to the SSE2 path.
+ *
+ * ── Split planes ────────────────────────────────────────────────
+ *
+ *   re = [r0 r1 r2 r3]   im = [i0 i1 i2 i3]     (one __m256d each)
+ *   y.re = ar·br − ai·bi,   y.im = ar·bi + ai·br
+ *
+ * Four complex values per AVX2 operation and no shuffles at all; the
+ * expressions are the scalar ones, lane by lane.
+ *
+ * ── Single precision ────────────────────────────────────────────
+ *
+ *   ComplexF kernels use the same shuffles on __m128 / __m256: two
+ *   complex floats per SSE2 register, four per AVX2 register — twice
+ *   the double-precision width, with the same bit-identity guarantee.
+ *
+ * @see include/simd.h
+ */
+
+#include "simd.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+/* ================================================================== */
+/*  Dispatch                                                          */
+/* ================================================================== */
+
+static int detected_level = -1;
+static int active_level   = -1;
+
+SimdLevel simd_detect(void)
+{
+    if (detected_level < 0) {
+        int lvl = SIMD_SCALAR;
+#ifdef SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse2")) lvl = SIMD_SSE2;
+        if (__builtin_cpu_supports("avx2")) lvl = SIMD_AVX2;
+#endif
+        detected_level = lvl;
+    }
+    return (SimdLevel)detected_level;
+}
+
+SimdLevel simd_level(void)
+{
+    if (active_level < 0)
+        active_level = simd_detect();
+    return (SimdLevel)active_level;
+}
+
+SimdLevel simd_set_level(SimdLevel level)
+{
+    SimdLevel best = simd_detect();
+    active_level = (level > best) ? best : level;
+    return (SimdLevel)active_level;
+}
+
+const char *simd_level_name(SimdLevel level)
+{
+    switch (level) {
+    case SIMD_AVX2: return "avx2";
+    case SIMD_SSE2: return "sse2";
+    default:        return "scalar";
+    }
+}
+
+/* ================================================================== */
+/*  Scalar reference kernels                                          */
+/* ================================================================== */
+
+static void cmul_scalar(Complex *y, const Complex *a, const Complex *b, int n)
+{
+    for (int k = 0; k < n; k++) {
+        double re = a[k].re * b[k].re - a[k].im * b[k].im;
+        double im = a[k].re * b[k].im + a[k].im * b[k].re;
+        y[k].re = re;
+        y[k].im = im;
+    }
+}
+
+static void cmul_conj_scalar(Complex *y, const Complex *a, const Complex *b, int n)
+{
+    for (int k = 0; k < n; k++) {
+        double re = a[k].re * b[k].re + a[k].im * b[k].im;
+        double im = a[k].re * b[k].im - a[k].im * b[k].re;
+        y[k].re = re;
+        y[k].im = im;
+    }
+}
+
+static void cmac_scalar(Complex *acc, const Complex *a, const Complex *b, int n)
+{
+    for (int k = 0; k < n; k++) {
+        double re = a[k].re * b[k].re - a[k].im * b[k].im;
+        double im = a[k].re * b[k].im + a[k].im * b[k].re;
+        acc[k].re += re;
+        acc[k].im += im;
+    }
+}
+
+/*
+ * Biquad cascades (see simd_sos_df2t).  Sections are taken in chunks of
+ * SOS_CHUNK whose coefficients and state stay in locals for the whole
+ * block; within a chunk each sample runs through every section before
+ * the next one is read, so successive samples overlap in the pipeline
+ * (a section-at-a-time pass would serialise on the y → s1 → y chain).
+ * Each kernel handles lanes [l0, lanes) and passes what its register
+ * width cannot cover down to the next narrower one.
+ */
+#define SOS_CHUNK 8
+
+static void sos_df2t_scalar(const double *coef, double *state, int n_sections,
+                            const double *in, double *out, int n,
+                            int l0, int lanes, int stride)
+{
+    for (int l = l0; l < lanes; l++) {
+        const double *src = in;
+        for (int k0 = 0; k0 < n_sections; k0 += SOS_CHUNK) {
+            int kn = n_sections - k0 < SOS_CHUNK ? n_sections - k0 : SOS_CHUNK;
+            double c[SOS_CHUNK][5], z1[SOS_CHUNK], z2[SOS_CHUNK];
+            for (int k = 0; k < kn; k++) {
+                const double *st = state + 2 * ((size_t)(k0 + k) * lanes + l);
+                memcpy(c[k], coef + 5 * (k0 + k), sizeof(c[k]));
+                z1[k] = st[0];
+                z2[k] = st[1];
+            }
+            for (int i = 0; i < n; i++) {
+                double v = src[(size_t)i * stride + l];
+                for (int k = 0; k < kn; k++) {
+                    double y = c[k][0] * v + z1[k];
+                    z1[k] = c[k][1] * v - c[k][3] * y + z2[k];
+                    z2[k] = c[k][2] * v - c[k][4] * y;
+                    v = y;
+                }
+                out[(size_t)i * stride + l] = v;
+            }
+            for (int k = 0; k < kn; k++) {
+                double *st = state + 2 * ((size_t)(k0 + k) * lanes + l);
+                st[0] = z1[k];
+                st[1] = z2[k];
+            }
+            src = out;
+        }
+    }
+}
+
+/*
+ * Parallel-form IIR (see simd_iir_parallel).  Four sections per group,
+ * one per lane; every section sees the same x, so the groups of a
+ * sample are independent of each other.  PAR_CHUNK groups at a time
+ * keep their coefficients and state in locals.  Per lane j the section
+ * outputs are summed group after group into p[j]; a chunk contributes
+ * (p0 + p2) + (p1 + p3) to out, which is what the register halves give
+ * on SSE2 and AVX2.
+ */
+#define PAR_CHUNK 4
+
+static void iir_parallel_scalar(const double *coef, double *state, int n_groups,
+                                double direct, const double *in, double *out,
+                                int n)
+{
+    for (int g0 = 0; g0 < n_groups; g0 += PAR_CHUNK) {
+        int gn = n_groups - g0 < PAR_CHUNK ? n_groups - g0 : PAR_CHUNK;
+        double c[PAR_CHUNK][16], z1[PAR_CHUNK][4], z2[PAR_CHUNK][4];
+        for (int g = 0; g < gn; g++) {
+            memcpy(c[g], coef + 16 * (g0 + g), sizeof(c[g]));
+            memcpy(z1[g], state + 8 * (g0 + g), sizeof(z1[g]));
+            memcpy(z2[g], state + 8 * (g0 + g) + 4, sizeof(z2[g]));
+        }
+        for (int i = 0; i < n; i++) {
+            double x = in[i], p[4] = {0.0, 0.0, 0.0, 0.0};
+            for (int g = 0; g < gn; g++) {
+                for (int j = 0; j < 4; j++) {
+                    double y = c[g][j] * x + z1[g][j];
+                    z1[g][j] = (c[g][4 + j] * x + z2[g][j]) - c[g][8 + j] * y;
+                    z2[g][j] = c[g][12 + j] * y;
+                    p[j] = g ? p[j] + y : y;
+                }
+            }
+            double t = (p[0] + p[2]) + (p[1] + p[3]);
+            out[i] = g0 ? out[i] + t : direct * x + t;
+        }
+        for (int g = 0; g < gn; g++) {
+            memcpy(state + 8 * (g0 + g), z1[g], sizeof(z1[g]));
+            memcpy(state + 8 * (g0 + g) + 4, z2[g], sizeof(z2[g]));
+        }
+    }
+}
+
+static void magnitude_scalar(const Complex *x, double *mag, int n)
+{
+    for (int k = 0; k < n; k++)
+        mag[k] = sqrt(x[k].re * x[k].re + x[k].im * x[k].im);
+}
+
+static void power_scalar(const Complex *x, double *p, int n, double scale,
+                         int accumulate)
+{
+    for (int k = 0; k < n; k++) {
+        double pw = (x[k].re * x[k].re + x[k].im * x[k].im) * scale;
+        if (accumulate)
+            p[k] += pw;
+        else
+            p[k] = pw;
+    }
+}
+
+static void radix4_stage_scalar(Complex *x, int n, int q, const Complex *tw)
+{
+    int len = q << 2;
+    const Complex *w1 = tw, *w2 = tw + q, *w3 = tw + 2 * q;
+
+    for (int group = 0; group < n; group += len) {
+        for (int k = 0; k < q; k++) {
+            Complex *x0 = x + group + k;
+            Complex *x1 = x0 + q;
+            Complex *x2 = x1 + q;
+            Complex *x3 = x2 + q;
+
+            /* c' = W^2k·x1,  b' = W^k·x2,  d' = W^3k·x3 */
+            double cr = w2[k].re * x1->re - w2[k].im * x1->im;
+            double ci = w2[k].re * x1->im + w2[k].im * x1->re;
+            double br = w1[k].re * x2->re - w1[k].im * x2->im;
+            double bi = w1[k].re * x2->im + w1[k].im * x2->re;
+            double dr = w3[k].re * x3->re - w3[k].im * x3->im;
+            double di = w3[k].re * x3->im + w3[k].im * x3->re;
+            double ar = x0->re, ai = x0->im;
+
+            double s0r = ar + cr, s0i = ai + ci;
+            double d0r = ar - cr, d0i = ai - ci;
+            double s1r = br + dr, s1i = bi + di;
+            double d1r = br - dr, d1i = bi - di;
+
+            x0->re = s0r + s1r;  x0->im = s0i + s1i;
+            x1->re = d0r + d1i;  x1->im = d0i - d1r;   /* − j(b'−d') */
+            x2->re = s0r - s1r;  x2->im = s0i - s1i;
+            x3->re = d0r - d1i;  x3->im = d0i + d1r;   /* + j(b'−d') */
+        }
+    }
+}
+
+static void cmul_split_scalar(double *yr, double *yi,
+                              const double *ar, const double *ai,
+                              const double *br, const double *bi, int n)
+{
+    for (int k = 0; k < n; k++) {
+        double re = ar[k] * br[k] - ai[k] * bi[k];
+        double im = ar[k] * bi[k] + ai[k] * br[k];
+        yr[k] = re;
+        yi[k] = im;
+    }
+}
+
+static void magnitude_split_scalar(const double *re, const double *im,
+                                   double *mag, int n)
+{
+    for (int k = 0; k < n; k++)
+        mag[k] = sqrt(re[k] * re[k] + im[k] * im[k]);
+}
+
+static void radix4_stage_split_scalar(double *re, double *im, int n, int q,
+                                      const double *tw)
+{
+    int len = q << 2;
+    const double *w1r = tw,         *w1i = tw + q;
+    const double *w2r = tw + 2 * q, *w2i = tw + 3 * q;
+    const double *w3r = tw + 4 * q, *w3i = tw + 5 * q;
+
+    for (int group = 0; group < n; group += len) {
+        for (int k = 0; k < q; k++) {
+            int i0 = group + k, i1 = i0 + q, i2 = i1 + q, i3 = i2 + q;
+
+            double cr = w2r[k] * re[i1] - w2i[k] * im[i1];
+            double ci = w2r[k] * im[i1] + w2i[k] * re[i1];
+            double br = w1r[k] * re[i2] - w1i[k] * im[i2];
+            double bi = w1r[k] * im[i2] + w1i[k] * re[i2];
+            double dr = w3r[k] * re[i3] - w3i[k] * im[i3];
+            double di = w3r[k] * im[i3] + w3i[k] * re[i3];
+            double ar = re[i0], ai = im[i0];
+
+            double s0r = ar + cr, s0i = ai + ci;
+            double d0r = ar - cr, d0i = ai - ci;
+            double s1r = br + dr, s1i = bi + di;
+            double d1r = br - dr, d1i = bi - di;
+
+            re[i0] = s0r + s1r;  im[i0] = s0i + s1i;
+            re[i1] = d0r + d1i;  im[i1] = d0i - d1r;
+            re[i2] = s0r - s1r;  im[i2] = s0i - s1i;
+            re[i3] = d0r - d1i;  im[i3] = d0i + d1r;
+        }
+    }
+}
+
+static void radix4_stage_batch_scalar(double *re, double *im, int n, int q,
+                                      const double *tw, int lanes)
+{
+    int len = q << 2;
+    const double *w1r = tw,         *w1i = tw + q;
+    const double *w2r = tw + 2 * q, *w2i = tw + 3 * q;
+    const double *w3r = tw + 4 * q, *w3i = tw + 5 * q;
+    size_t qs = (size_t)q * (size_t)lanes;
+
+    for (int group = 0; group < n; group += len) {
+        for (int k = 0; k < q; k++) {
+            double t1r = w1r[k], t1i = w1i[k];
+            double t2r = w2r[k], t2i = w2i[k];
+            double t3r = w3r[k], t3i = w3i[k];
+            double *r0 = re + (size_t)(group + k) * (size_t)lanes, *r1 = r0 + qs;
+            double *r2 = r1 + qs, *r3 = r2 + qs;
+            double *i0 = im + (size_t)(group + k) * (size_t)lanes, *i1 = i0 + qs;
+            double *i2 = i1 + qs, *i3 = i2 + qs;
+
+            for (int b = 0; b < lanes; b++) {
+                double cr = t2r * r1[b] - t2i * i1[b];
+                double ci = t2r * i1[b] + t2i * r1[b];
+                double br = t1r * r2[b] - t1i * i2[b];
+                double bi = t1r * i2[b] + t1i * r2[b];
+                double dr = t3r * r3[b] - t3i * i3[b];
+                double di = t3r * i3[b] + t3i * r3[b];
+                double ar = r0[b], ai = i0[b];
+
+                double s0r = ar + cr, s0i = ai + ci;
+                double d0r = ar - cr, d0i = ai - ci;
+                double s1r = br + dr, s1i = bi + di;
+                double d1r = br - dr, d1i = bi - di;
+
+                r0[b] = s0r + s1r;  i0[b] = s0i + s1i;
+                r1[b] = d0r + d1i;  i1[b] = d0i - d1r;
+                r2[b] = s0r - s1r;  i2[b] = s0i - s1i;
+                r3[b] = d0r - d1i;  i3[b] = d0i + d1r;
+            }
+        }
+    }
+}
+
+/* ── Single precision (ComplexF) ─────────────────────────────────── */
+
+static void cmul_f32_scalar(ComplexF *y, const ComplexF *a, const ComplexF *b, int n)
+{
+    for (int k = 0; k < n; k++) {
+        float re = a[k].re * b[k].re - a[k].im * b[k].im;
+        float im = a[k].re * b[k].im + a[k].im * b[k].re;
+        y[k].re = re;
+        y[k].im = im;
+    }
+}
+
+static void power_f32_scalar(const ComplexF *x, float *p, int n, float scale,
+                             int accumulate)
+{
+    for (int k = 0; k < n; k++) {
+        float pw = (x[k].re * x[k].re + x[k].im * x[k].im) * scale;
+        if (accumulate)
+            p[k] += pw;
+        else
+            p[k] = pw;
+    }
+}
+
+static void radix4_stage_f32_scalar(ComplexF *x, int n, int q, const ComplexF *tw)
+{
+    int len = q << 2;
+    const ComplexF *w1 = tw, *w2 = tw + q, *w3 = tw + 2 * q;
+
+    for (int group = 0; group < n; group += len) {
+        for (int k = 0; k < q; k++) {
+            ComplexF *x0 = x + group + k;
+            ComplexF *x1 = x0 + q;
+            ComplexF *x2 = x1 + q;
+            ComplexF *x3 = x2 + q;
+
+            float cr = w2[k].re * x1->re - w2[k].im * x1->im;
+            float ci = w2[k].re * x1->im + w2[k].im * x1->re;
+            float br = w1[k].re * x2->re - w1[k].im * x2->im;
+            float bi = w1[k].re * x2->im + w1[k].im * x2->re;
+            float dr = w3[k].re * x3->re - w3[k].im * x3->im;
+            float di = w3[k].re * x3->im + w3[k].im * x3->re;
+            float ar = x0->re, ai = x0->im;
+
+            float s0r = ar + cr, s0i = ai + ci;
+            float d0r = ar - cr, d0i = ai - ci;
+            float s1r = br + dr, s1i = bi + di;
+            float d1r = br - dr, d1i = bi - di;
+
+            x0->re = s0r + s1r;  x0->im = s0i + s1i;
+            x1->re = d0r + d1i;  x1->im = d0i - d1r;
+            x2->re = s0r - s1r;  x2->im = s0i - s1i;
+            x3->re = d0r - d1i;  x3->im = d0i + d1r;
+        }
+    }
+}
+
+#ifdef SIMD_X86
+
+/* ================================================================== */
+/*  SSE2 — one complex per __m128d                                    */
+/* ================================================================== */
+
+/* [ar ai]·[br bi] */
+__attribute__((target("sse2")))
+static inline __m128d cmul_pd128(__m128d a, __m128d b)
+{
+    const __m128d neg_lo = _mm_set_pd(0.0, -0.0);
+    __m128d b_re = _mm_unpacklo_pd(b, b);
+    __m128d b_im = _mm_unpackhi_pd(b, b);
+    __m128d a_sw = _mm_shuffle_pd(a, a, 1);
+    __m128d t1 = _mm_mul_pd(a, b_re);
+    __m128d t2 = _mm_xor_pd(_mm_mul_pd(a_sw, b_im), neg_lo);
+    return _mm_add_pd(t1, t2);
+}
+
+/* conj([ar ai])·[br bi] */
+__attribute__((target("sse2")))
+static inline __m128d cmul_conj_pd128(__m128d a, __m128d b)
+{
+    const __m128d neg_hi = _mm_set_pd(-0.0, 0.0);
+    __m128d a_re = _mm_unpacklo_pd(a, a);
+    __m128d a_im = _mm_unpackhi_pd(a, a);
+    __m128d b_sw = _mm_shuffle_pd(b, b, 1);
+    __m128d t1 = _mm_mul_pd(b, a_re);                   /* [br·ar  bi·ar] */
+    __m128d t2 = _mm_xor_pd(_mm_mul_pd(b_sw, a_im), neg_hi); /* [bi·ai −br·ai] */
+    return _mm_add_pd(t1, t2);
+}
+
+/* re² + im² in the low lane */
+__attribute__((target("sse2")))
+static inline __m128d norm_sd(__m128d v)
+{
+    __m128d sq = _mm_mul_pd(v, v);
+    return _mm_add_sd(sq, _mm_unpackhi_pd(sq, sq));
+}
+
+__attribute__((target("sse2")))
+static void cmul_sse2(Complex *y, const Complex *a, const Complex *b, int n)
+{
+    for (int k = 0; k < n; k++) {
+        __m128d r = cmul_pd128(_mm_loadu_pd(&a[k].re), _mm_loadu_pd(&b[k].re));
+        _mm_storeu_pd(&y[k].re, r);
+    }
+}
+
+__attribute__((target("sse2")))
+static void cmul_conj_sse2(Complex *y, const Complex *a, const Complex *b, int n)
+{
+    for (int k = 0; k < n; k++) {
+        __m128d r = cmul_conj_pd128(_mm_loadu_pd(&a[k].re), _mm_loadu_pd(&b[k].re));
+        _mm_storeu_pd(&y[k].re, r);
+    }
+}
+
+__attribute__((target("sse2")))
+static void cmac_sse2(Complex *acc, const Complex *a, const Complex *b, int n)
+{
+    for (int k = 0; k < n; k++) {
+        __m128d r = cmul_pd128(_mm_loadu_pd(&a[k].re), _mm_loadu_pd(&b[k].re));
+        _mm_storeu_pd(&acc[k].re, _mm_add_pd(_mm_loadu_pd(&acc[k].re), r));
+    }
+}
+
+/* Two lanes per register */
+__attribute__((target("sse2")))
+static void sos_df2t_sse2(const double *coef, double *state, int n_sections,
+                          const double *in, double *out, int n,
+                          int l0, int lanes, int stride)
+{
+    int l = l0;
+    for (; l + 2 <= lanes; l += 2) {
+        const double *src = in;
+        for (int k0 = 0; k0 < n_sections; k0 += SOS_CHUNK) {
+            int kn = n_sections - k0 < SOS_CHUNK ? n_sections - k0 : SOS_CHUNK;
+            __m128d c[SOS_CHUNK][5], z1[SOS_CHUNK], z2[SOS_CHUNK];
+            for (int k = 0; k < kn; k++) {
+                const double *st = state + 2 * ((size_t)(k0 + k) * lanes + l);
+                for (int j = 0; j < 5; j++)
+                    c[k][j] = _mm_set1_pd(coef[5 * (k0 + k) + j]);
+                z1[k] = _mm_set_pd(st[2], st[0]);
+                z2[k] = _mm_set_pd(st[3], st[1]);
+            }
+            for (int i = 0; i < n; i++) {
+                __m128d v = _mm_loadu_pd(src + (size_t)i * stride + l);
+                for (int k = 0; k < kn; k++) {
+                    __m128d y = _mm_add_pd(_mm_mul_pd(c[k][0], v), z1[k]);
+                    z1[k] = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(c[k][1], v),
+                                                  _mm_mul_pd(c[k][3], y)), z2[k]);
+                    z2[k] = _mm_sub_pd(_mm_mul_pd(c[k][2], v), _mm_mul_pd(c[k][4], y));
+                    v = y;
+                }
+                _mm_storeu_pd(out + (size_t)i * stride + l, v);
+            }
+            for (int k = 0; k < kn; k++) {
+                double *st = state + 2 * ((size_t)(k0 + k) * lanes + l);
+                _mm_storeu_pd(st,     _mm_unpacklo_pd(z1[k], z2[k]));
+                _mm_storeu_pd(st + 2, _mm_unpackhi_pd(z1[k], z2[k]));
+            }
+            src = out;
+        }
+    }
+    sos_df2t_scalar(coef, state, n_sections, in, out, n, l, lanes, stride);
+}
+
+/* One group in two registers: lanes 0-1 and 2-3 */
+__attribute__((target("sse2")))
+static void iir_parallel_sse2(const double *coef, double *state, int n_groups,
+                              double direct, const double *in, double *out,
+                              int n)
+{
+    __m128d d = _mm_set1_pd(direct);
+    for (int g0 = 0; g0 < n_groups; g0 += PAR_CHUNK) {
+        int gn = n_groups - g0 < PAR_CHUNK ? n_groups - g0 : PAR_CHUNK;
+        __m128d c[PAR_CHUNK][4][2], z1[PAR_CHUNK][2], z2[PAR_CHUNK][2];
+        for (int g = 0; g < gn; g++) {
+            const double *cg = coef + 16 * (g0 + g), *sg = state + 8 * (g0 + g);
+            for (int j = 0; j < 4; j++) {
+                c[g][j][0] = _mm_loadu_pd(cg + 4 * j);
+                c[g][j][1] = _mm_loadu_pd(cg + 4 * j + 2);
+            }
+            for (int h = 0; h < 2; h++) {
+                z1[g][h] = _mm_loadu_pd(sg + 2 * h);
+                z2[g][h] = _mm_loadu_pd(sg + 4 + 2 * h);
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            __m128d x = _mm_set1_pd(in[i]), p[2] = {x, x};
+            for (int g = 0; g < gn; g++) {
+                for (int h = 0; h < 2; h++) {
+                    __m128d y = _mm_add_pd(_mm_mul_pd(c[g][0][h], x), z1[g][h]);
+                    z1[g][h] = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(c[g][1][h], x), z2[g][h]),
+                                          _mm_mul_pd(c[g][2][h], y));
+                    z2[g][h] = _mm_mul_pd(c[g][3][h], y);
+                    p[h] = g ? _mm_add_pd(p[h], y) : y;
+                }
+            }
+            __m128d s = _mm_add_pd(p[0], p[1]);
+            __m128d t = _mm_add_sd(s, _mm_unpackhi_pd(s, s));
+            __m128d o = g0 ? _mm_load_sd(out + i) : _mm_mul_sd(d, x);
+            _mm_store_sd(out + i, _mm_add_sd(o, t));
+        }
+        for (int g = 0; g < gn; g++) {
+            double *sg = state + 8 * (g0 + g);
+            for (int h = 0; h < 2; h++) {
+                _mm_storeu_pd(sg + 2 * h, z1[g][h]);
+                _mm_storeu_pd(sg + 4 + 2 * h, z2[g][h]);
+            }
+        }
+    }
+}
+
+__attribute__((target("sse2")))
+static void magnitude_sse2(const Complex *x, double *mag, int n)
+{
+    for (int k = 0; k < n; k++) {
+        __m128d s = norm_sd(_mm_loadu_pd(&x[k].re));
+        _mm_store_sd(&mag[k], _mm_sqrt_sd(s, s));
+    }
+}
+
+__attribute__((target("sse2")))
+static void power_sse2(const Complex *x, double *p, int n, double scale,
+                       int accumulate)
+{
+    __m128d vs = _mm_set_sd(scale);
+    for (int k = 0; k < n; k++) {
+        __m128d pw = _mm_mul_sd(norm_sd(_mm_loadu_pd(&x[k].re)), vs);
+        if (accumulate)
+            pw = _mm_add_sd(_mm_load_sd(&p[k]), pw);
+        _mm_store_sd(&p[k], pw);
+    }
+}
+
+__attribute__((target("sse2")))
+static void radix4_stage_sse2(Complex *x, int n, int q, const Complex *tw)
+{
+    const __m128d neg_hi = _mm_set_pd(-0.0, 0.0);
+    int len = q << 2;
+    const Complex *w1 = tw, *w2 = tw + q, *w3 = tw + 2 * q;
+
+    for (int group = 0; group < n; group += len) {
+        for (int k = 0; k < q; k++) {
+            double *p0 = &x[group + k].re;
+            double *p1 = p0 + 2 * q;
+            double *p2 = p1 + 2 * q;
+            double *p3 = p2 + 2 * q;
+
+            __m128d a = _mm_loadu_pd(p0);
+            __m128d c = cmul_pd128(_mm_loadu_pd(p1), _mm_loadu_pd(&w2[k].re));
+            __m128d b = cmul_pd128(_mm_loadu_pd(p2), _mm_loadu_pd(&w1[k].re));
+            __m128d d = cmul_pd128(_mm_loadu_pd(p3), _mm_loadu_pd(&w3[k].re));
+
+            __m128d s0 = _mm_add_pd(a, c), d0 = _mm_sub_pd(a, c);
+            __m128d s1 = _mm_add_pd(b, d), d1 = _mm_sub_pd(b, d);
+
+            /* [d1i, −d1r] = −j·d1 */
+            __m128d jd1 = _mm_xor_pd(_mm_shuffle_pd(d1, d1, 1), neg_hi);
+
+            _mm_storeu_pd(p0, _mm_add_pd(s0, s1));
+            _mm_storeu_pd(p1, _mm_add_pd(d0, jd1));
+            _mm_storeu_pd(p2, _mm_sub_pd(s0, s1));
+            _mm_storeu_pd(p3, _mm_sub_pd(d0, jd1));
+        }
+    }
+}
+
+/* Split planes: two complex per operation */
+__attribute__((target("sse2")))
+static void cmul_split_sse2(double *yr, double *yi,
+                            const double *ar, const double *ai,
+                            const double *br, const double *bi, int n)
+{
+    int k = 0;
+    for (; k + 2 <= n; k += 2) {
+        __m128d a_r = _mm_loadu_pd(ar + k), a_i = _mm_loadu_pd(ai + k);
+        __m128d b_r = _mm_loadu_pd(br + k), b_i = _mm_loadu_pd(bi + k);
+        _mm_storeu_pd(yr + k, _mm_sub_pd(_mm_mul_pd(a_r, b_r), _mm_mul_pd(a_i, b_i)));
+        _mm_storeu_pd(yi + k, _mm_add_pd(_mm_mul_pd(a_r, b_i), _mm_mul_pd(a_i, b_r)));
+    }
+    cmul_split_scalar(yr + k, yi + k, ar + k, ai + k, br + k, bi + k, n - k);
+}
+
+__attribute__((target("sse2")))
+static void magnitude_split_sse2(const double *re, const double *im,
+                                 double *mag, int n)
+{
+    int k = 0;
+    for (; k + 2 <= n; k += 2) {
+        __m128d r = _mm_loadu_pd(re + k), i = _mm_loadu_pd(im + k);
+        __m128d s = _mm_add_pd(_mm_mul_pd(r, r), _mm_mul_pd(i, i));
+        _mm_storeu_pd(mag + k, _mm_sqrt_pd(s));
+    }
+    magnitude_split_scalar(re + k, im + k, mag + k, n - k);
+}
+
+/* Requires q >= 2 */
+__attribute__((target("sse2")))
+static void radix4_stage_split_sse2(double *re, double *im, int n, int q,
+                                    const double *tw)
+{
+    int len = q << 2;
+    const double *w1r = tw,         *w1i = tw + q;
+    const double *w2r = tw + 2 * q, *w2i = tw + 3 * q;
+    const double *w3r = tw + 4 * q, *w3i = tw + 5 * q;
+
+    for (int group = 0; group < n; group += len) {
+        for (int k = 0; k < q; k += 2) {
+            int i0 = group + k, i1 = i0 + q, i2 = i1 + q, i3 = i2 + q;
+            __m128d x1r = _mm_loadu_pd(re + i1), x1i = _mm_loadu_pd(im + i1);
+            __m128d x2r = _mm_loadu_pd(re + i2), x2i = _mm_loadu_pd(im + i2);
+            __m128d x3r = _mm_loadu_pd(re + i3), x3i = _mm_loadu_pd(im + i3);
+            __m128d t1r = _mm_loadu_pd(w1r + k), t1i = _mm_loadu_pd(w1i + k);
+            __m128d t2r = _mm_loadu_pd(w2r + k), t2i = _mm_loadu_pd(w2i + k);
+            __m128d t3r = _mm_loadu_pd(w3r + k), t3i = _mm_loadu_pd(w3i + k);
+
+            __m128d cr = _mm_sub_pd(_mm_mul_pd(t2r, x1r), _mm_mul_pd(t2i, x1i));
+            __m128d ci = _mm_add_pd(_mm_mul_pd(t2r, x1i), _mm_mul_pd(t2i, x1r));
+            __m128d br = _mm_sub_pd(_mm_mul_pd(t1r, x2r), _mm_mul_pd(t1i, x2i));
+            __m128d bi = _mm_add_pd(_mm_mul_pd(t1r, x2i), _mm_mul_pd(t1i, x2r));
+            __m128d dr = _mm_sub_pd(_mm_mul_pd(t3r, x3r), _mm_mul_pd(t3i, x3i));
+            __m128d di = _mm_add_pd(_mm_mul_pd(t3r, x3i), _mm_mul_pd(t3i, x3r));
+            __m128d ar = _mm_loadu_pd(re + i0), ai = _mm_loadu_pd(im + i0);
+
+            __m128d s0r = _mm_add_pd(ar, cr), s0i = _mm_add_pd(ai, ci);
+            __m128d d0r = _mm_sub_pd(ar, cr), d0i = _mm_sub_pd(ai, ci);
+            __m128d s1r = _mm_add_pd(br, dr), s1i = _mm_add_pd(bi, di);
+            __m128d d1r = _mm_sub_pd(br, dr), d1i = _mm_sub_pd(bi, di);
+
+            _mm_storeu_pd(re + i0, _mm_add_pd(s0r, s1r));
+            _mm_storeu_pd(im + i0, _mm_add_pd(s0i, s1i));
+            _mm_storeu_pd(re + i1, _mm_add_pd(d0r, d1i));
+            _mm_storeu_pd(im + i1, _mm_sub_pd(d0i, d1r));
+            _mm_storeu_pd(re + i2, _mm_sub_pd(s0r, s1r));
+            _mm_storeu_pd(im + i2, _mm_sub_pd(s0i, s1i));
+            _mm_storeu_pd(re + i3, _mm_sub_pd(d0r, d1i));
+            _mm_storeu_pd(im + i3, _mm_add_pd(d0i, d1r));
+        }
+    }
+}
+
+/* ================================================================== */
+/*  AVX2 — two complex per __m256d                                    */
+/* ================================================================== */
+
+__attribute__((target("avx2")))
+static inline __m256d cmul_pd256(__m256d a, __m256d b)
+{
+    __m256d b_re = _mm256_movedup_pd(b);            /* [br br | br br] */
+    __m256d b_im = _mm256_permute_pd(b, 0xF);       /* [bi bi | bi bi] */
+    __m256d a_sw = _mm256_permute_pd(a, 0x5);       /* [ai ar | ai ar] */
+    return _mm256_addsub_pd(_mm256_mul_pd(a, b_re), _mm256_mul_pd(a_sw, b_im));
+}
+
+__attribute__((target("avx2")))
+static inline __m256d cmul_conj_pd256(__m256d a, __m256d b)
+{
+    const __m256d neg_hi = _mm256_set_pd(-0.0, 0.0, -0.0, 0.0);
+    __m256d a_re = _mm256_movedup_pd(a);
+    __m256d a_im = _mm256_permute_pd(a, 0xF);
+    __m256d b_sw = _mm256_permute_pd(b, 0x5);
+    __m256d t1 = _mm256_mul_pd(b, a_re);
+    __m256d t2 = _mm256_xor_pd(_mm256_mul_pd(b_sw, a_im), neg_hi);
+    return _mm256_add_pd(t1, t2);
+}
+
+__attribute__((target("avx2")))
+static void cmul_avx2(Complex *y, const Complex *a, const Complex *b, int n)
+{
+    int k = 0;
+    for (; k + 2 <= n; k += 2) {
+        __m256d r = cmul_pd256(_mm256_loadu_pd(&a[k].re), _mm256_loadu_pd(&b[k].re));
+        _mm256_storeu_pd(&y[k].re, r);
+    }
+    cmul_sse2(y + k, a + k, b + k, n - k);
+}
+
+__attribute__((target("avx2")))
+static void cmul_conj_avx2(Complex *y, const Complex *a, const Complex *b, int n)
+{
+    int k = 0;
+    for (; k + 2 <= n; k += 2) {
+        __m256d r = cmul_conj_pd256(_mm256_loadu_pd(&a[k].re), _mm256_loadu_pd(&b[k].re));
+        _mm256_storeu_pd(&y[k].re, r);
+    }
+    cmul_conj_sse2(y + k, a + k, b + k, n - k);
+}
+
+__attribute__((target("avx2")))
+static void cmac_avx2(Complex *acc, const Complex *a, const Complex *b, int n)
+{
+    int k = 0;
+    for (; k + 2 <= n; k += 2) {
+        __m256d r = cmul_pd256(_mm256_loadu_pd(&a[k].re), _mm256_loadu_pd(&b[k].re));
+        _mm256_storeu_pd(&acc[k].re, _mm256_add_pd(_mm256_loadu_pd(&acc[k].re), r));
+    }
+    cmac_sse2(acc + k, a + k, b + k, n - k);
+}
+
+/*
+ * Four lanes per register, eight at a time: two independent chains per
+ * section keep both FP ports busy when there are few sections.
+ */
+__attribute__((target("avx2")))
+static void sos_df2t_avx2(const double *coef, double *state, int n_sections,
+                          const double *in, double *out, int n,
+                          int l0, int lanes, int stride)
+{
+    int l = l0;
+    for (int w = 8; w >= 4; w -= 4) {
+        int nr = w / 4;                       /* registers per section */
+        for (; l + w <= lanes; l += w) {
+            const double *src = in;
+            for (int k0 = 0; k0 < n_sections; k0 += SOS_CHUNK) {
+                int kn = n_sections - k0 < SOS_CHUNK ? n_sections - k0 : SOS_CHUNK;
+                __m256d c[SOS_CHUNK][5], z1[SOS_CHUNK][2], z2[SOS_CHUNK][2];
+                for (int k = 0; k < kn; k++) {
+                    const double *st = state + 2 * ((size_t)(k0 + k) * lanes + l);
+                    for (int j = 0; j < 5; j++)
+                        c[k][j] = _mm256_set1_pd(coef[5 * (k0 + k) + j]);
+                    for (int r = 0; r < nr; r++) {
+                        const double *p = st + 8 * r;
+                        z1[k][r] = _mm256_set_pd(p[6], p[4], p[2], p[0]);
+                        z2[k][r] = _mm256_set_pd(p[7], p[5], p[3], p[1]);
+                    }
+                }
+                if (nr == 2) {
+                    for (int i = 0; i < n; i++) {
+                        const double *px = src + (size_t)i * stride + l;
+                        __m256d va = _mm256_loadu_pd(px), vb = _mm256_loadu_pd(px + 4);
+                        for (int k = 0; k < kn; k++) {
+                            __m256d ya = _mm256_add_pd(_mm256_mul_pd(c[k][0], va), z1[k][0]);
+                            __m256d yb = _mm256_add_pd(_mm256_mul_pd(c[k][0], vb), z1[k][1]);
+                            z1[k][0] = _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(c[k][1], va),
+                                                                   _mm256_mul_pd(c[k][3], ya)), z2[k][0]);
+                            z1[k][1] = _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(c[k][1], vb),
+                                                                   _mm256_mul_pd(c[k][3], yb)), z2[k][1]);
+                            z2[k][0] = _mm256_sub_pd(_mm256_mul_pd(c[k][2], va),
+                                                     _mm256_mul_pd(c[k][4], ya));
+                            z2[k][1] = _mm256_sub_pd(_mm256_mul_pd(c[k][2], vb),
+                                                     _mm256_mul_pd(c[k][4], yb));
+                            va = ya;
+                            vb = yb;
+                        }
+                        _mm256_storeu_pd(out + (size_t)i * stride + l, va);
+                        _mm256_storeu_pd(out + (size_t)i * stride + l + 4, vb);
+                    }
+                } else {
+                    for (int i = 0; i < n; i++) {
+                        __m256d v = _mm256_loadu_pd(src + (size_t)i * stride + l);
+                        for (int k = 0; k < kn; k++) {
+                            __m256d y = _mm256_add_pd(_mm256_mul_pd(c[k][0], v), z1[k][0]);
+                            z1[k][0] = _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(c[k][1], v),
+                                                                   _mm256_mul_pd(c[k][3], y)), z2[k][0]);
+                            z2[k][0] = _mm256_sub_pd(_mm256_mul_pd(c[k][2], v),
+                                                     _mm256_mul_pd(c[k][4], y));
+                            v = y;
+                        }
+                        _mm256_storeu_pd(out + (size_t)i * stride + l, v);
+                    }
+                }
+                for (int k = 0; k < kn; k++) {
+                    double *st = state + 2 * ((size_t)(k0 + k) * lanes + l);
+                    for (int r = 0; r < nr; r++) {
+                        double a[4], b[4];
+                        _mm256_storeu_pd(a, z1[k][r]);
+                        _mm256_storeu_pd(b, z2[k][r]);
+                        for (int j = 0; j < 4; j++) {
+                            st[8 * r + 2 * j]     = a[j];
+                            st[8 * r + 2 * j + 1] = b[j];
+                        }
+                    }
+                }
+                src = out;
+            }
+        }
+    }
+    sos_df2t_sse2(coef, state, n_sections, in, out, n, l, lanes, stride);
+}
+
+/* One group per register */
+__attribute__((target("avx2")))
+static void iir_parallel_avx2(const double *coef, double *state, int n_groups,
+                              double direct, const double *in, double *out,
+                              int n)
+{
+    __m128d d = _mm_set1_pd(direct);
+    for (int g0 = 0; g0 < n_groups; g0 += PAR_CHUNK) {
+        int gn = n_groups - g0 < PAR_CHUNK ? n_groups - g0 : PAR_CHUNK;
+        __m256d c[PAR_CHUNK][4], z1[PAR_CHUNK], z2[PAR_CHUNK];
+        for (int g = 0; g < gn; g++) {
+            for (int j = 0; j < 4; j++)
+                c[g][j] = _mm256_loadu_pd(coef + 16 * (g0 + g) + 4 * j);
+            z1[g] = _mm256_loadu_pd(state + 8 * (g0 + g));
+            z2[g] = _mm256_loadu_pd(state + 8 * (g0 + g) + 4);
+        }
+        for (int i = 0; i < n; i++) {
+            __m256d x = _mm256_set1_pd(in[i]), p = _mm256_setzero_pd();
+            for (int g = 0; g < gn; g++) {
+                __m256d y = _mm256_add_pd(_mm256_mul_pd(c[g][0], x), z1[g]);
+                z1[g] = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(c[g][1], x), z2[g]),
+                                      _mm256_mul_pd(c[g][2], y));
+                z2[g] = _mm256_mul_pd(c[g][3], y);
+                p = g ? _mm256_add_pd(p, y) : y;
+            }
+            __m128d s = _mm_add_pd(_mm256_castpd256_pd128(p),
+                                   _mm256_extractf128_pd(p, 1));
+            __m128d t = _mm_add_sd(s, _mm_unpackhi_pd(s, s));
+            __m128d o = g0 ? _mm_load_sd(out + i)
+                           : _mm_mul_sd(d, _mm256_castpd256_pd128(x));
+            _mm_store_sd(out + i, _mm_add_sd(o, t));
+        }
+        for (int g = 0; g < gn; g++) {
+            _mm256_storeu_pd(state + 8 * (g0 + g), z1[g]);
+            _mm256_storeu_pd(state + 8 * (g0 + g) + 4, z2[g]);
+        }
+    }
+}
+
+/* |x|² for x[k..k+3], in order */
+__attribute__((target("avx2")))
+static inline __m256d norm4_pd256(const Complex *x)
+{
+    __m256d v0 = _mm256_loadu_pd(&x[0].re);
+    __m256d v1 = _mm256_loadu_pd(&x[2].re);
+    /* hadd → [|x0|² |x2|² | |x1|² |x3|²] */
+    __m256d h = _mm256_hadd_pd(_mm256_mul_pd(v0, v0), _mm256_mul_pd(v1, v1));
+    return _mm256_permute4x64_pd(h, 0xD8);
+}
+
+__attribute__((target("avx2")))
+static void magnitude_avx2(const Complex *x, double *mag, int n)
+{
+    int k = 0;
+    for (; k + 4 <= n; k += 4)
+        _mm256_storeu_pd(&mag[k], _mm256_sqrt_pd(norm4_pd256(x + k)));
+    magnitude_sse2(x + k, mag + k, n - k);
+}
+
+__attribute__((target("avx2")))
+static void power_avx2(const Complex *x, double *p, int n, double scale,
+                       int accumulate)
+{
+    __m256d vs = _mm256_set1_pd(scale);
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m256d pw = _mm256_mul_pd(norm4_pd256(x + k), vs);
+        if (accumulate)
+            pw = _mm256_add_pd(_mm256_loadu_pd(&p[k]), pw);
+        _mm256_storeu_pd(&p[k], pw);
+    }
+    power_sse2(x + k, p + k, n - k, scale, accumulate);
+}
+
+/* Requires q >= 2 (two butterflies per iteration) */
+__attribute__((target("avx2")))
+static void radix4_stage_avx2(Complex *x, int n, int q, const Complex *tw)
+{
+    const __m256d neg_hi = _mm256_set_pd(-0.0, 0.0, -0.0, 0.0);
+    int len = q << 2;
+    const Complex *w1 = tw, *w2 = tw + q, *w3 = tw + 2 * q;
+
+    for (int group = 0; group < n; group += len) {
+        for (int k = 0; k < q; k += 2) {
+            double *p0 = &x[group + k].re;
+            double *p1 = p0 + 2 * q;
+            double *p2 = p1 + 2 * q;
+            double *p3 = p2 + 2 * q;
+
+            __m256d a = _mm256_loadu_pd(p0);
+            __m256d c = cmul_pd256(_mm256_loadu_pd(p1), _mm256_loadu_pd(&w2[k].re));
+            __m256d b = cmul_pd256(_mm256_loadu_pd(p2), _mm256_loadu_pd(&w1[k].re));
+            __m256d d = cmul_pd256(_mm256_loadu_pd(p3), _mm256_loadu_pd(&w3[k].re));
+
+            __m256d s0 = _mm256_add_pd(a, c), d0 = _mm256_sub_pd(a, c);
+            __m256d s1 = _mm256_add_pd(b, d), d1 = _mm256_sub_pd(b, d);
+
+            __m256d jd1 = _mm256_xor_pd(_mm256_permute_pd(d1, 0x5), neg_hi);
+
+            _mm256_storeu_pd(p0, _mm256_add_pd(s0, s1));
+            _mm256_storeu_pd(p1, _mm256_add_pd(d0, jd1));
+            _mm256_storeu_pd(p2, _mm256_sub_pd(s0, s1));
+            _mm256_storeu_pd(p3, _mm256_sub_pd(d0, jd1));
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+static void cmul_split_avx2(double *yr, double *yi,
+                            const double *ar, const double *ai,
+                            const double *br, const double *bi, int n)
+{
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m256d a_r = _mm256_loadu_pd(ar + k), a_i = _mm256_loadu_pd(ai + k);
+        __m256d b_r = _mm256_loadu_pd(br + k), b_i = _mm256_loadu_pd(bi + k);
+        _mm256_storeu_pd(yr + k, _mm256_sub_pd(_mm256_mul_pd(a_r, b_r),
+                                               _mm256_mul_pd(a_i, b_i)));
+        _mm256_storeu_pd(yi + k, _mm256_add_pd(_mm256_mul_pd(a_r, b_i),
+                                               _mm256_mul_pd(a_i, b_r)));
+    }
+    cmul_split_sse2(yr + k, yi + k, ar + k, ai + k, br + k, bi + k, n - k);
+}
+
+__attribute__((target("avx2")))
+static void magnitude_split_avx2(const double *re, const double *im,
+                                 double *mag, int n)
+{
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m256d r = _mm256_loadu_pd(re + k), i = _mm256_loadu_pd(im + k);
+        __m256d s = _mm256_add_pd(_mm256_mul_pd(r, r), _mm256_mul_pd(i, i));
+        _mm256_storeu_pd(mag + k, _mm256_sqrt_pd(s));
+    }
+    magnitude_split_sse2(re + k, im + k, mag + k, n - k);
+}
+
+/* Requires q >= 4 (q is 1, 2 or a multiple of 4) */
+__attribute__((target("avx2")))
+static void radix4_stage_split_avx2(double *re, double *im, int n, int q,
+                                    const double *tw)
+{
+    int len = q << 2;
+    const double *w1r = tw,         *w1i = tw + q;
+    const double *w2r = tw + 2 * q, *w2i = tw + 3 * q;
+    const double *w3r = tw + 4 * q, *w3i = tw + 5 * q;
+
+    for (int group = 0; group < n; group += len) {
+        for (int k = 0; k < q; k += 4) {
+            int i0 = group + k, i1 = i0 + q, i2 = i1 + q, i3 = i2 + q;
+            __m256d x1r = _mm256_loadu_pd(re + i1), x1i = _mm256_loadu_pd(im + i1);
+            __m256d x2r = _mm256_loadu_pd(re + i2), x2i = _mm256_loadu_pd(im + i2);
+            __m256d x3r = _mm256_loadu_pd(re + i3), x3i = _mm256_loadu_pd(im + i3);
+            __m256d t1r = _mm256_loadu_pd(w1r + k), t1i = _mm256_loadu_pd(w1i + k);
+            __m256d t2r = _mm256_loadu_pd(w2r + k), t2i = _mm256_loadu_pd(w2i + k);
+            __m256d t3r = _mm256_loadu_pd(w3r + k), t3i = _mm256_loadu_pd(w3i + k);
+
+            __m256d cr = _mm256_sub_pd(_mm256_mul_pd(t2r, x1r), _mm256_mul_pd(t2i, x1i));
+            __m256d ci = _mm256_add_pd(_mm256_mul_pd(t2r, x1i), _mm256_mul_pd(t2i, x1r));
+            __m256d br = _mm256_sub_pd(_mm256_mul_pd(t1r, x2r), _mm256_mul_pd(t1i, x2i));
+            __m256d bi = _mm256_add_pd(_mm256_mul_pd(t1r, x2i), _mm256_mul_pd(t1i, x2r));
+            __m256d dr = _mm256_sub_pd(_mm256_mul_pd(t3r, x3r), _mm256_mul_pd(t3i, x3i));
+            __m256d di = _mm256_add_pd(_mm256_mul_pd(t3r, x3i), _mm256_mul_pd(t3i, x3r));
+            __m256d ar = _mm256_loadu_pd(re + i0), ai = _mm256_loadu_pd(im + i0);
+
+            __m256d s0r = _mm256_add_pd(ar, cr), s0i = _mm256_add_pd(ai, ci);
+            __m256d d0r = _mm256_sub_pd(ar, cr), d0i = _mm256_sub_pd(ai, ci);
+            __m256d s1r = _mm256_add_pd(br, dr), s1i = _mm256_add_pd(bi, di);
+            __m256d d1r = _mm256_sub_pd(br, dr), d1i = _mm256_sub_pd(bi, di);
+
+            _mm256_storeu_pd(re + i0, _mm256_add_pd(s0r, s1r));
+            _mm256_storeu_pd(im + i0, _mm256_add_pd(s0i, s1i));
+            _mm256_storeu_pd(re + i1, _mm256_add_pd(d0r, d1i));
+            _mm256_storeu_pd(im + i1, _mm256_sub_pd(d0i, d1r));
+            _mm256_storeu_pd(re + i2, _mm256_sub_pd(s0r, s1r));
+            _mm256_storeu_pd(im + i2, _mm256_sub_pd(s0i, s1i));
+            _mm256_storeu_pd(re + i3, _mm256_sub_pd(d0r, d1i));
+            _mm256_storeu_pd(im + i3, _mm256_add_pd(d0i, d1r));
+        }
+    }
+}
+
+/* Requires lanes % 4 == 0; twiddles are broadcast across the lanes */
+__attribute__((target("avx2")))
+static void radix4_stage_batch_avx2(double *re, double *im, int n, int q,
+                                    const double *tw, int lanes)
+{
+    int len = q << 2;
+    const double *w1r = tw,         *w1i = tw + q;
+    const double *w2r = tw + 2 * q, *w2i = tw + 3 * q;
+    const double *w3r = tw + 4 * q, *w3i = tw + 5 * q;
+    size_t qs = (size_t)q * (size_t)lanes;
+
+    for (int group = 0; group < n; group += len) {
+        for (int k = 0; k < q; k++) {
+            __m256d t1r = _mm256_set1_pd(w1r[k]), t1i = _mm256_set1_pd(w1i[k]);
+            __m256d t2r = _mm256_set1_pd(w2r[k]), t2i = _mm256_set1_pd(w2i[k]);
+            __m256d t3r = _mm256_set1_pd(w3r[k]), t3i = _mm256_set1_pd(w3i[k]);
+            double *r0 = re + (size_t)(group + k) * (size_t)lanes, *r1 = r0 + qs;
+            double *r2 = r1 + qs, *r3 = r2 + qs;
+            double *i0 = im + (size_t)(group + k) * (size_t)lanes, *i1 = i0 + qs;
+            double *i2 = i1 + qs, *i3 = i2 + qs;
+
+            for (int b = 0; b < lanes; b += 4) {
+                __m256d x1r = _mm256_loadu_pd(r1 + b), x1i = _mm256_loadu_pd(i1 + b);
+                __m256d x2r = _mm256_loadu_pd(r2 + b), x2i = _mm256_loadu_pd(i2 + b);
+                __m256d x3r = _mm256_loadu_pd(r3 + b), x3i = _mm256_loadu_pd(i3 + b);
+
+                __m256d cr = _mm256_sub_pd(_mm256_mul_pd(t2r, x1r), _mm256_mul_pd(t2i, x1i));
+                __m256d ci = _mm256_add_pd(_mm256_mul_pd(t2r, x1i), _mm256_mul_pd(t2i, x1r));
+                __m256d br = _mm256_sub_pd(_mm256_mul_pd(t1r, x2r), _mm256_mul_pd(t1i, x2i));
+                __m256d bi = _mm256_add_pd(_mm256_mul_pd(t1r, x2i), _mm256_mul_pd(t1i, x2r));
+                __m256d dr = _mm256_sub_pd(_mm256_mul_pd(t3r, x3r), _mm256_mul_pd(t3i, x3i));
+                __m256d di = _mm256_add_pd(_mm256_mul_pd(t3r, x3i), _mm256_mul_pd(t3i, x3r));
+                __m256d ar = _mm256_loadu_pd(r0 + b), ai = _mm256_loadu_pd(i0 + b);
+
+                __m256d s0r = _mm256_add_pd(ar, cr), s0i = _mm256_add_pd(ai, ci);
+                __m256d d0r = _mm256_sub_pd(ar, cr), d0i = _mm256_sub_pd(ai, ci);
+                __m256d s1r = _mm256_add_pd(br, dr), s1i = _mm256_add_pd(bi, di);
+                __m256d d1r = _mm256_sub_pd(br, dr), d1i = _mm256_sub_pd(bi, di);
+
+                _mm256_storeu_pd(r0 + b, _mm256_add_pd(s0r, s1r));
+                _mm256_storeu_pd(i0 + b, _mm256_add_pd(s0i, s1i));
+                _mm256_storeu_pd(r1 + b, _mm256_add_pd(d0r, d1i));
+                _mm256_storeu_pd(i1 + b, _mm256_sub_pd(d0i, d1r));
+                _mm256_storeu_pd(r2 + b, _mm256_sub_pd(s0r, s1r));
+                _mm256_storeu_pd(i2 + b, _mm256_sub_pd(s0i, s1i));
+                _mm256_storeu_pd(r3 + b, _mm256_sub_pd(d0r, d1i));
+                _mm256_storeu_pd(i3 + b, _mm256_add_pd(d0i, d1r));
+            }
+        }
+    }
+}
+
+
+/* ================================================================== */
+/*  Single precision — two complex per __m128, four per __m256        */
+/* ================================================================== */
+
+/* [a0·b0, a1·b1]; same terms as cmul_f32_scalar(), lane 0/2 subtract
+ * done as + (−t2) */
+__attribute__((target("sse2")))
+static inline __m128 cmul_ps128(__m128 a, __m128 b)
+{
+    const __m128 neg_re = _mm_castsi128_ps(_mm_set_epi32(0, (int)0x80000000,
+                                                         0, (int)0x80000000));
+    __m128 b_re = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 0, 0));
+    __m128 b_im = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 1, 1));
+    __m128 a_sw = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 t1 = _mm_mul_ps(a, b_re);
+    __m128 t2 = _mm_xor_ps(_mm_mul_ps(a_sw, b_im), neg_re);
+    return _mm_add_ps(t1, t2);
+}
+
+__attribute__((target("sse2")))
+static void cmul_f32_sse2(ComplexF *y, const ComplexF *a, const ComplexF *b, int n)
+{
+    int k = 0;
+    for (; k + 2 <= n; k += 2)
+        _mm_storeu_ps(&y[k].re, cmul_ps128(_mm_loadu_ps(&a[k].re),
+                                           _mm_loadu_ps(&b[k].re)));
+    cmul_f32_scalar(y + k, a + k, b + k, n - k);
+}
+
+/* Requires q >= 2 */
+__attribute__((target("sse2")))
+static void radix4_stage_f32_sse2(ComplexF *x, int n, int q, const ComplexF *tw)
+{
+    const __m128 neg_im = _mm_castsi128_ps(_mm_set_epi32((int)0x80000000, 0,
+                                                         (int)0x80000000, 0));
+    int len = q << 2;
+    const ComplexF *w1 = tw, *w2 = tw + q, *w3 = tw + 2 * q;
+
+    for (int group = 0; group < n; group += len) {
+        for (int k = 0; k < q; k += 2) {
+            float *p0 = &x[group + k].re;
+            float *p1 = p0 + 2 * q;
+            float *p2 = p1 + 2 * q;
+            float *p3 = p2 + 2 * q;
+
+            __m128 a = _mm_loadu_ps(p0);
+            __m128 c = cmul_ps128(_mm_loadu_ps(p1), _mm_loadu_ps(&w2[k].re));
+            __m128 b = cmul_ps128(_mm_loadu_ps(p2), _mm_loadu_ps(&w1[k].re));
+            __m128 d = cmul_ps128(_mm_loadu_ps(p3), _mm_loadu_ps(&w3[k].re));
+
+            __m128 s0 = _mm_add_ps(a, c), d0 = _mm_sub_ps(a, c);
+            __m128 s1 = _mm_add_ps(b, d), d1 = _mm_sub_ps(b, d);
+
+            /* [d1i, −d1r] = −j·d1, per complex */
+            __m128 jd1 = _mm_xor_ps(_mm_shuffle_ps(d1, d1, _MM_SHUFFLE(2, 3, 0, 1)),
+                                    neg_im);
+
+            _mm_storeu_ps(p0, _mm_add_ps(s0, s1));
+            _mm_storeu_ps(p1, _mm_add_ps(d0, jd1));
+            _mm_storeu_ps(p2, _mm_sub_ps(s0, s1));
+            _mm_storeu_ps(p3, _mm_sub_ps(d0, jd1));
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+static inline __m256 cmul_ps256(__m256 a, __m256 b)
+{
+    __m256 b_re = _mm256_moveldup_ps(b);            /* [br br ...] */
+    __m256 b_im = _mm256_movehdup_ps(b);            /* [bi bi ...] */
+    __m256 a_sw = _mm256_permute_ps(a, 0xB1);       /* [ai ar ...] */
+    return _mm256_addsub_ps(_mm256_mul_ps(a, b_re), _mm256_mul_ps(a_sw, b_im));
+}
+
+__attribute__((target("avx2")))
+static void cmul_f32_avx2(ComplexF *y, const ComplexF *a, const ComplexF *b, int n)
+{
+    int k = 0;
+    for (; k + 4 <= n; k += 4)
+        _mm256_storeu_ps(&y[k].re, cmul_ps256(_mm256_loadu_ps(&a[k].re),
+                                              _mm256_loadu_ps(&b[k].re)));
+    cmul_f32_sse2(y + k, a + k, b + k, n - k);
+}
+
+/* |x|² · scale for x[k..k+7], in order */
+__attribute__((target("avx2")))
+static void power_f32_avx2(const ComplexF *x, float *p, int n, float scale,
+                           int accumulate)
+{
+    __m256 vs = _mm256_set1_ps(scale);
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256 v0 = _mm256_loadu_ps(&x[k].re);
+        __m256 v1 = _mm256_loadu_ps(&x[k + 4].re);
+        /* hadd per 128-bit half → [x0 x1 x4 x5 | x2 x3 x6 x7]; reorder */
+        __m256 h = _mm256_hadd_ps(_mm256_mul_ps(v0, v0), _mm256_mul_ps(v1, v1));
+        h = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(h), 0xD8));
+        __m256 pw = _mm256_mul_ps(h, vs);
+        if (accumulate)
+            pw = _mm256_add_ps(_mm256_loadu_ps(&p[k]), pw);
+        _mm256_storeu_ps(&p[k], pw);
+    }
+    power_f32_scalar(x + k, p + k, n - k, scale, accumulate);
+}
+
+/* Requires q >= 4 (q is 1, 2 or a multiple of 4) */
+__attribute__((target("avx2")))
+static void radix4_stage_f32_avx2(ComplexF *x, int n, int q, const ComplexF *tw)
+{
+    const __m256 neg_im = _mm256_castsi256_ps(_mm256_set_epi32(
+        (int)0x80000000, 0, (int)0x80000000, 0,
+        (int)0x80000000, 0, (int)0x80000000, 0));
+    int len = q << 2;
+    const ComplexF *w1 = tw, *w2 = tw + q, *w3 = tw + 2 * q;
+
+    for (int group = 0; group < n; group += len) {
+        for (int k = 0; k < q; k += 4) {
+            float *p0 = &x[group + k].re;
+            float *p1 = p0 + 2 * q;
+            float *p2 = p1 + 2 * q;
+            float *p3 = p2 + 2 * q;
+
+            __m256 a = _mm256_loadu_ps(p0);
+            __m256 c = cmul_ps256(_mm256_loadu_ps(p1), _mm256_loadu_ps(&w2[k].re));
+            __m256 b = cmul_ps256(_mm256_loadu_ps(p2), _mm256_loadu_ps(&w1[k].re));
+            __m256 d = cmul_ps256(_mm256_loadu_ps(p3), _mm256_loadu_ps(&w3[k].re));
+
+            __m256 s0 = _mm256_add_ps(a, c), d0 = _mm256_sub_ps(a, c);
+            __m256 s1 = _mm256_add_ps(b, d), d1 = _mm256_sub_ps(b, d);
+
+            __m256 jd1 = _mm256_xor_ps(_mm256_permute_ps(d1, 0xB1), neg_im);
+
+            _mm256_storeu_ps(p0, _mm256_add_ps(s0, s1));
+            _mm256_storeu_ps(p1, _mm256_add_ps(d0, jd1));
+            _mm256_storeu_ps(p2, _mm256_sub_ps(s0, s1));
+            _mm256_storeu_ps(p3, _mm256_sub_ps(d0, jd1));
+        }
+    }
+}
+#endif /* SIMD_X86 */
+
+/* ================================================================== */
+/*  Public entry points                                               */
+/* ================================================================== */
+
+void simd_cmul(Complex *y, const Complex *a, const Complex *b, int n)
+{
+#ifdef SIMD_X86
+    SimdLevel lvl = simd_level();
+    if (lvl == SIMD_AVX2) { cmul_avx2(y, a, b, n); return; }
+    if (lvl == SIMD_SSE2) { cmul_sse2(y, a, b, n); return; }
+#endif
+    cmul_scalar(y, a, b, n);
+}
+
+void simd_cmul_conj(Complex *y, const Complex *a, const Complex *b, int n)
+{
+#ifdef SIMD_X86
+    SimdLevel lvl = simd_level();
+    if (lvl == SIMD_AVX2) { cmul_conj_avx2(y, a, b, n); return; }
+    if (lvl == SIMD_SSE2) { cmul_conj_sse2(y, a, b, n); return; }
+#endif
+    cmul_conj_scalar(y, a, b, n);
+}
+
+void simd_cmac(Complex *acc, const Complex *a, const Complex *b, int n)
+{
+#ifdef SIMD_X86
+    SimdLevel lvl = simd_level();
+    if (lvl == SIMD_AVX2) { cmac_avx2(acc, a, b, n); return; }
+    if (lvl == SIMD_SSE2) { cmac_sse2(acc, a, b, n); return; }
+#endif
+    cmac_scalar(acc, a, b, n);
+}
+
+void simd_sos_df2t(const double *coef, double *state, int n_sections,
+                   const double *in, double *out, int n, int lanes, int stride)
+{
+#ifdef SIMD_X86
+    SimdLevel lvl = simd_level();
+    if (lvl == SIMD_AVX2) {
+        sos_df2t_avx2(coef, state, n_sections, in, out, n, 0, lanes, stride);
+        return;
+    }
+    if (lvl == SIMD_SSE2) {
+        sos_df2t_sse2(coef, state, n_sections, in, out, n, 0, lanes, stride);
+        return;
+    }
+#endif
+    sos_df2t_scalar(coef, state, n_sections, in, out, n, 0, lanes, stride);
+}
+
+void simd_iir_parallel(const double *coef, double *state, int n_groups,
+                       double direct, const double *in, double *out, int n)
+{
+#ifdef SIMD_X86
+    SimdLevel lvl = simd_level();
+    if (lvl == SIMD_AVX2) {
+        iir_parallel_avx2(coef, state, n_groups, direct, in, out, n);
+        return;
+    }
+    if (lvl == SIMD_SSE2) {
+        iir_parallel_sse2(coef, state, n_groups, direct, in, out, n);
+        return;
+    }
+#endif
+    iir_parallel_scalar(coef, state, n_groups, direct, in, out, n);
+}
+
+void simd_magnitude(const Complex *x, double *mag, int n)
+{
+#ifdef SIMD_X86
+    SimdLevel lvl = simd_level();
+    if (lvl == SIMD_AVX2) { magnitude_avx2(x, mag, n); return; }
+    if (lvl == SIMD_SSE2) { magnitude_sse2(x, mag, n); return; }
+#endif
+    magnitude_scalar(x, mag, n);
+}
+
+void simd_power(const Complex *x, double *p, int n, double scale, int accumulate)
+{
+#ifdef SIMD_X86
+    SimdLevel lvl = simd_level();
+    if (lvl == SIMD_AVX2) { power_avx2(x, p, n, scale, accumulate); return; }
+    if (lvl == SIMD_SSE2) { power_sse2(x, p, n, scale, accumulate); return; }
+#endif
+    power_scalar(x, p, n, scale, accumulate);
+}
+
+void simd_radix4_stage(Complex *x, int n, int q, const Complex *tw)
+{
+#ifdef SIMD_X86
+    SimdLevel lvl = simd_level();
+    if (lvl == SIMD_AVX2 && q >= 2) { radix4_stage_avx2(x, n, q, tw); return; }
+    if (lvl >= SIMD_SSE2)           { radix4_stage_sse2(x, n, q, tw); return; }
+#endif
+    radix4_stage_scalar(x, n, q, tw);
+}
+
+void simd_cmul_split(double *yr, double *yi,
+                     const double *ar, const double *ai,
+                     const double *br, const double *bi, int n)
+{
+#ifdef SIMD_X86
+    SimdLevel lvl = simd_level();
+    if (lvl == SIMD_AVX2) { cmul_split_avx2(yr, yi, ar, ai, br, bi, n); return; }
+    if (lvl == SIMD_SSE2) { cmul_split_sse2(yr, yi, ar, ai, br, bi, n); return; }
+#endif
+    cmul_split_scalar(yr, yi, ar, ai, br, bi, n);
+}
+
+void simd_magnitude_split(const double *re, const double *im, double *mag, int n)
+{
+#ifdef SIMD_X86
+    SimdLevel lvl = simd_level();
+    if (lvl == SIMD_AVX2) { magnitude_split_avx2(re, im, mag, n); return; }
+    if (lvl == SIMD_SSE2) { magnitude_split_sse2(re, im, mag, n); return; }
+#endif
+    magnitude_split_scalar(re, im, mag, n);
+}
+
+void simd_radix4_stage_split(double *re, double *im, int n, int q, const double *tw)
+{
+#ifdef SIMD_X86
+    SimdLevel lvl = simd_level();
+    if (lvl == SIMD_AVX2 && q >= 4) { radix4_stage_split_avx2(re, im, n, q, tw); return; }
+    if (lvl >= SIMD_SSE2 && q >= 2) { radix4_stage_split_sse2(re, im, n, q, tw); return; }
+#endif
+    radix4_stage_split_scalar(re, im, n, q, tw);
+}
+
+void simd_radix4_stage_batch(double *re, double *im, int n, int q,
+                             const double *tw, int lanes)
+{
+#ifdef SIMD_X86
+    if (simd_level() == SIMD_AVX2 && (lanes & 3) == 0) {
+        radix4_stage_batch_avx2(re, im, n, q, tw, lanes);
+        return;
+    }
+#endif
+    radix4_stage_batch_scalar(re, im, n, q, tw, lanes);
+}
+
+void simd_cmul_f32(ComplexF *y, const ComplexF *a, const ComplexF *b, int n)
+{
+#ifdef SIMD_X86
+    SimdLevel lvl = simd_level();
+    if (lvl == SIMD_AVX2) { cmul_f32_avx2(y, a, b, n); return; }
+    if (lvl == SIMD_SSE2) { cmul_f32_sse2(y, a, b, n); return; }
+#endif
+    cmul_f32_scalar(y, a, b, n);
+}
+
+void simd_power_f32(const ComplexF *x, float *p, int n, float scale, int accumulate)
+{
+#ifdef SIMD_X86
+    if (simd_level() == SIMD_AVX2) { power_f32_avx2(x, p, n, scale, accumulate); return; }
+#endif
+    power_f32_scalar(x, p, n, scale, accumulate);
+}
+
+void simd_radix4_stage_f32(ComplexF *x, int n, int q, const ComplexF *tw)
+{
+#ifdef SIMD_X86
+    SimdLevel lvl = simd_level();
+    if (lvl == SIMD_AVX2 && q >= 4) { radix4_stage_f32_avx2(x, n, q, tw); return; }
+    if (lvl >= SIMD_SSE2 && q >= 2) { radix4_stage_f32_sse2(x, n, q, tw); return; }
+#endif
+    radix4_stage_f32_scalar(x, n, q, tw);
+}
@@ -18,7 +18,7 @@
  *     │
  *     ▼  (for each segment)
  *   ┌───────────┐   ┌───────────┐   ┌───────────┐
- *   │  Window   │──►│    FFT    │──►│  |X[k]|²  │
+ *   │  Window   │──►│   rfft    │──►│  |X[k]|²  │
  *   │  (Hann)   │   │  (NFFT)   │   │  / (N·U)  │
  *   └───────────┘   └───────────┘   └───────────┘
  *     │
@@ -32,10 +32,14 @@
  *   x[N] ──► window ──► FFT ──► |X[k]|² / N  =  PSD
  *
  *   Simple but high variance (no averaging).
+ *
+ *   All inputs are real, so every transform here is an rfft() that
+ *   produces only the NFFT/2 + 1 bins the one-sided PSD needs.
  */
 #define _POSIX_C_SOURCE 200809L
 #include "spectrum.h"
 #include "fft.h"
+#include "simd.h"
 #include "dsp_utils.h"
 
 #include <math.h>
@@ -46,27 +50,24 @@
 /*  Helpers                                                           */
 /* ------------------------------------------------------------------ */
 
-/** Check that n is a power of 2 */
-static int is_power_of_2(int n)
+/** Segments windowed and transformed per rfft_execute_many() call */
+#define SEG_BATCH 16
+
+/** Check that nfft is a usable one-sided FFT size (even, so bin nfft/2 is Nyquist) */
+static int is_valid_nfft(int n)
 {
-    return n > 0 && (n & (n - 1)) == 0;
+    return n >= 2 && (n & 1) == 0;
 }
 
 /**
  *  Compute |X[k]|² for k = 0 … nfft/2.
- *  buf must be of length nfft (Complex).  Modified in place.
+ *  buf holds the nfft/2 + 1 bins produced by rfft().
  */
 static void accumulate_power(Complex *buf, int nfft,
                              double *psd, double scale, int accumulate)
 {
-    int n_bins = nfft / 2 + 1;
-    for (int k = 0; k < n_bins; k++) {
-        double power = (buf[k].re * buf[k].re + buf[k].im * buf[k].im) * scale;
-        if (accumulate)
-            psd[k] += power;
-        else
-            psd[k] = power;
-    }
+    /* psd[k] (+)= (re² + im²)·scale, vectorised */
+    simd_power(buf, psd, nfft / 2 + 1, scale, accumulate);
 }
 
 /* ------------------------------------------------------------------ */
@@ -81,30 +82,34 @@ int periodogram(const double *x, int n, double *psd, int nfft)
 int periodogram_windowed(const double *x, int n, double *psd, int nfft,
                          window_fn win)
 {
-    if (!x || !psd || n <= 0 || nfft <= 0 || !is_power_of_2(nfft))
+    if (!x || !psd || n <= 0 || !is_valid_nfft(nfft))
         return -1;
     if (nfft < n) return -1;
 
     int n_bins = nfft / 2 + 1;
 
-    /* Allocate working buffer */
-    Complex *buf = (Complex *)calloc((size_t)nfft, sizeof(Complex));
-    if (!buf) return -1;
+    /* Allocate working buffers */
+    double  *seg = (double *)calloc((size_t)nfft, sizeof(double));
+    Complex *buf = (Complex *)malloc((size_t)n_bins * sizeof(Complex));
+    if (!seg || !buf) {
+        free(seg);
+        free(buf);
+        return -1;
+    }
 
     /* Copy signal with optional window */
     double win_power = 0.0;
     for (int i = 0; i < n; i++) {
         double w = win ? win(n, i) : 1.0;
         win_power += w * w;
-        buf[i].re = x[i] * w;
-        buf[i].im = 0.0;
+        seg[i] = x[i] * w;
     }
     /* zero-pad (calloc already zeroed) */
 
     if (win_power < 1e-30) win_power = (double)n;   /* safety for rectangular */
 
-    /* FFT */
-    fft(buf, nfft);
+    /* Real FFT → bins 0 … nfft/2 */
+    rfft(seg, buf, nfft);
 
     /* Power spectrum: |X|² / (win_power) */
     double scale = 1.0 / win_power;
@@ -114,6 +119,7 @@ int periodogram_windowed(const double *x, int n, double *psd, int nfft,
     for (int k = 1; k < n_bins - 1; k++)
         psd[k] *= 2.0;
 
+    free(seg);
     free(buf);
     return n_bins;
 }
@@ -125,7 +131,7 @@ int periodogram_windowed(const double *x, int n, double *psd, int nfft,
 int welch_psd(const double *x, int n, double *psd, int nfft,
               int seg_len, int overlap, window_fn win)
 {
-    if (!x || !psd || n <= 0 || nfft <= 0 || !is_power_of_2(nfft))
+    if (!x || !psd || n <= 0 || !is_valid_nfft(nfft))
         return -1;
     if (seg_len <= 0 || seg_len > nfft || overlap < 0 || overlap >= seg_len)
         return -1;
@@ -134,11 +140,13 @@ int welch_psd(const double *x, int n, double *psd, int nfft,
     int hop    = seg_len - overlap;
     int n_segs = 0;
 
-    /* Pre-compute window and its power */
-    double *w = (double *)malloc((size_t)seg_len * sizeof(double));
-    Complex *buf = (Complex *)calloc((size_t)nfft, sizeof(Complex));
-    if (!w || !buf) {
+    /* Pre-compute window and its power; SEG_BATCH segment/bin rows */
+    double  *w   = (double *)malloc((size_t)seg_len * sizeof(double));
+    double  *seg = (double *)calloc((size_t)SEG_BATCH * nfft, sizeof(double));
+    Complex *buf = (Complex *)malloc((size_t)SEG_BATCH * n_bins * sizeof(Complex));
+    if (!w || !seg || !buf) {
         free(w);
+        free(seg);
         free(buf);
         return -1;
     }
@@ -152,28 +160,46 @@ int welch_psd(const double *x, int n, double *psd, int nfft,
 
     double scale = 1.0 / win_power;
 
+    /* One plan for every segment */
+    const RfftPlan *plan = rfft_plan_cached(nfft);
+    if (!plan) {
+        free(w);
+        free(seg);
+        free(buf);
+        return -1;
+    }
+
     /* Zero the accumulator */
     memset(psd, 0, (size_t)n_bins * sizeof(double));
 
-    /* Iterate over segments */
-    for (int start = 0; start + seg_len <= n; start += hop) {
-        /* Window the segment into buf */
-        memset(buf, 0, (size_t)nfft * sizeof(Complex));
-        for (int i = 0; i < seg_len; i++) {
-            buf[i].re = x[start + i] * w[i];
-            buf[i].im = 0.0;
+    /* Iterate over segments, SEG_BATCH per batched FFT call */
+    int start = 0;
+    while (start + seg_len <= n) {
+        /* Window the segments (tails seg[seg_len..nfft-1] stay zero) */
+        int cnt = 0;
+        for (; cnt < SEG_BATCH && start + seg_len <= n; cnt++, start += hop) {
+            double *s = seg + (size_t)cnt * nfft;
+            for (int i = 0; i < seg_len; i++)
+                s[i] = x[start + i] * w[i];
         }
 
-        /* FFT */
-        fft(buf, nfft);
+        /* Real FFTs, one plan for the whole batch */
+        if (rfft_execute_many(plan, seg, nfft, buf, n_bins, cnt) != 0) {
+            free(w);
+            free(seg);
+            free(buf);
+            return -1;
+        }
 
-        /* Accumulate power */
-        accumulate_power(buf, nfft, psd, scale, 1);
-        n_segs++;
+        /* Accumulate power, in segment order */
+        for (int j = 0; j < cnt; j++)
+            accumulate_power(buf + (size_t)j * n_bins, nfft, psd, scale, 1);
+        n_segs += cnt;
     }
 
     if (n_segs == 0) {
         free(w);
+        free(seg);
         free(buf);
         return -1;
     }
@@ -186,6 +212,7 @@ int welch_psd(const double *x, int n, double *psd, int nfft,
         psd[k] *= 2.0;
 
     free(w);
+    free(seg);
     free(buf);
     return n_segs;
 }
@@ -198,7 +225,7 @@ int cross_psd(const double *x, const double *y, int n,
               Complex *cpsd, int nfft,
               int seg_len, int overlap, window_fn win)
 {
-    if (!x || !y || !cpsd || n <= 0 || nfft <= 0 || !is_power_of_2(nfft))
+    if (!x || !y || !cpsd || n <= 0 || !is_valid_nfft(nfft))
         return -1;
     if (seg_len <= 0 || seg_len > nfft || overlap < 0 || overlap >= seg_len)
         return -1;
@@ -207,11 +234,13 @@ int cross_psd(const double *x, const double *y, int n,
     int hop    = seg_len - overlap;
     int n_segs = 0;
 
-    double *w = (double *)malloc((size_t)seg_len * sizeof(double));
-    Complex *bx = (Complex *)calloc((size_t)nfft, sizeof(Complex));
-    Complex *by = (Complex *)calloc((size_t)nfft, sizeof(Complex));
-    if (!w || !bx || !by) {
-        free(w); free(bx); free(by);
+    double  *w  = (double *)malloc((size_t)seg_len * sizeof(double));
+    double  *sx = (double *)calloc((size_t)SEG_BATCH * nfft, sizeof(double));
+    double  *sy = (double *)calloc((size_t)SEG_BATCH * nfft, sizeof(double));
+    Complex *bx = (Complex *)malloc((size_t)SEG_BATCH * n_bins * sizeof(Complex));
+    Complex *by = (Complex *)malloc((size_t)SEG_BATCH * n_bins * sizeof(Complex));
+    if (!w || !sx || !sy || !bx || !by) {
+        free(w); free(sx); free(sy); free(bx); free(by);
         return -1;
     }
 
@@ -224,31 +253,48 @@ int cross_psd(const double *x, const double *y, int n,
 
     double scale = 1.0 / win_power;
 
+    const RfftPlan *plan = rfft_plan_cached(nfft);
+    if (!plan) {
+        free(w); free(sx); free(sy); free(bx); free(by);
+        return -1;
+    }
+
     memset(cpsd, 0, (size_t)n_bins * sizeof(Complex));
 
-    for (int start = 0; start + seg_len <= n; start += hop) {
-        memset(bx, 0, (size_t)nfft * sizeof(Complex));
-        memset(by, 0, (size_t)nfft * sizeof(Complex));
-        for (int i = 0; i < seg_len; i++) {
-            bx[i].re = x[start + i] * w[i];
-            by[i].re = y[start + i] * w[i];
+    int start = 0;
+    while (start + seg_len <= n) {
+        int cnt = 0;
+        for (; cnt < SEG_BATCH && start + seg_len <= n; cnt++, start += hop) {
+            double *px = sx + (size_t)cnt * nfft;
+            double *py = sy + (size_t)cnt * nfft;
+            for (int i = 0; i < seg_len; i++) {
+                px[i] = x[start + i] * w[i];
+                py[i] = y[start + i] * w[i];
+            }
         }
 
-        fft(bx, nfft);
-        fft(by, nfft);
+        if (rfft_execute_many(plan, sx, nfft, bx, n_bins, cnt) != 0 ||
+            rfft_execute_many(plan, sy, nfft, by, n_bins, cnt) != 0) {
+            free(w); free(sx); free(sy); free(bx); free(by);
+            return -1;
+        }
 
         /* Pxy += conj(X) · Y */
-        for (int k = 0; k < n_bins; k++) {
-            double xr = bx[k].re, xi = bx[k].im;
-            double yr = by[k].re, yi = by[k].im;
-            cpsd[k].re += (xr * yr + xi * yi) * scale;   /* Re(conj(X)·Y) */
-            cpsd[k].im += (xr * yi - xi * yr) * scale;   /* Im(conj(X)·Y) */
+        for (int j = 0; j < cnt; j++) {
+            const Complex *X = bx + (size_t)j * n_bins;
+            const Complex *Y = by + (size_t)j * n_bins;
+            for (int k = 0; k < n_bins; k++) {
+                double xr = X[k].re, xi = X[k].im;
+                double yr = Y[k].re, yi = Y[k].im;
+                cpsd[k].re += (xr * yr + xi * yi) * scale;   /* Re(conj(X)·Y) */
+                cpsd[k].im += (xr * yi - xi * yr) * scale;   /* Im(conj(X)·Y) */
+            }
         }
-        n_segs++;
+        n_segs += cnt;
     }
 
     if (n_segs == 0) {
-        free(w); free(bx); free(by);
+        free(w); free(sx); free(sy); free(bx); free(by);
         return -1;
     }
 
@@ -263,7 +309,7 @@ int cross_psd(const double *x, const double *y, int n,
         cpsd[k].im *= 2.0;
     }
 
-    free(w); free(bx); free(by);
+    free(w); free(sx); free(sy); free(bx); free(by);
     return n_segs;
 }
 
@@ -9,7 +9,7 @@
  *   [x_block, 0, 0, ..., 0]    ← zero-pad to N = L + M - 1
  *         │
  *         ▼
- *       FFT(N)  ──► X[k] × H[k]  ──► IFFT(N)  ──► y_full[0..N-1]
+ *      rfft(N)  ──► X[k] × H[k]  ──► irfft(N) ──► y_full[0..N-1]
  *                                                       │
  *                                            ┌──────────┴──────────┐
  *                                            │                     │
@@ -21,7 +21,7 @@
  *
  * ── Overlap-Save Data Flow ───────────────────────────────────────
  *
- *   Maintain a running buffer of N samples:
+ *   Each FFT reads N samples in place from an input ring:
  *     [last M-1 samples | new L samples]
  *         overlap            new data
  *
@@ -29,44 +29,99 @@
  *                                                                 │
  *                              Discard first M-1 samples  ◄───────┘
  *                              Output y_full[M-1 .. N-1]  (L samples)
+ *
+ * Signal and filter are real, so both methods keep only the N/2 + 1
+ * non-redundant bins of H and X (rfft/irfft), halving the FFT work and
+ * the spectral multiply.
  */
 
 #include "streaming.h"
 #include "fft.h"
+#include "simd.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* ── Block size ──────────────────────────────────────────────────── */
+
+int stream_block_size(int filter_len)
+{
+    if (filter_len < 1) return -1;
+
+    /* Work per output ∝ N·log₂N / (N − M + 1); N from 2·M up to 64·M */
+    int n = next_power_of_2(2 * filter_len);
+    int best_n = n;
+    double best = HUGE_VAL;
+    for (int k = 0; k < 6; k++, n *= 2) {
+        double cost = n * log2((double)n) / (n - filter_len + 1);
+        if (cost < 0.95 * best) {
+            best = cost;
+            best_n = n;
+        }
+    }
+    return best_n - filter_len + 1;
+}
+
+/* ── Crossfade (hot filter swap) ─────────────────────────────────── */
+
+/*
+ * out[i] ← out[i] + w_i·(y_new[i] − out[i]), w_i = sin²(π(i + ½) / 2L),
+ * where y_new[i] also gets tail[i] for i < carry.  The ramp is symmetric
+ * (w_i + w_{L−1−i} = 1) and flat at both ends, so neither block boundary
+ * shows a step in level or in slope.
+ */
+static void stream_crossfade(double *out, const double *y_new,
+                             const double *tail, int carry, int L)
+{
+    for (int i = 0; i < L; i++) {
+        double w = sin(M_PI * (i + 0.5) / (2.0 * L));
+        double yn = y_new[i] + (i < carry ? tail[i] : 0.0);
+        out[i] += w * w * (yn - out[i]);
+    }
+}
+
 /* ── Overlap-Add Implementation ──────────────────────────────────── */
 
 int ola_init(OlaState *s, const double *h, int filter_len, int block_size)
 {
+    memset(s, 0, sizeof(*s));
+    if (!h || filter_len < 1) return -1;
+    if (block_size <= 0)
+        block_size = stream_block_size(filter_len);
+
     s->filter_len = filter_len;
     s->block_size = block_size;
 
     /* FFT size = next power-of-2 ≥ block_size + filter_len - 1 */
     int min_n = block_size + filter_len - 1;
     s->fft_size = next_power_of_2(min_n);
+    s->plan = rfft_plan_cached(s->fft_size);
+    if (!s->plan) return -1;
 
-    /* Pre-compute H[k] = FFT of zero-padded filter */
-    s->H = (Complex *)calloc((size_t)s->fft_size, sizeof(Complex));
-    if (!s->H) return -1;
-    for (int i = 0; i < filter_len; i++) {
-        s->H[i].re = h[i];
-        s->H[i].im = 0.0;
-    }
-    fft(s->H, s->fft_size);
-
-    /* Allocate scratch buffers */
-    s->Xbuf   = (Complex *)calloc((size_t)s->fft_size, sizeof(Complex));
+    int n_bins = s->fft_size / 2 + 1;
+    s->H      = (Complex *)calloc((size_t)n_bins, sizeof(Complex));
+    s->Xbuf   = (Complex *)calloc((size_t)n_bins, sizeof(Complex));
     s->tail   = (double *)calloc((size_t)(s->fft_size - block_size), sizeof(double));
     s->padded = (double *)calloc((size_t)s->fft_size, sizeof(double));
+    s->ybuf   = (double *)calloc((size_t)s->fft_size, sizeof(double));
+    s->H_next = (Complex *)calloc((size_t)n_bins, sizeof(Complex));
+    s->Xnext  = (Complex *)calloc((size_t)n_bins, sizeof(Complex));
+    s->ynext  = (double *)calloc((size_t)s->fft_size, sizeof(double));
 
-    if (!s->Xbuf || !s->tail || !s->padded) {
+    if (!s->H || !s->Xbuf || !s->tail || !s->padded || !s->ybuf ||
+        !s->H_next || !s->Xnext || !s->ynext) {
         ola_free(s);
         return -1;
     }
 
+    /* Pre-compute H[k] = FFT of zero-padded filter (ybuf as scratch) */
+    memcpy(s->ybuf, h, (size_t)filter_len * sizeof(double));
+    rfft_execute(s->plan, s->ybuf, s->H);
+
     return 0;
 }
 
@@ -76,31 +131,47 @@ void ola_process(OlaState *s, const double *in, double *out)
     int L = s->block_size;
     int tail_len = N - L;
 
-    /* Zero-pad input to N samples */
-    memset(s->padded, 0, (size_t)N * sizeof(double));
+    /* padded[L..N-1] is zero from init and never written: copy L only */
     memcpy(s->padded, in, (size_t)L * sizeof(double));
 
     /* FFT of input block */
-    for (int i = 0; i < N; i++) {
-        s->Xbuf[i].re = s->padded[i];
-        s->Xbuf[i].im = 0.0;
+    rfft_execute(s->plan, s->padded, s->Xbuf);
+
+    /* Swap queued: the same block through the new filter as well */
+    if (s->swap_pending) {
+        simd_cmul(s->Xnext, s->Xbuf, s->H_next, N / 2 + 1);
+        irfft_execute(s->plan, s->Xnext, s->ynext);
     }
-    fft(s->Xbuf, N);
 
     /* Frequency-domain multiply: Y[k] = X[k] · H[k] */
-    for (int k = 0; k < N; k++)
-        s->Xbuf[k] = complex_mul(s->Xbuf[k], s->H[k]);
+    simd_cmul(s->Xbuf, s->Xbuf, s->H, N / 2 + 1);
 
     /* IFFT back to time domain */
-    ifft(s->Xbuf, N);
-
-    /* Output: first L samples + overlap tail from previous block */
-    for (int i = 0; i < L; i++)
-        out[i] = s->Xbuf[i].re + s->tail[i];
+    irfft_execute(s->plan, s->Xbuf, s->ybuf);
+
+    /* Output: first L samples + overlap tail from previous blocks.
+     * The tail holds N - L samples, which may be more or fewer than L. */
+    int carry = tail_len < L ? tail_len : L;
+    for (int i = 0; i < carry; i++)
+        out[i] = s->ybuf[i] + s->tail[i];
+    for (int i = carry; i < L; i++)
+        out[i] = s->ybuf[i];
+
+    /* Crossfade to (new filter on this block + old tail); from here on
+     * the tail grows from the new filter's output only */
+    const double *y = s->ybuf;
+    if (s->swap_pending) {
+        stream_crossfade(out, s->ynext, s->tail, carry, L);
+        memcpy(s->H, s->H_next, (size_t)(N / 2 + 1) * sizeof(Complex));
+        s->swap_pending = 0;
+        y = s->ynext;
+    }
 
-    /* Save new tail for next block (samples L..N-1) */
-    for (int i = 0; i < tail_len; i++)
-        s->tail[i] = s->Xbuf[L + i].re;
+    /* New tail = samples L..N-1 + what is left of the old tail */
+    for (int i = 0; i < tail_len; i++) {
+        double old = L + i < tail_len ? s->tail[L + i] : 0.0;
+        s->tail[i] = y[L + i] + old;
+    }
 }
 
 void ola_free(OlaState *s)
@@ -110,40 +181,66 @@ void ola_free(OlaState *s)
         free(s->Xbuf);   s->Xbuf   = NULL;
         free(s->tail);   s->tail   = NULL;
         free(s->padded); s->padded = NULL;
+        free(s->ybuf);   s->ybuf   = NULL;
+        free(s->H_next); s->H_next = NULL;
+        free(s->Xnext);  s->Xnext  = NULL;
+        free(s->ynext);  s->ynext  = NULL;
     }
 }
 
 /* ── Overlap-Save Implementation ─────────────────────────────────── */
 
+/*
+ * Input ring (4N samples).  Blocks are appended at ring_pos and each
+ * FFT reads the N samples starting M−1 before the new block directly
+ * from the ring:
+ *
+ *   [ … | last M−1 | new L | 0 … 0 | (unwritten) … ]
+ *          ^ seg              ^ seg + N
+ *
+ * When a segment would run off the end, the last M−1 samples move to
+ * the front — once every ~3N/L blocks instead of every block.  Samples
+ * ahead of ring_pos are zero (written ones are cleared on the wrap), so
+ * the padding for L < N − M + 1 comes for free; with the automatic
+ * L = N − M + 1 there is no padding at all.
+ */
 int ols_init(OlsState *s, const double *h, int filter_len, int block_size)
 {
+    memset(s, 0, sizeof(*s));
+    if (!h || filter_len < 1) return -1;
+    if (block_size <= 0)
+        block_size = stream_block_size(filter_len);
+
     s->filter_len = filter_len;
     s->block_size = block_size;
 
     /* FFT size = next power-of-2 ≥ block_size + filter_len - 1 */
     int min_n = block_size + filter_len - 1;
     s->fft_size = next_power_of_2(min_n);
-
-    /* Recompute L to match: L = N - M + 1 may differ from block_size */
-    /* We keep block_size as requested; user must ensure consistency */
-
-    /* Pre-compute H[k] */
-    s->H = (Complex *)calloc((size_t)s->fft_size, sizeof(Complex));
-    if (!s->H) return -1;
-    for (int i = 0; i < filter_len; i++) {
-        s->H[i].re = h[i];
-        s->H[i].im = 0.0;
-    }
-    fft(s->H, s->fft_size);
-
-    s->Xbuf = (Complex *)calloc((size_t)s->fft_size, sizeof(Complex));
-    s->input_buf = (double *)calloc((size_t)s->fft_size, sizeof(double));
-
-    if (!s->Xbuf || !s->input_buf) {
+    s->ring_len = 4 * s->fft_size;
+    s->ring_pos = filter_len - 1;
+    s->plan = rfft_plan_cached(s->fft_size);
+    if (!s->plan) return -1;
+
+    int n_bins = s->fft_size / 2 + 1;
+    s->H         = (Complex *)calloc((size_t)n_bins, sizeof(Complex));
+    s->Xbuf      = (Complex *)calloc((size_t)n_bins, sizeof(Complex));
+    s->input_buf = (double *)calloc((size_t)s->ring_len, sizeof(double));
+    s->ybuf      = (double *)calloc((size_t)s->fft_size, sizeof(double));
+    s->H_next    = (Complex *)calloc((size_t)n_bins, sizeof(Complex));
+    s->Xnext     = (Complex *)calloc((size_t)n_bins, sizeof(Complex));
+    s->ynext     = (double *)calloc((size_t)s->fft_size, sizeof(double));
+
+    if (!s->H || !s->Xbuf || !s->input_buf || !s->ybuf ||
+        !s->H_next || !s->Xnext || !s->ynext) {
         ols_free(s);
         return -1;
     }
 
+    /* Pre-compute H[k] (ybuf doubles as the zero-padded filter) */
+    memcpy(s->ybuf, h, (size_t)filter_len * sizeof(double));
+    rfft_execute(s->plan, s->ybuf, s->H);
+
     return 0;
 }
 
@@ -152,33 +249,41 @@ void ols_process(OlsState *s, const double *in, double *out)
     int N = s->fft_size;
     int M = s->filter_len;
     int L = s->block_size;
+    double *ring = s->input_buf;
 
-    /* Shift: keep last M-1 samples, append new L samples */
-    memmove(s->input_buf, s->input_buf + L, (size_t)(M - 1) * sizeof(double));
-    memcpy(s->input_buf + (M - 1), in, (size_t)L * sizeof(double));
+    /* Wrap: history to the front, clear what was written after it */
+    if (s->ring_pos - (M - 1) + N > s->ring_len) {
+        memmove(ring, ring + s->ring_pos - (M - 1), (size_t)(M - 1) * sizeof(double));
+        memset(ring + (M - 1), 0, (size_t)(s->ring_pos - (M - 1)) * sizeof(double));
+        s->ring_pos = M - 1;
+    }
 
-    /* Zero-pad rest (if N > M-1 + L) */
-    int filled = M - 1 + L;
-    if (filled < N)
-        memset(s->input_buf + filled, 0, (size_t)(N - filled) * sizeof(double));
+    /* Append the block; the segment [last M-1 | new L | 0…] is in place */
+    memcpy(ring + s->ring_pos, in, (size_t)L * sizeof(double));
+    rfft_execute(s->plan, ring + s->ring_pos - (M - 1), s->Xbuf);
+    s->ring_pos += L;
 
-    /* FFT of input segment */
-    for (int i = 0; i < N; i++) {
-        s->Xbuf[i].re = s->input_buf[i];
-        s->Xbuf[i].im = 0.0;
+    /* Swap queued: the same segment through the new filter as well */
+    if (s->swap_pending) {
+        simd_cmul(s->Xnext, s->Xbuf, s->H_next, N / 2 + 1);
+        irfft_execute(s->plan, s->Xnext, s->ynext);
     }
-    fft(s->Xbuf, N);
 
     /* Y[k] = X[k] · H[k] */
-    for (int k = 0; k < N; k++)
-        s->Xbuf[k] = complex_mul(s->Xbuf[k], s->H[k]);
+    simd_cmul(s->Xbuf, s->Xbuf, s->H, N / 2 + 1);
 
     /* IFFT */
-    ifft(s->Xbuf, N);
+    irfft_execute(s->plan, s->Xbuf, s->ybuf);
 
     /* Discard first M-1 samples (circular convolution artefacts) */
-    for (int i = 0; i < L; i++)
-        out[i] = s->Xbuf[M - 1 + i].re;
+    memcpy(out, s->ybuf + (M - 1), (size_t)L * sizeof(double));
+
+    /* Both outputs are complete (same history): plain crossfade */
+    if (s->swap_pending) {
+        stream_crossfade(out, s->ynext + (M - 1), NULL, 0, L);
+        memcpy(s->H, s->H_next, (size_t)(N / 2 + 1) * sizeof(Complex));
+        s->swap_pending = 0;
+    }
 }
 
 void ols_free(OlsState *s)
@@ -187,5 +292,344 @@ void ols_free(OlsState *s)
         free(s->H);         s->H         = NULL;
         free(s->Xbuf);      s->Xbuf      = NULL;
         free(s->input_buf); s->input_buf = NULL;
+        free(s->ybuf);      s->ybuf      = NULL;
+        free(s->H_next);    s->H_next    = NULL;
+        free(s->Xnext);     s->Xnext     = NULL;
+        free(s->ynext);     s->ynext     = NULL;
+    }
+}
+
+/* ── Hot filter swap ─────────────────────────────────────────────── */
+
+int stream_filter_spectrum(const double *h, int filter_len, int fft_size,
+                           Complex *H)
+{
+    if (!h || !H || filter_len < 1 || fft_size < 2 || filter_len > fft_size ||
+        (fft_size & (fft_size - 1)))
+        return -1;
+
+    const RfftPlan *plan = rfft_plan_cached(fft_size);
+    double *pad = (double *)calloc((size_t)fft_size, sizeof(double));
+    if (!plan || !pad) {
+        free(pad);
+        return -1;
+    }
+    memcpy(pad, h, (size_t)filter_len * sizeof(double));
+    rfft_execute(plan, pad, H);
+    free(pad);
+    return 0;
+}
+
+int ola_set_filter(OlaState *s, const Complex *H, int filter_len)
+{
+    if (!H || filter_len < 1 || filter_len > s->fft_size - s->block_size + 1)
+        return -1;
+    memcpy(s->H_next, H, (size_t)(s->fft_size / 2 + 1) * sizeof(Complex));
+    s->swap_pending = 1;
+    return 0;
+}
+
+int ols_set_filter(OlsState *s, const Complex *H, int filter_len)
+{
+    if (!H || filter_len < 1 || filter_len > s->filter_len)
+        return -1;
+    memcpy(s->H_next, H, (size_t)(s->fft_size / 2 + 1) * sizeof(Complex));
+    s->swap_pending = 1;
+    return 0;
+}
+
+/* ── Uniformly Partitioned Overlap-Save ──────────────────────────── */
+
+int upols_init(UpolsState *s, const double *h, int filter_len, int block_size)
+{
+    memset(s, 0, sizeof(*s));
+    if (!h || filter_len < 1 || block_size < 1) return -1;
+
+    int B = block_size;
+    s->block_size = B;
+    s->fft_size   = 2 * B;
+    s->filter_len = filter_len;
+    s->n_parts    = (filter_len + B - 1) / B;
+    s->plan = rfft_plan_cached(s->fft_size);
+    if (!s->plan) return -1;
+
+    size_t nb = (size_t)B + 1;
+    s->H         = (Complex *)calloc(nb * (size_t)s->n_parts, sizeof(Complex));
+    s->fdl       = (Complex *)calloc(nb * (size_t)s->n_parts, sizeof(Complex));
+    s->acc       = (Complex *)calloc(nb, sizeof(Complex));
+    s->input_buf = (double *)calloc((size_t)s->fft_size, sizeof(double));
+    s->ybuf      = (double *)calloc((size_t)s->fft_size, sizeof(double));
+
+    if (!s->H || !s->fdl || !s->acc || !s->input_buf || !s->ybuf) {
+        upols_free(s);
+        return -1;
+    }
+
+    /* H_p = rfft of [h[pB .. pB+B−1], 0 … 0] (ybuf as the padded buffer) */
+    for (int p = 0; p < s->n_parts; p++) {
+        int len = filter_len - p * B < B ? filter_len - p * B : B;
+        memset(s->ybuf, 0, (size_t)s->fft_size * sizeof(double));
+        memcpy(s->ybuf, h + (size_t)p * B, (size_t)len * sizeof(double));
+        rfft_execute(s->plan, s->ybuf, s->H + (size_t)p * nb);
+    }
+    return 0;
+}
+
+void upols_process(UpolsState *s, const double *in, double *out)
+{
+    int B  = s->block_size;
+    int P  = s->n_parts;
+    int nb = B + 1;
+
+    /* Slide: [x_{n−1} | x_n] */
+    memcpy(s->input_buf, s->input_buf + B, (size_t)B * sizeof(double));
+    memcpy(s->input_buf + B, in, (size_t)B * sizeof(double));
+
+    /* Newest spectrum overwrites the oldest; the FDL runs backwards so
+     * X_{n−p} sits p slots after it (mod P) */
+    s->fdl_pos = (s->fdl_pos == 0 ? P : s->fdl_pos) - 1;
+    Complex *xn = s->fdl + (size_t)s->fdl_pos * nb;
+    rfft_execute(s->plan, s->input_buf, xn);
+
+    /* Y = Σ_p X_{n−p} · H_p */
+    simd_cmul(s->acc, xn, s->H, nb);
+    for (int p = 1; p < P; p++) {
+        int slot = s->fdl_pos + p;
+        if (slot >= P) slot -= P;
+        simd_cmac(s->acc, s->fdl + (size_t)slot * nb, s->H + (size_t)p * nb, nb);
+    }
+
+    /* First B samples are circular wrap-around; keep the last B */
+    irfft_execute(s->plan, s->acc, s->ybuf);
+    memcpy(out, s->ybuf + B, (size_t)B * sizeof(double));
+}
+
+void upols_reset(UpolsState *s)
+{
+    size_t nb = (size_t)s->block_size + 1;
+    memset(s->fdl, 0, nb * (size_t)s->n_parts * sizeof(Complex));
+    memset(s->input_buf, 0, (size_t)s->fft_size * sizeof(double));
+    s->fdl_pos = 0;
+}
+
+void upols_free(UpolsState *s)
+{
+    if (s) {
+        free(s->H);         s->H         = NULL;
+        free(s->fdl);       s->fdl       = NULL;
+        free(s->acc);       s->acc       = NULL;
+        free(s->input_buf); s->input_buf = NULL;
+        free(s->ybuf);      s->ybuf      = NULL;
+    }
+}
+
+/* ── Non-Uniformly Partitioned Convolution ───────────────────────── */
+
+/*
+ * Level i (block K = B·4^i) covers taps [K − B, 4K − B) — three
+ * partitions — and the last level takes everything that is left.
+ *
+ * Timing: level i collects K inputs starting at sample t0 and runs when
+ * the call covering [t0 + K − B, t0 + K) arrives.  Its K outputs are
+ * (h_i ∗ x)[t0 .. t0+K−1], which belong at samples t0 + (K − B) + j:
+ * the first one is due in this very call, the rest over the next
+ * K/B − 1 calls.  They are added into a ring read one block per call.
+ */
+int nupols_init(NupolsState *s, const double *h, int filter_len,
+                int block_size, int max_block)
+{
+    memset(s, 0, sizeof(*s));
+    if (!h || filter_len < 1 || block_size < 1) return -1;
+
+    int B = block_size;
+    s->block_size = B;
+    s->filter_len = filter_len;
+
+    /* Partition layout */
+    int K = B, start = 0, n = 0;
+    while (start < filter_len && n < NUPOLS_MAX_LEVELS) {
+        int next_k = 4 * K;
+        int last = n == NUPOLS_MAX_LEVELS - 1 || next_k > max_block ||
+                   next_k > filter_len;
+        int end = last ? filter_len : next_k - B;
+        if (end > filter_len) end = filter_len;
+
+        s->offset[n] = start;
+        if (upols_init(&s->level[n], h + start, end - start, K) != 0) {
+            s->n_levels = n;
+            nupols_free(s);
+            return -1;
+        }
+        n++;
+        start = end;
+        K = next_k;
+    }
+    s->n_levels = n;
+
+    int k_max = s->level[n - 1].block_size;
+    int ring_len = next_power_of_2(k_max);
+    s->ring_mask = ring_len - 1;
+    s->ring    = (double *)calloc((size_t)ring_len, sizeof(double));
+    s->scratch = (double *)calloc((size_t)k_max, sizeof(double));
+    int ok = s->ring && s->scratch;
+    for (int i = 1; i < n && ok; i++) {
+        s->in_acc[i] = (double *)calloc((size_t)s->level[i].block_size,
+                                        sizeof(double));
+        ok = s->in_acc[i] != NULL;
+    }
+    if (!ok) {
+        nupols_free(s);
+        return -1;
+    }
+    return 0;
+}
+
+void nupols_process(NupolsState *s, const double *in, double *out)
+{
+    int B = s->block_size;
+
+    /* Gather input for the large levels before out (maybe = in) is written */
+    for (int i = 1; i < s->n_levels; i++) {
+        memcpy(s->in_acc[i] + s->fill[i], in, (size_t)B * sizeof(double));
+        s->fill[i] += B;
+    }
+
+    upols_process(&s->level[0], in, out);
+
+    for (int i = 1; i < s->n_levels; i++) {
+        int K = s->level[i].block_size;
+        if (s->fill[i] < K) continue;
+        s->fill[i] = 0;
+        upols_process(&s->level[i], s->in_acc[i], s->scratch);
+        for (int j = 0; j < K; j++)
+            s->ring[(s->ring_pos + j) & s->ring_mask] += s->scratch[j];
+    }
+
+    for (int j = 0; j < B; j++) {
+        int slot = (s->ring_pos + j) & s->ring_mask;
+        out[j] += s->ring[slot];
+        s->ring[slot] = 0.0;
+    }
+    s->ring_pos = (s->ring_pos + B) & s->ring_mask;
+}
+
+void nupols_free(NupolsState *s)
+{
+    if (s) {
+        for (int i = 0; i < s->n_levels; i++) {
+            upols_free(&s->level[i]);
+            free(s->in_acc[i]);
+            s->in_acc[i] = NULL;
+        }
+        free(s->ring);    s->ring    = NULL;
+        free(s->scratch); s->scratch = NULL;
+        s->n_levels = 0;
+    }
+}
+
+/* ── Multichannel Convolution ────────────────────────────────────── */
+
+int multiconv_init(MultiConvState *s, const double *h, int filter_len,
+                   int block_size, int n_channels, ChannelLayout layout,
+                   int overlap_save)
+{
+    memset(s, 0, sizeof(*s));
+    if (!h || filter_len < 1 || block_size < 1 || n_channels < 1)
+        return -1;
+
+    int N = next_power_of_2(block_size + filter_len - 1);
+    s->block_size   = block_size;
+    s->fft_size     = N;
+    s->filter_len   = filter_len;
+    s->n_channels   = n_channels;
+    s->n_pairs      = (n_channels + 1) / 2;
+    s->overlap_save = overlap_save ? 1 : 0;
+    s->hist_len     = s->overlap_save ? filter_len - 1 : N - block_size;
+    s->layout       = layout;
+    s->plan = fft_plan_cached(N);
+    if (!s->plan) return -1;
+
+    s->H      = (Complex *)calloc((size_t)N, sizeof(Complex));
+    s->frames = (Complex *)calloc((size_t)N * (size_t)s->n_pairs, sizeof(Complex));
+    s->hist   = (double *)calloc((size_t)n_channels * (size_t)(s->hist_len + 1),
+                                 sizeof(double));
+    if (!s->H || !s->frames || !s->hist) {
+        multiconv_free(s);
+        return -1;
+    }
+
+    /* Full N-bin spectrum of the zero-padded filter */
+    for (int k = 0; k < filter_len; k++)
+        s->H[k].re = h[k];
+    fft_execute(s->plan, s->H);
+    return 0;
+}
+
+int multiconv_process(MultiConvState *s, const double *in, double *out)
+{
+    int N = s->fft_size, L = s->block_size, C = s->n_channels;
+    int P = s->n_pairs, H = s->hist_len;
+    int ch_step = s->layout == CHAN_INTERLEAVED ? 1 : L;  /* channel c at c·ch_step */
+    int i_step  = s->layout == CHAN_INTERLEAVED ? C : 1;  /* sample i at i·i_step   */
+    int lead = s->overlap_save ? H : 0;                   /* history ahead of block */
+
+    /* Stage: channel 2p → frame p real part, channel 2p+1 → imaginary */
+    memset(s->frames, 0, (size_t)N * P * sizeof(Complex));
+    for (int c = 0; c < C; c++) {
+        double *f = (double *)(s->frames + (size_t)(c >> 1) * N) + (c & 1);
+        const double *x = in + (size_t)c * ch_step;
+        double *hist = s->hist + (size_t)c * H;
+        for (int t = 0; t < lead; t++)
+            f[2 * t] = hist[t];
+        for (int i = 0; i < L; i++)
+            f[2 * (lead + i)] = x[(size_t)i * i_step];
+        /* OLS: keep the newest M − 1 samples of [history | block] */
+        for (int t = 0; t < lead; t++)
+            hist[t] = f[2 * (L + t)];
+    }
+
+    if (fft_execute_many(s->plan, s->frames, P, 1, N) != 0)
+        return -1;
+    for (int p = 0; p < P; p++) {
+        Complex *f = s->frames + (size_t)p * N;
+        simd_cmul(f, f, s->H, N);
+    }
+    if (ifft_execute_many(s->plan, s->frames, P, 1, N) != 0)
+        return -1;
+
+    /* Unpack: OLS discards the first M − 1 samples, OLA adds the tails */
+    int carry = H < L ? H : L;
+    for (int c = 0; c < C; c++) {
+        const double *f = (const double *)(s->frames + (size_t)(c >> 1) * N) + (c & 1);
+        double *y = out + (size_t)c * ch_step;
+        double *hist = s->hist + (size_t)c * H;
+        if (s->overlap_save) {
+            for (int i = 0; i < L; i++)
+                y[(size_t)i * i_step] = f[2 * (lead + i)];
+            continue;
+        }
+        for (int i = 0; i < L; i++) {
+            double v = f[2 * i];
+            y[(size_t)i * i_step] = i < carry ? v + hist[i] : v;
+        }
+        for (int t = 0; t < H; t++) {
+            double old = L + t < H ? hist[L + t] : 0.0;
+            hist[t] = f[2 * (L + t)] + old;
+        }
+    }
+    return 0;
+}
+
+void multiconv_reset(MultiConvState *s)
+{
+    memset(s->hist, 0, (size_t)s->n_channels * (size_t)s->hist_len * sizeof(double));
+}
+
+void multiconv_free(MultiConvState *s)
+{
+    if (s) {
+        free(s->H);      s->H      = NULL;
+        free(s->frames); s->frames = NULL;
+        free(s->hist);   s->hist   = NULL;
     }
 }
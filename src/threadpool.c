@@ -0,0 +1,177 @@
+/**
+ * @file threadpool.c
+ * @brief Library-owned pthread worker pool.
+ *
+ * ── Job protocol ────────────────────────────────────────────────
+ *
+ *   caller                               workers (n_threads − 1)
+ *   ──────                               ───────
+ *   lock, publish job, generation++  ──► wake on work_cv
+ *   take chunks until none left          take chunks until none left
+ *   wait on done_cv until pending == 0 ◄─ last chunk signals done_cv
+ *
+ * Chunks are handed out under pool_lock (one lock round-trip per
+ * chunk, and there are at most n_threads chunks), so no atomics are
+ * needed.  Only one job runs at a time; a nested or concurrent
+ * dsp_parallel_for() sees `busy` and runs serially on its caller.
+ *
+ * @see include/threadpool.h
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "threadpool.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  work_cv   = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  done_cv   = PTHREAD_COND_INITIALIZER;
+
+static pthread_t workers[DSP_MAX_THREADS];
+static int n_threads = 1;          /* requested, caller included   */
+static int n_workers = 0;          /* running worker threads       */
+static int stopping  = 0;
+static int busy      = 0;
+static unsigned long generation = 0;
+
+/* Current job */
+static dsp_task_fn job_fn;
+static void *job_ctx;
+static int job_count, job_chunks, job_next, job_pending;
+
+/* ================================================================== */
+/*  Chunk execution                                                   */
+/* ================================================================== */
+
+/* Called with pool_lock held; returns with it held */
+static void run_chunks(void)
+{
+    while (job_next < job_chunks) {
+        int c = job_next++;
+        int begin = (int)((long long)job_count * c / job_chunks);
+        int end   = (int)((long long)job_count * (c + 1) / job_chunks);
+        dsp_task_fn fn = job_fn;
+        void *ctx = job_ctx;
+
+        pthread_mutex_unlock(&pool_lock);
+        fn(ctx, begin, end);
+        pthread_mutex_lock(&pool_lock);
+
+        if (--job_pending == 0)
+            pthread_cond_signal(&done_cv);
+    }
+}
+
+static void *worker_main(void *arg)
+{
+    unsigned long seen = (unsigned long)(uintptr_t)arg;
+
+    pthread_mutex_lock(&pool_lock);
+    for (;;) {
+        while (!stopping && generation == seen)
+            pthread_cond_wait(&work_cv, &pool_lock);
+        if (stopping)
+            break;
+        seen = generation;
+        run_chunks();
+    }
+    pthread_mutex_unlock(&pool_lock);
+    return NULL;
+}
+
+/* ================================================================== */
+/*  Public API                                                        */
+/* ================================================================== */
+
+int dsp_set_num_threads(int n)
+{
+    if (n <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        n = cpus > 0 ? (int)cpus : 1;
+    }
+    if (n > DSP_MAX_THREADS) n = DSP_MAX_THREADS;
+
+    /* Shrinking: retire the current workers, the next job respawns */
+    pthread_mutex_lock(&pool_lock);
+    int shrink = n - 1 < n_workers;
+    pthread_mutex_unlock(&pool_lock);
+    if (shrink)
+        dsp_threadpool_shutdown();
+
+    pthread_mutex_lock(&pool_lock);
+    n_threads = n;
+    pthread_mutex_unlock(&pool_lock);
+    return n;
+}
+
+int dsp_get_num_threads(void)
+{
+    pthread_mutex_lock(&pool_lock);
+    int n = n_threads;
+    pthread_mutex_unlock(&pool_lock);
+    return n;
+}
+
+void dsp_parallel_for(int count, int min_chunk, dsp_task_fn fn, void *ctx)
+{
+    if (count <= 0) return;
+    if (min_chunk < 1) min_chunk = 1;
+
+    pthread_mutex_lock(&pool_lock);
+    int chunks = count / min_chunk;
+    if (chunks > n_threads) chunks = n_threads;
+
+    if (chunks <= 1 || busy) {
+        pthread_mutex_unlock(&pool_lock);
+        fn(ctx, 0, count);
+        return;
+    }
+
+    /* Spawn missing workers; they start at the current generation */
+    while (n_workers < n_threads - 1) {
+        if (pthread_create(&workers[n_workers], NULL, worker_main,
+                           (void *)(uintptr_t)generation) != 0)
+            break;
+        n_workers++;
+    }
+    if (n_workers == 0) {
+        pthread_mutex_unlock(&pool_lock);
+        fn(ctx, 0, count);
+        return;
+    }
+
+    busy        = 1;
+    job_fn      = fn;
+    job_ctx     = ctx;
+    job_count   = count;
+    job_chunks  = chunks;
+    job_next    = 0;
+    job_pending = chunks;
+    generation++;
+    pthread_cond_broadcast(&work_cv);
+
+    run_chunks();                       /* the caller works too */
+    while (job_pending > 0)
+        pthread_cond_wait(&done_cv, &pool_lock);
+
+    busy = 0;
+    pthread_mutex_unlock(&pool_lock);
+}
+
+void dsp_threadpool_shutdown(void)
+{
+    pthread_mutex_lock(&pool_lock);
+    int n = n_workers;
+    stopping = 1;
+    pthread_cond_broadcast(&work_cv);
+    pthread_mutex_unlock(&pool_lock);
+
+    for (int i = 0; i < n; i++)
+        pthread_join(workers[i], NULL);
+
+    pthread_mutex_lock(&pool_lock);
+    n_workers = 0;
+    stopping  = 0;
+    pthread_mutex_unlock(&pool_lock);
+}
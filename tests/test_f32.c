@@ -0,0 +1,319 @@
+/**
+ * @file test_f32.c
+ * @brief Unit tests for the single-precision (float32) API.
+ *
+ * Every float routine is compared with its double counterpart on the
+ * same data; tolerances are relative to the signal scale and sized for
+ * a 24-bit mantissa.
+ *
+ * Tests:
+ *   1.  Float SIMD kernels are bit-identical to scalar at every level
+ *   2.  fft_f32 matches fft (power-of-2 and mixed-radix sizes)
+ *   3.  ifft_f32 / irfft round-trip
+ *   4.  rfft_f32 matches rfft
+ *   5.  fir_filter_f32 matches fir_filter
+ *   6.  SOS float cascade matches double; block == per-sample
+ *   7.  OLA/OLS float match direct FIR
+ *   8.  welch_psd_f32 matches welch_psd
+ *   9.  Float ring buffer write/read/peek/skip and wrap-around
+ *
+ * Run: make test
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include "test_framework.h"
+#include "dsp_f32.h"
+#include "dsp_utils.h"
+#include "fft.h"
+#include "filter.h"
+#include "iir.h"
+#include "simd.h"
+#include "spectrum.h"
+#include "streaming.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* max |a − b| over n complex values, relative to max |b| */
+static double rel_err_c(const ComplexF *a, const Complex *b, int n)
+{
+    double err = 0.0, ref = 1e-30;
+    for (int i = 0; i < n; i++) {
+        double dr = a[i].re - b[i].re, di = a[i].im - b[i].im;
+        double e = sqrt(dr * dr + di * di);
+        double m = sqrt(b[i].re * b[i].re + b[i].im * b[i].im);
+        if (e > err) err = e;
+        if (m > ref) ref = m;
+    }
+    return err / ref;
+}
+
+/* max |a − b| over n reals, relative to max |b| */
+static double rel_err_r(const float *a, const double *b, int n)
+{
+    double err = 0.0, ref = 1e-30;
+    for (int i = 0; i < n; i++) {
+        double e = fabs(a[i] - b[i]);
+        if (e > err) err = e;
+        if (fabs(b[i]) > ref) ref = fabs(b[i]);
+    }
+    return err / ref;
+}
+
+int main(void)
+{
+    TEST_SUITE("Single precision (float32) API");
+
+    TEST_CASE_BEGIN("Float SIMD kernels are bit-identical to scalar");
+    {
+        enum { N = 64 };
+        ComplexF a[N], b[N], y0[N], y1[N], x0[N], x1[N], tw[3 * 16];
+        float p0[N], p1[N];
+        SimdLevel best = simd_detect();
+        for (int i = 0; i < N; i++) {
+            a[i].re = (float)(sin(0.9 * i) * 3.0);  a[i].im = (float)(cos(0.2 * i) - 0.5);
+            b[i].re = (float)(1.0 / (i + 1.5));     b[i].im = (float)sin(2.1 * i);
+        }
+        for (int k = 0; k < 3 * 16; k++) {
+            tw[k].re = (float)cos(0.1 * k);
+            tw[k].im = (float)-sin(0.1 * k);
+        }
+        int ok = 1;
+        for (int lv = SIMD_SSE2; lv <= (int)best && ok; lv++) {
+            /* n = 37: odd tail; q = 1, 2, 4, 16 hit every stage path */
+            for (int q = 1; q <= 16 && ok; q = q < 4 ? q * 2 : q * 4) {
+                simd_set_level(SIMD_SCALAR);
+                simd_cmul_f32(y0, a, b, 37);
+                for (int i = 0; i < N; i++) p0[i] = p1[i] = 0.25f * (float)i;
+                simd_power_f32(b, p0, 37, 0.5f, 1);
+                memcpy(x0, a, sizeof(a));
+                simd_radix4_stage_f32(x0, N, q, tw);
+
+                simd_set_level((SimdLevel)lv);
+                simd_cmul_f32(y1, a, b, 37);
+                simd_power_f32(b, p1, 37, 0.5f, 1);
+                memcpy(x1, a, sizeof(a));
+                simd_radix4_stage_f32(x1, N, q, tw);
+
+                ok = memcmp(y0, y1, 37 * sizeof(ComplexF)) == 0 &&
+                     memcmp(p0, p1, 37 * sizeof(float)) == 0 &&
+                     memcmp(x0, x1, sizeof(x0)) == 0;
+            }
+        }
+        simd_set_level(best);
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("vector float kernel differs from scalar"); }
+    }
+
+    TEST_CASE_BEGIN("fft_f32 matches fft (pow2 and mixed-radix)");
+    {
+        static const int sizes[] = { 2, 8, 32, 1024, 4096, 12, 360 };
+        int ok = 1;
+        for (int s = 0; s < 7 && ok; s++) {
+            int n = sizes[s];
+            Complex  *d = (Complex *)malloc((size_t)n * sizeof(Complex));
+            ComplexF *f = (ComplexF *)malloc((size_t)n * sizeof(ComplexF));
+            for (int i = 0; i < n; i++) {
+                d[i].re = sin(0.37 * i) + 0.1 * (i % 7);
+                d[i].im = cos(1.3 * i);
+                f[i].re = (float)d[i].re;
+                f[i].im = (float)d[i].im;
+            }
+            fft(d, n);
+            ok = fft_f32(f, n) == 0 && rel_err_c(f, d, n) < 1e-5;
+            free(d);
+            free(f);
+        }
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("float FFT disagrees with double"); }
+    }
+
+    TEST_CASE_BEGIN("ifft_f32 and irfft_execute_f32 round-trip");
+    {
+        int n = 2048, ok = 1;
+        ComplexF *x = (ComplexF *)malloc((size_t)n * sizeof(ComplexF));
+        ComplexF *X = (ComplexF *)malloc((size_t)(n / 2 + 1) * sizeof(ComplexF));
+        float *r = (float *)malloc((size_t)n * sizeof(float));
+        float *r2 = (float *)malloc((size_t)n * sizeof(float));
+        for (int i = 0; i < n; i++) {
+            x[i].re = (float)sin(0.05 * i);
+            x[i].im = (float)(0.5 * cos(0.11 * i));
+            r[i] = x[i].re;
+        }
+        fft_f32(x, n);
+        ifft_f32(x, n);
+        for (int i = 0; i < n && ok; i++)
+            ok = fabsf(x[i].re - (float)sin(0.05 * i)) < 1e-5f &&
+                 fabsf(x[i].im - (float)(0.5 * cos(0.11 * i))) < 1e-5f;
+
+        const RfftPlanF *p = rfft_plan_cached_f32(n);
+        ok = ok && p && rfft_execute_f32(p, r, X) == 0 &&
+             irfft_execute_f32(p, X, r2) == 0;
+        for (int i = 0; i < n && ok; i++)
+            ok = fabsf(r2[i] - r[i]) < 1e-5f;
+        free(x);
+        free(X);
+        free(r);
+        free(r2);
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("round-trip error too large"); }
+    }
+
+    TEST_CASE_BEGIN("rfft_f32 matches rfft");
+    {
+        static const int sizes[] = { 2, 16, 1024, 24 };
+        int ok = 1;
+        for (int s = 0; s < 4 && ok; s++) {
+            int n = sizes[s], nb = n / 2 + 1;
+            double   *d  = (double *)malloc((size_t)n * sizeof(double));
+            float    *f  = (float *)malloc((size_t)n * sizeof(float));
+            Complex  *D  = (Complex *)malloc((size_t)nb * sizeof(Complex));
+            ComplexF *F  = (ComplexF *)malloc((size_t)nb * sizeof(ComplexF));
+            for (int i = 0; i < n; i++) {
+                f[i] = (float)(sin(0.3 * i) + 0.2 * cos(2.0 * i));
+                d[i] = f[i];
+            }
+            rfft(d, D, n);
+            ok = rfft_f32(f, F, n) == 0 && rel_err_c(F, D, nb) < 1e-5;
+            free(d);
+            free(f);
+            free(D);
+            free(F);
+        }
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("float rfft disagrees with double"); }
+    }
+
+    TEST_CASE_BEGIN("fir_filter_f32 matches fir_filter");
+    {
+        enum { N = 500, T = 31 };
+        double xd[N], yd[N], hd[T];
+        float  xf[N], yf[N], hf[T];
+        for (int i = 0; i < N; i++) {
+            xf[i] = (float)(sin(0.07 * i) + 0.3 * sin(1.9 * i));
+            xd[i] = xf[i];
+        }
+        for (int k = 0; k < T; k++) {
+            hf[k] = (float)(0.5 - 0.5 * cos(2.0 * M_PI * k / (T - 1))) / 15.0f;
+            hd[k] = hf[k];
+        }
+        fir_filter(xd, yd, N, hd, T);
+        fir_filter_f32(xf, yf, N, hf, T);
+        if (rel_err_r(yf, yd, N) < 1e-5) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("float FIR disagrees with double"); }
+    }
+
+    TEST_CASE_BEGIN("SOS float cascade matches double; block == per-sample");
+    {
+        enum { N = 1000 };
+        SOSCascade  sd;
+        SOSCascadeF sf, sf2;
+        double xd[N], yd[N];
+        float  xf[N], yf[N], ys[N];
+        int ok = butterworth_lowpass(6, 0.1, &sd) == 0;
+        sos_to_f32(&sf, &sd);
+        sos_to_f32(&sf2, &sd);
+        ok = ok && sf.n_sections == sd.n_sections;
+        for (int i = 0; i < N; i++) {
+            xf[i] = (float)(sin(0.05 * i) + 0.5 * sin(1.7 * i));
+            xd[i] = xf[i];
+        }
+        sos_process_block(&sd, xd, yd, N);
+        sos_process_block_f32(&sf, xf, yf, N / 2);          /* two calls:   */
+        sos_process_block_f32(&sf, xf + N / 2, yf + N / 2, N / 2); /* state kept */
+        for (int i = 0; i < N; i++)
+            ys[i] = sos_process_sample_f32(&sf2, xf[i]);
+        ok = ok && rel_err_r(yf, yd, N) < 1e-4 &&
+             memcmp(yf, ys, sizeof(yf)) == 0;
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("float SOS disagrees"); }
+    }
+
+    TEST_CASE_BEGIN("OLA/OLS float match direct FIR");
+    {
+        enum { N = 1024, M = 33, L = 128 };
+        double xd[N], yd[N], hd[M];
+        float  xf[N], hf[M], ya[N], yo[N];
+        for (int i = 0; i < N; i++) {
+            xf[i] = (float)(sin(0.03 * i) + 0.25 * cos(2.2 * i));
+            xd[i] = xf[i];
+        }
+        for (int k = 0; k < M; k++) {
+            hf[k] = (float)(sin(0.2 * (k - 16) + 1e-9) / (0.2 * (k - 16) + 1e-9) / 6.0);
+            hd[k] = hf[k];
+        }
+        fir_filter(xd, yd, N, hd, M);
+
+        OlaStateF ola;
+        OlsStateF ols;
+        int ok = ola_init_f32(&ola, hf, M, L) == 0 &&
+                 ols_init_f32(&ols, hf, M, L) == 0;
+        for (int b = 0; ok && b < N / L; b++) {
+            ola_process_f32(&ola, xf + b * L, ya + b * L);
+            ols_process_f32(&ols, xf + b * L, yo + b * L);
+        }
+        ok = ok && rel_err_r(ya, yd, N) < 1e-5 && rel_err_r(yo, yd, N) < 1e-5;
+        ola_free_f32(&ola);
+        ols_free_f32(&ols);
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("float OLA/OLS disagree with direct FIR"); }
+    }
+
+    TEST_CASE_BEGIN("welch_psd_f32 matches welch_psd");
+    {
+        enum { N = 8192, NFFT = 512 };
+        double *xd = (double *)malloc(N * sizeof(double));
+        float  *xf = (float *)malloc(N * sizeof(float));
+        double pd[NFFT / 2 + 1];
+        float  pf[NFFT / 2 + 1];
+        for (int i = 0; i < N; i++) {
+            xf[i] = (float)(sin(2.0 * M_PI * 0.1 * i) + 0.01 * sin(1.3 * i * i));
+            xd[i] = xf[i];
+        }
+        int sd = welch_psd(xd, N, pd, NFFT, 256, 128, hann_window);
+        int sf = welch_psd_f32(xf, N, pf, NFFT, 256, 128, hann_window);
+        int ok = sd > 0 && sd == sf && rel_err_r(pf, pd, NFFT / 2 + 1) < 1e-5 &&
+                 welch_psd_f32(xf, 100, pf, NFFT, 256, 128, NULL) == -1;
+        free(xd);
+        free(xf);
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("float Welch PSD disagrees with double"); }
+    }
+
+    TEST_CASE_BEGIN("Float ring buffer write/read/peek/skip and wrap");
+    {
+        RingBufferF *rb = ring_buffer_create_f32(6);
+        float in[7] = { 1, 2, 3, 4, 5, 6, 7 }, out[7] = { 0 };
+        int ok = rb && rb->cap == 8 &&
+                 ring_buffer_write_f32(rb, in, 7) == 7 &&
+                 ring_buffer_space_f32(rb) == 0 &&
+                 ring_buffer_peek_f32(rb, out, 2) == 2 && out[1] == 2.0f &&
+                 ring_buffer_skip_f32(rb, 3) == 3 &&
+                 ring_buffer_write_f32(rb, in, 3) == 3 &&       /* wraps */
+                 ring_buffer_available_f32(rb) == 7 &&
+                 ring_buffer_read_f32(rb, out, 7) == 7;
+        static const float want[7] = { 4, 5, 6, 7, 1, 2, 3 };
+        ok = ok && memcmp(out, want, sizeof(want)) == 0 &&
+             ring_buffer_available_f32(rb) == 0;
+        if (rb) ring_buffer_reset_f32(rb);
+        ring_buffer_destroy_f32(rb);
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("float ring buffer misbehaves"); }
+    }
+
+    fft_plan_cache_clear_f32();
+
+    /* ── Summary ──────────────────────────────────────────── */
+    printf("\n  ────────────────────────────\n");
+    printf("  Results: %d/%d passed", test_passed, test_count);
+    if (test_failed > 0)
+        printf(", %d FAILED", test_failed);
+    printf("\n\n");
+
+    return test_failed > 0 ? 1 : 0;
+}
@@ -7,7 +7,10 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <math.h>
+#include <string.h>
+#include <pthread.h>
 #include "test_framework.h"
 #include "fft.h"
 #include "dsp_utils.h"
@@ -16,6 +19,25 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+/* Test 17 worker: repeat cached-plan transforms, count wrong results */
+static const int reentrant_sizes[] = {360, 1050, 3001};   /* stack, mixed, Bluestein */
+static Complex *reentrant_ref[3];
+
+static void *fft_reentrant_worker(void *arg) {
+    int *bad = (int *)arg;
+    for (int it = 0; it < 200; it++) {
+        int si = it % 3, n = reentrant_sizes[si];
+        Complex *x = (Complex *)malloc((size_t)n * sizeof(Complex));
+        if (!x) { (*bad)++; continue; }
+        for (int i = 0; i < n; i++) { x[i].re = sin(0.01 * i * i); x[i].im = 0.0; }
+        fft(x, n);
+        if (memcmp(x, reentrant_ref[si], (size_t)n * sizeof(Complex)) != 0)
+            (*bad)++;
+        free(x);
+    }
+    return NULL;
+}
+
 int main() {
     TEST_SUITE("FFT Functions");
 
@@ -127,6 +149,340 @@ int main() {
         else    { TEST_FAIL_STMT("fft_real should match manual conversion"); }
     }
 
+    /* ── Test 7: plan matches textbook radix-2 at large N ──── */
+    TEST_CASE_BEGIN("fft_execute matches fft_radix2 (N=4096)");
+    {
+        int n = 4096;
+        FftPlan *p = fft_plan_create(n);
+        Complex *a = (Complex *)malloc((size_t)n * sizeof(Complex));
+        Complex *b = (Complex *)malloc((size_t)n * sizeof(Complex));
+        for (int i = 0; i < n; i++) {
+            a[i].re = sin(0.37 * i) + 0.25 * cos(1.9 * i);
+            a[i].im = cos(0.11 * i);
+            b[i] = a[i];
+        }
+        fft_execute(p, a);
+        fft_radix2(b, n);
+
+        double max_err = 0.0;
+        for (int i = 0; i < n; i++) {
+            double e = complex_mag(complex_sub(a[i], b[i]));
+            if (e > max_err) max_err = e;
+        }
+        free(a); free(b);
+        fft_plan_destroy(p);
+        if (p && max_err < 1e-8) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("plan output differs from radix-2 reference"); }
+    }
+
+    /* ── Test 8: plan round-trip ─────────────────────────────── */
+    TEST_CASE_BEGIN("fft_execute → ifft_execute round-trip");
+    {
+        int n = 1024;
+        const FftPlan *p = fft_plan_cached(n);
+        Complex *x = (Complex *)malloc((size_t)n * sizeof(Complex));
+        for (int i = 0; i < n; i++) { x[i].re = (double)(i % 7) - 3.0; x[i].im = 0.5 * (i % 3); }
+        fft_execute(p, x);
+        ifft_execute(p, x);
+        double max_err = 0.0;
+        for (int i = 0; i < n; i++) {
+            double e = fabs(x[i].re - ((double)(i % 7) - 3.0)) + fabs(x[i].im - 0.5 * (i % 3));
+            if (e > max_err) max_err = e;
+        }
+        free(x);
+        if (max_err < 1e-12) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("round-trip error too large"); }
+    }
+
+    /* ── Test 9: cache hands out one plan per size ───────────── */
+    TEST_CASE_BEGIN("fft_plan_cached reuses plans, rejects bad sizes");
+    {
+        const FftPlan *p1 = fft_plan_cached(256);
+        const FftPlan *p2 = fft_plan_cached(256);
+        const FftPlan *p3 = fft_plan_cached(100);
+        int ok = p1 && p1 == p2 && p1->n == 256 && p1->log2n == 8;
+        ok = ok && p3 && p3 == fft_plan_cached(100) && p3->log2n == -1;
+        ok = ok && fft_plan_cached(0) == NULL && fft_plan_create(0) == NULL;
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("plan cache misbehaved"); }
+    }
+
+    /* ── Test 10: radix-4 engine at odd and even log2(N) ────── */
+    TEST_CASE_BEGIN("fft_execute matches fft_radix2 for N = 2 .. 16384");
+    {
+        double max_err = 0.0;
+        for (int n = 2; n <= 16384; n <<= 1) {
+            Complex *a = (Complex *)malloc((size_t)n * sizeof(Complex));
+            Complex *b = (Complex *)malloc((size_t)n * sizeof(Complex));
+            for (int i = 0; i < n; i++) {
+                a[i].re = cos(0.11 * i) + 0.01 * (i % 17);
+                a[i].im = sin(0.07 * i * i / (double)n);
+                b[i] = a[i];
+            }
+            fft_radix2(a, n);
+            fft_execute(fft_plan_cached(n), b);
+            for (int k = 0; k < n; k++) {
+                double e = (fabs(a[k].re - b[k].re) + fabs(a[k].im - b[k].im)) / sqrt((double)n);
+                if (e > max_err) max_err = e;
+            }
+            free(a); free(b);
+        }
+        if (max_err < 1e-10) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("radix-4 engine differs from reference"); }
+    }
+
+    /* ── Test 11: rfft matches the full complex FFT ─────────── */
+    TEST_CASE_BEGIN("rfft matches fft_radix2 half spectrum (N = 2 .. 2048)");
+    {
+        double max_err = 0.0;
+        for (int n = 2; n <= 2048; n <<= 1) {
+            double  *x   = (double *)malloc((size_t)n * sizeof(double));
+            Complex *ref = (Complex *)malloc((size_t)n * sizeof(Complex));
+            Complex *out = (Complex *)malloc((size_t)(n / 2 + 1) * sizeof(Complex));
+            for (int i = 0; i < n; i++) {
+                x[i] = sin(0.37 * i) + 0.25 * ((i * 13) % 5);
+                ref[i].re = x[i];
+                ref[i].im = 0.0;
+            }
+            fft_radix2(ref, n);
+            rfft(x, out, n);
+            for (int k = 0; k <= n / 2; k++) {
+                double e = fabs(out[k].re - ref[k].re) + fabs(out[k].im - ref[k].im);
+                if (e > max_err) max_err = e;
+            }
+            free(x); free(ref); free(out);
+        }
+        if (max_err < 1e-9) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("rfft differs from complex FFT"); }
+    }
+
+    /* ── Test 12: irfft inverts rfft ─────────────────────────── */
+    TEST_CASE_BEGIN("rfft → irfft round-trip");
+    {
+        int n = 1024;
+        const RfftPlan *p = rfft_plan_cached(n);
+        double  *x = (double *)malloc((size_t)n * sizeof(double));
+        double  *y = (double *)malloc((size_t)n * sizeof(double));
+        Complex *X = (Complex *)malloc((size_t)(n / 2 + 1) * sizeof(Complex));
+        for (int i = 0; i < n; i++) x[i] = (double)(i % 11) - 5.0 + 0.1 * cos(0.01 * i);
+        rfft_execute(p, x, X);
+        irfft_execute(p, X, y);
+        double max_err = 0.0;
+        for (int i = 0; i < n; i++)
+            if (fabs(y[i] - x[i]) > max_err) max_err = fabs(y[i] - x[i]);
+        int ok = p && p == rfft_plan_cached(n) && rfft_plan_cached(7) == NULL;
+        free(x); free(y); free(X);
+        if (ok && max_err < 1e-12) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("irfft round-trip error too large"); }
+    }
+
+    /* ── Test 13: mixed-radix and Bluestein against a direct DFT ─ */
+    TEST_CASE_BEGIN("fft matches direct DFT for non-power-of-2 sizes");
+    {
+        /* 7-smooth: 3, 5, 6, 7, 12, 15, 60, 105, 210, 1000, 1029;
+           Bluestein: 11, 13, 97, 1025 (5²·41) */
+        static const int sizes[] = { 3, 5, 6, 7, 12, 15, 60, 105, 210, 1000,
+                                     1029, 11, 13, 97, 1025 };
+        double max_err = 0.0;
+        for (size_t t = 0; t < sizeof(sizes) / sizeof(sizes[0]); t++) {
+            int n = sizes[t];
+            Complex *x = (Complex *)malloc((size_t)n * sizeof(Complex));
+            Complex *X = (Complex *)malloc((size_t)n * sizeof(Complex));
+            for (int i = 0; i < n; i++) {
+                x[i].re = sin(0.3 * i) + 0.1 * (i % 4);
+                x[i].im = cos(0.17 * i * i / (double)n);
+                X[i] = x[i];
+            }
+            fft(X, n);
+            for (int k = 0; k < n; k++) {
+                double sr = 0.0, si = 0.0;
+                for (int i = 0; i < n; i++) {
+                    long long ki = ((long long)k * i) % n;
+                    double a = -2.0 * M_PI * (double)ki / (double)n;
+                    sr += x[i].re * cos(a) - x[i].im * sin(a);
+                    si += x[i].re * sin(a) + x[i].im * cos(a);
+                }
+                double e = (fabs(X[k].re - sr) + fabs(X[k].im - si)) / sqrt((double)n);
+                if (e > max_err) max_err = e;
+            }
+            ifft(X, n);
+            for (int i = 0; i < n; i++) {
+                double e = fabs(X[i].re - x[i].re) + fabs(X[i].im - x[i].im);
+                if (e > max_err) max_err = e;
+            }
+            free(x); free(X);
+        }
+        if (max_err < 1e-10) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("non-power-of-2 FFT differs from DFT"); }
+    }
+
+    /* ── Test 14: fast lengths and even-size rfft ────────────── */
+    TEST_CASE_BEGIN("fft_fast_length and rfft at N = 1030");
+    {
+        int ok = fft_fast_length(1025) == 1029 && fft_fast_length(48000) == 48000 &&
+                 fft_fast_length(11) == 12 && fft_fast_length(1) == 1 &&
+                 rfft_fast_length(1025) == 1050 && rfft_fast_length(1) == 2;
+
+        int n = 1030;   /* half length 515 = 5·103 → Bluestein inside rfft */
+        double  *x = (double *)malloc((size_t)n * sizeof(double));
+        double  *y = (double *)malloc((size_t)n * sizeof(double));
+        Complex *X = (Complex *)malloc((size_t)(n / 2 + 1) * sizeof(Complex));
+        Complex *R = (Complex *)malloc((size_t)n * sizeof(Complex));
+        for (int i = 0; i < n; i++) {
+            x[i] = cos(0.05 * i) + 0.3 * ((i * 7) % 3);
+            R[i].re = x[i];
+            R[i].im = 0.0;
+        }
+        rfft(x, X, n);
+        fft(R, n);
+        double max_err = 0.0;
+        for (int k = 0; k <= n / 2; k++) {
+            double e = fabs(X[k].re - R[k].re) + fabs(X[k].im - R[k].im);
+            if (e > max_err) max_err = e;
+        }
+        irfft(X, y, n);
+        for (int i = 0; i < n; i++)
+            if (fabs(y[i] - x[i]) > max_err) max_err = fabs(y[i] - x[i]);
+        free(x); free(y); free(X); free(R);
+        if (ok && max_err < 1e-9) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("fast length or even rfft wrong"); }
+    }
+
+    /* ── Test 15: split-plane FFT matches interleaved FFT ────── */
+    TEST_CASE_BEGIN("fft_split matches fft (bit-exact for powers of 2)");
+    {
+        static const int sizes[] = {1, 2, 8, 64, 512, 4096, 60, 97};
+        int ok = 1;
+        for (int si = 0; si < 8 && ok; si++) {
+            int n = sizes[si];
+            SplitComplex *s = split_complex_create(n);
+            Complex *x = (Complex *)malloc((size_t)n * sizeof(Complex));
+            for (int i = 0; i < n; i++) {
+                x[i].re = sin(0.3 * i) + 0.01 * i;
+                x[i].im = cos(0.7 * i) - 0.5;
+            }
+            complex_to_split(x, s->re, s->im, n);
+            fft(x, n);
+            ok = fft_split(s->re, s->im, n) == 0;
+            for (int k = 0; k < n && ok; k++) {
+                if (n & (n - 1))   /* mixed radix / Bluestein: via copy */
+                    ok = fabs(s->re[k] - x[k].re) < 1e-9 && fabs(s->im[k] - x[k].im) < 1e-9;
+                else
+                    ok = s->re[k] == x[k].re && s->im[k] == x[k].im;
+            }
+            /* Round trip back to the input */
+            ifft(x, n);
+            ok = ok && ifft_split(s->re, s->im, n) == 0;
+            for (int i = 0; i < n && ok; i++)
+                ok = fabs(s->re[i] - (sin(0.3 * i) + 0.01 * i)) < 1e-9 &&
+                     fabs(s->im[i] - (cos(0.7 * i) - 0.5)) < 1e-9;
+            free(x);
+            split_complex_destroy(s);
+        }
+        ok = ok && split_complex_create(0) == NULL;
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("split FFT differs from interleaved FFT"); }
+    }
+
+    /* ── Test 16: batched transforms (howmany / stride / dist) ─ */
+    TEST_CASE_BEGIN("fft_execute_many matches one-at-a-time transforms");
+    {
+        /* 11 transforms interleaved channel-wise: stride 11, dist 1
+         * (one full block of 8 plus a partial block of 3) */
+        static const int sizes[] = {64, 128, 12};
+        int H = 11, ok = 1;
+        for (int si = 0; si < 3 && ok; si++) {
+            int n = sizes[si];
+            const FftPlan *p = fft_plan_cached(n);
+            Complex *x   = (Complex *)malloc((size_t)n * H * sizeof(Complex));
+            Complex *ref = (Complex *)malloc((size_t)n * H * sizeof(Complex));
+            double  *re  = (double *)malloc((size_t)n * H * sizeof(double));
+            double  *im  = (double *)malloc((size_t)n * H * sizeof(double));
+            for (int i = 0; i < n * H; i++) {
+                x[i].re = sin(0.13 * i) + (i % 5);
+                x[i].im = cos(0.29 * i);
+            }
+            complex_to_split(x, re, im, n * H);
+
+            /* Reference: transform j is column j of an n×H matrix */
+            for (int j = 0; j < H; j++) {
+                Complex col[128];
+                for (int i = 0; i < n; i++) col[i] = x[i * H + j];
+                fft_execute(p, col);
+                for (int i = 0; i < n; i++) ref[i * H + j] = col[i];
+            }
+            ok = fft_execute_many(p, x, H, H, 1) == 0 &&
+                 fft_execute_many_split(p, re, im, H, H, 1) == 0;
+            for (int i = 0; i < n * H && ok; i++) {
+                if (n & (n - 1))
+                    ok = fabs(x[i].re - ref[i].re) < 1e-12 && fabs(x[i].im - ref[i].im) < 1e-12;
+                else
+                    ok = x[i].re == ref[i].re && x[i].im == ref[i].im &&
+                         re[i] == ref[i].re && im[i] == ref[i].im;
+            }
+
+            /* Contiguous inverse (stride 1, dist n) undoes it row by row */
+            for (int j = 0; j < H; j++)
+                for (int i = 0; i < n; i++)
+                    x[j * n + i] = ref[i * H + j];
+            ok = ok && ifft_execute_many(p, x, H, 1, n) == 0;
+            for (int j = 0; j < H && ok; j++)
+                for (int i = 0; i < n && ok; i++) {
+                    int at = i * H + j;
+                    ok = fabs(x[j * n + i].re - (sin(0.13 * at) + (at % 5))) < 1e-9 &&
+                         fabs(x[j * n + i].im - cos(0.29 * at)) < 1e-9;
+                }
+            free(x); free(ref); free(re); free(im);
+        }
+
+        /* Batched real transforms against rfft_execute() */
+        int n = 256, nb = n / 2 + 1, H2 = 5;
+        const RfftPlan *rp = rfft_plan_cached(n);
+        double  *in  = (double *)malloc((size_t)n * H2 * sizeof(double));
+        Complex *out = (Complex *)malloc((size_t)nb * H2 * sizeof(Complex));
+        Complex *one = (Complex *)malloc((size_t)nb * sizeof(Complex));
+        for (int i = 0; i < n * H2; i++) in[i] = sin(0.021 * i * i);
+        ok = ok && rfft_execute_many(rp, in, n, out, nb, H2) == 0;
+        for (int j = 0; j < H2 && ok; j++) {
+            rfft_execute(rp, in + j * n, one);
+            ok = memcmp(one, out + j * nb, (size_t)nb * sizeof(Complex)) == 0;
+        }
+        ok = ok && rfft_execute_many(rp, in, n - 1, out, nb, H2) == -1;
+        free(in); free(out); free(one);
+
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("batched FFT differs from single transforms"); }
+    }
+
+    /* ── Test 17: shared plans run on two threads at once ────── */
+    TEST_CASE_BEGIN("fft is reentrant at non-power-of-2 sizes");
+    {
+        int ok;
+        for (int si = 0; si < 3; si++) {
+            int n = reentrant_sizes[si];
+            reentrant_ref[si] = (Complex *)malloc((size_t)n * sizeof(Complex));
+            for (int i = 0; i < n; i++) {
+                reentrant_ref[si][i].re = sin(0.01 * i * i);
+                reentrant_ref[si][i].im = 0.0;
+            }
+            fft(reentrant_ref[si], n);
+        }
+        int bad[2] = {0, 0};
+        pthread_t t[2];
+        int started = 0;
+        while (started < 2 &&
+               pthread_create(&t[started], NULL, fft_reentrant_worker, &bad[started]) == 0)
+            started++;
+        for (int i = 0; i < started; i++)
+            pthread_join(t[i], NULL);
+        ok = started == 2 && bad[0] == 0 && bad[1] == 0;
+        for (int si = 0; si < 3; si++)
+            free(reentrant_ref[si]);
+
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("concurrent transforms corrupted each other"); }
+    }
+
     printf("\n=== Test Summary ===\n");
     printf("Total: %d, Passed: %d, Failed: %d\n",
            test_count, test_passed, test_failed);
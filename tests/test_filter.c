@@ -132,6 +132,90 @@ int main() {
         }
     }
 
+    /* ── Test 7: Streaming FIR matches one whole-buffer call ─── */
+    TEST_CASE_BEGIN("Streaming FIR in chunks matches fir_filter");
+    {
+        enum { N = 1000, T = 37 };
+        static const int chunks[] = { 1, 7, 36, 37, 200, 3, 64 };
+        double h[T], in[N], ref[N], out[N];
+        fir_lowpass(h, T, 0.15);
+        for (int i = 0; i < N; i++)
+            in[i] = sin(0.05 * i) + 0.4 * sin(2.3 * i) + 0.01 * (i % 11);
+        fir_filter(in, ref, N, h, T);
+
+        FirState fs;
+        int ok = fir_init(&fs, h, T) == 0;
+        for (int pass = 0; pass < 2 && ok; pass++) {
+            /* Second pass after fir_reset() must start from zero history */
+            int pos = 0, c = 0;
+            while (pos < N) {
+                int len = chunks[c++ % 7];
+                if (len > N - pos) len = N - pos;
+                fir_process_block(&fs, in + pos, out + pos, len);
+                pos += len;
+            }
+            for (int i = 0; i < N && ok; i++)
+                ok = out[i] == ref[i];
+            fir_reset(&fs);
+        }
+        /* In place, single-tap edge case */
+        double one[1] = { 2.0 }, buf[4] = { 1, 2, 3, 4 };
+        FirState fs1;
+        ok = ok && fir_init(&fs1, one, 1) == 0;
+        if (ok) {
+            fir_process_block(&fs1, buf, buf, 4);
+            ok = buf[0] == 2.0 && buf[3] == 8.0;
+            fir_free(&fs1);
+        }
+        ok = ok && fir_init(&fs1, one, 0) == -1;
+        fir_free(&fs);
+        if (ok) { TEST_PASS_STMT; }
+        else    { TEST_FAIL_STMT("Chunked FirState output differs from fir_filter"); }
+    }
+
+    /* ── Test 8: Folded linear-phase kernel, Types I–IV ──────── */
+    TEST_CASE_BEGIN("Symmetric FIR matches fir_filter for Types I-IV");
+    {
+        enum { N = 300 };
+        static const int orders[4] = { 21, 20, 21, 20 };
+        static const FirSymmetry syms[4] = {
+            FIR_SYM_EVEN, FIR_SYM_EVEN, FIR_SYM_ODD, FIR_SYM_ODD
+        };
+        double in[N], ref[N], out[N], h[21];
+        for (int i = 0; i < N; i++)
+            in[i] = sin(0.11 * i) + 0.5 * cos(1.7 * i);
+
+        int ok = 1;
+        for (int t = 0; t < 4 && ok; t++) {
+            int M = orders[t];
+            double sign = syms[t] == FIR_SYM_EVEN ? 1.0 : -1.0;
+            for (int k = 0; k < M; k++)
+                h[k] = 0.0;
+            for (int k = 0; k < M / 2; k++) {
+                h[k] = 0.1 * (k + 1) - 0.03 * k * k;
+                h[M - 1 - k] = sign * h[k];
+            }
+            if ((M & 1) && sign > 0)
+                h[M / 2] = 0.7;
+            ok = fir_symmetry(h, M) == syms[t];
+            fir_filter(in, ref, N, h, M);
+            fir_filter_symmetric(in, out, N, h, M, syms[t]);
+            for (int i = 0; i < N && ok; i++)
+                ok = fabs(out[i] - ref[i]) < 1e-12;
+        }
+        /* Designed filters qualify; asymmetric taps fall back */
+        double lp[31], asym[3] = { 1.0, 0.5, 0.25 };
+        fir_lowpass(lp, 31, 0.1);
+        ok = ok && fir_symmetry(lp, 31) == FIR_SYM_EVEN &&
+             fir_symmetry(asym, 3) == FIR_SYM_NONE;
+        fir_filter(in, ref, N, asym, 3);
+        fir_filter_symmetric(in, out, N, asym, 3, FIR_SYM_NONE);
+        for (int i = 0; i < N && ok; i++)
+            ok = out[i] == ref[i];
+        if (ok) { TEST_PASS_STMT; }
+        else    { TEST_FAIL_STMT("Folded kernel differs from fir_filter"); }
+    }
+
     printf("\n=== Test Summary ===\n");
     printf("Total: %d, Passed: %d, Failed: %d\n",
            test_count, test_passed, test_failed);
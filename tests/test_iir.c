@@ -13,6 +13,9 @@
  *   8. SOS cascade impulse response matches iir_filter expansion
  *   9. All designed filters are stable (poles inside unit circle)
  *  10. Group delay of symmetric FIR is constant
+ *  11. Block SOS engines (DF1, DF2T, multichannel SIMD) match per-sample
+ *  12. SOSChain: order > 16, arena allocation, banks, matches SOSCascade
+ *  13. Parallel and lattice forms match the cascade / direct form (chains past order 16)
  *
  * Run with: make test
  */
@@ -20,8 +23,10 @@
 #include <stdio.h>
 #include <math.h>
 #include <string.h>
+#include <stdlib.h>
 #include "test_framework.h"
 #include "iir.h"
+#include "simd.h"
 #include "dsp_utils.h"
 
 #ifndef M_PI
@@ -285,6 +290,230 @@ int main(void)
         else    { TEST_FAIL_STMT("Symmetric FIR should have τ ≈ (N-1)/2"); }
     }
 
+    /* ── Test 11: Block cascade engines ──────────────────────── */
+    TEST_CASE_BEGIN("Block SOS (DF1, DF2T, multichannel) match per-sample");
+    {
+        const int N = 1000, CMAX = 11;
+        SOSCascade sos;
+        butterworth_lowpass(8, 0.05, &sos);
+        double *x = (double *)malloc((size_t)N * CMAX * sizeof(double));
+        double *ref = (double *)malloc((size_t)N * CMAX * sizeof(double));
+        double *y = (double *)malloc((size_t)N * CMAX * sizeof(double));
+        for (int i = 0; i < N * CMAX; i++)
+            x[i] = sin(0.013 * i) + 0.3 * ((i * 37) % 17 - 8) / 8.0;
+
+        /* Reference: channel 0 sample by sample (DF1) */
+        for (int k = 0; k < sos.n_sections; k++) biquad_df1_init(&sos.states[k]);
+        for (int i = 0; i < N; i++) ref[i] = sos_process_sample(&sos, x[i]);
+        double peak = 0.0;
+        for (int i = 0; i < N; i++) if (fabs(ref[i]) > peak) peak = fabs(ref[i]);
+
+        /* DF1 block, uneven chunks: bit-identical */
+        int ok = 1;
+        for (int k = 0; k < sos.n_sections; k++) biquad_df1_init(&sos.states[k]);
+        for (int b = 0, len = 1; b < N; b += len, len = len * 2 + 1) {
+            if (b + len > N) len = N - b;
+            sos_process_block(&sos, x + b, y + b, len);
+        }
+        for (int i = 0; i < N && ok; i++) ok = y[i] == ref[i];
+
+        /* DF2T block, in place: same filter to rounding */
+        BiquadDF2TState st[MAX_SOS_SECTIONS * 11];
+        for (int k = 0; k < sos.n_sections; k++) biquad_df2t_init(&st[k]);
+        memcpy(y, x, (size_t)N * sizeof(double));
+        sos_process_block_df2t(&sos, st, y, y, 300);
+        sos_process_block_df2t(&sos, st, y + 300, y + 300, N - 300);
+        for (int i = 0; i < N && ok; i++) ok = fabs(y[i] - ref[i]) < 1e-12 * peak;
+
+        /* Multichannel: each channel equals the single-channel DF2T
+         * result exactly, for 4-, 8- and 8+3-lane groups at every level */
+        int chans[3] = { 4, 8, CMAX };
+        SimdLevel saved = simd_level();
+        for (int lvl = SIMD_SCALAR; lvl <= (int)simd_detect() && ok; lvl++) {
+            simd_set_level((SimdLevel)lvl);
+            for (int t = 0; t < 3 && ok; t++) {
+                int C = chans[t];
+                memset(st, 0, sizeof(st));
+                sos_process_multi(&sos, st, x, y, N / 2, C);
+                sos_process_multi(&sos, st, x + (size_t)(N / 2) * C,
+                                  y + (size_t)(N / 2) * C, N - N / 2, C);
+                for (int c = 0; c < C && ok; c++) {
+                    double chan[1000], one[1000];
+                    BiquadDF2TState s1[MAX_SOS_SECTIONS];
+                    memset(s1, 0, sizeof(s1));
+                    for (int i = 0; i < N; i++) chan[i] = x[(size_t)i * C + c];
+                    sos_process_block_df2t(&sos, s1, chan, one, N);
+                    for (int i = 0; i < N && ok; i++)
+                        ok = y[(size_t)i * C + c] == one[i];
+                }
+            }
+        }
+        simd_set_level(saved);
+
+        if (ok) { TEST_PASS_STMT; }
+        else    { TEST_FAIL_STMT("Block engines should reproduce sos_process_sample()"); }
+        free(x); free(ref); free(y);
+    }
+
+    /* ── Test 12: Variable-length chains ─────────────────────── */
+    TEST_CASE_BEGIN("SOSChain: high order, arena, bank, matches SOSCascade");
+    {
+        static unsigned char mem[1 << 17];
+        DspArena arena;
+        dsp_arena_init(&arena, mem, sizeof(mem));
+
+        /* Order 40 does not fit an SOSCascade but designs into a chain */
+        SOSCascade sos;
+        SOSChain *c = sos_chain_create(&arena, sos_chain_sections(40));
+        int ok = butterworth_lowpass(40, 0.1, &sos) == -1 && c &&
+                 butterworth_lowpass_chain(40, 0.1, c) == 0 &&
+                 c->n_sections == 20 &&
+                 butterworth_lowpass_chain(42, 0.1, c) == -1;
+        if (ok) {
+            double mag[129];
+            sos_chain_freq_response(c, mag, NULL, 129);
+            /* cutoff 0.1 → bin 0.1/0.5·128 = 25.6; order 40 is a brick wall */
+            ok = fabs(mag[0] - 1.0) < 1e-9 && mag[20] > 0.999 && mag[40] < 1e-6;
+        }
+
+        /* Order 8: same coefficients, same DF2T output as the cascade */
+        SOSChain *h = sos_chain_create(NULL, 4);
+        ok = ok && h && chebyshev1_lowpass(8, 0.5, 0.2, &sos) == 0 &&
+             chebyshev1_lowpass_chain(8, 0.5, 0.2, h) == 0 &&
+             h->gain == sos.gain;
+        for (int k = 0; ok && k < 4; k++)
+            ok = memcmp(&h->sections[k], &sos.sections[k], sizeof(Biquad)) == 0;
+        if (ok) {
+            double x[500], y1[500], y2[500];
+            BiquadDF2TState st[MAX_SOS_SECTIONS];
+            memset(st, 0, sizeof(st));
+            for (int i = 0; i < 500; i++) x[i] = sin(0.07 * i) + ((i * 5) % 7 - 3) * 0.1;
+            sos_process_block_df2t(&sos, st, x, y1, 500);
+            sos_chain_process(h, x, y2, 250);
+            sos_chain_process(h, x + 250, y2 + 250, 250);
+            ok = memcmp(y1, y2, sizeof(y1)) == 0;
+        }
+        sos_chain_destroy(h);
+
+        /* Bank of 1000 2nd-order chains: one compact block */
+        int caps[1000];
+        for (int f = 0; f < 1000; f++) caps[f] = 1;
+        dsp_arena_reset(&arena);
+        SOSBank *bank = sos_bank_create(&arena, caps, 1000);
+        ok = ok && bank && arena.used < 1000 * (sizeof(SOSChain) + sizeof(Biquad) +
+                                                sizeof(BiquadDF2TState)) + 64;
+        ok = ok && butterworth_highpass_chain(2, 0.05 + 0.0004 * 999,
+                                              &bank->chains[999]) == 0 &&
+             bank->chains[999].n_sections == 1 && bank->chains[998].n_sections == 0;
+        ok = ok && sos_bank_create(&arena, caps, 1000) == NULL;   /* full */
+
+        if (ok) { TEST_PASS_STMT; }
+        else    { TEST_FAIL_STMT("SOSChain should lift the section limit and match SOSCascade"); }
+    }
+
+    /* ── Test 13: Parallel and lattice realizations ───────────── */
+    TEST_CASE_BEGIN("Parallel and lattice forms match cascade / direct form");
+    {
+        double x[600], y_ref[600], y[600];
+        for (int i = 0; i < 600; i++) x[i] = sin(0.05 * i) + ((i * 7) % 11 - 5) * 0.08;
+
+        /* From a cascade: Chebyshev order 8, blocks of 250 + 350 */
+        SOSCascade sos;
+        BiquadDF2TState st[MAX_SOS_SECTIONS];
+        memset(st, 0, sizeof(st));
+        int ok = chebyshev1_lowpass(8, 0.5, 0.2, &sos) == 0;
+        sos_process_block_df2t(&sos, st, x, y_ref, 600);
+
+        IIRParallel *par = iir_parallel_from_sos(&sos);
+        IIRLattice *lat = iir_lattice_from_sos(&sos);
+        ok = ok && par && lat && par->n_sections == 4 && par->n_fir == 1;
+        double err_p = 0.0, err_l = 0.0;
+        if (ok) {
+            iir_parallel_process(par, x, y, 250);
+            iir_parallel_process(par, x + 250, y + 250, 350);
+            for (int i = 0; i < 600; i++) err_p = fmax(err_p, fabs(y[i] - y_ref[i]));
+            iir_lattice_process(lat, x, y, 250);
+            iir_lattice_process(lat, x + 250, y + 250, 350);
+            for (int i = 0; i < 600; i++) err_l = fmax(err_l, fabs(y[i] - y_ref[i]));
+            for (int m = 0; m < lat->order; m++) ok = ok && fabs(lat->k[m]) < 1.0;
+        }
+        ok = ok && err_p < 1e-10 && err_l < 1e-10;
+
+        /* From (b, a) with deg B > deg A: direct terms with history */
+        const double b[] = { 0.2, 0.1, -0.3, 0.25, 0.05, 0.1 };
+        const double a[] = { 2.0, -1.2, 0.9, -0.3, 0.08 };
+        iir_filter(b, 6, a, 5, x, y_ref, 600);
+        IIRParallel *pba = iir_parallel_create(b, 6, a, 5);
+        IIRLattice *lba = iir_lattice_create(b, 6, a, 5);
+        ok = ok && pba && lba && pba->n_fir == 2 && pba->n_sections == 2;
+        if (ok) {
+            double e1 = 0.0, e2 = 0.0;
+            iir_parallel_process(pba, x, y, 1);
+            iir_parallel_process(pba, x + 1, y + 1, 599);
+            for (int i = 0; i < 600; i++) e1 = fmax(e1, fabs(y[i] - y_ref[i]));
+            iir_lattice_process(lba, x, y, 600);
+            for (int i = 0; i < 600; i++) e2 = fmax(e2, fabs(y[i] - y_ref[i]));
+            ok = e1 < 1e-12 && e2 < 1e-12;
+        }
+
+        /* Poles outside the unit circle: no stable lattice */
+        const double bad[] = { 1.0, 0.0, 1.21 };
+        ok = ok && iir_lattice_create(b, 1, bad, 3) == NULL;
+
+        /* Sections in SIMD lanes: same bits at every level */
+        IIRParallel *p16 = NULL;
+        if (ok && butterworth_lowpass(16, 0.05, &sos) == 0 &&
+            (p16 = iir_parallel_from_sos(&sos)) != NULL) {
+            SimdLevel saved = simd_level();
+            simd_set_level(SIMD_SCALAR);
+            iir_parallel_process(p16, x, y_ref, 600);
+            for (int lv = SIMD_SSE2; lv <= (int)simd_detect(); lv++) {
+                simd_set_level((SimdLevel)lv);
+                iir_parallel_reset(p16);
+                iir_parallel_process(p16, x, y, 600);
+                ok = ok && memcmp(y, y_ref, sizeof(y)) == 0;
+            }
+            simd_set_level(saved);
+        } else {
+            ok = 0;
+        }
+
+        /* Past order 16 from a chain; sizes beyond order 64 refused */
+        SOSChain *ch = sos_chain_create(NULL, sos_chain_sections(66));
+        IIRParallel *pch = NULL;
+        IIRLattice *lch = NULL;
+        ok = ok && ch && chebyshev1_lowpass_chain(24, 0.5, 0.2, ch) == 0 &&
+             (pch = iir_parallel_from_chain(ch)) != NULL &&
+             (lch = iir_lattice_from_chain(ch)) != NULL && pch->n_sections == 12;
+        if (ok) {
+            double e1 = 0.0, e2 = 0.0;
+            sos_chain_process(ch, x, y_ref, 600);
+            iir_parallel_process(pch, x, y, 600);
+            for (int i = 0; i < 600; i++) e1 = fmax(e1, fabs(y[i] - y_ref[i]));
+            iir_lattice_process(lch, x, y, 600);
+            for (int i = 0; i < 600; i++) e2 = fmax(e2, fabs(y[i] - y_ref[i]));
+            ok = e1 < 1e-10 && e2 < 1e-8;
+        }
+        /* 12 close Butterworth pole pairs: distinct, not "repeated" */
+        iir_parallel_destroy(pch);
+        pch = NULL;
+        ok = ok && butterworth_lowpass_chain(24, 0.05, ch) == 0 &&
+             (pch = iir_parallel_from_chain(ch)) != NULL;
+        ok = ok && butterworth_lowpass_chain(66, 0.2, ch) == 0 &&
+             iir_parallel_from_chain(ch) == NULL && iir_lattice_from_chain(ch) == NULL;
+        iir_parallel_destroy(pch);
+        iir_lattice_destroy(lch);
+        sos_chain_destroy(ch);
+
+        iir_parallel_destroy(par);
+        iir_parallel_destroy(pba);
+        iir_parallel_destroy(p16);
+        iir_lattice_destroy(lat);
+        iir_lattice_destroy(lba);
+        if (ok) { TEST_PASS_STMT; }
+        else    { TEST_FAIL_STMT("Parallel / lattice output should match the reference structures"); }
+    }
+
     printf("\n=== Test Summary ===\n");
     printf("Total: %d, Passed: %d, Failed: %d\n",
            test_count, test_passed, test_failed);
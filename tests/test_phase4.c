@@ -15,6 +15,12 @@
  *   10. Sliding DFT tracks frequency
  *   11. OLA matches direct convolution
  *   12. OLS matches direct convolution
+ *   13. convolve()/fir_filter() method selection: all paths agree
+ *   14. UPOLS matches direct FIR for a filter much longer than the block
+ *   15. Non-uniform partitions match direct FIR
+ *   16. Multichannel OLA/OLS (planar + interleaved, odd C) match direct FIR
+ *   17. Automatic OLA/OLS block size; OLS input ring across many wraps
+ *   18. OLA/OLS hot filter swap: one-block crossfade, then the new filter
  *
  * Run: make test
  */
@@ -27,6 +33,7 @@
 #include "fixed_point.h"
 #include "advanced_fft.h"
 #include "streaming.h"
+#include "convolution.h"
 #include "fft.h"
 #include "filter.h"
 #include "dsp_utils.h"
@@ -286,6 +293,275 @@ int main(void)
         free(x); free(y_ref); free(y_ols);
     }
 
+    /* ── Test 13: Direct / OLA / OLS / auto convolution agree ── */
+    TEST_CASE_BEGIN("convolve() methods agree, auto picks FFT for long filters");
+    {
+        const int N = 20000, taps = 257;
+        double *h = (double *)malloc((size_t)taps * sizeof(double));
+        double *x = (double *)malloc((size_t)N * sizeof(double));
+        double *y_ref = (double *)malloc((size_t)(N + taps - 1) * sizeof(double));
+        double *y = (double *)malloc((size_t)(N + taps - 1) * sizeof(double));
+        fir_lowpass(h, taps, 0.1);
+        gen_sine(x, N, 1.0, 300.0, 8000.0, 0.0);
+        for (int i = 0; i < N; i++)
+            x[i] += 0.1 * ((i * 7) % 13 - 6);
+
+        int ok = convolve_method(x, N, h, taps, y_ref, CONV_DIRECT) == N + taps - 1;
+        static const ConvMethod methods[3] = { CONV_OLA, CONV_OLS, CONV_AUTO };
+        for (int m = 0; m < 3 && ok; m++) {
+            ok = convolve_method(x, N, h, taps, y, methods[m]) == N + taps - 1;
+            for (int i = 0; i < N + taps - 1 && ok; i++)
+                ok = fabs(y[i] - y_ref[i]) < 1e-10;
+            /* Causal / FIR entry points return the first N samples */
+            convolve_causal_method(x, N, h, taps, y, methods[m]);
+            for (int i = 0; i < N && ok; i++)
+                ok = fabs(y[i] - y_ref[i]) < 1e-10;
+            fir_filter_method(x, y, N, h, taps, methods[m]);
+            for (int i = 0; i < N && ok; i++)
+                ok = fabs(y[i] - y_ref[i]) < 1e-10;
+        }
+        /* fir_filter() is the auto path: same bits as the method the
+         * size-only cost model names, on every call */
+        double *y_sel = (double *)malloc((size_t)N * sizeof(double));
+        fir_filter(x, y, N, h, taps);
+        fir_filter_method(x, y_sel, N, h, taps, conv_select_method(N, taps));
+        ok = ok && memcmp(y, y_sel, (size_t)N * sizeof(double)) == 0;
+        free(y_sel);
+        /* Short filters stay direct (bit-exact); 257 × 20000 and
+         * 4097 × 10M go FFT */
+        ok = ok && conv_select_method(N, 8) == CONV_DIRECT
+                && conv_select_method(64, taps) == CONV_DIRECT
+                && conv_select_method(N, taps) == CONV_OLS
+                && conv_select_method(10000000, 4097) == CONV_OLS;
+        /* Forced FFT on a tiny problem still gives the right answer */
+        double a[3] = { 1, 2, 3 }, b[2] = { 1, -1 }, c[4];
+        ok = ok && convolve_method(a, 3, b, 2, c, CONV_OLS) == 4
+                && fabs(c[0] - 1) < 1e-12 && fabs(c[1] - 1) < 1e-12
+                && fabs(c[2] - 1) < 1e-12 && fabs(c[3] + 3) < 1e-12;
+
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("FFT convolution paths should match direct to 1e-10"); }
+        free(h); free(x); free(y_ref); free(y);
+    }
+
+    /* ── Test 14: Uniformly partitioned convolution ───────── */
+    TEST_CASE_BEGIN("UPOLS matches direct FIR (M >> block)");
+    {
+        const int N = 8192, taps = 3001, blk = 64;
+        double *h = (double *)malloc((size_t)taps * sizeof(double));
+        double *x = (double *)malloc((size_t)N * sizeof(double));
+        double *y_ref = (double *)malloc((size_t)N * sizeof(double));
+        double *y = (double *)malloc((size_t)N * sizeof(double));
+        for (int k = 0; k < taps; k++)
+            h[k] = exp(-k / 600.0) * sin(0.37 * k);
+        gen_sine(x, N, 1.0, 300.0, 8000.0, 0.0);
+        for (int i = 0; i < N; i++)
+            x[i] += 0.1 * ((i * 7) % 13 - 6);
+        fir_filter_method(x, y_ref, N, h, taps, CONV_DIRECT);
+
+        UpolsState up;
+        int ok = upols_init(&up, h, taps, blk) == 0 && up.n_parts == 47;
+        for (int pass = 0; pass < 2 && ok; pass++) {
+            /* Block-size latency: output block b is y[b·B .. b·B+B−1];
+             * second pass after upols_reset(), in place */
+            memcpy(y, x, (size_t)N * sizeof(double));
+            for (int b = 0; b < N / blk; b++)
+                upols_process(&up, y + b * blk, y + b * blk);
+            for (int i = 0; i < N && ok; i++)
+                ok = fabs(y[i] - y_ref[i]) < 1e-10;
+            upols_reset(&up);
+        }
+        if (ok) upols_free(&up);
+        ok = ok && upols_init(&up, h, taps, 0) == -1;
+
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("UPOLS max error should be < 1e-10"); }
+        free(h); free(x); free(y_ref); free(y);
+    }
+
+    /* ── Test 15: Non-uniform partitions ─────────────────── */
+    TEST_CASE_BEGIN("Non-uniform partitioned convolution matches direct FIR");
+    {
+        const int N = 8192, taps = 3001, blk = 32;
+        double *h = (double *)malloc((size_t)taps * sizeof(double));
+        double *x = (double *)malloc((size_t)N * sizeof(double));
+        double *y_ref = (double *)malloc((size_t)N * sizeof(double));
+        double *y = (double *)malloc((size_t)N * sizeof(double));
+        for (int k = 0; k < taps; k++)
+            h[k] = exp(-k / 600.0) * cos(0.21 * k);
+        gen_sine(x, N, 1.0, 440.0, 8000.0, 0.3);
+        for (int i = 0; i < N; i++)
+            x[i] += 0.1 * ((i * 5) % 11 - 5);
+        fir_filter_method(x, y_ref, N, h, taps, CONV_DIRECT);
+
+        /* max_block 512: blocks 32, 128, 512 → 3 levels */
+        NupolsState nu;
+        int ok = nupols_init(&nu, h, taps, blk, 512) == 0 && nu.n_levels == 3;
+        for (int b = 0; b < N / blk && ok; b++)
+            nupols_process(&nu, x + b * blk, y + b * blk);
+        for (int i = 0; i < N && ok; i++)
+            ok = fabs(y[i] - y_ref[i]) < 1e-10;
+        if (ok) nupols_free(&nu);
+
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("Non-uniform partitions should match direct to 1e-10"); }
+        free(h); free(x); free(y_ref); free(y);
+    }
+
+    /* ── Test 16: Multichannel convolution, shared spectrum ─ */
+    TEST_CASE_BEGIN("Multichannel OLA/OLS match per-channel direct FIR");
+    {
+        enum { C = 5, T = 1024, BLK = 128, TAPS = 63 };
+        double h[TAPS];
+        fir_lowpass(h, TAPS, 0.2);
+        double *x = (double *)malloc((size_t)C * T * sizeof(double));
+        double *y_ref = (double *)malloc((size_t)C * T * sizeof(double));
+        double *buf = (double *)malloc((size_t)C * BLK * sizeof(double));
+        for (int c = 0; c < C; c++) {
+            gen_sine(x + c * T, T, 1.0, 200.0 + 350.0 * c, 8000.0, 0.1 * c);
+            fir_filter_method(x + c * T, y_ref + c * T, T, h, TAPS, CONV_DIRECT);
+        }
+
+        int ok = 1;
+        for (int mode = 0; mode < 4 && ok; mode++) {
+            ChannelLayout lay = (mode & 1) ? CHAN_INTERLEAVED : CHAN_PLANAR;
+            MultiConvState mc;
+            ok = multiconv_init(&mc, h, TAPS, BLK, C, lay, mode >> 1) == 0 &&
+                 mc.n_pairs == 3;
+            for (int b = 0; b < T / BLK && ok; b++) {
+                for (int c = 0; c < C; c++)
+                    for (int i = 0; i < BLK; i++)
+                        buf[lay == CHAN_PLANAR ? c * BLK + i : i * C + c] =
+                            x[c * T + b * BLK + i];
+                ok = multiconv_process(&mc, buf, buf) == 0;   /* in place */
+                for (int c = 0; c < C && ok; c++)
+                    for (int i = 0; i < BLK && ok; i++) {
+                        double v = buf[lay == CHAN_PLANAR ? c * BLK + i : i * C + c];
+                        ok = fabs(v - y_ref[c * T + b * BLK + i]) < 1e-10;
+                    }
+            }
+            if (ok) multiconv_free(&mc);
+        }
+
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("Multichannel output should match direct FIR to 1e-10"); }
+        free(x); free(y_ref); free(buf);
+    }
+
+    /* ── Test 17: Auto block size, long streams ─────────── */
+    TEST_CASE_BEGIN("OLA/OLS auto block size and long-stream OLS ring");
+    {
+        const int N = 20000, taps = 101;
+        double h[101];
+        fir_lowpass(h, taps, 0.2);
+        double *x = (double *)malloc((size_t)N * sizeof(double));
+        double *y_ref = (double *)malloc((size_t)N * sizeof(double));
+        double *y = (double *)malloc((size_t)N * sizeof(double));
+        gen_sine(x, N, 1.0, 700.0, 8000.0, 0.2);
+        for (int i = 0; i < N; i++)
+            x[i] += 0.05 * ((i * 11) % 9 - 4);
+        fir_filter_method(x, y_ref, N, h, taps, CONV_DIRECT);
+
+        /* 101 taps: N = 512 (1024 saves < 5%), L = 412 */
+        int ok = stream_block_size(taps) == 412 && stream_block_size(0) == -1;
+
+        OlaState ola;
+        OlsState ols;
+        ok = ok && ola_init(&ola, h, taps, 0) == 0 && ols_init(&ols, h, taps, 0) == 0;
+        ok = ok && ola.block_size == 412 && ols.block_size == 412 &&
+             ols.fft_size == 512;
+        int blk = ok ? ols.block_size : 1;
+        for (int b = 0; b + blk <= N && ok; b += blk) {
+            ola_process(&ola, x + b, y + b);
+            for (int i = b; i < b + blk && ok; i++)
+                ok = fabs(y[i] - y_ref[i]) < 1e-10;
+            ols_process(&ols, x + b, y + b);
+            for (int i = b; i < b + blk && ok; i++)
+                ok = fabs(y[i] - y_ref[i]) < 1e-10;
+        }
+        if (ok) { ola_free(&ola); ols_free(&ols); }
+
+        /* Small blocks with zero padding: the ring wraps ~every 14 blocks */
+        ok = ok && ols_init(&ols, h, 31, 16) == 0;
+        if (ok) {
+            fir_filter_method(x, y_ref, N, h, 31, CONV_DIRECT);
+            for (int b = 0; b + 16 <= N; b += 16)
+                ols_process(&ols, x + b, y + b);
+            for (int i = 0; i < N - N % 16 && ok; i++)
+                ok = fabs(y[i] - y_ref[i]) < 1e-10;
+            ols_free(&ols);
+        }
+
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("Auto block size / ring OLS should match direct FIR"); }
+        free(x); free(y_ref); free(y);
+    }
+
+    /* ── Test 18: Hot filter swap ───────────────────────── */
+    TEST_CASE_BEGIN("OLA/OLS filter swap crossfades over one block");
+    {
+        const int N = 2560, taps = 65, L = 64, swap = 640;
+        double h1[65], h2[65];
+        fir_lowpass(h1, taps, 0.1);
+        fir_lowpass(h2, taps, 0.3);
+        double *x = (double *)malloc((size_t)N * sizeof(double));
+        double *y1 = (double *)malloc((size_t)N * sizeof(double));
+        double *y2 = (double *)malloc((size_t)N * sizeof(double));
+        double *yo = (double *)malloc((size_t)N * sizeof(double));
+        double *tmp = (double *)malloc((size_t)N * sizeof(double));
+        double *y = (double *)malloc((size_t)N * sizeof(double));
+        gen_sine(x, N, 1.0, 900.0, 8000.0, 0.0);
+        for (int i = 0; i < N; i++)
+            x[i] += 0.1 * ((i * 7) % 13 - 6);
+        fir_filter_method(x, y1, N, h1, taps, CONV_DIRECT);
+        fir_filter_method(x, y2, N, h2, taps, CONV_DIRECT);
+
+        /* OLA model: inputs before the swap stay on h1, later ones use h2 */
+        memcpy(tmp, x, (size_t)N * sizeof(double));
+        memset(tmp + swap, 0, (size_t)(N - swap) * sizeof(double));
+        fir_filter_method(tmp, yo, N, h1, taps, CONV_DIRECT);
+        memset(tmp, 0, (size_t)swap * sizeof(double));
+        memcpy(tmp + swap, x + swap, (size_t)(N - swap) * sizeof(double));
+        fir_filter_method(tmp, y, N, h2, taps, CONV_DIRECT);
+        for (int i = 0; i < N; i++) yo[i] += y[i];
+
+        OlaState ola;
+        OlsState ols;
+        int ok = ola_init(&ola, h1, taps, L) == 0 && ols_init(&ols, h1, taps, L) == 0;
+        Complex *H2 = ok ? (Complex *)malloc((size_t)(ols.fft_size / 2 + 1) * sizeof(Complex)) : NULL;
+        ok = ok && H2 && stream_filter_spectrum(h2, taps, ols.fft_size, H2) == 0;
+        ok = ok && ols_set_filter(&ols, H2, taps + 1) == -1 && !ols.swap_pending;
+
+        for (int pass = 0; pass < 2 && ok; pass++) {
+            for (int b = 0; b < N; b += L) {
+                if (b == swap)
+                    ok = ok && (pass ? ols_set_filter(&ols, H2, taps)
+                                     : ola_set_filter(&ola, H2, taps)) == 0;
+                if (pass) ols_process(&ols, x + b, y + b);
+                else      ola_process(&ola, x + b, y + b);
+            }
+            /* Before: h1.  Swap block: sin² blend.  After: h2 (OLS) or
+             * the switched-input model (OLA). */
+            const double *after = pass ? y2 : yo;
+            for (int i = 0; i < N && ok; i++) {
+                double ref = y1[i];
+                if (i >= swap + L) {
+                    ref = after[i];
+                } else if (i >= swap) {
+                    double w = sin(M_PI * (i - swap + 0.5) / (2.0 * L));
+                    ref = y1[i] + w * w * (after[i] - y1[i]);
+                }
+                ok = fabs(y[i] - ref) < 1e-10;
+            }
+        }
+        ola_free(&ola);
+        ols_free(&ols);
+
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("Swap should crossfade h1 → h2 over one block"); }
+        free(x); free(y1); free(y2); free(yo); free(tmp); free(y); free(H2);
+    }
+
     printf("\n=== Test Summary ===\n");
     printf("Total: %d, Passed: %d, Failed: %d\n",
            test_count, test_passed, test_failed);
@@ -18,6 +18,11 @@
  *  13.  Remez lowpass passband gain ≈ 0 dB
  *  14.  Remez lowpass stopband attenuation
  *  15.  Remez bandpass passband gain ≈ 0 dB
+ *  16.  Streaming resamplers: polyphase L/M and arbitrary ratio
+ *  17.  Decimator/Interpolator objects match whole-buffer filtering
+ *  18.  Multistage decimation plan and cascade (M = 1000)
+ *  19.  Polyphase filter bank: channels, streaming, reconstruction
+ *  20.  Multistage decimation without a small divisor (M = 37, 143, 1009)
  *
  * Run: make test
  */
@@ -424,6 +429,318 @@ int main(void)
         free(h);
     }
 
+    /* ── Test 16: Streaming resamplers ───────────────────── */
+    TEST_CASE_BEGIN("Streaming polyphase and arbitrary-ratio resamplers");
+    {
+        int N = 4410;
+        double fs = 44100.0;
+        double *x  = (double *)calloc((size_t)N, sizeof(double));
+        double *y1 = (double *)calloc((size_t)(3 * N), sizeof(double));
+        double *y2 = (double *)calloc((size_t)(3 * N), sizeof(double));
+        gen_sine(x, N, 1.0, 1000.0, fs, 0.0);
+
+        /* resample() (now polyphase) = interpolate by 3, keep every 2nd */
+        int n1 = resample(x, N, 3, 2, y1);
+        interpolate(x, N, 3, y2);
+        double err = 0.0;
+        for (int i = 0; i < n1; i++)
+            err = fmax(err, fabs(y1[i] - y2[2 * i]));
+        int ok = n1 == (3 * N + 1) / 2 && err < 1e-12;
+
+        /* 44.1k → 48k in uneven chunks = one call, exact output counts */
+        ResamplerState rs;
+        ok = resampler_init(&rs, 48000, 44100, 24) == 0 && ok && rs.L == 160 && rs.M == 147;
+        int total = resampler_process(&rs, x, N, y1);
+        resampler_reset(&rs);
+        int got = 0;
+        for (int i = 0, k = 1; ok && i < N; i += k, k = k % 37 + 5) {
+            int len = (i + k > N) ? N - i : k;
+            int expect = resampler_max_output(&rs, len);
+            int n = resampler_process(&rs, x + i, len, y2 + got);
+            ok = n == expect;
+            got += n;
+        }
+        ok = ok && total == got && total == (N * 160 + 146) / 147 &&
+             memcmp(y1, y2, (size_t)total * sizeof(double)) == 0;
+
+        /* Output m is the sine at input time m·M/L − delay */
+        double delay = (24.0 * 160 - 2.0) / 2.0 / 160.0;
+        err = 0.0;
+        for (int m = 100; m < total - 100; m++) {
+            double t = m * 147.0 / 160.0 - delay;
+            err = fmax(err, fabs(y1[m] - sin(2.0 * M_PI * 1000.0 * t / fs)));
+        }
+        ok = ok && err < 1e-2;
+        resampler_free(&rs);
+
+        /* Arbitrary ratio: output m = x(m / ratio), no delay to undo */
+        FracResamplerState fr;
+        double ratio = 48000.0 / 44100.0 * (1.0 + 37e-6);   /* drifting clock */
+        ok = frac_resampler_init(&fr, ratio, 32) == 0 && ok;
+        int nf = frac_resampler_process(&fr, x, N / 2, y1);
+        nf += frac_resampler_process(&fr, x + N / 2, N - N / 2, y1 + nf);
+        err = 0.0;
+        for (int m = 50; m < nf - 50; m++)
+            err = fmax(err, fabs(y1[m] - sin(2.0 * M_PI * 1000.0 * (m / ratio) / fs)));
+        ok = ok && nf <= frac_resampler_max_output(&fr, N) && err < 1e-4;
+
+        /* Changing the ratio mid-stream changes the output rate */
+        frac_resampler_set_ratio(&fr, 0.5);
+        int nh = frac_resampler_process(&fr, x, 1000, y1);
+        ok = ok && nh >= 499 && nh <= 501;
+        frac_resampler_free(&fr);
+
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("Resampler output or streaming mismatch"); }
+        free(x); free(y1); free(y2);
+    }
+
+    /* ── Test 17: Decimator / Interpolator objects ───────── */
+    TEST_CASE_BEGIN("Decimator/Interpolator objects match whole-buffer filtering");
+    {
+        int N = 1000, M = 5, L = 3, taps = 41;
+        double *x   = (double *)malloc((size_t)N * sizeof(double));
+        double *ref = (double *)calloc((size_t)(N * L), sizeof(double));
+        double *up  = (double *)calloc((size_t)(N * L), sizeof(double));
+        double *y1  = (double *)calloc((size_t)(N * L), sizeof(double));
+        double *y2  = (double *)calloc((size_t)(N * L), sizeof(double));
+        double *h   = (double *)malloc((size_t)taps * sizeof(double));
+        int ok = 1;
+        for (int i = 0; i < N; i++)
+            x[i] = sin(0.031 * i) + 0.5 * cos(0.17 * i + 0.3);
+
+        /* decimate(): its filter, evaluated at inputs 0, M, 2M, … */
+        fir_lowpass(h, taps, 0.5 / M);
+        fir_filter(x, ref, N, h, taps);
+        int nd = decimate(x, N, M, y1);
+        ok = ok && nd == N / M;
+        for (int m = 0; m < nd; m++)
+            ok = ok && fabs(y1[m] - ref[m * M]) < 1e-12;
+
+        /* Same stream in uneven chunks through a DecimatorState */
+        DecimatorState ds;
+        ok = decimator_init(&ds, M, NULL, 0) == 0 && ok;
+        int total = 0;
+        for (int i = 0, c = 1; i < N; i += c, c = c % 13 + 1)
+            total += decimator_process(&ds, x + i, (N - i < c) ? N - i : c,
+                                       y2 + total);
+        ok = ok && total == nd;
+        for (int m = 0; m < total; m++)
+            ok = ok && y2[m] == y1[m];
+        decimator_free(&ds);
+
+        /* polyphase_decimate() with the same filter agrees */
+        polyphase_decimate(x, N, h, taps, M, y2);
+        for (int m = 0; m < N / M; m++)
+            ok = ok && fabs(y2[m] - ref[m * M]) < 1e-12;
+
+        /* Long linear-phase prototypes run folded, same samples */
+        for (int sg = 1; sg >= -1; sg -= 2) {
+            double hl[121];
+            fir_lowpass(hl, 121, 0.1);
+            for (int i = 0; i < 60 && sg < 0; i++) hl[120 - i] = -hl[i];
+            if (sg < 0) hl[60] = 0.0;
+            fir_filter(x, ref, N, hl, 121);
+            ok = decimator_init(&ds, 4, hl, 121) == 0 && ds.sym == sg && ok;
+            int nf = ok ? decimator_process(&ds, x, N, y2) : 0;
+            ok = ok && nf == N / 4;
+            for (int m = 0; m < nf; m++)
+                ok = ok && fabs(y2[m] - ref[m * 4]) < 1e-12;
+            decimator_free(&ds);
+        }
+
+        /* interpolate(): gain-L filter over the zero-stuffed input */
+        fir_lowpass(h, 25, 0.5 / L);
+        for (int i = 0; i < 25; i++) h[i] *= L;
+        for (int i = 0; i < N; i++) up[i * L] = x[i];
+        fir_filter(up, ref, N * L, h, 25);
+        int ni = interpolate(x, N, L, y1);
+        ok = ok && ni == N * L;
+        for (int i = 0; i < ni; i++)
+            ok = ok && fabs(y1[i] - ref[i]) < 1e-12;
+
+        InterpolatorState is;
+        ok = interpolator_init(&is, L, NULL, 0) == 0 && ok;
+        total = 0;
+        for (int i = 0, c = 1; i < N; i += c, c = c % 7 + 1)
+            total += interpolator_process(&is, x + i, (N - i < c) ? N - i : c,
+                                          y2 + total);
+        ok = ok && total == ni;
+        for (int i = 0; i < total; i++)
+            ok = ok && y2[i] == y1[i];
+        interpolator_free(&is);
+
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("Decimator/Interpolator output mismatch"); }
+        free(x); free(ref); free(up); free(y1); free(y2); free(h);
+    }
+
+    /* ── Test 18: Multistage decimation ──────────────────── */
+    TEST_CASE_BEGIN("Multistage decimation plan and cascade (M = 1000)");
+    {
+        int M = 1000, N = 400 * 1000;
+        DecimPlan plan;
+        int ok = decim_plan(&plan, M, 0.8) == 0;
+
+        /* CIC first, factors multiply to M, far cheaper than one FIR */
+        int prod = 1;
+        for (int i = 0; i < plan.n_stages; i++)
+            prod *= plan.stage[i].factor;
+        ok = ok && plan.n_stages > 2 && prod == M &&
+             plan.stage[0].type == DECIM_STAGE_CIC &&
+             plan.cost < plan.single_cost / 3.0;
+
+        double *x  = (double *)malloc((size_t)N * sizeof(double));
+        double *y1 = (double *)malloc((size_t)(N / M + 1) * sizeof(double));
+        double *y2 = (double *)malloc((size_t)(N / M + 1) * sizeof(double));
+        MultistageDecimator *d = multistage_decimator_create(&plan);
+        ok = ok && d != NULL;
+
+        if (ok) {
+            /* Passband tone (0.3 of output Nyquist) comes through at ~unit
+             * gain; one that folds onto 0.1 of it is rejected */
+            double peak_pass = 0.0, peak_alias = 0.0;
+            for (int i = 0; i < N; i++) x[i] = sin(2.0 * M_PI * 0.15 / M * i);
+            int n1 = multistage_decimator_process(d, x, N, y1);
+            for (int i = n1 / 2; i < n1; i++)
+                if (fabs(y1[i]) > peak_pass) peak_pass = fabs(y1[i]);
+            ok = ok && n1 == N / M && fabs(peak_pass - 1.0) < 0.02;
+
+            /* Same stream in uneven chunks gives the same samples */
+            multistage_decimator_reset(d);
+            int total = 0;
+            for (int i = 0, c = 1; i < N; i += c, c = c * 7 % 9973 + 1)
+                total += multistage_decimator_process(d, x + i,
+                                                      (N - i < c) ? N - i : c,
+                                                      y2 + total);
+            ok = ok && total == n1;
+            for (int i = 0; i < total; i++)
+                ok = ok && y2[i] == y1[i];
+
+            multistage_decimator_reset(d);
+            for (int i = 0; i < N; i++) x[i] = sin(2.0 * M_PI * 0.95 / M * i);
+            int n2 = multistage_decimator_process(d, x, N, y1);
+            for (int i = n2 / 2; i < n2; i++)
+                if (fabs(y1[i]) > peak_alias) peak_alias = fabs(y1[i]);
+            ok = ok && peak_alias < 3e-3;
+        }
+        multistage_decimator_destroy(d);
+
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("Multistage plan or cascade out of spec"); }
+        free(x); free(y1); free(y2);
+    }
+
+    /* ── Test 19: Polyphase filter bank ──────────────────── */
+    TEST_CASE_BEGIN("Polyphase filter bank: channels, streaming, reconstruction");
+    {
+        int K = 32, D = 16, P = 8, N = 4096, q0 = 5;
+        int max_frames = N / D + 1;
+        Complex *x  = (Complex *)malloc((size_t)N * sizeof(Complex));
+        Complex *Y1 = (Complex *)malloc((size_t)max_frames * K * sizeof(Complex));
+        Complex *Y2 = (Complex *)malloc((size_t)max_frames * K * sizeof(Complex));
+        Complex *xr = (Complex *)malloc((size_t)N * sizeof(Complex));
+        PfbAnalysis an;
+        PfbSynthesis sy;
+        int ok = pfb_analysis_init(&an, K, D, P) == 0;
+        ok = pfb_synthesis_init(&sy, K, D, P) == 0 && ok;
+
+        if (ok) {
+            /* A tone at the centre of channel q0, plus one in channel 20 */
+            for (int i = 0; i < N; i++) {
+                double a = 2.0 * M_PI * q0 * i / K, b = 2.0 * M_PI * 20.3 * i / K;
+                x[i].re = cos(a) + 0.5 * cos(b);
+                x[i].im = sin(a) + 0.5 * sin(b);
+            }
+            int nf = pfb_analysis_process(&an, x, N, Y1);
+            ok = ok && nf == (N + D - 1) / D;
+
+            /* Frames match the defining sum y_q[m] = Σ h x e^{−j2πq(mD−n)/K} */
+            double hk[32 * 8];
+            for (int i = 0; i < K * P; i++) hk[i] = an.h[i] / K;
+            double err = 0.0;
+            for (int m = 20; m < 24; m++)
+                for (int q = 0; q < K; q++) {
+                    double re = 0.0, im = 0.0;
+                    for (int k = 0; k < K * P && k <= m * D; k++) {
+                        double ph = -2.0 * M_PI * q * ((m * D - k) % K) / K;
+                        const Complex *v = &x[m * D - k];
+                        re += hk[k] * (v->re * cos(ph) - v->im * sin(ph));
+                        im += hk[k] * (v->re * sin(ph) + v->im * cos(ph));
+                    }
+                    Complex y = Y1[m * K + q];
+                    err = fmax(err, hypot(y.re - re, y.im - im));
+                }
+            ok = ok && err < 1e-12;
+
+            /* Channel q0 carries the unit tone; empty channels stay quiet */
+            Complex c = Y1[(nf - 1) * K + q0], e = Y1[(nf - 1) * K + 10];
+            ok = ok && fabs(hypot(c.re, c.im) - 1.0) < 1e-3 &&
+                 hypot(e.re, e.im) < 1e-2;
+
+            /* Streaming in uneven chunks gives the same frames */
+            pfb_analysis_reset(&an);
+            int tf = 0;
+            for (int i = 0, ch = 1; i < N; i += ch, ch = ch % 37 + 1)
+                tf += pfb_analysis_process(&an, x + i, (N - i < ch) ? N - i : ch,
+                                           Y2 + (size_t)tf * K);
+            ok = ok && tf == nf;
+            for (int i = 0; i < tf * K; i++)
+                ok = ok && Y2[i].re == Y1[i].re && Y2[i].im == Y1[i].im;
+
+            /* Synthesis rebuilds x delayed by taps − 1, ~50 dB down */
+            int nr = pfb_synthesis_process(&sy, Y1, N / D, xr);
+            int dly = an.taps - 1;
+            double se = 0.0, sx = 0.0;
+            for (int t = 2 * K * P; t < nr; t++) {
+                double dr = xr[t].re - x[t - dly].re, di = xr[t].im - x[t - dly].im;
+                se += dr * dr + di * di;
+                sx += x[t - dly].re * x[t - dly].re + x[t - dly].im * x[t - dly].im;
+            }
+            ok = ok && nr == N && 10.0 * log10(sx / se) > 45.0;
+        }
+        pfb_analysis_free(&an);
+        pfb_synthesis_free(&sy);
+
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("Filter bank output or reconstruction out of spec"); }
+        free(x); free(Y1); free(Y2); free(xr);
+    }
+
+    /* ── Test 20: M with no divisor up to 8 ──────────────── */
+    TEST_CASE_BEGIN("Multistage decimation without a small divisor (M = 37, 143, 1009)");
+    {
+        static const int Ms[] = {37, 143, 1009};
+        int ok = 1;
+        for (int t = 0; t < 3 && ok; t++) {
+            int M = Ms[t], N = 200 * M;
+            DecimPlan plan;
+            ok = decim_plan(&plan, M, 0.8) == 0 && plan.n_stages > 0 &&
+                 plan.stage[plan.n_stages - 1].type == DECIM_STAGE_FIR &&
+                 plan.stage[plan.n_stages - 1].factor > 1;
+
+            double *x = (double *)malloc((size_t)N * sizeof(double));
+            double *y = (double *)malloc((size_t)(N / M + 1) * sizeof(double));
+            MultistageDecimator *d = multistage_decimator_create(&plan);
+            ok = ok && d != NULL;
+
+            /* Pass a 0.3-Nyquist tone, reject one folding onto 0.1 */
+            for (int pass = 1; pass >= 0 && ok; pass--) {
+                double f = pass ? 0.15 / M : 0.95 / M, peak = 0.0;
+                for (int i = 0; i < N; i++) x[i] = sin(2.0 * M_PI * f * i);
+                multistage_decimator_reset(d);
+                int n = multistage_decimator_process(d, x, N, y);
+                for (int i = n / 2; i < n; i++)
+                    if (fabs(y[i]) > peak) peak = fabs(y[i]);
+                ok = n == N / M && (pass ? fabs(peak - 1.0) < 0.02 : peak < 3e-3);
+            }
+            multistage_decimator_destroy(d);
+            free(x); free(y);
+        }
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("Cascade without a FIR stage or aliasing"); }
+    }
+
     printf("\n=== Test Summary ===\n");
     printf("Total: %d, Passed: %d, Failed: %d\n",
            test_count, test_passed, test_failed);
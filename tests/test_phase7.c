@@ -1,6 +1,6 @@
 /**
  * @file test_phase7.c
- * @brief Unit tests for Phase 7 modules: realtime, optimization.
+ * @brief Unit tests for Phase 7 modules: realtime, optimization, threadpool.
  *
  * Tests:
  *   1.  Ring buffer create/destroy
@@ -21,6 +21,17 @@
  *  16.  Aligned memory read/write works
  *  17.  Benchmark produces valid results
  *  18.  Bench print does not crash
+ *  19.  SIMD FFT is bit-identical to scalar at every level
+ *  20.  SIMD kernels are bit-identical to scalar (incl. odd tails)
+ *  21.  Split-plane SIMD kernels are bit-identical to scalar
+ *  22.  Thread count set/get and parallel_for covers the range once
+ *  23.  fft2d/ifft2d are bit-identical for 1 and 4 threads
+ *  24.  conv2d is bit-identical for 1 and 4 threads
+ *  25.  Four-step FFT: thread-independent, matches DFT bins, round-trips
+ *  26.  Forced four-step engine matches in-place at small sizes
+ *  27.  Four-step bench and crossover return valid results
+ *  28.  Symmetric FIR bench is accurate and timed
+ *  29.  Ring buffer survives a producer/consumer thread stress test
  *
  * Run: make test
  */
@@ -34,12 +45,71 @@
 #include "realtime.h"
 #include "optimization.h"
 #include "fft.h"
+#include "simd.h"
 #include "dsp_utils.h"
+#include "dsp2d.h"
+#include "threadpool.h"
+#include <pthread.h>
+#include <sched.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+/* dsp_parallel_for callback: count visits per index */
+static void mark_range(void *ctx, int begin, int end)
+{
+    int *hits = (int *)ctx;
+    for (int i = begin; i < end; i++)
+        hits[i]++;
+}
+
+/* Ring buffer stress: producer pushes 0, 1, 2, … in varying blocks */
+#define RB_STRESS_N (1 << 20)
+
+static void *rb_stress_producer(void *p)
+{
+    RingBuffer *rb = (RingBuffer *)p;
+    double blk[61];
+    int next = 0, k = 1;
+    while (next < RB_STRESS_N) {
+        int want = RB_STRESS_N - next < k ? RB_STRESS_N - next : k;
+        for (int i = 0; i < want; i++)
+            blk[i] = (double)(next + i);
+        int w = ring_buffer_write(rb, blk, want);
+        if (w == 0) sched_yield();
+        next += w;
+        k = k % 61 + 1;
+    }
+    return NULL;
+}
+
+static void *rb_stress_consumer(void *p)
+{
+    RingBuffer *rb = (RingBuffer *)p;
+    static long bad;
+    double blk[53];
+    int next = 0, k = 1;
+    bad = 0;
+    while (next < RB_STRESS_N) {
+        /* Mix read with peek + skip, which must see the same data */
+        int r;
+        if (k % 3 == 0) {
+            r = ring_buffer_peek(rb, blk, k);
+            ring_buffer_skip(rb, r);
+        } else {
+            r = ring_buffer_read(rb, blk, k);
+        }
+        if (r == 0) sched_yield();
+        for (int i = 0; i < r; i++)
+            if (blk[i] != (double)(next + i))
+                bad++;
+        next += r;
+        k = k % 53 + 1;
+    }
+    return &bad;
+}
+
 int main(void)
 {
     TEST_SUITE("Phase 7: Real-Time & Optimisation");
@@ -289,9 +359,9 @@ int main(void)
         else { TEST_FAIL_STMT("round-trip error too large"); }
     }
 
-    TEST_CASE_BEGIN("Radix-4 fallback for non-power-of-4");
+    TEST_CASE_BEGIN("Radix-4 FFT on non-power-of-4 size");
     {
-        /* N=128 is power of 2 but not power of 4 */
+        /* N=128 is power of 2 but not power of 4: radix-2 + 3 radix-4 stages */
         int N = 128;
         Complex *x2 = (Complex *)malloc((size_t)N * sizeof(Complex));
         Complex *x4 = (Complex *)malloc((size_t)N * sizeof(Complex));
@@ -302,8 +372,8 @@ int main(void)
             x4[i] = x2[i];
         }
 
-        fft(x2, N);
-        fft_radix4(x4, N);  /* should fall back to radix-2 */
+        fft_radix2(x2, N);
+        fft_radix4(x4, N);
 
         double max_err = 0;
         for (int i = 0; i < N; i++) {
@@ -314,8 +384,8 @@ int main(void)
 
         free(x2);
         free(x4);
-        if (max_err < 1e-12) { TEST_PASS_STMT; }
-        else { TEST_FAIL_STMT("radix-4 fallback failed"); }
+        if (max_err < 1e-9) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("radix-4 mismatch at N=128"); }
     }
 
     TEST_CASE_BEGIN("Twiddle table FFT matches direct FFT");
@@ -396,6 +466,16 @@ int main(void)
         else { TEST_FAIL_STMT("invalid bench result"); }
     }
 
+    TEST_CASE_BEGIN("Radix-4 bench verifies against radix-2");
+    {
+        BenchResult r4 = bench_fft_radix4(128, 3);
+        BenchResult r2 = bench_fft_radix2(128, 3);
+        int ok = (r4.n == 128) && (r4.max_err >= 0.0) && (r4.max_err < 1e-9) &&
+                 (r2.max_err == 0.0);
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("radix-4 bench error out of range"); }
+    }
+
     TEST_CASE_BEGIN("Bench print does not crash");
     {
         BenchResult r = bench_fft_radix4(64, 5);
@@ -404,6 +484,329 @@ int main(void)
         TEST_PASS_STMT;
     }
 
+    TEST_CASE_BEGIN("SIMD FFT is bit-identical to scalar at every level");
+    {
+        static const int sizes[] = {2, 4, 8, 32, 512, 2048, 1000};
+        SimdLevel best = simd_detect();
+        int ok = 1;
+        for (int si = 0; si < 7 && ok; si++) {
+            int n = sizes[si];
+            Complex *ref = (Complex *)malloc((size_t)n * sizeof(Complex));
+            Complex *x   = (Complex *)malloc((size_t)n * sizeof(Complex));
+            for (int i = 0; i < n; i++) {
+                ref[i].re = sin(0.37 * i) + 0.1 * (i % 7);
+                ref[i].im = cos(1.3 * i);
+            }
+            memcpy(x, ref, (size_t)n * sizeof(Complex));
+            simd_set_level(SIMD_SCALAR);
+            fft(ref, n);
+            for (int lv = SIMD_SSE2; lv <= (int)best && ok; lv++) {
+                for (int i = 0; i < n; i++) {
+                    x[i].re = sin(0.37 * i) + 0.1 * (i % 7);
+                    x[i].im = cos(1.3 * i);
+                }
+                simd_set_level((SimdLevel)lv);
+                fft(x, n);
+                ok = memcmp(x, ref, (size_t)n * sizeof(Complex)) == 0;
+            }
+            free(ref);
+            free(x);
+        }
+        simd_set_level(best);
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("vector FFT differs from scalar"); }
+    }
+
+    TEST_CASE_BEGIN("SIMD kernels are bit-identical to scalar (incl. odd tails)");
+    {
+        int n = 37;   /* odd: exercises the scalar tail of each kernel */
+        Complex a[37], b[37], y0[37], y1[37];
+        double m0[37], m1[37], p0[37], p1[37];
+        SimdLevel best = simd_detect();
+        for (int i = 0; i < n; i++) {
+            a[i].re = sin(0.9 * i) * 3.0;  a[i].im = cos(0.2 * i) - 0.5;
+            b[i].re = 1.0 / (i + 1.5);     b[i].im = sin(2.1 * i);
+        }
+        int ok = 1;
+        for (int lv = SIMD_SSE2; lv <= (int)best && ok; lv++) {
+            simd_set_level(SIMD_SCALAR);
+            simd_cmul(y0, a, b, n);
+            simd_magnitude(a, m0, n);
+            for (int i = 0; i < n; i++) p0[i] = p1[i] = 0.25 * i;
+            simd_power(b, p0, n, 0.5, 1);
+            simd_set_level((SimdLevel)lv);
+            simd_cmul(y1, a, b, n);
+            simd_magnitude(a, m1, n);
+            simd_power(b, p1, n, 0.5, 1);
+            ok = memcmp(y0, y1, sizeof(y0)) == 0 &&
+                 memcmp(m0, m1, sizeof(m0)) == 0 &&
+                 memcmp(p0, p1, sizeof(p0)) == 0;
+
+            simd_set_level(SIMD_SCALAR);
+            simd_cmul_conj(y0, a, b, n);
+            simd_power(a, p0, n, 2.0, 0);
+            simd_cmac(y0, a, b, n);
+            simd_set_level((SimdLevel)lv);
+            simd_cmul_conj(y1, a, b, n);
+            simd_power(a, p1, n, 2.0, 0);
+            simd_cmac(y1, a, b, n);
+            ok = ok && memcmp(y0, y1, sizeof(y0)) == 0 &&
+                 memcmp(p0, p1, sizeof(p0)) == 0;
+        }
+        /* Scalar path against the textbook definition */
+        simd_set_level(SIMD_SCALAR);
+        simd_cmul(y0, a, b, n);
+        for (int i = 0; i < n && ok; i++) {
+            Complex r = complex_mul(a[i], b[i]);
+            ok = fabs(r.re - y0[i].re) < 1e-12 && fabs(r.im - y0[i].im) < 1e-12;
+        }
+        simd_set_level(best);
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("vector kernel differs from scalar"); }
+    }
+
+    TEST_CASE_BEGIN("Split-plane SIMD kernels are bit-identical to scalar");
+    {
+        int n = 1024 + 7;   /* FFT on the first 1024, kernels on all (odd tail) */
+        SimdLevel best = simd_detect();
+        double *ar = (double *)malloc((size_t)(8 * n) * sizeof(double));
+        double *ai = ar + n, *br = ai + n, *bi = br + n;
+        double *y0r = bi + n, *y0i = y0r + n, *y1r = y0i + n, *y1i = y1r + n;
+        double m0[1031], m1[1031];
+        int ok = 1;
+        for (int lv = SIMD_SSE2; lv <= (int)best && ok; lv++) {
+            for (int pass = 0; pass < 2; pass++) {
+                simd_set_level(pass == 0 ? SIMD_SCALAR : (SimdLevel)lv);
+                double *yr = pass == 0 ? y0r : y1r, *yi = pass == 0 ? y0i : y1i;
+                double *m = pass == 0 ? m0 : m1;
+                for (int i = 0; i < n; i++) {
+                    ar[i] = sin(0.11 * i);  ai[i] = cos(0.05 * i) * 2.0;
+                    br[i] = 1.0 / (i + 3);  bi[i] = sin(1.7 * i);
+                }
+                fft_split(ar, ai, 1024);
+                simd_cmul_split(yr, yi, ar, ai, br, bi, n);
+                simd_magnitude_split(yr, yi, m, n);
+            }
+            ok = memcmp(y0r, y1r, (size_t)n * sizeof(double)) == 0 &&
+                 memcmp(y0i, y1i, (size_t)n * sizeof(double)) == 0 &&
+                 memcmp(m0, m1, sizeof(m0)) == 0;
+        }
+        simd_set_level(best);
+        free(ar);
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("split vector kernel differs from scalar"); }
+    }
+
+    /* ─── Thread Pool Tests ─────────────────────────────── */
+
+    TEST_CASE_BEGIN("Thread count set/get and parallel_for covers the range once");
+    {
+        int ok = dsp_get_num_threads() == 1;           /* default: serial */
+        ok = ok && dsp_set_num_threads(4) == 4 && dsp_get_num_threads() == 4;
+        ok = ok && dsp_set_num_threads(1000) == DSP_MAX_THREADS;
+        ok = ok && dsp_set_num_threads(0) >= 1;
+        dsp_set_num_threads(4);
+        int hits[1001];
+        static const int counts[] = {1, 3, 4, 7, 1001};
+        for (int ci = 0; ci < 5 && ok; ci++) {
+            memset(hits, 0, sizeof(hits));
+            dsp_parallel_for(counts[ci], 1, mark_range, hits);
+            for (int i = 0; i < counts[ci]; i++)
+                ok = ok && hits[i] == 1;
+        }
+        dsp_set_num_threads(1);
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("range not covered exactly once"); }
+    }
+
+    TEST_CASE_BEGIN("fft2d/ifft2d are bit-identical for 1 and 4 threads");
+    {
+        /* Power of 2, mixed radix, and Bluestein (34 = 2·17, 13) */
+        static const int dims[][2] = {{64, 128}, {96, 64}, {30, 20}, {34, 13}};
+        int ok = 1;
+        for (int d = 0; d < 4 && ok; d++) {
+            int rows = dims[d][0], cols = dims[d][1], n = rows * cols;
+            double *buf = (double *)malloc((size_t)(4 * n) * sizeof(double));
+            double *r1 = buf, *i1 = r1 + n, *r4 = i1 + n, *i4 = r4 + n;
+            for (int i = 0; i < n; i++) {
+                r1[i] = r4[i] = sin(0.013 * i) + 0.1 * (i % 11);
+                i1[i] = i4[i] = cos(0.7 * i);
+            }
+            dsp_set_num_threads(1);
+            fft2d(r1, i1, rows, cols);
+            dsp_set_num_threads(4);
+            fft2d(r4, i4, rows, cols);
+            ok = memcmp(r1, r4, (size_t)n * sizeof(double)) == 0 &&
+                 memcmp(i1, i4, (size_t)n * sizeof(double)) == 0;
+            dsp_set_num_threads(1);
+            ifft2d(r1, i1, rows, cols);
+            dsp_set_num_threads(4);
+            ifft2d(r4, i4, rows, cols);
+            ok = ok && memcmp(r1, r4, (size_t)n * sizeof(double)) == 0 &&
+                 memcmp(i1, i4, (size_t)n * sizeof(double)) == 0;
+            for (int i = 0; i < n && ok; i++)
+                ok = fabs(r1[i] - (sin(0.013 * i) + 0.1 * (i % 11))) < 1e-10;
+            free(buf);
+        }
+        dsp_set_num_threads(1);
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("threaded 2-D FFT differs from serial"); }
+    }
+
+    TEST_CASE_BEGIN("conv2d is bit-identical for 1 and 4 threads");
+    {
+        int rows = 57, cols = 64, n = rows * cols;
+        double *img = (double *)malloc((size_t)(3 * n) * sizeof(double));
+        double *o1 = img + n, *o4 = o1 + n;
+        double k[25];
+        for (int i = 0; i < n; i++) img[i] = sin(0.05 * i) * cos(0.003 * i);
+        kernel_gaussian(k, 5, 1.2);
+        dsp_set_num_threads(1);
+        conv2d(img, rows, cols, k, 5, 5, o1);
+        dsp_set_num_threads(4);
+        conv2d(img, rows, cols, k, 5, 5, o4);
+        dsp_set_num_threads(1);
+        int ok = memcmp(o1, o4, (size_t)n * sizeof(double)) == 0;
+        free(img);
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("threaded conv2d differs from serial"); }
+    }
+
+    TEST_CASE_BEGIN("Four-step FFT: thread-independent, matches DFT bins, round-trips");
+    {
+        int n = 1 << FFT_FOURSTEP_MIN_LOG2;
+        Complex *x = (Complex *)malloc((size_t)n * sizeof(Complex));
+        Complex *y = (Complex *)malloc((size_t)n * sizeof(Complex));
+        for (int i = 0; i < n; i++) {
+            x[i].re = sin(0.001 * i) + 0.25 * ((i * 7) % 13 - 6);
+            x[i].im = cos(0.37 * i);
+        }
+        memcpy(y, x, (size_t)n * sizeof(Complex));
+        dsp_set_num_threads(1);
+        fft(x, n);
+        dsp_set_num_threads(3);
+        fft(y, n);
+        int ok = memcmp(x, y, (size_t)n * sizeof(Complex)) == 0;
+
+        /* A few bins against the direct sum */
+        static const int bins[] = {0, 1, 12345, 1 << 20};
+        double peak = 0.0, err = 0.0;
+        for (int b = 0; b < 4; b++) {
+            int k = bins[b] % n;
+            double sr = 0.0, si = 0.0;
+            for (int i = 0; i < n; i++) {
+                double xr = sin(0.001 * i) + 0.25 * ((i * 7) % 13 - 6);
+                double xi = cos(0.37 * i);
+                double a = -2.0 * M_PI * (double)(((long long)k * i) % n) / n;
+                sr += xr * cos(a) - xi * sin(a);
+                si += xr * sin(a) + xi * cos(a);
+            }
+            double e = fabs(sr - x[k].re) + fabs(si - x[k].im);
+            if (e > err) err = e;
+            if (fabs(sr) > peak) peak = fabs(sr);
+        }
+        ok = ok && err < 1e-9 * (peak + 1.0);
+
+        ifft(x, n);
+        for (int i = 0; i < n && ok; i += 97)
+            ok = fabs(x[i].re - (sin(0.001 * i) + 0.25 * ((i * 7) % 13 - 6))) < 1e-9 &&
+                 fabs(x[i].im - cos(0.37 * i)) < 1e-9;
+        dsp_set_num_threads(1);
+        dsp_threadpool_shutdown();
+        free(x);
+        free(y);
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("four-step FFT wrong or thread-dependent"); }
+    }
+
+    TEST_CASE_BEGIN("Forced four-step engine matches in-place at small sizes");
+    {
+        static const int sizes[] = {4, 8, 64, 2048, 1 << 13};
+        int ok = fft_plan_create_engine(12, FFT_ENGINE_FOURSTEP) == NULL &&
+                 fft_plan_create_engine(2, FFT_ENGINE_FOURSTEP) == NULL;
+        for (int si = 0; si < 5 && ok; si++) {
+            int n = sizes[si];
+            FftPlan *ip = fft_plan_create_engine(n, FFT_ENGINE_INPLACE);
+            FftPlan *fs = fft_plan_create_engine(n, FFT_ENGINE_FOURSTEP);
+            Complex *a = (Complex *)malloc((size_t)n * sizeof(Complex));
+            Complex *b = (Complex *)malloc((size_t)n * sizeof(Complex));
+            ok = ip && fs && !ip->fs_cols && fs->fs_cols && fs->n1 * fs->n2 == n;
+            for (int i = 0; ok && i < n; i++) {
+                a[i].re = b[i].re = sin(0.3 * i) + 0.01 * (i % 17);
+                a[i].im = b[i].im = cos(0.07 * i);
+            }
+            if (ok) {
+                fft_execute(ip, a);
+                fft_execute(fs, b);
+            }
+            for (int i = 0; ok && i < n; i++)
+                ok = fabs(a[i].re - b[i].re) < 1e-11 && fabs(a[i].im - b[i].im) < 1e-11;
+            if (ok) {
+                ifft_execute(fs, b);
+                for (int i = 0; ok && i < n; i++)
+                    ok = fabs(b[i].re - (sin(0.3 * i) + 0.01 * (i % 17))) < 1e-12;
+            }
+            fft_plan_destroy(ip);
+            fft_plan_destroy(fs);
+            free(a);
+            free(b);
+        }
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("four-step engine differs from in-place"); }
+    }
+
+    TEST_CASE_BEGIN("Four-step bench and crossover return valid results");
+    {
+        BenchResult r = bench_fft_fourstep(4096, 3);
+        BenchResult bad = bench_fft_fourstep(100, 1);
+        int cross = bench_fft_crossover(8, 10, 2);
+        int ok = r.n == 4096 && r.min_us > 0.0 && r.min_us <= r.avg_us &&
+                 r.max_err >= 0.0 && r.max_err < 1e-9 &&
+                 bad.max_err < 0.0 &&
+                 (cross == -1 || (cross >= 8 && cross <= 10)) &&
+                 bench_fft_crossover(10, 8, 1) == -1;
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("invalid four-step bench result"); }
+    }
+
+    TEST_CASE_BEGIN("Symmetric FIR bench is accurate and timed");
+    {
+        BenchResult d = bench_fir_direct(4096, 63, 3);
+        BenchResult f = bench_fir_symmetric(4096, 63, 3);
+        BenchResult bad = bench_fir_symmetric(0, 63, 1);
+        int ok = d.n == 4096 && d.min_us > 0.0 && d.mflops > 0.0 &&
+                 f.min_us > 0.0 && f.min_us <= f.avg_us &&
+                 f.max_err >= 0.0 && f.max_err < 1e-12 &&
+                 bad.max_err < 0.0;
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("invalid FIR bench result"); }
+    }
+
+    TEST_CASE_BEGIN("Ring buffer survives a producer/consumer thread stress test");
+    {
+        /* Small ring so both sides wrap and hit full/empty constantly */
+        RingBuffer *rb = ring_buffer_create(64);
+        pthread_t tp, tc;
+        void *bad = NULL;
+        int ok = rb != NULL &&
+                 pthread_create(&tc, NULL, rb_stress_consumer, rb) == 0;
+        if (ok) {
+            ok = pthread_create(&tp, NULL, rb_stress_producer, rb) == 0;
+            if (ok) pthread_join(tp, NULL);
+            else    rb_stress_producer(rb);
+            pthread_join(tc, &bad);
+        }
+        ok = ok && *(long *)bad == 0 && ring_buffer_available(rb) == 0;
+
+        BenchResult r = bench_ring_buffer(64, 1 << 18, 2);
+        BenchResult none = bench_ring_buffer(0, 1 << 18, 1);
+        ok = ok && r.n == 64 && r.min_us > 0.0 && r.mflops > 0.0 &&
+             r.max_err == 0.0 && none.max_err < 0.0;
+        ring_buffer_destroy(rb);
+        if (ok) { TEST_PASS_STMT; }
+        else { TEST_FAIL_STMT("ring buffer lost or reordered samples"); }
+    }
+
     /* ── Summary ──────────────────────────────────────────── */
     printf("\n  ────────────────────────────\n");
     printf("  Results: %d/%d passed", test_passed, test_count);
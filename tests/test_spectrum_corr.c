@@ -59,6 +59,22 @@ static int test_periodogram_peak(void)
     return (peak_bin == 64);
 }
 
+/** Non-power-of-2 nfft: peak on the exact bin, odd nfft rejected */
+static int test_periodogram_fast_length(void)
+{
+    const int N = 1000;
+    const double fs = 1000.0;
+    double x[1000], psd[501];
+    gen_cosine(x, N, 1.0, 250.0, fs, 0.0);
+
+    int nb = periodogram(x, N, psd, 1000);   /* 1000 = 2³·5³ */
+    int peak_bin = 0;
+    for (int k = 1; k < nb; k++)
+        if (psd[k] > psd[peak_bin]) peak_bin = k;
+
+    return nb == 501 && peak_bin == 250 && periodogram(x, N, psd, 1001) == -1;
+}
+
 /** Welch returns positive number of segments */
 static int test_welch_segments(void)
 {
@@ -268,6 +284,26 @@ static int test_noise_autocorr_delta(void)
     return ok;
 }
 
+/** FFT xcorr at a non-power-of-2 length matches the direct sum */
+static int test_xcorr_direct_odd_lengths(void)
+{
+    const int NX = 37, NY = 53;   /* r_len = 89 → nfft 90 */
+    double x[37], y[53], r[89];
+    for (int i = 0; i < NX; i++) x[i] = sin(0.4 * i) + 0.05 * i;
+    for (int i = 0; i < NY; i++) y[i] = cos(0.25 * i) - 0.5;
+
+    xcorr(x, NX, y, NY, r);
+
+    /* r[NX-1+m] = Σ_n x[n]·y[n+m] */
+    for (int m = -(NX - 1); m < NY; m++) {
+        double acc = 0.0;
+        for (int n = 0; n < NX; n++)
+            if (n + m >= 0 && n + m < NY) acc += x[n] * y[n + m];
+        if (fabs(r[NX - 1 + m] - acc) > 1e-10) return 0;
+    }
+    return 1;
+}
+
 /** xcorr_peak_lag returns correct value */
 static int test_peak_lag_api(void)
 {
@@ -284,6 +320,7 @@ int main(void)
 
     /* Spectrum tests */
     RUN_TEST(periodogram_peak);
+    RUN_TEST(periodogram_fast_length);
     RUN_TEST(welch_segments);
     RUN_TEST(welch_white_noise_flat);
     RUN_TEST(psd_to_db);
@@ -296,6 +333,7 @@ int main(void)
     RUN_TEST(xcorr_delay);
     RUN_TEST(xcorr_norm_identical);
     RUN_TEST(noise_autocorr_delta);
+    RUN_TEST(xcorr_direct_odd_lengths);
     RUN_TEST(peak_lag_api);
 
     printf("\n=== Test Summary ===\n");